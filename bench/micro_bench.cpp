@@ -0,0 +1,490 @@
+// 	Microbenchmarks for the pdvzip core kernels, to check an optimisation kernel by kernel rather than only end to end.
+//	Each kernel is run in samples of a calibrated number of iterations (at least "MIN_SAMPLE_NS" each, so the clock's resolution doesn't count),
+//	after a warm-up, and reported as the mean time per byte or per entry with its 95% confidence interval (Student's t, over the samples).
+//	Inputs are in memory and warm in the cache where they fit: these are kernel costs, without I/O.
+
+//	Kernels:
+//	"crc"      "Crc" (whole buffer), "Crc_Update" (chained over 256 KB blocks, as "Embed_Zip_Stream" does) & zlib's "crc32" for reference, 1 KB to 1 GB.
+//	"search"   4-byte signature search: the backward "End Central Directory" scan of "Find_Zip_Records" (a 4-byte load per byte),
+//	           "std::search" & "memmem", over buffers without the signature (the whole buffer is searched).
+//	"store"    Endian field stores: the byte loop pdvzip used before the record views ("Value_Updater"), then "Store" (see "pdv_records.hpp"),
+//	           one per 46-byte record (a central directory record's size), per entry.
+//	"script"   "Complete_Extraction_Script", for a first ZIP entry of each launcher category, per script.
+//	"relocate" Central directory relocation ("Fix_Zip_Offset": record search & offset rewrite), for ZIP files of 1 to 1M entries (ZIP64 over 65535), per entry.
+
+//	To compile program (Linux):
+// 	$ g++ -std=c++17 -O2 -DNDEBUG micro_bench.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp -lz -o micro_bench
+
+// 	Run it (largest buffer in MB, default 1024; most ZIP entries, default 1000000; only the kernels whose name contains the filter, if given):
+// 	$ ./micro_bench [max_mb] [max_entries] [filter]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#include "../src/pdv_core.hpp"
+
+constexpr size_t
+	MIN_SAMPLES = 5,
+	MAX_SAMPLES = 30,
+	CRC_BLOCK_SIZE = 256 << 10,	// "Crc_Update" block size ("ZIP_STREAM_BLOCK_SIZE").
+	STORE_RECORD_SIZE = 46,		// "ZIP_CENTRAL_VIEW::SIZE".
+	STORE_ENTRIES = 1 << 16;	// Stores per iteration.
+
+constexpr uint64_t
+	MIN_SAMPLE_NS = 2000000,	// Shortest sample.
+	TIME_BUDGET_NS = 500000000;	// Samples stop after this long (once there are "MIN_SAMPLES").
+
+// Mean time per unit (byte or entry), in nanoseconds, with the half width of its 95% confidence interval.
+struct BENCH_RESULT {
+	double mean, half_width;
+	size_t samples;
+};
+
+// Results of the kernels, kept so the compiler can't drop their work.
+static volatile uint64_t sink;
+
+// Keep the compiler from removing or merging stores to memory the pointer can reach.
+static inline void Clobber(const void* ptr) {
+	asm volatile("" : : "r"(ptr) : "memory");
+}
+
+static uint64_t Now_Ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Run a kernel: "setup(iterations)" (not timed) then "run(iterations)" (timed) for each sample, each iteration doing "units" bytes or entries of work.
+template <typename Setup, typename Run>
+static BENCH_RESULT Measure(Setup, Run, double);
+
+// Print a result line.
+static void Report(const char*, const char*, const std::string&, const char*, const BENCH_RESULT&);
+
+// Whether the kernel matches the filter (or there is none).
+static bool Selected(const char*);
+
+// Size as "1 KB", "64 MB", ... / count as "1", "10K", "1M".
+static std::string Size_Name(size_t), Count_Name(size_t);
+
+// The endian store pdvzip used before the record views: one byte per loop, big-endian from the index, little-endian back from it.
+static void Value_Updater(std::vector<Byte>&, size_t, const size_t&, int, bool);
+
+// A ZIP file of "entries" empty stored files (ZIP64 records over 65535 entries), for "Fix_Zip_Offset".
+static std::vector<Byte> Make_Zip(size_t);
+
+// Zip_Vec for "Complete_Extraction_Script": the framing "IDAT" length & name fields, then a local file header for the named first entry.
+static std::vector<Byte> Make_Script_Zip(const std::string&);
+
+static const char* filter = nullptr;
+
+int main(int argc, char** argv) {
+
+	const size_t
+		MAX_SIZE = (argc > 1 ? std::max(1UL, std::strtoul(argv[1], nullptr, 10)) : 1024) << 20,
+		MAX_ENTRIES = argc > 2 ? std::max(1UL, std::strtoul(argv[2], nullptr, 10)) : 1000000;
+
+	filter = argc > 3 ? argv[3] : nullptr;
+
+	std::printf("\n%-10s %-34s %8s %10s %12s %10s %7s %4s\n", "kernel", "variant", "size", "unit", "mean", "+-95% CI", "+-%", "n");
+
+	// Sizes for the byte kernels, 1 KB to "MAX_SIZE" (1 GB by default).
+	std::vector<size_t> Size_Vec;
+
+	for (size_t size = 1024; size <= MAX_SIZE; size *= 16) {
+		Size_Vec.push_back(size);
+	}
+	if (Size_Vec.back() != MAX_SIZE && MAX_SIZE > 1024) {
+		Size_Vec.push_back(MAX_SIZE);
+	}
+
+	// Random bytes, without "P" (0x50), so that no "PK" signature is ever found & each search reads the whole buffer.
+	std::vector<Byte> Data_Vec;
+
+	if (Selected("crc") || Selected("search")) {
+		Data_Vec.resize(Size_Vec.back());
+
+		uint64_t state = 0x9E3779B97F4A7C15;
+
+		for (Byte& byte : Data_Vec) {
+			state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+			byte = static_cast<Byte>(state >> 24);
+			byte += byte == 0x50;
+		}
+	}
+
+	auto No_Setup = [](size_t) {};
+
+	for (const size_t SIZE : Size_Vec) {
+		Byte* const DATA = Data_Vec.data();
+
+		if (Selected("crc")) {
+			Report("crc", "Crc", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					sink = Crc(DATA, SIZE);
+				}
+			}, static_cast<double>(SIZE)));
+
+			Report("crc", "Crc_Update (256 KB blocks)", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					size_t crc = 0xffffffffL;
+					for (size_t index = 0; index < SIZE; index += CRC_BLOCK_SIZE) {
+						crc = Crc_Update(crc, DATA + index, std::min(CRC_BLOCK_SIZE, SIZE - index));
+					}
+					sink = crc ^ 0xffffffffL;
+				}
+			}, static_cast<double>(SIZE)));
+
+			Report("crc", "zlib crc32 (reference)", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					sink = crc32(crc32(0, nullptr, 0), DATA, static_cast<uInt>(SIZE));
+				}
+			}, static_cast<double>(SIZE)));
+		}
+
+		if (Selected("search")) {
+			constexpr Byte SIG[]{ 0x50, 0x4B, 0x05, 0x06 };	// "End Central Directory" ("ZIP_END_VIEW::SIG").
+
+			Report("search", "backward scan (Find_Zip_Records)", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					size_t index = SIZE - ZIP_END_VIEW::SIZE;
+					while (index && ZIP_END_VIEW(DATA + index, SIZE - index).Signature() != ZIP_END_VIEW::SIG) {
+						index--;
+					}
+					sink = index;
+				}
+			}, static_cast<double>(SIZE)));
+
+			Report("search", "std::search", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					sink = static_cast<uint64_t>(std::search(DATA, DATA + SIZE, SIG, SIG + sizeof(SIG)) - DATA);
+				}
+			}, static_cast<double>(SIZE)));
+
+			Report("search", "memmem", Size_Name(SIZE), "ns/byte", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					sink = reinterpret_cast<uintptr_t>(memmem(DATA, SIZE, SIG, sizeof(SIG)));
+				}
+			}, static_cast<double>(SIZE)));
+		}
+	}
+
+	if (Selected("store")) {
+		std::vector<Byte> Record_Vec(STORE_ENTRIES * STORE_RECORD_SIZE);
+
+		Byte* const RECORDS = Record_Vec.data();
+
+		const std::string ENTRIES = Count_Name(STORE_ENTRIES);
+
+		// Each iteration stores different values, so that no store is dead.
+		Report("store", "Value_Updater 32-bit big", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Value_Updater(Record_Vec, entry * STORE_RECORD_SIZE + 42, entry + iterations, 32, true);
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+
+		Report("store", "Value_Updater 32-bit little", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Value_Updater(Record_Vec, entry * STORE_RECORD_SIZE + 45, entry + iterations, 32, false);
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+
+		Report("store", "Store<uint16_t, Little>", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Store<uint16_t, Endian::Little>(RECORDS + entry * STORE_RECORD_SIZE + 28, static_cast<uint16_t>(entry + iterations));
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+
+		Report("store", "Store<uint32_t, Big>", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Store<uint32_t, Endian::Big>(RECORDS + entry * STORE_RECORD_SIZE + 42, static_cast<uint32_t>(entry + iterations));
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+
+		Report("store", "Store<uint32_t, Little>", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Store<uint32_t, Endian::Little>(RECORDS + entry * STORE_RECORD_SIZE + 42, static_cast<uint32_t>(entry + iterations));
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+
+		Report("store", "Store<uint64_t, Little>", ENTRIES, "ns/entry", Measure(No_Setup, [&](size_t iterations) {
+			while (iterations--) {
+				for (size_t entry = 0; entry < STORE_ENTRIES; entry++) {
+					Store<uint64_t, Endian::Little>(RECORDS + entry * STORE_RECORD_SIZE + 38, entry + iterations);
+				}
+				Clobber(RECORDS);
+			}
+		}, STORE_ENTRIES));
+	}
+
+	if (Selected("script")) {
+		// First ZIP entry names, one per launcher category of "Complete_Extraction_Script".
+		const char* const CATEGORIES[][2]{
+			{ "video/audio (vlc)", "holiday_video.mp4" },
+			{ "pdf (evince)", "manual.pdf" },
+			{ "python (args)", "script.py" },
+			{ "powershell (args)", "script.ps1" },
+			{ "executable (args)", "program.exe" },
+			{ "shell script (args)", "install.sh" },
+			{ "folder", "documents/" },
+			{ "default (xdg-open)", "notes.txt" } };
+
+		for (const auto& CATEGORY : CATEGORIES) {
+			PDV_STRUCT pdv;
+
+			pdv.Zip_Vec = Make_Script_Zip(CATEGORY[1]);
+
+			if (Complete_Extraction_Script(pdv) != PDV_ERROR::NONE) {
+				std::fprintf(stderr, "\nBenchmark Error: Complete_Extraction_Script failed for %s.\n\n", CATEGORY[1]);
+				return EXIT_FAILURE;
+			}
+
+			Report("script", CATEGORY[0], std::to_string(pdv.script_size) + " B", "ns/script", Measure(No_Setup, [&](size_t iterations) {
+				while (iterations--) {
+					sink = static_cast<uint64_t>(Complete_Extraction_Script(pdv));
+				}
+			}, 1));
+		}
+	}
+
+	if (Selected("relocate")) {
+		for (size_t entries = 1; entries <= MAX_ENTRIES; entries *= 10) {
+			const std::vector<Byte> ZIP_VEC = Make_Zip(entries);
+
+			const size_t ZIP_SIZE = ZIP_VEC.size();
+
+			// "Fix_Zip_Offset" rewrites the offsets (& the comment length) in place, so each iteration relocates its own copy of the ZIP file,
+			// copied back in before each sample (not timed). The copies lie end to end within "Image_Vec", each a single piece.
+			PDV_STRUCT pdv;
+
+			std::vector<ZIP_PIECE> Piece_Vec{ { 0, 0, ZIP_SIZE } };
+
+			bool relocate_ok = true;
+
+			Report("relocate", "Fix_Zip_Offset", Count_Name(entries), "ns/entry", Measure([&](size_t iterations) {
+				pdv.Image_Vec.resize(iterations * ZIP_SIZE);
+				for (size_t copy = 0; copy < iterations; copy++) {
+					std::memcpy(pdv.Image_Vec.data() + copy * ZIP_SIZE, ZIP_VEC.data(), ZIP_SIZE);
+				}
+			}, [&](size_t iterations) {
+				for (size_t copy = 0; copy < iterations; copy++) {
+					Piece_Vec[0].to = copy * ZIP_SIZE;
+					relocate_ok &= Fix_Zip_Offset(pdv, Piece_Vec) == PDV_ERROR::NONE;
+				}
+			}, static_cast<double>(entries)));
+
+			if (!relocate_ok) {
+				std::fprintf(stderr, "\nBenchmark Error: Fix_Zip_Offset failed for %zu entries.\n\n", entries);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	std::fputs("\n", stdout);
+}
+
+template <typename Setup, typename Run>
+static BENCH_RESULT Measure(Setup setup, Run run, double units) {
+	// Calibrate (this also warms up the caches & branch predictors): double the iterations until a sample takes "MIN_SAMPLE_NS".
+	size_t iterations = 1;
+
+	while (true) {
+		setup(iterations);
+
+		const uint64_t START_NS = Now_Ns();
+		run(iterations);
+
+		if (Now_Ns() - START_NS >= MIN_SAMPLE_NS) {
+			break;
+		}
+		iterations *= 2;
+	}
+
+	std::vector<double> Sample_Vec;
+
+	const uint64_t BENCH_START_NS = Now_Ns();
+
+	while (Sample_Vec.size() < MAX_SAMPLES && (Sample_Vec.size() < MIN_SAMPLES || Now_Ns() - BENCH_START_NS < TIME_BUDGET_NS)) {
+		setup(iterations);
+
+		const uint64_t START_NS = Now_Ns();
+		run(iterations);
+		const uint64_t SAMPLE_NS = Now_Ns() - START_NS;
+
+		Sample_Vec.push_back(static_cast<double>(SAMPLE_NS) / (static_cast<double>(iterations) * units));
+	}
+
+	const size_t SAMPLES = Sample_Vec.size();
+
+	double mean = 0, variance = 0;
+
+	for (const double SAMPLE : Sample_Vec) {
+		mean += SAMPLE;
+	}
+	mean /= static_cast<double>(SAMPLES);
+
+	for (const double SAMPLE : Sample_Vec) {
+		variance += (SAMPLE - mean) * (SAMPLE - mean);
+	}
+	variance /= static_cast<double>(SAMPLES - 1);
+
+	// Two-sided 95% critical values of Student's t, by degrees of freedom (1 to 30).
+	constexpr double T_95[]{ 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+		2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+
+	const double T = T_95[std::min(SAMPLES - 1, sizeof(T_95) / sizeof(T_95[0])) - 1];
+
+	return { mean, T * std::sqrt(variance / static_cast<double>(SAMPLES)), SAMPLES };
+}
+
+static void Report(const char* kernel, const char* variant, const std::string& size, const char* unit, const BENCH_RESULT& result) {
+	// Fine grained results (below a nanosecond) get more decimal places.
+	const int DECIMALS = result.mean < 1 ? 4 : 2;
+
+	std::printf("%-10s %-34s %8s %10s %12.*f %10.*f %6.1f%% %4zu\n", kernel, variant, size.c_str(), unit,
+		DECIMALS, result.mean, DECIMALS, result.half_width, result.mean ? 100 * result.half_width / result.mean : 0, result.samples);
+	std::fflush(stdout);
+}
+
+static bool Selected(const char* kernel) {
+	return !filter || std::strstr(kernel, filter);
+}
+
+static std::string Size_Name(size_t size) {
+	return size >= (1 << 30) && !(size % (1 << 30)) ? std::to_string(size >> 30) + " GB"
+		: size >= (1 << 20) && !(size % (1 << 20)) ? std::to_string(size >> 20) + " MB" : std::to_string(size >> 10) + " KB";
+}
+
+static std::string Count_Name(size_t count) {
+	return count >= 1000000 && !(count % 1000000) ? std::to_string(count / 1000000) + "M"
+		: count >= 1000 && !(count % 1000) ? std::to_string(count / 1000) + "K" : std::to_string(count);
+}
+
+static void Value_Updater(std::vector<Byte>& vec, size_t value_insert_index, const size_t& NEW_VALUE, int bits, bool big_endian) {
+	if (big_endian) {
+		while (bits) {
+			vec[value_insert_index++] = (NEW_VALUE >> (bits -= 8)) & 0xff;
+		}
+	}
+	else {
+		while (bits) {
+			vec[value_insert_index--] = (NEW_VALUE >> (bits -= 8)) & 0xff;
+		}
+	}
+}
+
+static std::vector<Byte> Make_Zip(size_t entries) {
+	const bool ZIP64 = entries > 0xFFFF;
+
+	std::vector<Byte>
+		Zip_Vec,
+		Central_Vec;
+
+	char name[16];
+
+	for (size_t entry = 0; entry < entries; entry++) {
+		const int NAME_LENGTH = std::snprintf(name, sizeof(name), "f%07zu.txt", entry);
+
+		const size_t LOCAL_INDEX = Zip_Vec.size();
+
+		Zip_Vec.resize(LOCAL_INDEX + ZIP_LOCAL_VIEW::SIZE + NAME_LENGTH);
+
+		Byte* local = Zip_Vec.data() + LOCAL_INDEX;
+
+		Store<uint32_t, Endian::Little>(local, ZIP_LOCAL_VIEW::SIG);
+		Store<uint16_t, Endian::Little>(local + 4, 10);		// Version needed.
+		Store<uint16_t, Endian::Little>(local + 26, static_cast<uint16_t>(NAME_LENGTH));
+		std::memcpy(local + ZIP_LOCAL_VIEW::SIZE, name, NAME_LENGTH);
+
+		const size_t CENTRAL_INDEX = Central_Vec.size();
+
+		Central_Vec.resize(CENTRAL_INDEX + ZIP_CENTRAL_VIEW::SIZE + NAME_LENGTH);
+
+		Byte* central = Central_Vec.data() + CENTRAL_INDEX;
+
+		Store<uint32_t, Endian::Little>(central, ZIP_CENTRAL_VIEW::SIG);
+		Store<uint16_t, Endian::Little>(central + 4, 20);		// Version made by.
+		Store<uint16_t, Endian::Little>(central + 6, 10);		// Version needed.
+		Store<uint16_t, Endian::Little>(central + 28, static_cast<uint16_t>(NAME_LENGTH));
+		Store<uint32_t, Endian::Little>(central + 42, static_cast<uint32_t>(LOCAL_INDEX));
+		std::memcpy(central + ZIP_CENTRAL_VIEW::SIZE, name, NAME_LENGTH);
+	}
+
+	const uint64_t
+		DIR_OFFSET = Zip_Vec.size(),
+		DIR_SIZE = Central_Vec.size();
+
+	Zip_Vec.insert(Zip_Vec.end(), Central_Vec.begin(), Central_Vec.end());
+
+	if (ZIP64) {
+		const size_t ZIP64_END_INDEX = Zip_Vec.size();
+
+		Zip_Vec.resize(ZIP64_END_INDEX + ZIP64_END_VIEW::SIZE + ZIP64_LOCATOR_VIEW::SIZE);
+
+		Byte
+			* zip64_end = Zip_Vec.data() + ZIP64_END_INDEX,
+			* zip64_locator = zip64_end + ZIP64_END_VIEW::SIZE;
+
+		Store<uint32_t, Endian::Little>(zip64_end, ZIP64_END_VIEW::SIG);
+		Store<uint64_t, Endian::Little>(zip64_end + 4, ZIP64_END_VIEW::SIZE - 12);	// Size of the rest of the record.
+		Store<uint16_t, Endian::Little>(zip64_end + 12, 45);
+		Store<uint16_t, Endian::Little>(zip64_end + 14, 45);
+		Store<uint64_t, Endian::Little>(zip64_end + 24, entries);
+		Store<uint64_t, Endian::Little>(zip64_end + 32, entries);
+		Store<uint64_t, Endian::Little>(zip64_end + 40, DIR_SIZE);
+		Store<uint64_t, Endian::Little>(zip64_end + 48, DIR_OFFSET);
+
+		Store<uint32_t, Endian::Little>(zip64_locator, ZIP64_LOCATOR_VIEW::SIG);
+		Store<uint64_t, Endian::Little>(zip64_locator + 8, ZIP64_END_INDEX);
+		Store<uint32_t, Endian::Little>(zip64_locator + 16, 1);	// Total disks.
+	}
+
+	const size_t END_INDEX = Zip_Vec.size();
+
+	Zip_Vec.resize(END_INDEX + ZIP_END_VIEW::SIZE);
+
+	Byte* end = Zip_Vec.data() + END_INDEX;
+
+	Store<uint32_t, Endian::Little>(end, ZIP_END_VIEW::SIG);
+	Store<uint16_t, Endian::Little>(end + 8, static_cast<uint16_t>(ZIP64 ? 0xFFFF : entries));
+	Store<uint16_t, Endian::Little>(end + 10, static_cast<uint16_t>(ZIP64 ? 0xFFFF : entries));
+	Store<uint32_t, Endian::Little>(end + 12, static_cast<uint32_t>(ZIP64 ? 0xFFFFFFFF : DIR_SIZE));
+	Store<uint32_t, Endian::Little>(end + 16, static_cast<uint32_t>(ZIP64 ? 0xFFFFFFFF : DIR_OFFSET));
+
+	return Zip_Vec;
+}
+
+static std::vector<Byte> Make_Script_Zip(const std::string& name) {
+	std::vector<Byte> Zip_Vec(8 + ZIP_LOCAL_VIEW::SIZE + name.length() + 4);
+
+	Store<uint32_t, Endian::Big>(Zip_Vec.data() + 4, 0x49444154);	// "IDAT".
+
+	Byte* local = Zip_Vec.data() + 8;
+
+	Store<uint32_t, Endian::Little>(local, ZIP_LOCAL_VIEW::SIG);
+	Store<uint16_t, Endian::Little>(local + 26, static_cast<uint16_t>(name.length()));
+	std::memcpy(local + ZIP_LOCAL_VIEW::SIZE, name.data(), name.length());
+
+	return Zip_Vec;
+}
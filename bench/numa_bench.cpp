@@ -0,0 +1,154 @@
+// 	NUMA benchmark for the pdvzip job scheduler. Runs the same batch of memory-bound jobs through the scheduler twice: without NUMA placement
+//	(one pool, workers free to move between nodes, as before) and with it (a pool per node, workers bound to their node). Each job does
+//	what an in-memory embed does with its buffers: fills a "Zip_Vec" (as the read would), copies it into an "Image_Vec", then reads that back (as the CRC would).
+
+//	Cross-node traffic is measured, not estimated from timings: after each pass, the node of every 16th page of its buffers is looked up ("move_pages" query)
+//	and compared with the node the job's thread ran the pass on. "remote %" is the share of the bytes moved by the passes that crossed the interconnect.
+//	On a host with a single NUMA node both runs are the same (and all traffic is local).
+
+//	To compile program (Linux):
+// 	$ g++ -std=c++17 -O2 -pthread numa_bench.cpp ../src/pdv_numa.cpp ../src/pdv_sched.cpp ../src/pdv_metrics.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp -lz -o numa_bench
+
+// 	Run it (ZIP size per job in MB, default 200; jobs, default 4 per worker; workers, default 2 per node):
+// 	$ ./numa_bench [mb] [jobs] [workers]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../src/pdv_numa.hpp"
+#include "../src/pdv_sched.hpp"
+
+// Bytes moved by the jobs' passes, and those of them between a thread & memory on different nodes.
+static std::atomic<uint64_t>
+	bytes_moved{ 0 },
+	bytes_remote{ 0 },
+	job_sum{ 0 };
+
+static size_t zip_size;
+
+// Bytes of the buffer (of the given size) on a node other than "node", from every 16th page. With an unknown node, none.
+static uint64_t Remote_Bytes(const Byte*, size_t, int);
+
+// The job: fill, copy & read back, as an in-memory embed does with its buffers.
+static PDV_ERROR Run_Job(PDV_JOB&);
+
+static void Job_Done(const PDV_JOB&) {
+}
+
+int main(int argc, char** argv) {
+
+	const std::vector<NUMA_NODE> NODE_VEC = Numa_Nodes();
+
+	const size_t
+		MB = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200,
+		WORKERS = argc > 3 ? std::max(1, std::atoi(argv[3])) : std::max<size_t>(2, 2 * NODE_VEC.size()),
+		JOBS = argc > 2 ? std::max(1, std::atoi(argv[2])) : 4 * WORKERS;
+
+	zip_size = MB * 1024 * 1024;
+
+	std::printf("\nNUMA nodes: %zu", NODE_VEC.size());
+	for (const NUMA_NODE& NODE : NODE_VEC) {
+		std::printf("%s node%u (%zu CPUs)", &NODE == &NODE_VEC[0] ? ":" : ",", NODE.id, NODE.Cpu_Vec.size());
+	}
+	std::printf("\nJobs: %zu x %zu MB, on %zu workers.\n\n%-8s %10s %10s %10s %10s\n", JOBS, MB, WORKERS, "mode", "wall ms", "GB/s", "moved GB", "remote %");
+
+	for (const bool NUMA : { false, true }) {
+		bytes_moved = bytes_remote = 0;
+
+		std::vector<PDV_JOB> Job_Vec(JOBS);
+
+		for (PDV_JOB& job : Job_Vec) {
+			job.size = zip_size;
+		}
+
+		const uint64_t START_NS = Sched_Now_Ns();
+
+		Scheduler_Start(WORKERS, 0, Run_Job, Job_Done, NUMA);
+		Scheduler_Submit(std::move(Job_Vec));
+		Scheduler_Finish();
+
+		const double
+			SECONDS = (Sched_Now_Ns() - START_NS) / 1e9,
+			MOVED = static_cast<double>(bytes_moved);
+
+		std::printf("%-8s %10.1f %10.2f %10.2f %10.2f\n", NUMA ? "numa" : "default", SECONDS * 1e3, MOVED / SECONDS / 1e9, MOVED / 1e9,
+			MOVED ? 100.0 * bytes_remote / MOVED : 0.0);
+	}
+	if (NODE_VEC.size() < 2) {
+		std::puts("\nSingle NUMA node: nothing crosses an interconnect, so both modes are the same.");
+	}
+	std::printf("\n(checksum %llu)\n\n", static_cast<unsigned long long>(job_sum.load()));
+}
+
+static PDV_ERROR Run_Job(PDV_JOB& job) {
+	// "Zip_Buffer": allocated & filled by the worker (first touch places its pages on the worker's node).
+	std::vector<Byte> Zip_Vec(job.size);
+
+	int node = Numa_Current_Node();
+
+	std::memset(Zip_Vec.data(), static_cast<int>(job.sequence), Zip_Vec.size());
+
+	uint64_t remote = Remote_Bytes(Zip_Vec.data(), Zip_Vec.size(), node);
+
+	// Combine: the ZIP file is copied into the image buffer (read one, write the other).
+	std::vector<Byte> Image_Vec(job.size + 65536);
+
+	node = Numa_Current_Node();
+
+	std::copy_n(Zip_Vec.data(), Zip_Vec.size(), Image_Vec.data() + 65536);
+
+	remote += Remote_Bytes(Zip_Vec.data(), Zip_Vec.size(), node) + Remote_Bytes(Image_Vec.data(), Image_Vec.size(), node);
+
+	// CRC: the image buffer is read back.
+	node = Numa_Current_Node();
+
+	uint64_t sum = 0;
+
+	for (size_t i = 0; i + 8 <= Image_Vec.size(); i += 8) {
+		uint64_t word;
+		std::memcpy(&word, Image_Vec.data() + i, 8);
+		sum += word;
+	}
+	remote += Remote_Bytes(Image_Vec.data(), Image_Vec.size(), node);
+
+	job_sum += sum;
+	bytes_moved += Zip_Vec.size() * 2 + Image_Vec.size() * 2;
+	bytes_remote += remote;
+
+	return PDV_ERROR::NONE;
+}
+
+static uint64_t Remote_Bytes(const Byte* data, size_t size, int node) {
+	constexpr size_t
+		PAGE_SIZE = 4096,
+		STRIDE = 16;
+
+	if (node < 0) {
+		return 0;
+	}
+
+	std::vector<void*> Page_Vec;
+
+	for (size_t offset = 0; offset < size; offset += PAGE_SIZE * STRIDE) {
+		Page_Vec.push_back(const_cast<Byte*>(data) + offset);
+	}
+
+	std::vector<int> Status_Vec(Page_Vec.size(), -1);
+
+	// With no target nodes, "move_pages" only reports the node of each page.
+	if (syscall(SYS_move_pages, 0, Page_Vec.size(), Page_Vec.data(), nullptr, Status_Vec.data(), 0)) {
+		return 0;
+	}
+
+	const size_t REMOTE_PAGES = std::count_if(Status_Vec.begin(), Status_Vec.end(), [node](int status) { return status >= 0 && status != node; });
+
+	return REMOTE_PAGES * size / Page_Vec.size();
+}
@@ -0,0 +1,246 @@
+// 	Startup benchmark for pdvzip. Measures exec-to-exit wall time of pdvzip for a trivial embed job (68 x 68 cover image, tiny ZIP file),
+//	compared against the exec-to-exit time of a no-op C++ process (the fork/exec/dynamic-link floor of this machine).
+
+//	To compile program (Linux):
+// 	$ g++ startup_bench.cpp -O2 -s -o startup_bench
+
+// 	Run it:
+// 	$ ./startup_bench ../src/pdvzip [runs]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef unsigned char Byte;
+
+uint32_t
+	// Bitwise CRC32 (PNG/ZIP polynomial). Only used to build the small benchmark input files.
+	Crc(const Byte*, size_t),
+	Adler(const Byte*, size_t);
+
+void
+	// Append big-endian (PNG) or little-endian (ZIP) values to a vector.
+	Put_Be(std::vector<Byte>&, uint32_t),
+	Put_Le(std::vector<Byte>&, uint32_t, int),
+	// Write the trivial job's input files (cover image & ZIP file) into the current directory.
+	Write_Job_Files();
+
+// Run "argv" to completion with stdout/stderr discarded. Returns the exec-to-exit wall time in microseconds, or -1 on failure.
+double Time_Run(char* const*);
+
+int main(int argc, char** argv) {
+
+	if (argc == 2 && !std::strcmp(argv[1], "--noop")) {
+		return 0;
+	}
+
+	if (argc < 2 || argc > 3) {
+		std::fputs("\nUsage: startup_bench <pdvzip_binary> [runs]\n\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const int RUNS = argc == 3 ? std::max(1, std::atoi(argv[2])) : 200;
+
+	char
+		self_path[4096]{},
+		pdvzip_path[4096]{},
+		temp_dir[] = "/tmp/pdvzip_bench_XXXXXX";
+
+	if (readlink("/proc/self/exe", self_path, sizeof(self_path) - 1) < 0 || !realpath(argv[1], pdvzip_path) || !mkdtemp(temp_dir) || chdir(temp_dir)) {
+		std::fputs("\nBenchmark Error: Unable to locate binaries or create temporary directory.\n\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	Write_Job_Files();
+
+	char
+		noop_arg[] = "--noop",
+		cover_arg[] = "cover.png",
+		zip_arg[] = "data.zip";
+
+	char
+		* const NOOP_ARGV[]{ self_path, noop_arg, nullptr },
+		* const JOB_ARGV[]{ pdvzip_path, cover_arg, zip_arg, nullptr };
+
+	std::vector<double> Noop_Vec, Job_Vec;
+
+	// Warm up the page cache for both binaries, then interleave runs so that frequency scaling or background noise affects both equally.
+	Time_Run(NOOP_ARGV), Time_Run(JOB_ARGV);
+
+	for (int i = 0; i != RUNS; i++) {
+		Noop_Vec.emplace_back(Time_Run(NOOP_ARGV));
+		Job_Vec.emplace_back(Time_Run(JOB_ARGV));
+	}
+
+	// Remove job files and any output images, then the temporary directory.
+	if (DIR* dir = opendir(".")) {
+		while (dirent* entry = readdir(dir)) {
+			if (std::strcmp(entry->d_name, ".") && std::strcmp(entry->d_name, "..")) {
+				unlink(entry->d_name);
+			}
+		}
+		closedir(dir);
+	}
+	chdir("/");
+	rmdir(temp_dir);
+
+	if (std::count(Job_Vec.begin(), Job_Vec.end(), -1.0)) {
+		std::fputs("\nBenchmark Error: pdvzip failed to complete the trivial job.\n\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	std::sort(Noop_Vec.begin(), Noop_Vec.end());
+	std::sort(Job_Vec.begin(), Job_Vec.end());
+
+	auto percentile = [RUNS](const std::vector<double>& vec, double p) { return vec[std::min(RUNS - 1, static_cast<int>(p * RUNS))]; };
+
+	std::printf("\nRuns: %d\n\n%-8s %10s %10s %10s\n", RUNS, "(us)", "min", "median", "p99");
+	std::printf("%-8s %10.1f %10.1f %10.1f\n", "no-op", Noop_Vec[0], percentile(Noop_Vec, 0.5), percentile(Noop_Vec, 0.99));
+	std::printf("%-8s %10.1f %10.1f %10.1f\n", "pdvzip", Job_Vec[0], percentile(Job_Vec, 0.5), percentile(Job_Vec, 0.99));
+	std::printf("\npdvzip overhead (median - no-op median): %.1f us\n\n", percentile(Job_Vec, 0.5) - percentile(Noop_Vec, 0.5));
+}
+
+double Time_Run(char* const* argv) {
+
+	timespec start{}, end{};
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	const pid_t PID = fork();
+
+	if (PID == 0) {
+		const int NULL_FD = open("/dev/null", O_WRONLY);
+		dup2(NULL_FD, STDOUT_FILENO);
+		dup2(NULL_FD, STDERR_FILENO);
+		execv(argv[0], argv);
+		_exit(127);
+	}
+
+	int status = 0;
+	if (PID < 0 || waitpid(PID, &status, 0) != PID) {
+		return -1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	return WIFEXITED(status) && !WEXITSTATUS(status) ? (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3 : -1;
+}
+
+void Write_Job_Files() {
+
+	// Cover image: smallest supported PNG-24 (68 x 68) with a gradient, stored (uncompressed) deflate block.
+	// If the IHDR chunk happens to contain a "BAD_CHAR" character, widen the image by a pixel and try again.
+	const std::string BAD_CHAR = "\x22\x27\x28\x29\x3B\x3E\x60";
+
+	std::vector<Byte> Image_Vec;
+
+	for (uint32_t width = 68;; width++) {
+		const uint32_t HEIGHT = 68;
+
+		Image_Vec = { 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+		Put_Be(Image_Vec, 13);
+		Image_Vec.insert(Image_Vec.end(), { 'I', 'H', 'D', 'R' });
+		Put_Be(Image_Vec, width);
+		Put_Be(Image_Vec, HEIGHT);
+		Image_Vec.insert(Image_Vec.end(), { 8, 2, 0, 0, 0 });
+		Put_Be(Image_Vec, Crc(&Image_Vec[12], 17));
+
+		if (std::none_of(Image_Vec.begin() + 19, Image_Vec.begin() + 33, [&BAD_CHAR](Byte b) { return BAD_CHAR.find(static_cast<char>(b)) != std::string::npos; })) {
+			std::vector<Byte> Raw_Vec;
+			for (uint32_t y = 0; y != HEIGHT; y++) {
+				Raw_Vec.emplace_back(0);
+				for (uint32_t x = 0; x != width; x++) {
+					Raw_Vec.insert(Raw_Vec.end(), { static_cast<Byte>(x * 3), static_cast<Byte>(y * 3), static_cast<Byte>(x + y) });
+				}
+			}
+			const uint32_t RAW_SIZE = static_cast<uint32_t>(Raw_Vec.size());
+
+			std::vector<Byte> Idat_Vec{ 'I', 'D', 'A', 'T', 0x78, 0x01, 0x01 };
+			Put_Le(Idat_Vec, RAW_SIZE, 16);
+			Put_Le(Idat_Vec, ~RAW_SIZE & 0xFFFF, 16);
+			Idat_Vec.insert(Idat_Vec.end(), Raw_Vec.begin(), Raw_Vec.end());
+			Put_Be(Idat_Vec, Adler(Raw_Vec.data(), Raw_Vec.size()));
+
+			Put_Be(Image_Vec, static_cast<uint32_t>(Idat_Vec.size() - 4));
+			Image_Vec.insert(Image_Vec.end(), Idat_Vec.begin(), Idat_Vec.end());
+			Put_Be(Image_Vec, Crc(Idat_Vec.data(), Idat_Vec.size()));
+			Image_Vec.insert(Image_Vec.end(), { 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82 });
+			break;
+		}
+	}
+
+	// ZIP file: a single stored entry "hello.txt" (no extension-dependent prompts from pdvzip).
+	const std::string
+		NAME = "hello.txt",
+		DATA = "Hello from the pdvzip startup benchmark.\n";
+
+	const uint32_t
+		NAME_SIZE = static_cast<uint32_t>(NAME.size()),
+		DATA_SIZE = static_cast<uint32_t>(DATA.size()),
+		DATA_CRC = Crc(reinterpret_cast<const Byte*>(DATA.data()), DATA.size());
+
+	std::vector<Byte> Zip_Vec;
+
+	Put_Le(Zip_Vec, 0x04034B50, 32), Put_Le(Zip_Vec, 10, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 32);
+	Put_Le(Zip_Vec, DATA_CRC, 32), Put_Le(Zip_Vec, DATA_SIZE, 32), Put_Le(Zip_Vec, DATA_SIZE, 32), Put_Le(Zip_Vec, NAME_SIZE, 16), Put_Le(Zip_Vec, 0, 16);
+	Zip_Vec.insert(Zip_Vec.end(), NAME.begin(), NAME.end());
+	Zip_Vec.insert(Zip_Vec.end(), DATA.begin(), DATA.end());
+
+	const uint32_t CENTRAL_DIR_INDEX = static_cast<uint32_t>(Zip_Vec.size());
+
+	Put_Le(Zip_Vec, 0x02014B50, 32), Put_Le(Zip_Vec, 10, 16), Put_Le(Zip_Vec, 10, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 32);
+	Put_Le(Zip_Vec, DATA_CRC, 32), Put_Le(Zip_Vec, DATA_SIZE, 32), Put_Le(Zip_Vec, DATA_SIZE, 32), Put_Le(Zip_Vec, NAME_SIZE, 16);
+	Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 32), Put_Le(Zip_Vec, 0, 32);
+	Zip_Vec.insert(Zip_Vec.end(), NAME.begin(), NAME.end());
+
+	const uint32_t CENTRAL_DIR_SIZE = static_cast<uint32_t>(Zip_Vec.size()) - CENTRAL_DIR_INDEX;
+
+	Put_Le(Zip_Vec, 0x06054B50, 32), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 0, 16), Put_Le(Zip_Vec, 1, 16), Put_Le(Zip_Vec, 1, 16);
+	Put_Le(Zip_Vec, CENTRAL_DIR_SIZE, 32), Put_Le(Zip_Vec, CENTRAL_DIR_INDEX, 32), Put_Le(Zip_Vec, 0, 16);
+
+	for (const auto& [NAME_STR, VEC] : { std::make_pair("cover.png", &Image_Vec), std::make_pair("data.zip", &Zip_Vec) }) {
+		if (std::FILE* file_ofs = std::fopen(NAME_STR, "wb")) {
+			std::fwrite(VEC->data(), 1, VEC->size(), file_ofs);
+			std::fclose(file_ofs);
+		}
+	}
+}
+
+void Put_Be(std::vector<Byte>& vec, uint32_t value) {
+	vec.insert(vec.end(), { static_cast<Byte>(value >> 24), static_cast<Byte>(value >> 16), static_cast<Byte>(value >> 8), static_cast<Byte>(value) });
+}
+
+void Put_Le(std::vector<Byte>& vec, uint32_t value, int bits) {
+	for (int shift = 0; shift != bits; shift += 8) {
+		vec.emplace_back(static_cast<Byte>(value >> shift));
+	}
+}
+
+uint32_t Crc(const Byte* buf, size_t len) {
+	uint32_t c = 0xFFFFFFFF;
+	while (len--) {
+		c ^= *buf++;
+		for (int k = 0; k != 8; k++) {
+			c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+		}
+	}
+	return c ^ 0xFFFFFFFF;
+}
+
+uint32_t Adler(const Byte* buf, size_t len) {
+	uint32_t a = 1, b = 0;
+	while (len--) {
+		a = (a + *buf++) % 65521;
+		b = (b + a) % 65521;
+	}
+	return b << 16 | a;
+}
@@ -0,0 +1,27 @@
+// 	libFuzzer target: cover image parsing. Fuzzed input is the PNG image, embedded with a fixed, valid ZIP file.
+//	Runs every core stage (image checks, chunk strip, ZIP checks, script build, combine, offset fix & CRC) in memory.
+
+//	To compile (clang, libFuzzer):
+// 	$ clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined fuzz_image.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp -lz -pthread -o fuzz_image
+
+// 	Run it (see "seed_corpus.sh"):
+// 	$ ./fuzz_image -max_len=65536 corpus_image/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "../src/pdv_core.hpp"
+#include "fuzz_inputs.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+
+	PDV_STRUCT pdv;
+
+	pdv.Image_Vec.assign(data, data + size);
+	std::memcpy(Zip_Buffer(pdv, sizeof(FUZZ_ZIP_FILE)), FUZZ_ZIP_FILE, sizeof(FUZZ_ZIP_FILE));
+
+	Embed_Zip(pdv);
+
+	return 0;
+}
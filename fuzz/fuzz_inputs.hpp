@@ -0,0 +1,30 @@
+// 	Fixed inputs for the pdvzip fuzz targets. When one input is being fuzzed, the other input is one of these known-good files.
+
+//	FUZZ_COVER_IMAGE: 68 x 68 PNG-24 (Truecolor) gradient ("Generate_Gradient_Png", over 256 colours, so "Check_Image_File" accepts it), single IDAT chunk.
+//	FUZZ_ZIP_FILE: ZIP archive with a single stored file, "hello.txt".
+
+#pragma once
+
+#include "../src/pdv_records.hpp"
+
+inline const Byte FUZZ_COVER_IMAGE[]{
+	0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x44, 0x00, 0x00, 0x00, 0x44, 0x08, 0x02, 0x00, 0x00, 0x00, 0xB7, 0x71, 0x04,
+	0xE5, 0x00, 0x00, 0x00, 0x54, 0x49, 0x44, 0x41, 0x54, 0x78, 0xDA, 0xED, 0xCF, 0x01, 0x09, 0x00,
+	0x00, 0x08, 0x03, 0xB0, 0xDF, 0xFE, 0xA1, 0x8D, 0x21, 0xC8, 0x60, 0x05, 0xD6, 0x24, 0xFD, 0x62,
+	0xFE, 0x54, 0x2A, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+	0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+	0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x23,
+	0x23, 0x23, 0x23, 0x23, 0x23, 0x23, 0x73, 0x60, 0x01, 0x5C, 0x5B, 0x12, 0x97, 0xAC, 0x71, 0x2C,
+	0xEB, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82 };
+
+inline const Byte FUZZ_ZIP_FILE[]{
+	0x50, 0x4B, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x58, 0x49, 0xCB,
+	0xCF, 0x33, 0x0F, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x68, 0x65,
+	0x6C, 0x6C, 0x6F, 0x2E, 0x74, 0x78, 0x74, 0x48, 0x65, 0x6C, 0x6C, 0x6F, 0x2C, 0x20, 0x70, 0x64,
+	0x76, 0x7A, 0x69, 0x70, 0x2E, 0x0A, 0x50, 0x4B, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x21, 0x58, 0x49, 0xCB, 0xCF, 0x33, 0x0F, 0x00, 0x00, 0x00, 0x0F, 0x00,
+	0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01,
+	0x00, 0x00, 0x00, 0x00, 0x68, 0x65, 0x6C, 0x6C, 0x6F, 0x2E, 0x74, 0x78, 0x74, 0x50, 0x4B, 0x05,
+	0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x37, 0x00, 0x00, 0x00, 0x36, 0x00, 0x00,
+	0x00, 0x00, 0x00 };
@@ -0,0 +1,25 @@
+// 	libFuzzer target: PNG decoding ("Decode_Png"). Fuzzed input is the PNG image.
+//	Runs the chunk walk, inflate, unfiltering (SIMD & parallel row runs) and Adam7 deinterlacing.
+
+//	To compile (clang, libFuzzer):
+// 	$ clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined fuzz_png.cpp ../src/pdv_png.cpp -lz -pthread -o fuzz_png
+
+// 	Run it (see "seed_corpus.sh", the "corpus_image" seeds):
+// 	$ ./fuzz_png -max_len=65536 corpus_image/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../src/pdv_png.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+
+	const std::vector<Byte> Image_Vec(data, data + size);
+
+	PNG_IMAGE image;
+
+	// Two threads, so that the parallel unfilter path is reachable on large enough images.
+	Decode_Png(Image_Vec, image, 2);
+
+	return 0;
+}
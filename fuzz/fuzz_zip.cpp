@@ -0,0 +1,42 @@
+// 	libFuzzer target: ZIP file parsing & relocation. Fuzzed input is the ZIP file, embedded within a fixed, valid cover image.
+//	Runs every core stage (image checks, chunk strip, ZIP checks, script build, combine, offset fix & CRC) in memory,
+//	then again with the "twitter" carrier chunks ("Fill_Carrier_Chunks"), aborting if the "iCCP" chunk's length field
+//	would break the Linux extraction script (holds a "BAD_CHAR" character).
+
+//	To compile (clang, libFuzzer):
+// 	$ clang++ -std=c++17 -g -O1 -fsanitize=fuzzer,address,undefined fuzz_zip.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp -lz -pthread -o fuzz_zip
+
+// 	Run it (see "seed_corpus.sh"):
+// 	$ ./fuzz_zip -max_len=65536 corpus_zip/
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "../src/pdv_core.hpp"
+#include "fuzz_inputs.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+
+	for (const PDV_CARRIERS CARRIERS : { PDV_CARRIERS::NONE, PDV_CARRIERS::TWITTER }) {
+		PDV_STRUCT pdv;
+
+		pdv.carriers = CARRIERS;
+		pdv.Image_Vec.assign(FUZZ_COVER_IMAGE, FUZZ_COVER_IMAGE + sizeof(FUZZ_COVER_IMAGE));
+
+		if (size) {
+			std::memcpy(Zip_Buffer(pdv, size), data, size);
+		}
+
+		if (Embed_Zip(pdv) == PDV_ERROR::NONE && CARRIERS != PDV_CARRIERS::NONE) {
+			// The "iCCP" chunk follows the PNG signature & "IHDR" chunk.
+			for (size_t index = 33; index != 37; index++) {
+				if (pdv.BAD_CHAR.find(static_cast<char>(pdv.Image_Vec[index])) != std::string::npos) {
+					std::abort();
+				}
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# 	Build the seed corpora for the pdvzip fuzz targets from the PNG-ZIP polyglot images in "../demo_image".
+#	corpus_image/	The demo images, as-is (valid PNG images, to seed "fuzz_image" & "fuzz_png").
+#	corpus_zip/	The ZIP file carved out of each demo image (from the first local file header to the end of the image), to seed "fuzz_zip".
+#			Its comment length already covers the trailing "IDAT" CRC & "IEND" chunk, but its record offsets are still image-relative,
+#			so these seeds also exercise the offset checks.
+#			Also "iccp_length.zip": 160 small stored files, so that the "twitter" carrier chunks fill the "iCCP" chunk to a length of 0x27xx
+#			(its high byte "'" would break the Linux extraction script, see "Fill_Carrier_Chunks").
+
+# 	The demo images are several MB each. For throughput, run the targets with a small -max_len (e.g. 65536),
+#	so that libFuzzer only mutates the leading bytes (headers, IHDR, first chunks / first records) of each seed.
+
+#	Usage: ./seed_corpus.sh [demo_image_dir]
+
+set -e
+
+DEMO_DIR="${1:-../demo_image}"
+
+mkdir -p corpus_image corpus_zip
+
+for image in "$DEMO_DIR"/*.png; do
+	name=$(basename "$image" .png)
+	cp "$image" "corpus_image/$name.png"
+
+	# Byte offset of the first "PK\x03\x04" signature.
+	zip_index=$(LC_ALL=C grep -obUaP "PK\x03\x04" "$image" | head -n 1 | cut -d: -f1)
+
+	if [ -n "$zip_index" ]; then
+		tail -c +$(( zip_index + 1 )) "$image" > "corpus_zip/$name.zip"
+	fi
+done
+
+# Write hex digits out as bytes. A number as 4 little-endian bytes (hex digits).
+hex_bytes() { printf "$(sed 's/../\\x&/g' <<< "$1")"; }
+le32() { printf "%08x" "$1" | sed 's/\(..\)\(..\)\(..\)\(..\)/\4\3\2\1/'; }
+
+# Local records of 62 bytes (30-byte header, 8-byte name "fNNN.txt", 24 bytes of data), central directory records of 54 bytes.
+printf -v data "%024d" 0
+crc=$(printf "%s" "$data" | gzip -c | tail -c 8 | head -c 4 | od -An -tx1 | tr -d " \n")
+index=0
+central=""
+
+for file in $(seq -w 0 159); do
+	name_hex=$(printf "f%s.txt" "$file" | od -An -tx1 | tr -d " \n")
+	data_hex=$(printf "%s" "$data" | od -An -tx1 | tr -d " \n")
+	hex_bytes "504b0304""0a00""0000""0000""00000000""$crc""18000000""18000000""0800""0000""$name_hex""$data_hex" >> corpus_zip/iccp_length.zip.tmp
+	central+="504b0102""1e03""0a00""0000""0000""00000000""$crc""18000000""18000000""0800""0000""0000""0000""0000""00000000""$(le32 $index)""$name_hex"
+	index=$(( index + 62 ))
+done
+
+hex_bytes "$central""504b0506""0000""0000""a000""a000""$(le32 $(( 160 * 54 )))""$(le32 $index)""0000" >> corpus_zip/iccp_length.zip.tmp
+mv corpus_zip/iccp_length.zip.tmp corpus_zip/iccp_length.zip
+
+echo "Seed corpora: $(ls corpus_image | wc -l) image(s), $(ls corpus_zip | wc -l) zip file(s)."
@@ -0,0 +1,72 @@
+// 	Standalone driver for the pdvzip fuzz targets, for compilers without libFuzzer (e.g. g++).
+//	Replays each input file (or every file within an input directory) through the target, then reports executions per second.
+//	Useful for reproducing crashes, regression-testing a corpus and measuring target throughput.
+
+//	To compile (link with one target):
+// 	$ g++ -std=c++17 -g -O2 -fsanitize=address,undefined standalone_main.cpp fuzz_zip.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp -lz -pthread -o fuzz_zip
+
+// 	Run it:
+// 	$ ./fuzz_zip [-runs=N] <file|directory>...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t*, size_t);
+
+int main(int argc, char** argv) {
+
+	std::vector<std::vector<uint8_t>> Input_Vec;
+
+	int runs = 1;
+
+	auto read_input = [&Input_Vec](const std::filesystem::path& path) {
+		if (std::FILE* input_ifs = std::fopen(path.string().c_str(), "rb")) {
+			std::vector<uint8_t> Data_Vec(std::filesystem::file_size(path));
+			Data_Vec.resize(std::fread(Data_Vec.data(), 1, Data_Vec.size(), input_ifs));
+			std::fclose(input_ifs);
+			Input_Vec.emplace_back(std::move(Data_Vec));
+		}
+	};
+
+	for (int i = 1; i != argc; i++) {
+		if (!std::strncmp(argv[i], "-runs=", 6)) {
+			runs = std::max(1, std::atoi(argv[i] + 6));
+		}
+		else if (std::filesystem::is_directory(argv[i])) {
+			for (const auto& entry : std::filesystem::directory_iterator(argv[i])) {
+				if (entry.is_regular_file()) {
+					read_input(entry.path());
+				}
+			}
+		}
+		else {
+			read_input(argv[i]);
+		}
+	}
+
+	if (Input_Vec.empty()) {
+		std::fputs("\nUsage: <fuzz_target> [-runs=N] <file|directory>...\n\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	const auto START = std::chrono::steady_clock::now();
+
+	for (int run = 0; run != runs; run++) {
+		for (const auto& Data_Vec : Input_Vec) {
+			LLVMFuzzerTestOneInput(Data_Vec.data(), Data_Vec.size());
+		}
+	}
+
+	const double
+		SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count(),
+		EXECS = static_cast<double>(runs) * Input_Vec.size();
+
+	std::printf("\nExecuted %zu inputs x %d runs in %.3f s (%.0f exec/s).\n\n", Input_Vec.size(), runs, SECONDS, EXECS / SECONDS);
+}
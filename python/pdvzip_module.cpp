@@ -0,0 +1,602 @@
+// 	PDVZIP Python extension module ("import pdvzip"). Embed, verify & extract in-process, over the core code, without spawning pdvzip or writing temporary files.
+
+//	Every file argument is either a bytes-like object ("bytes", "bytearray", "memoryview", "mmap", ... anything with the buffer protocol)
+//	or a file descriptor (int). Buffers are used in place, never copied whole: the buffer is held (and so can't be resized) for the call.
+//	A descriptor for a regular file is memory mapped (the whole file, from its start), otherwise (pipe, socket) read to its end.
+//	The GIL is released for all the work (CRC, offset relocation, inflate-free chunk reads & I/O), so calls on several threads run in parallel.
+
+//	pdvzip.embed(image, zip, *, out_fd=None, linux_args="", windows_args="", reduce_cover=False, carriers=None, packs=None)
+//		Embed the ZIP file within the PNG cover image. Returns the polyglot image as a read-only "pdvzip.Buffer" (buffer protocol: use it with
+//		memoryview, bytes, file.write, ...), or with "out_fd", writes it to that descriptor and returns its size. "linux_args" & "windows_args" are the
+//		command-line arguments for the extraction script (for file types that take them). Without "carriers" or "packs", the ZIP file is streamed
+//		(see "Embed_Zip_Stream"): only its first local header & trailing records are copied, its body goes straight from the input buffer to the output.
+//		"carriers" is a "--carriers" profile name (e.g. "twitter"). "packs" is a sequence of (name, zip) pairs, as "--pack" (names end with ".zip").
+//	pdvzip.extract(image, pack=None, *, out_fd=None)
+//		Rebuild the ZIP file (or the named pack) from the polyglot image. Returns a "pdvzip.Buffer", or with "out_fd", writes it & returns its size.
+//	pdvzip.verify(image)
+//		Check the polyglot image: every chunk lies within the image with a valid CRC, and the ZIP file & each pack rebuild with valid records.
+//		Returns {"chunks": <count>, "zip_size": <bytes>, "packs": {<name>: <bytes>, ...}}.
+
+//	Failures raise "pdvzip.Error", with args (error name, message), e.g. ("zip_signature", "ZIP File Error: File does not appear to be a valid ZIP archive.").
+
+//	Linux only (descriptors are mapped & written with POSIX calls). To compile (from this directory):
+// 	$ g++ -std=c++17 -O2 -DNDEBUG -shared -fPIC $(python3-config --includes) pdvzip_module.cpp ../src/pdv_core.cpp ../src/pdv_png.cpp ../src/pdv_extract.cpp
+//	  ../src/pdv_job.cpp ../src/pdv_direct.cpp ../src/pdv_stats.cpp ../src/pdv_trace.cpp ../src/pdv_metrics.cpp -pthread -lz -o pdvzip$(python3-config --extension-suffix)
+
+// 	Use it:
+// 	>>> import pdvzip
+// 	>>> polyglot = pdvzip.embed(open("cover.png", "rb").read(), open("data.zip", "rb").read())
+// 	>>> pdvzip.verify(polyglot)
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../src/pdv_core.hpp"
+#include "../src/pdv_extract.hpp"
+#include "../src/pdv_job.hpp"
+
+// A file argument: the caller's buffer, a memory mapped descriptor, or the bytes read from a descriptor.
+struct PDV_INPUT {
+	Py_buffer view{};
+	bool held{};		// "view" holds the caller's buffer.
+	const Byte* data = nullptr;
+	size_t size{};
+	void* map = nullptr;	// Memory map of a descriptor ("size" bytes).
+	std::vector<Byte> Read_Vec;
+};
+
+// Where the output goes: to a descriptor, or into "Out_Vec".
+struct PDV_OUTPUT {
+	int fd = -1;
+	std::vector<Byte> Out_Vec;
+	size_t size{};
+};
+
+// "pdvzip.Buffer": owns a result vector and exports it, read-only, through the buffer protocol.
+struct PDV_BUFFER {
+	PyObject_HEAD
+	std::vector<Byte>* Data_Vec;
+};
+
+static PyObject* pdv_error_type;
+
+static bool
+	// Fill in the input from a bytes-like object or a descriptor (argument "name", for the exception message). Sets a Python exception on failure.
+	Get_Input(PyObject*, PDV_INPUT&, const char*),
+	// Write the bytes to the descriptor (all of them, retrying after short writes & EINTR). Called without the GIL.
+	Write_Fd(int, const Byte*, size_t),
+	// Streaming hooks ("PDV_STRUCT"): read from the ZIP file input held in "zip_stream" / write to the output held in "out_stream".
+	Read_Zip_Input(PDV_STRUCT&, Byte*, size_t, size_t),
+	Write_Output(PDV_STRUCT&, const Byte*, size_t);
+
+// Release the caller's buffer or the descriptor's map.
+static void Release_Input(PDV_INPUT&);
+
+static PyObject
+	// Raise "pdvzip.Error" for the error value (returns nullptr).
+	* Raise_Error(PDV_ERROR),
+	// The result for the output: a "pdvzip.Buffer" holding it, or the number of bytes written to the descriptor.
+	* Output_Result(PDV_OUTPUT&),
+	// Module functions.
+	* Embed(PyObject*, PyObject*, PyObject*),
+	* Extract(PyObject*, PyObject*, PyObject*),
+	* Verify(PyObject*, PyObject*);
+
+static int Buffer_Get(PyObject* self, Py_buffer* view, int flags) {
+	std::vector<Byte>& data = *reinterpret_cast<PDV_BUFFER*>(self)->Data_Vec;
+
+	return PyBuffer_FillInfo(view, self, data.data(), static_cast<Py_ssize_t>(data.size()), 1, flags);
+}
+
+static Py_ssize_t Buffer_Length(PyObject* self) {
+	return static_cast<Py_ssize_t>(reinterpret_cast<PDV_BUFFER*>(self)->Data_Vec->size());
+}
+
+static void Buffer_Dealloc(PyObject* self) {
+	delete reinterpret_cast<PDV_BUFFER*>(self)->Data_Vec;
+	Py_TYPE(self)->tp_free(self);
+}
+
+// Python's type & module structs are filled in member by member, so each field left out is zeroed without a missing-initializer warning.
+static PyBufferProcs buffer_procs = [] {
+	PyBufferProcs procs{};
+	procs.bf_getbuffer = Buffer_Get;
+	return procs;
+}();
+
+static PySequenceMethods buffer_sequence = [] {
+	PySequenceMethods sequence{};
+	sequence.sq_length = Buffer_Length;
+	return sequence;
+}();
+
+static PyTypeObject buffer_type = [] {
+	PyTypeObject type{};
+	type.ob_base = { PyObject_HEAD_INIT(nullptr) 0 };
+	type.tp_name = "pdvzip.Buffer";
+	type.tp_basicsize = sizeof(PDV_BUFFER);
+	type.tp_dealloc = Buffer_Dealloc;
+	type.tp_as_sequence = &buffer_sequence;
+	type.tp_as_buffer = &buffer_procs;
+	type.tp_flags = Py_TPFLAGS_DEFAULT;
+	type.tp_doc = "Read-only bytes produced by pdvzip (buffer protocol).";
+	return type;
+}();
+
+static PyMethodDef module_methods[]{
+	{ "embed", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(Embed)), METH_VARARGS | METH_KEYWORDS,
+		"embed(image, zip, *, out_fd=None, linux_args='', windows_args='', reduce_cover=False, carriers=None, packs=None)\n\n"
+		"Embed the ZIP file within the PNG cover image. Returns a pdvzip.Buffer, or the size written to out_fd." },
+	{ "extract", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(Extract)), METH_VARARGS | METH_KEYWORDS,
+		"extract(image, pack=None, *, out_fd=None)\n\nRebuild the ZIP file (or the named pack). Returns a pdvzip.Buffer, or the size written to out_fd." },
+	{ "verify", Verify, METH_O,
+		"verify(image)\n\nCheck the polyglot image's chunks & ZIP files. Returns {'chunks': n, 'zip_size': n, 'packs': {name: size}}." },
+	{ nullptr, nullptr, 0, nullptr }
+};
+
+static PyModuleDef pdvzip_module = [] {
+	PyModuleDef module{};
+	module.m_base = PyModuleDef_HEAD_INIT;
+	module.m_name = "pdvzip";
+	module.m_doc = "PNG Data Vehicle, ZIP Edition: embed, verify & extract in-process.";
+	module.m_size = -1;
+	module.m_methods = module_methods;
+	return module;
+}();
+
+PyMODINIT_FUNC PyInit_pdvzip() {
+	if (PyType_Ready(&buffer_type) < 0) {
+		return nullptr;
+	}
+
+	PyObject* module = PyModule_Create(&pdvzip_module);
+
+	if (!module) {
+		return nullptr;
+	}
+
+	pdv_error_type = PyErr_NewException("pdvzip.Error", nullptr, nullptr);
+
+	Py_INCREF(&buffer_type);
+
+	if (!pdv_error_type || PyModule_AddObject(module, "Error", pdv_error_type) || PyModule_AddObject(module, "Buffer", reinterpret_cast<PyObject*>(&buffer_type))) {
+		Py_DECREF(module);
+		return nullptr;
+	}
+	Py_INCREF(pdv_error_type);
+	return module;
+}
+
+static PyObject* Embed(PyObject*, PyObject* args, PyObject* kwargs) {
+	static const char* KEYWORDS[]{ "image", "zip", "out_fd", "linux_args", "windows_args", "reduce_cover", "carriers", "packs", nullptr };
+
+	PyObject
+		* image_arg,
+		* zip_arg,
+		* out_fd_arg = Py_None,
+		* packs_arg = Py_None;
+
+	const char
+		* linux_args = "",
+		* windows_args = "",
+		* carriers = nullptr;
+
+	int reduce_cover = 0;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|$OsspzO", const_cast<char**>(KEYWORDS), &image_arg, &zip_arg, &out_fd_arg,
+		&linux_args, &windows_args, &reduce_cover, &carriers, &packs_arg)) {
+		return nullptr;
+	}
+
+	PDV_STRUCT pdv;
+	PDV_OUTPUT output;
+
+	output.fd = out_fd_arg == Py_None ? -1 : PyObject_AsFileDescriptor(out_fd_arg);
+
+	if (out_fd_arg != Py_None && output.fd < 0) {
+		return nullptr;
+	}
+	if (carriers) {
+		pdv.carriers = Carriers_Profile(carriers);
+
+		if (pdv.carriers == PDV_CARRIERS::COUNT) {
+			PyErr_Format(PyExc_ValueError, "unknown carriers profile: %s", carriers);
+			return nullptr;
+		}
+	}
+
+	pdv.args_linux = linux_args;
+	pdv.args_windows = windows_args;
+	pdv.reduce_image = reduce_cover;
+	pdv.threads = 1;	// Callers run their own threads (the GIL is released).
+
+	// Packs are embedded in memory ("Add_Zip_Packs"), so each is copied into "Pack_Vec".
+	size_t packs_size = 0;
+
+	if (packs_arg != Py_None) {
+		PyObject* packs = PySequence_Fast(packs_arg, "packs must be a sequence of (name, zip) pairs");
+
+		for (Py_ssize_t pack = 0; packs && pack < PySequence_Fast_GET_SIZE(packs); pack++) {
+			const char* name = nullptr;
+
+			PyObject* zip = nullptr;
+
+			if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(packs, pack), "sO;packs must be a sequence of (name, zip) pairs", &name, &zip)) {
+				Py_CLEAR(packs);
+				break;
+			}
+
+			const std::string NAME = name;
+
+			if (NAME.length() < 5 || NAME.length() > MAX_PACK_NAME_LENGTH || NAME.compare(NAME.length() - 4, 4, ".zip")
+				|| NAME.find_first_of("/\\:") != std::string::npos || pdv.Pack_Name_Vec.size() == MAX_PACKS
+				|| std::count(pdv.Pack_Name_Vec.begin(), pdv.Pack_Name_Vec.end(), NAME)) {
+				PyErr_SetString(PyExc_ValueError, "pack names must be different file names ending with .zip (up to 255 packs, of up to 255 characters)");
+				Py_CLEAR(packs);
+				break;
+			}
+
+			PDV_INPUT input;
+
+			if (!Get_Input(zip, input, "pack")) {
+				Py_CLEAR(packs);
+				break;
+			}
+			pdv.Pack_Vec.emplace_back(input.data, input.data + input.size);
+			pdv.Pack_Name_Vec.push_back(NAME);
+			packs_size += input.size;
+
+			Release_Input(input);
+		}
+		if (!packs) {
+			return nullptr;
+		}
+		Py_DECREF(packs);
+	}
+
+	PDV_INPUT
+		image,
+		zip;
+
+	if (!Get_Input(image_arg, image, "image")) {
+		return nullptr;
+	}
+	if (!Get_Input(zip_arg, zip, "zip")) {
+		Release_Input(image);
+		return nullptr;
+	}
+
+	pdv.image_size = image.size;
+	pdv.zip_size = zip.size;
+	pdv.combined_file_size = image.size + zip.size + packs_size;
+
+	PDV_ERROR error = Check_File_Sizes(pdv);
+
+	Py_BEGIN_ALLOW_THREADS
+
+	if (error == PDV_ERROR::NONE) {
+		pdv.Image_Vec.assign(image.data, image.data + image.size);
+
+		if (pdv.carriers != PDV_CARRIERS::NONE || !pdv.Pack_Vec.empty()) {
+			std::copy_n(zip.data, zip.size, Zip_Buffer(pdv, zip.size));
+
+			error = Embed_Zip(pdv);
+
+			if (error == PDV_ERROR::NONE && output.fd >= 0) {
+				error = Write_Fd(output.fd, pdv.Image_Vec.data(), pdv.image_size) ? PDV_ERROR::NONE : PDV_ERROR::WRITE_OUT;
+				output.size = pdv.image_size;
+			}
+			else if (error == PDV_ERROR::NONE) {
+				pdv.Image_Vec.resize(pdv.image_size);
+				output.Out_Vec.swap(pdv.Image_Vec);
+			}
+		}
+		else {
+			if (output.fd < 0) {
+				output.Out_Vec.reserve(image.size + zip.size + 65536);
+			}
+			pdv.Read_Zip = Read_Zip_Input;
+			pdv.Write_Out = Write_Output;
+			pdv.zip_stream = &zip;
+			pdv.out_stream = &output;
+
+			error = Embed_Zip_Stream(pdv, zip.size);
+		}
+	}
+
+	Py_END_ALLOW_THREADS
+
+	Release_Input(image);
+	Release_Input(zip);
+
+	return error != PDV_ERROR::NONE ? Raise_Error(error) : Output_Result(output);
+}
+
+static PyObject* Extract(PyObject*, PyObject* args, PyObject* kwargs) {
+	static const char* KEYWORDS[]{ "image", "pack", "out_fd", nullptr };
+
+	PyObject
+		* image_arg,
+		* out_fd_arg = Py_None;
+
+	const char* pack = nullptr;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|z$O", const_cast<char**>(KEYWORDS), &image_arg, &pack, &out_fd_arg)) {
+		return nullptr;
+	}
+
+	PDV_OUTPUT output;
+
+	output.fd = out_fd_arg == Py_None ? -1 : PyObject_AsFileDescriptor(out_fd_arg);
+
+	if (out_fd_arg != Py_None && output.fd < 0) {
+		return nullptr;
+	}
+
+	const std::string PACK_NAME = pack ? pack : "";
+
+	PDV_INPUT image;
+
+	if (!Get_Input(image_arg, image, "image")) {
+		return nullptr;
+	}
+
+	PDV_ERROR error;
+
+	Py_BEGIN_ALLOW_THREADS
+
+	IMAGE_FILE image_file;
+
+	Open_Image_Data(image_file, image.data, image.size);
+
+	error = Read_Zip_Image(image_file, PACK_NAME, output.Out_Vec);
+
+	if (error == PDV_ERROR::NONE && output.fd >= 0) {
+		error = Write_Fd(output.fd, output.Out_Vec.data(), output.Out_Vec.size()) ? PDV_ERROR::NONE : PDV_ERROR::WRITE_OUT;
+		output.size = output.Out_Vec.size();
+	}
+
+	Py_END_ALLOW_THREADS
+
+	Release_Input(image);
+
+	return error != PDV_ERROR::NONE ? Raise_Error(error) : Output_Result(output);
+}
+
+static PyObject* Verify(PyObject*, PyObject* image_arg) {
+	PDV_INPUT image;
+
+	if (!Get_Input(image_arg, image, "image")) {
+		return nullptr;
+	}
+
+	PDV_ERROR error;
+
+	std::vector<IMAGE_CHUNK> Table_Vec;
+	std::vector<PACK_ENTRY> Pack_Vec;
+	std::vector<size_t> Pack_Size_Vec;
+
+	size_t zip_size = 0;
+
+	Py_BEGIN_ALLOW_THREADS
+
+	IMAGE_FILE image_file;
+
+	Open_Image_Data(image_file, image.data, image.size);
+
+	error = Read_Chunk_Table(image_file, Table_Vec);
+
+	// Each chunk's CRC covers its name & data fields (the 4 bytes before the data field, onwards). "Crc" only reads the bytes.
+	for (size_t chunk = 0; error == PDV_ERROR::NONE && chunk < Table_Vec.size(); chunk++) {
+		const IMAGE_CHUNK& CHUNK = Table_Vec[chunk];
+
+		Byte* name = const_cast<Byte*>(image.data) + CHUNK.index - 4;
+
+		if (Crc(name, CHUNK.length + 4) != Load<uint32_t, Endian::Big>(name + 4 + CHUNK.length)) {
+			error = PDV_ERROR::IMAGE_CORRUPT;
+		}
+	}
+
+	std::vector<Byte> Zip_Vec;
+
+	if (error == PDV_ERROR::NONE) {
+		error = Read_Zip_Image(image_file, "", Zip_Vec);
+		zip_size = Zip_Vec.size();
+	}
+
+	// The pack directory, if any, is within the "IDAT" chunk before the last one (the last one holds the ZIP file).
+	const IMAGE_CHUNK
+		* last_idat = nullptr,
+		* directory_idat = nullptr;
+
+	for (const IMAGE_CHUNK& CHUNK : Table_Vec) {
+		if (CHUNK.name == 0x49444154) {
+			directory_idat = last_idat;
+			last_idat = &CHUNK;
+		}
+	}
+	if (error == PDV_ERROR::NONE && directory_idat && Read_Pack_Directory(image_file, *directory_idat, Pack_Vec) != PDV_ERROR::NONE) {
+		Pack_Vec.clear();
+	}
+	for (size_t pack = 0; error == PDV_ERROR::NONE && pack < Pack_Vec.size(); pack++) {
+		error = Read_Zip_Image(image_file, Pack_Vec[pack].name, Zip_Vec);
+		Pack_Size_Vec.push_back(Zip_Vec.size());
+	}
+
+	Py_END_ALLOW_THREADS
+
+	Release_Input(image);
+
+	if (error != PDV_ERROR::NONE) {
+		return Raise_Error(error);
+	}
+
+	PyObject* packs = PyDict_New();
+
+	for (size_t pack = 0; packs && pack < Pack_Vec.size(); pack++) {
+		PyObject* size = PyLong_FromSize_t(Pack_Size_Vec[pack]);
+
+		if (!size || PyDict_SetItemString(packs, Pack_Vec[pack].name.c_str(), size)) {
+			Py_CLEAR(packs);
+		}
+		Py_XDECREF(size);
+	}
+	if (!packs) {
+		return nullptr;
+	}
+
+	PyObject* result = Py_BuildValue("{s:n,s:n,s:N}", "chunks", static_cast<Py_ssize_t>(Table_Vec.size()), "zip_size", static_cast<Py_ssize_t>(zip_size), "packs", packs);
+
+	return result;
+}
+
+static bool Get_Input(PyObject* arg, PDV_INPUT& input, const char* name) {
+	if (PyObject_CheckBuffer(arg)) {
+		if (PyObject_GetBuffer(arg, &input.view, PyBUF_SIMPLE)) {
+			return false;
+		}
+		input.held = true;
+		input.data = static_cast<const Byte*>(input.view.buf);
+		input.size = static_cast<size_t>(input.view.len);
+		return true;
+	}
+	if (!PyLong_Check(arg)) {
+		PyErr_Format(PyExc_TypeError, "%s must be a bytes-like object or a file descriptor", name);
+		return false;
+	}
+
+	const int FD = PyObject_AsFileDescriptor(arg);
+
+	if (FD < 0) {
+		return false;
+	}
+
+	struct stat fd_stat;
+
+	bool read_ok = !fstat(FD, &fd_stat);
+
+	Py_BEGIN_ALLOW_THREADS
+
+	if (read_ok && S_ISREG(fd_stat.st_mode) && fd_stat.st_size > 0) {
+		void* map = mmap(nullptr, static_cast<size_t>(fd_stat.st_size), PROT_READ, MAP_PRIVATE, FD, 0);
+
+		if (map != MAP_FAILED) {
+			input.map = map;
+			input.data = static_cast<const Byte*>(map);
+			input.size = static_cast<size_t>(fd_stat.st_size);
+		}
+	}
+	// Not a regular file (or it can't be mapped): read it to its end.
+	for (Byte block[65536]; read_ok && !input.map;) {
+		const ssize_t READ_SIZE = read(FD, block, sizeof(block));
+
+		if (READ_SIZE < 0 && errno == EINTR) {
+			continue;
+		}
+		if (READ_SIZE <= 0) {
+			read_ok = !READ_SIZE;
+			break;
+		}
+		input.Read_Vec.insert(input.Read_Vec.end(), block, block + READ_SIZE);
+	}
+
+	Py_END_ALLOW_THREADS
+
+	if (!read_ok) {
+		PyErr_SetFromErrno(PyExc_OSError);
+		return false;
+	}
+	if (!input.map) {
+		input.data = input.Read_Vec.data();
+		input.size = input.Read_Vec.size();
+	}
+	return true;
+}
+
+static void Release_Input(PDV_INPUT& input) {
+	if (input.held) {
+		PyBuffer_Release(&input.view);
+		input.held = false;
+	}
+	if (input.map) {
+		munmap(input.map, input.size);
+		input.map = nullptr;
+	}
+}
+
+static bool Write_Fd(int fd, const Byte* data, size_t length) {
+	while (length) {
+		const ssize_t WRITTEN = write(fd, data, length);
+
+		if (WRITTEN < 0 && errno == EINTR) {
+			continue;
+		}
+		if (WRITTEN <= 0) {
+			return false;
+		}
+		data += WRITTEN;
+		length -= static_cast<size_t>(WRITTEN);
+	}
+	return true;
+}
+
+static bool Read_Zip_Input(PDV_STRUCT& pdv, Byte* buffer, size_t offset, size_t length) {
+	const PDV_INPUT& ZIP = *static_cast<const PDV_INPUT*>(pdv.zip_stream);
+
+	if (offset > ZIP.size || length > ZIP.size - offset) {
+		return false;
+	}
+	std::copy_n(ZIP.data + offset, length, buffer);
+	return true;
+}
+
+static bool Write_Output(PDV_STRUCT& pdv, const Byte* data, size_t length) {
+	PDV_OUTPUT& output = *static_cast<PDV_OUTPUT*>(pdv.out_stream);
+
+	output.size += length;
+
+	if (output.fd >= 0) {
+		return Write_Fd(output.fd, data, length);
+	}
+	output.Out_Vec.insert(output.Out_Vec.end(), data, data + length);
+	return true;
+}
+
+static PyObject* Raise_Error(PDV_ERROR error) {
+	// The messages are written for the terminal: drop their surrounding blank lines.
+	std::string message = Error_Message(error);
+
+	message.erase(0, message.find_first_not_of('\n'));
+	message.erase(message.find_last_not_of('\n') + 1);
+
+	PyObject* error_args = Py_BuildValue("(ss)", Error_Name(error), message.c_str());
+
+	if (error_args) {
+		PyErr_SetObject(pdv_error_type, error_args);
+		Py_DECREF(error_args);
+	}
+	return nullptr;
+}
+
+static PyObject* Output_Result(PDV_OUTPUT& output) {
+	if (output.fd >= 0) {
+		return PyLong_FromSize_t(output.size);
+	}
+
+	PDV_BUFFER* buffer = PyObject_New(PDV_BUFFER, &buffer_type);
+
+	if (buffer) {
+		buffer->Data_Vec = new std::vector<Byte>(std::move(output.Out_Vec));
+	}
+	return reinterpret_cast<PyObject*>(buffer);
+}
@@ -0,0 +1,565 @@
+// 	PDVZIP catalog. See "pdv_catalog.hpp".
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <zlib.h>
+
+#include "pdv_catalog.hpp"
+#include "pdv_extract.hpp"
+#include "pdv_index.hpp"
+
+// Catalog file layout (little-endian): the header, then the image, name & name number tables (fixed-size records), then the Bloom filter words,
+// then the strings (image paths & names, not terminated).
+constexpr uint32_t CATALOG_SIG = 0x43564450;	// "PDVC"
+
+constexpr uint16_t CATALOG_VERSION = 1;
+
+constexpr size_t
+	CATALOG_HEADER_SIZE = 48,
+	IMAGE_RECORD_SIZE = 48,		// See "CATALOG_IMAGE_VIEW".
+	NAME_RECORD_SIZE = 16,		// Name hash (8 bytes), string offset (4 bytes), length (2 bytes), unused (2 bytes). Sorted by hash, then name.
+	ID_RECORD_SIZE = 4,		// Name number (its record within the name table). Sorted, within each image.
+	WORD_SIZE = 8,			// Bloom filter word (64 bits).
+	BLOOM_BITS_PER_NAME = 10,	// With "BLOOM_PROBES", about a 1% false positive rate.
+	BLOOM_PROBES = 7;
+
+// Catalog file header.
+struct CATALOG_HEADER_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Version() const { return Get<uint16_t>(4); }
+	constexpr uint16_t Header_Size() const { return Get<uint16_t>(6); }
+	constexpr uint32_t Checksum() const { return Get<uint32_t>(8); }
+	constexpr uint32_t Images() const { return Get<uint32_t>(12); }
+	constexpr uint32_t Names() const { return Get<uint32_t>(16); }
+	constexpr uint64_t Ids() const { return Get<uint64_t>(24); }
+	constexpr uint64_t Words() const { return Get<uint64_t>(32); }
+	constexpr uint64_t Strings_Size() const { return Get<uint64_t>(40); }
+
+	// Offsets of the tables, worked out from the counts.
+	constexpr uint64_t Name_Table() const { return CATALOG_HEADER_SIZE + uint64_t{ Images() } * IMAGE_RECORD_SIZE; }
+	constexpr uint64_t Id_Table() const { return Name_Table() + uint64_t{ Names() } * NAME_RECORD_SIZE; }
+	constexpr uint64_t Word_Table() const { return Id_Table() + Ids() * ID_RECORD_SIZE; }
+	constexpr uint64_t Strings() const { return Word_Table() + Words() * WORD_SIZE; }
+	constexpr uint64_t Total_Size() const { return Strings() + Strings_Size(); }
+};
+
+// Image record.
+struct CATALOG_IMAGE_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	constexpr uint32_t Path_Offset() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Path_Length() const { return Get<uint16_t>(4); }
+	constexpr uint64_t Image_Size() const { return Get<uint64_t>(8); }
+	constexpr uint64_t Image_Mtime() const { return Get<uint64_t>(16); }
+	constexpr uint64_t First_Id() const { return Get<uint64_t>(24); }
+	constexpr uint32_t Ids() const { return Get<uint32_t>(32); }
+	constexpr uint32_t Words() const { return Get<uint32_t>(36); }
+	constexpr uint64_t First_Word() const { return Get<uint64_t>(40); }
+};
+
+// An image found within the directory, and its names (sorted, no duplicates).
+struct CATALOG_IMAGE {
+	std::string path;
+	uint64_t size{}, mtime{};
+	std::vector<std::string> Name_Vec;
+	bool
+		readable{},	// The image could be opened (unreadable images are left out of the catalog).
+		reused{};	// The names were taken from the old catalog.
+};
+
+// Check the catalog's header, and that its size matches the header's counts. With "checksum" set, also check its checksum (CRC32 after the checksum field).
+static bool Check_Catalog(const MAPPED_FILE&, bool);
+
+// Path of the numbered image record, or false if the record is out of bounds.
+static bool Image_Path(const MAPPED_FILE&, size_t, std::string&);
+
+// Name record "name" of the catalog, or false if its string is out of bounds.
+static bool Catalog_Name(const MAPPED_FILE&, size_t, std::string&);
+
+// Take the image's names from the old catalog, if it lists the same path with the same size & modification time (a binary search of its image records).
+static bool Reuse_Names(const MAPPED_FILE&, CATALOG_IMAGE&);
+
+// Find the image's size & modification time, then its names: from the old catalog if unchanged, otherwise from its index (see "pdv_index.hpp").
+static void Read_Image_Names(const MAPPED_FILE&, CATALOG_IMAGE&);
+
+// Bit number of the probe, for a name hash, within a Bloom filter of "bits" bits (double hashing: the hash, plus "probe" steps of its rotation).
+static uint64_t Bloom_Bit(uint64_t, size_t, uint64_t);
+
+// Write the catalog to the named file (via a temporary file, renamed over it).
+static bool Save_Catalog(const std::string&, const std::vector<Byte>&);
+
+PDV_ERROR Build_Catalog(const std::string& catalog_name, const std::string& dir_name, size_t workers, CATALOG_SUMMARY& summary) {
+
+	std::vector<CATALOG_IMAGE> Image_Vec;
+
+	std::error_code error;
+
+	std::filesystem::recursive_directory_iterator dir_entry(dir_name, std::filesystem::directory_options::skip_permission_denied, error);
+
+	for (; !error && dir_entry != std::filesystem::recursive_directory_iterator(); dir_entry.increment(error)) {
+		std::error_code type_error;
+
+		if (dir_entry->is_regular_file(type_error) && dir_entry->path().extension() == ".png") {
+			Image_Vec.push_back({});
+			Image_Vec.back().path = dir_entry->path().string();
+		}
+	}
+	if (error) {
+		return PDV_ERROR::DIR_OPEN;
+	}
+
+	std::sort(Image_Vec.begin(), Image_Vec.end(), [](const CATALOG_IMAGE& a, const CATALOG_IMAGE& b) { return a.path < b.path; });
+
+	MAPPED_FILE old_catalog;
+
+	if (Map_File(old_catalog, catalog_name) && !Check_Catalog(old_catalog, true)) {
+		Unmap_File(old_catalog);
+	}
+
+	// Images are handed out one at a time, as reading them takes anything from a lookup to a full central directory parse.
+	std::atomic<size_t> next_image{ 0 };
+
+	std::vector<std::thread> Thread_Vec;
+
+	for (size_t t = 0; t < std::min(std::max<size_t>(workers, 1), Image_Vec.size()); t++) {
+		Thread_Vec.emplace_back([&] {
+			for (size_t image = next_image++; image < Image_Vec.size(); image = next_image++) {
+				Read_Image_Names(old_catalog, Image_Vec[image]);
+			}
+		});
+	}
+	for (std::thread& thread : Thread_Vec) {
+		thread.join();
+	}
+	Unmap_File(old_catalog);
+
+	Image_Vec.erase(std::remove_if(Image_Vec.begin(), Image_Vec.end(),
+		[](const CATALOG_IMAGE& image) { return !image.readable || image.path.length() > UINT16_MAX; }), Image_Vec.end());
+
+	// Every name once, sorted by hash, then name. A name's number is its place within this table.
+	std::vector<std::pair<uint64_t, const std::string*>> Name_Vec;
+
+	for (const CATALOG_IMAGE& IMAGE : Image_Vec) {
+		for (const std::string& NAME : IMAGE.Name_Vec) {
+			Name_Vec.push_back({ Name_Hash(NAME.data(), NAME.length()), &NAME });
+		}
+	}
+
+	auto Name_Less = [](const std::pair<uint64_t, const std::string*>& a, const std::pair<uint64_t, const std::string*>& b) {
+		return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+	};
+
+	std::sort(Name_Vec.begin(), Name_Vec.end(), Name_Less);
+
+	Name_Vec.erase(std::unique(Name_Vec.begin(), Name_Vec.end(),
+		[](const std::pair<uint64_t, const std::string*>& a, const std::pair<uint64_t, const std::string*>& b) { return *a.second == *b.second; }), Name_Vec.end());
+
+	uint64_t
+		ids = 0,
+		words = 0,
+		strings_size = 0;
+
+	for (const CATALOG_IMAGE& IMAGE : Image_Vec) {
+		ids += IMAGE.Name_Vec.size();
+		words += (IMAGE.Name_Vec.size() * BLOOM_BITS_PER_NAME + 63) / 64;
+		strings_size += IMAGE.path.length();
+	}
+	for (const auto& NAME : Name_Vec) {
+		strings_size += NAME.second->length();
+	}
+	if (Image_Vec.size() > UINT32_MAX || Name_Vec.size() > UINT32_MAX || strings_size > UINT32_MAX) {
+		return PDV_ERROR::WRITE_OUT;
+	}
+
+	std::vector<Byte> Catalog_Vec(CATALOG_HEADER_SIZE);
+
+	Byte* header = Catalog_Vec.data();
+
+	Store<uint32_t, Endian::Little>(header, CATALOG_SIG);
+	Store<uint16_t, Endian::Little>(header + 4, CATALOG_VERSION);
+	Store<uint16_t, Endian::Little>(header + 6, static_cast<uint16_t>(CATALOG_HEADER_SIZE));
+	Store<uint32_t, Endian::Little>(header + 12, static_cast<uint32_t>(Image_Vec.size()));
+	Store<uint32_t, Endian::Little>(header + 16, static_cast<uint32_t>(Name_Vec.size()));
+	Store<uint64_t, Endian::Little>(header + 24, ids);
+	Store<uint64_t, Endian::Little>(header + 32, words);
+	Store<uint64_t, Endian::Little>(header + 40, strings_size);
+
+	Catalog_Vec.resize(static_cast<size_t>(CATALOG_HEADER_VIEW(Catalog_Vec.data(), Catalog_Vec.size()).Total_Size()));
+
+	const CATALOG_HEADER_VIEW HEADER(Catalog_Vec.data(), Catalog_Vec.size());
+
+	Byte* strings = Catalog_Vec.data() + HEADER.Strings();
+
+	uint32_t string_offset = 0;
+
+	auto Add_String = [strings, &string_offset](const std::string& text) {
+		std::copy(text.begin(), text.end(), strings + string_offset);
+		string_offset += static_cast<uint32_t>(text.length());
+		return string_offset - static_cast<uint32_t>(text.length());
+	};
+
+	for (size_t name = 0; name < Name_Vec.size(); name++) {
+		Byte* record = Catalog_Vec.data() + HEADER.Name_Table() + name * NAME_RECORD_SIZE;
+
+		Store<uint64_t, Endian::Little>(record, Name_Vec[name].first);
+		Store<uint32_t, Endian::Little>(record + 8, Add_String(*Name_Vec[name].second));
+		Store<uint16_t, Endian::Little>(record + 12, static_cast<uint16_t>(Name_Vec[name].second->length()));
+	}
+
+	uint64_t
+		first_id = 0,
+		first_word = 0;
+
+	std::vector<uint32_t> Id_Vec;
+
+	for (size_t image = 0; image < Image_Vec.size(); image++) {
+		const CATALOG_IMAGE& IMAGE = Image_Vec[image];
+
+		const uint64_t
+			IMAGE_WORDS = (IMAGE.Name_Vec.size() * BLOOM_BITS_PER_NAME + 63) / 64,
+			BITS = IMAGE_WORDS * 64;
+
+		Byte* record = Catalog_Vec.data() + CATALOG_HEADER_SIZE + image * IMAGE_RECORD_SIZE;
+
+		Store<uint32_t, Endian::Little>(record, Add_String(IMAGE.path));
+		Store<uint16_t, Endian::Little>(record + 4, static_cast<uint16_t>(IMAGE.path.length()));
+		Store<uint64_t, Endian::Little>(record + 8, IMAGE.size);
+		Store<uint64_t, Endian::Little>(record + 16, IMAGE.mtime);
+		Store<uint64_t, Endian::Little>(record + 24, first_id);
+		Store<uint32_t, Endian::Little>(record + 32, static_cast<uint32_t>(IMAGE.Name_Vec.size()));
+		Store<uint32_t, Endian::Little>(record + 36, static_cast<uint32_t>(IMAGE_WORDS));
+		Store<uint64_t, Endian::Little>(record + 40, first_word);
+
+		Id_Vec.clear();
+
+		Byte* bloom = Catalog_Vec.data() + HEADER.Word_Table() + first_word * WORD_SIZE;
+
+		for (const std::string& NAME : IMAGE.Name_Vec) {
+			const std::pair<uint64_t, const std::string*> KEY{ Name_Hash(NAME.data(), NAME.length()), &NAME };
+
+			Id_Vec.push_back(static_cast<uint32_t>(std::lower_bound(Name_Vec.begin(), Name_Vec.end(), KEY, Name_Less) - Name_Vec.begin()));
+
+			for (size_t probe = 0; probe < BLOOM_PROBES; probe++) {
+				const uint64_t BIT = Bloom_Bit(KEY.first, probe, BITS);
+
+				Byte* word = bloom + BIT / 64 * WORD_SIZE;
+
+				Store<uint64_t, Endian::Little>(word, Load<uint64_t, Endian::Little>(word) | uint64_t{ 1 } << (BIT % 64));
+			}
+		}
+
+		std::sort(Id_Vec.begin(), Id_Vec.end());
+
+		for (size_t id = 0; id < Id_Vec.size(); id++) {
+			Store<uint32_t, Endian::Little>(Catalog_Vec.data() + HEADER.Id_Table() + (first_id + id) * ID_RECORD_SIZE, Id_Vec[id]);
+		}
+
+		first_id += IMAGE.Name_Vec.size();
+		first_word += IMAGE_WORDS;
+
+		summary.read += !IMAGE.reused;
+		summary.reused += IMAGE.reused;
+	}
+
+	uLong crc = crc32(0, nullptr, 0);
+
+	for (size_t index = 12; index < Catalog_Vec.size(); index += UINT32_MAX / 2) {
+		crc = crc32(crc, Catalog_Vec.data() + index, static_cast<uInt>(std::min<size_t>(Catalog_Vec.size() - index, UINT32_MAX / 2)));
+	}
+	Store<uint32_t, Endian::Little>(Catalog_Vec.data() + 8, static_cast<uint32_t>(crc));
+
+	if (!Save_Catalog(catalog_name, Catalog_Vec)) {
+		return PDV_ERROR::WRITE_OUT;
+	}
+
+	summary.images = Image_Vec.size();
+	summary.names = Name_Vec.size();
+	summary.size = Catalog_Vec.size();
+
+	return PDV_ERROR::NONE;
+}
+
+PDV_ERROR Find_In_Catalog(const std::string& catalog_name, const std::string& name, std::vector<std::string>& Path_Vec) {
+
+	MAPPED_FILE catalog;
+
+	if (!Map_File(catalog, catalog_name)) {
+		return PDV_ERROR::CATALOG_OPEN;
+	}
+	if (!Check_Catalog(catalog, false)) {
+		Unmap_File(catalog);
+		return PDV_ERROR::CATALOG_OPEN;
+	}
+
+	const CATALOG_HEADER_VIEW HEADER(catalog.data, catalog.size);
+
+	const uint64_t NAME_HASH = Name_Hash(name.data(), name.length());
+
+	auto Record_Hash = [&](size_t record) {
+		return Load<uint64_t, Endian::Little>(catalog.data + HEADER.Name_Table() + record * NAME_RECORD_SIZE);
+	};
+
+	// Binary search for the first name record of the hash, then check the names of that hash (almost always just one).
+	size_t
+		low = 0,
+		high = HEADER.Names();
+
+	while (low < high) {
+		const size_t MID = low + (high - low) / 2;
+
+		if (Record_Hash(MID) < NAME_HASH) {
+			low = MID + 1;
+		}
+		else {
+			high = MID;
+		}
+	}
+
+	size_t id = HEADER.Names();
+
+	std::string record_name;
+
+	for (; low < HEADER.Names() && Record_Hash(low) == NAME_HASH; low++) {
+		if (!Catalog_Name(catalog, low, record_name)) {
+			Unmap_File(catalog);
+			return PDV_ERROR::CATALOG_OPEN;
+		}
+		if (record_name == name) {
+			id = low;
+			break;
+		}
+	}
+
+	bool valid = true;
+
+	for (size_t image = 0; valid && id < HEADER.Names() && image < HEADER.Images(); image++) {
+		const CATALOG_IMAGE_VIEW IMAGE(catalog.data + CATALOG_HEADER_SIZE + image * IMAGE_RECORD_SIZE, IMAGE_RECORD_SIZE);
+
+		valid = IMAGE.First_Id() <= HEADER.Ids() && IMAGE.Ids() <= HEADER.Ids() - IMAGE.First_Id()
+			&& IMAGE.First_Word() <= HEADER.Words() && IMAGE.Words() <= HEADER.Words() - IMAGE.First_Word();
+
+		if (!valid || !IMAGE.Words()) {
+			continue;
+		}
+
+		const Byte* BLOOM = catalog.data + HEADER.Word_Table() + IMAGE.First_Word() * WORD_SIZE;
+
+		bool maybe = true;
+
+		for (size_t probe = 0; maybe && probe < BLOOM_PROBES; probe++) {
+			const uint64_t BIT = Bloom_Bit(NAME_HASH, probe, uint64_t{ IMAGE.Words() } * 64);
+
+			maybe = Load<uint64_t, Endian::Little>(BLOOM + BIT / 64 * WORD_SIZE) >> (BIT % 64) & 1;
+		}
+		if (!maybe) {
+			continue;
+		}
+
+		const Byte* IDS = catalog.data + HEADER.Id_Table() + IMAGE.First_Id() * ID_RECORD_SIZE;
+
+		size_t
+			first = 0,
+			last = IMAGE.Ids();
+
+		while (first < last) {
+			const size_t MID = first + (last - first) / 2;
+
+			if (Load<uint32_t, Endian::Little>(IDS + MID * ID_RECORD_SIZE) < id) {
+				first = MID + 1;
+			}
+			else {
+				last = MID;
+			}
+		}
+		if (first < IMAGE.Ids() && Load<uint32_t, Endian::Little>(IDS + first * ID_RECORD_SIZE) == id) {
+			Path_Vec.emplace_back();
+			valid = Image_Path(catalog, image, Path_Vec.back());
+		}
+	}
+	Unmap_File(catalog);
+
+	return valid ? PDV_ERROR::NONE : PDV_ERROR::CATALOG_OPEN;
+}
+
+static bool Check_Catalog(const MAPPED_FILE& catalog, bool checksum) {
+	if (catalog.size < CATALOG_HEADER_SIZE) {
+		return false;
+	}
+
+	const CATALOG_HEADER_VIEW HEADER(catalog.data, catalog.size);
+
+	// Each count is checked against the file size first, so working out the table offsets can't overflow.
+	if (HEADER.Signature() != CATALOG_SIG || HEADER.Version() != CATALOG_VERSION || HEADER.Header_Size() != CATALOG_HEADER_SIZE
+		|| HEADER.Ids() > catalog.size / ID_RECORD_SIZE || HEADER.Words() > catalog.size / WORD_SIZE || HEADER.Strings_Size() > catalog.size
+		|| HEADER.Total_Size() != catalog.size) {
+		return false;
+	}
+	if (!checksum) {
+		return true;
+	}
+
+	uLong crc = crc32(0, nullptr, 0);
+
+	for (size_t index = 12; index < catalog.size; index += UINT32_MAX / 2) {
+		crc = crc32(crc, catalog.data + index, static_cast<uInt>(std::min<size_t>(catalog.size - index, UINT32_MAX / 2)));
+	}
+	return HEADER.Checksum() == static_cast<uint32_t>(crc);
+}
+
+static bool Image_Path(const MAPPED_FILE& catalog, size_t image, std::string& path) {
+	const CATALOG_HEADER_VIEW HEADER(catalog.data, catalog.size);
+
+	const CATALOG_IMAGE_VIEW IMAGE(catalog.data + CATALOG_HEADER_SIZE + image * IMAGE_RECORD_SIZE, IMAGE_RECORD_SIZE);
+
+	if (uint64_t{ IMAGE.Path_Offset() } + IMAGE.Path_Length() > HEADER.Strings_Size()) {
+		return false;
+	}
+
+	const char* TEXT = reinterpret_cast<const char*>(catalog.data + HEADER.Strings() + IMAGE.Path_Offset());
+
+	path.assign(TEXT, IMAGE.Path_Length());
+	return true;
+}
+
+static bool Catalog_Name(const MAPPED_FILE& catalog, size_t name, std::string& text) {
+	const CATALOG_HEADER_VIEW HEADER(catalog.data, catalog.size);
+
+	const RECORD_VIEW<Endian::Little> RECORD(catalog.data + HEADER.Name_Table() + name * NAME_RECORD_SIZE, NAME_RECORD_SIZE);
+
+	if (uint64_t{ RECORD.Get<uint32_t>(8) } + RECORD.Get<uint16_t>(12) > HEADER.Strings_Size()) {
+		return false;
+	}
+	text.assign(reinterpret_cast<const char*>(catalog.data + HEADER.Strings() + RECORD.Get<uint32_t>(8)), RECORD.Get<uint16_t>(12));
+	return true;
+}
+
+static bool Reuse_Names(const MAPPED_FILE& catalog, CATALOG_IMAGE& image) {
+	if (!catalog.data) {
+		return false;
+	}
+
+	const CATALOG_HEADER_VIEW HEADER(catalog.data, catalog.size);
+
+	std::string path;
+
+	// Image records are sorted by path.
+	size_t
+		low = 0,
+		high = HEADER.Images();
+
+	while (low < high) {
+		const size_t MID = low + (high - low) / 2;
+
+		if (!Image_Path(catalog, MID, path)) {
+			return false;
+		}
+		if (path < image.path) {
+			low = MID + 1;
+		}
+		else {
+			high = MID;
+		}
+	}
+	if (low == HEADER.Images() || !Image_Path(catalog, low, path) || path != image.path) {
+		return false;
+	}
+
+	const CATALOG_IMAGE_VIEW IMAGE(catalog.data + CATALOG_HEADER_SIZE + low * IMAGE_RECORD_SIZE, IMAGE_RECORD_SIZE);
+
+	if (IMAGE.Image_Size() != image.size || IMAGE.Image_Mtime() != image.mtime
+		|| IMAGE.First_Id() > HEADER.Ids() || IMAGE.Ids() > HEADER.Ids() - IMAGE.First_Id()) {
+		return false;
+	}
+
+	std::vector<std::string> Name_Vec(IMAGE.Ids());
+
+	for (size_t id = 0; id < IMAGE.Ids(); id++) {
+		const uint32_t NAME = Load<uint32_t, Endian::Little>(catalog.data + HEADER.Id_Table() + (IMAGE.First_Id() + id) * ID_RECORD_SIZE);
+
+		if (NAME >= HEADER.Names() || !Catalog_Name(catalog, NAME, Name_Vec[id])) {
+			return false;
+		}
+	}
+	std::sort(Name_Vec.begin(), Name_Vec.end());
+
+	image.Name_Vec = std::move(Name_Vec);
+	return true;
+}
+
+static void Read_Image_Names(const MAPPED_FILE& old_catalog, CATALOG_IMAGE& image) {
+	IMAGE_FILE image_file;
+
+	image.readable = Open_Image(image_file, image.path);
+
+	if (!image.readable) {
+		return;
+	}
+	image.size = image_file.size;
+	image.mtime = image_file.mtime;
+
+	Close_Image(image_file);
+
+	image.reused = Reuse_Names(old_catalog, image);
+
+	if (image.reused) {
+		return;
+	}
+
+	PDV_INDEX index;
+
+	// Not a pdvzip image (or a damaged one): listed with no names.
+	if (Open_Index(index, image.path, false, false) != PDV_ERROR::NONE) {
+		return;
+	}
+	for (size_t entry = 0; entry < Index_Entries(index); entry++) {
+		const std::string NAME = Index_Entry(index, entry).name;
+
+		// The last part of the name: after its last "/", and after the "<pack_name>:" of a pack entry.
+		const size_t LAST_PART = NAME.find_last_of("/:");
+
+		image.Name_Vec.push_back(NAME);
+
+		if (LAST_PART != std::string::npos && LAST_PART + 1 < NAME.length()) {
+			image.Name_Vec.push_back(NAME.substr(LAST_PART + 1));
+		}
+	}
+	Close_Index(index);
+
+	image.Name_Vec.erase(std::remove_if(image.Name_Vec.begin(), image.Name_Vec.end(),
+		[](const std::string& name) { return name.length() > UINT16_MAX; }), image.Name_Vec.end());
+
+	std::sort(image.Name_Vec.begin(), image.Name_Vec.end());
+	image.Name_Vec.erase(std::unique(image.Name_Vec.begin(), image.Name_Vec.end()), image.Name_Vec.end());
+}
+
+static uint64_t Bloom_Bit(uint64_t hash, size_t probe, uint64_t bits) {
+	const uint64_t STEP = (hash >> 32 | hash << 32) | 1;
+
+	return (hash + probe * STEP) % bits;
+}
+
+static bool Save_Catalog(const std::string& catalog_name, const std::vector<Byte>& Catalog_Vec) {
+	const std::string TEMP_NAME = catalog_name + ".tmp";
+
+	std::FILE* catalog_ofs = std::fopen(TEMP_NAME.c_str(), "wb");
+
+	if (!catalog_ofs) {
+		return false;
+	}
+
+	const bool
+		WRITE_OK = std::fwrite(Catalog_Vec.data(), 1, Catalog_Vec.size(), catalog_ofs) == Catalog_Vec.size(),
+		CLOSE_OK = !std::fclose(catalog_ofs);
+
+	if (!WRITE_OK || !CLOSE_OK || std::rename(TEMP_NAME.c_str(), catalog_name.c_str())) {
+		std::remove(TEMP_NAME.c_str());
+		return false;
+	}
+	return true;
+}
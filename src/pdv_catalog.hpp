@@ -0,0 +1,47 @@
+// 	PDVZIP catalog ("--catalog build <dir>" & "--catalog find <name>"). Which pdvzip images, within a directory tree, hold an entry of a given name?
+
+//	"build" reads the ZIP file entries of every ".png" image within the directory (and its subdirectories) on worker threads, each image through its
+//	sidecar index when it has a valid one (see "pdv_index.hpp", a missing or stale sidecar is rebuilt in memory only, never written), and writes them
+//	to one compact catalog file. Each image is listed under its entry names (with "<pack_name>:" before a pack entry's name, as "--list" shows them)
+//	and under each name's last path part (e.g. "docs/readme.txt" is also found as "readme.txt").
+//	Rebuilding an existing catalog is incremental: an image with the same path, size & modification time as before keeps its names from the old catalog,
+//	so only new & changed images are read. Images that aren't pdvzip images are listed with no names (so they aren't read again either).
+
+//	"find" answers from the catalog alone, without opening any image. The catalog holds every name once, sorted (binary search), then, for each image,
+//	the sorted numbers of its names and a Bloom filter of them: most images are ruled out by the filter (a few bit tests), and the rest are confirmed
+//	with a binary search of their name numbers, so false positives never reach the results.
+
+//	The file is little-endian, with fixed-size records at offsets worked out from the counts in its header, used straight from a read-only memory map
+//	(see "Map_File"), so a search reads only the records it needs. "build" checks the whole file (version & checksum) before reusing any of it,
+//	while "find" checks only the header and the bounds of the records it reads, as checksumming a large catalog would take longer than the search.
+//	The catalog is written to a temporary file, then renamed over the old one, so a search never reads a partly written catalog.
+
+//	Requires zlib (link with -lz).
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "pdv_core.hpp"
+
+// Catalog file used when "--catalog-file" isn't given (within the current directory).
+constexpr const char* CATALOG_FILE_NAME = "pdvzip.pdvcat";
+
+// Counts for a built catalog, for display.
+struct CATALOG_SUMMARY {
+	size_t
+		images,		// Images listed within the catalog.
+		read,		// Images read (new or changed since the last build).
+		reused,		// Images with their names taken from the old catalog.
+		names,		// Different names within the catalog.
+		size;		// Catalog file size, in bytes.
+};
+
+// Build (or incrementally rebuild) the catalog file, for the images within the directory, using the given number of worker threads.
+// Fails with "DIR_OPEN" if the directory can't be listed, or "WRITE_OUT" if the catalog file can't be written (or is too large for its 32-bit fields).
+PDV_ERROR Build_Catalog(const std::string&, const std::string&, size_t, CATALOG_SUMMARY&);
+
+// Search the catalog file for the name (a full entry name, or the last part of one), listing the paths of the images holding it, in path order.
+// Fails with "CATALOG_OPEN" if the catalog file can't be opened or is invalid.
+PDV_ERROR Find_In_Catalog(const std::string&, const std::string&, std::vector<std::string>&);
@@ -0,0 +1,162 @@
+// 	PDVZIP container limits. See "pdv_cgroup.hpp".
+
+#include <algorithm>
+#include <thread>
+
+#include "pdv_cgroup.hpp"
+
+#ifdef __linux__
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <sched.h>
+
+// Read the first line of a file (without its newline). Returns false if it can't be read.
+static bool Read_Line(const std::string&, std::string&);
+
+// Find the cgroup2 mount point & the process's cgroup directory within it. Returns false without a cgroup2 mount (cgroup v1 only, or none).
+static bool Cgroup_Dir(std::string&, std::string&);
+
+CGROUP_LIMITS Cgroup_Limits() {
+	CGROUP_LIMITS limits{ std::max(1u, std::thread::hardware_concurrency()), 0 };
+
+	cpu_set_t allowed;
+
+	if (!sched_getaffinity(0, sizeof(allowed), &allowed)) {
+		limits.cpus = std::min(limits.cpus, static_cast<size_t>(std::max(1, CPU_COUNT(&allowed))));
+	}
+
+	std::string
+		mount,
+		dir;
+
+	if (!Cgroup_Dir(mount, dir)) {
+		return limits;
+	}
+
+	// Limits are inherited: a child cgroup can't use more than any of its ancestors allow, whatever its own files say.
+	while (true) {
+		std::string line;
+
+		// "cpu.max": "<quota> <period>" in microseconds, or "max <period>" for no limit.
+		unsigned long long
+			quota = 0,
+			period = 0;
+
+		if (Read_Line(dir + "/cpu.max", line) && std::sscanf(line.c_str(), "%llu %llu", &quota, &period) == 2 && quota && period) {
+			limits.cpus = std::min(limits.cpus, static_cast<size_t>(std::max(1ULL, (quota + period - 1) / period)));
+		}
+
+		// "memory.max": bytes, or "max" for no limit.
+		if (Read_Line(dir + "/memory.max", line) && line != "max") {
+			char* end = nullptr;
+
+			const unsigned long long MEMORY = std::strtoull(line.c_str(), &end, 10);
+
+			if (!*end && MEMORY) {
+				limits.memory = limits.memory ? std::min(limits.memory, static_cast<size_t>(MEMORY)) : static_cast<size_t>(MEMORY);
+			}
+		}
+
+		if (dir.length() <= mount.length()) {
+			break;
+		}
+		dir.erase(dir.find_last_of('/'));
+	}
+	return limits;
+}
+
+static bool Cgroup_Dir(std::string& mount, std::string& dir) {
+	std::FILE* mount_ifs = std::fopen("/proc/self/mountinfo", "rb");
+
+	if (!mount_ifs) {
+		return false;
+	}
+
+	// "<id> <parent> <major:minor> <root> <mount point> <options> [<optional fields>...] - <fs type> <source> <super options>"
+	std::string root;
+
+	char line[4096];
+
+	while (std::fgets(line, sizeof(line), mount_ifs)) {
+		char
+			mount_root[1024],
+			mount_point[1024];
+
+		const char* FS_TYPE = std::strstr(line, " - ");
+
+		if (FS_TYPE && !std::strncmp(FS_TYPE + 3, "cgroup2 ", 8) && std::sscanf(line, "%*s %*s %*s %1023s %1023s", mount_root, mount_point) == 2) {
+			root = mount_root;
+			mount = mount_point;
+			break;
+		}
+	}
+	std::fclose(mount_ifs);
+
+	std::FILE* cgroup_ifs = mount.empty() ? nullptr : std::fopen("/proc/self/cgroup", "rb");
+
+	if (!cgroup_ifs) {
+		return false;
+	}
+
+	// The cgroup v2 line is "0::<path>", the path from the root of the hierarchy (or of the cgroup namespace).
+	std::string path;
+
+	while (std::fgets(line, sizeof(line), cgroup_ifs)) {
+		if (!std::strncmp(line, "0::", 3)) {
+			path = line + 3;
+			path.erase(path.find_last_not_of("\r\n") + 1);
+			break;
+		}
+	}
+	std::fclose(cgroup_ifs);
+
+	if (path.empty() || path[0] != '/') {
+		return false;
+	}
+
+	// The mount may be of part of the hierarchy only (its root). A path outside of it can't be read, so only the mount's own limits are.
+	if (root != "/") {
+		path = !path.compare(0, root.length(), root) && (path.length() == root.length() || path[root.length()] == '/') ? path.substr(root.length()) : "";
+	}
+	if (mount == "/") {
+		mount.clear();
+	}
+	while (!path.empty() && path.back() == '/') {
+		path.pop_back();
+	}
+
+	dir = mount + path;
+	return true;
+}
+
+static bool Read_Line(const std::string& name, std::string& line) {
+	std::FILE* file_ifs = std::fopen(name.c_str(), "rb");
+
+	if (!file_ifs) {
+		return false;
+	}
+
+	char buffer[256];
+
+	const bool READ_OK = std::fgets(buffer, sizeof(buffer), file_ifs) != nullptr;
+
+	std::fclose(file_ifs);
+
+	if (READ_OK) {
+		line = buffer;
+		line.erase(line.find_last_not_of("\r\n") + 1);
+	}
+	return READ_OK;
+}
+
+#else
+
+CGROUP_LIMITS Cgroup_Limits() {
+	return { std::max(1u, std::thread::hardware_concurrency()), 0 };
+}
+
+#endif
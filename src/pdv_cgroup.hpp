@@ -0,0 +1,22 @@
+// 	PDVZIP container limits (cgroup v2), for sizing worker threads & memory budgets by default. Linux only, elsewhere only the CPU count is found.
+
+//	A container sees the host's CPUs & memory, not its own limits, so sizing from the CPU count alone oversubscribes a CPU quota (the workers are throttled)
+//	and unlimited memory use runs into the memory limit (the process is OOM-killed). The limits are read once, at start, from the process's
+//	cgroup: "cpu.max" (CPU time quota per period) and "memory.max", at each level from the process's cgroup up to the root of the cgroup2 mount
+//	(as found within "/proc/self/mountinfo"), keeping the least. Inside a cgroup namespace, that root is the container's own cgroup.
+
+#pragma once
+
+#include <cstddef>
+
+struct CGROUP_LIMITS {
+	size_t
+		cpus,	// CPUs the process can use: the CPU count, the affinity mask & the "cpu.max" quota (rounded up), whichever is least. At least 1.
+		memory;	// Least "memory.max" (bytes) up the cgroup path, 0 = no limit.
+};
+
+// Share of the memory limit used as the default memory budget ("--max-memory"), in quarters. The rest is left for the program, stdio buffers & page cache.
+constexpr size_t CGROUP_MEMORY_QUARTERS = 3;
+
+// The process's limits (see above).
+CGROUP_LIMITS Cgroup_Limits();
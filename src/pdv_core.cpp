@@ -0,0 +1,1725 @@
+// 	PDVZIP core. See "pdv_core.hpp".
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pdv_core.hpp"
+#include "pdv_png.hpp"
+#include "pdv_probes.hpp"
+
+PDV_PROBE_SEMAPHORE(stage__start);
+PDV_PROBE_SEMAPHORE(stage__end);
+PDV_PROBE_SEMAPHORE(crc);
+
+constexpr size_t
+	MAX_SCRIPT_SIZE = 750,			// Extraction script ("iCCP" chunk) size limit.
+	MAX_ZIP_COMMENT_LENGTH = 0xFFFF,
+	ZIP_STREAM_BLOCK_SIZE = 256 << 10,	// "Embed_Zip_Stream" copies the ZIP file's local records & file data through a buffer of this size.
+	MAX_CARRIER_CHUNKS = 8,			// Most carrier chunks added by a "PDV_CARRIERS" profile (the "iCCP" chunk is extended, not added).
+	MAX_ICCP_PADDING = 255,			// Most padding before the "iCCP" chunk's carried bytes, to keep "BAD_CHAR" characters out of its length field.
+	SPLT_HEADER_SIZE = 9,			// Start of a carrier "sPLT" chunk: palette name ("pdvzip" & the carrier's number), null separator & sample depth.
+	SPLT_ENTRY_SIZE = 6,			// "sPLT" palette entry, at a sample depth of 8: red, green, blue, alpha & a 2-byte frequency.
+	MAX_CARRIER_SIZE = 2 << 20;		// Most ZIP file bytes held by a profile's carrier chunks, copied aside by "Fill_Carrier_Chunks".
+
+constexpr uint64_t NO_OFFSET = UINT64_MAX;	// "Map_Offset" result for an offset outside every piece.
+
+constexpr uint32_t
+	IHDR_NAME = 0x49484452,	// PNG chunk names (see "PNG_CHUNK_VIEW::Name").
+	ICCP_NAME = 0x69434350,
+	SPLT_NAME = 0x73504C54,
+	IDAT_NAME = 0x49444154;
+
+// Carrier chunk within a "PDV_CARRIERS" profile, with the most data it may hold (for the "iCCP" chunk, including the extraction script).
+// Only chunks with a free-form payload carry data, so each carrier chunk stays valid: the "iCCP" chunk (after its compressed profile, which decoders stop at)
+// and "sPLT" chunks (the carried bytes as palette entries, after a palette name & sample depth). Both go before the "PLTE" & "IDAT" chunks.
+struct CARRIER_CHUNK {
+	uint32_t name;
+	size_t max_length;
+};
+
+static const std::vector<CARRIER_CHUNK> CARRIER_PROFILES[]{
+	{},
+	// Twitter keeps an "iCCP" chunk of up to 10KB. It sets no limit on "sPLT" chunks, so each holds up to 256KB.
+	{ { ICCP_NAME, 10240 - 12 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 },
+	  { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 } },
+	{ { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 },
+	  { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 }, { SPLT_NAME, 256 << 10 } }
+};
+
+static_assert(sizeof(CARRIER_PROFILES) / sizeof(CARRIER_PROFILES[0]) == static_cast<size_t>(PDV_CARRIERS::COUNT), "Carrier profiles");
+
+constexpr uint32_t
+	MAX_TRUECOLOR_DIMS = 899,	// 899 x 899 maximum supported dimensions for PNG Truecolor (PNG-32/24, color types 2 & 6).
+	MAX_INDEXED_COLOR_DIMS = 4096,	// 4096 x 4096 maximum supported dimensions for PNG Indexed color (PNG-8, color type 3).
+	MIN_DIMS = 68;			// 68 x 68 minimum supported dimensions for both PNG Indexed color and Truecolor.
+
+// Location of the ZIP file's trailing records. Index values are relative to the start of the ZIP file.
+struct ZIP_RECORDS {
+	size_t end_central_dir_index;
+	uint64_t
+		central_dir_index,
+		zip64_end_index,
+		zip_records,
+		first_index,	// Lowest index of the records that "Relocate_Zip_Records" will update.
+		offset_base;	// The ZIP file's offset values, less this value, are its index values (0, unless its offsets have already been relocated).
+	bool zip64;
+};
+
+// Check that the PNG chunk at "index" (length, name, data & CRC fields) lies within the image. Chunk lengths are untrusted input.
+static bool Chunk_Fits(std::vector<Byte>&, size_t);
+
+// Check the IHDR chunk's width, height & CRC fields (and the bytes between) for "BAD_CHAR" characters, which would break the Linux extraction script.
+static bool Has_Ihdr_Bad_Char(const PDV_STRUCT&, const std::vector<Byte>&);
+
+// Size vector "Zip_Vec" for a ZIP file of "zip_file_size" bytes, framed as an "IDAT" chunk, but only open a gap of "buffer_size" bytes for it (see "Zip_Buffer").
+static Byte* Frame_Zip(PDV_STRUCT&, size_t, size_t);
+
+// Run one stage, calling the "Stage" hook (if set) either side of it.
+template <typename Run>
+static PDV_ERROR Run_Stage(PDV_STRUCT&, PDV_STAGE, Run);
+
+// Find & check the ZIP file's trailing records (End Central Directory, ZIP64 records), within a window holding the ZIP file's bytes
+// from "window_index" to its end ("zip_file_size"), with the given "offset_base". If "first_index" comes back below "window_index", the caller needs a larger window.
+static PDV_ERROR Find_Zip_Records(Byte*, size_t, size_t, ZIP_RECORDS&, uint64_t);
+
+// Replace each offset within the ZIP file's trailing records, held in the window, as above, with "map(offset)" (e.g. the offset plus the ZIP file's new index location)
+// and add "comment_delta" to the ZIP comment length. "map" must keep the offsets in order and return "NO_OFFSET" for an offset it can't place.
+template <typename Map>
+static PDV_ERROR Relocate_Zip_Records(Byte*, size_t, size_t, const ZIP_RECORDS&, Map, int);
+
+// Map an offset through a piece list (see "ZIP_PIECE"). Returns "NO_OFFSET" for an offset outside every piece.
+static uint64_t Map_Offset(const std::vector<ZIP_PIECE>&, uint64_t);
+
+PDV_ERROR Embed_Zip(PDV_STRUCT& pdv) {
+
+	if (pdv.reduce_image) {
+		Run_Stage(pdv, PDV_STAGE::IMAGE_REDUCE, [&] { return Reduce_Image_File(pdv); });
+	}
+
+	PDV_ERROR error = Run_Stage(pdv, PDV_STAGE::IMAGE_CHECK, [&] { return Check_Image_File(pdv); });
+
+	// Now erase all unnecessary chunks from our cover image.
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::CHUNK_STRIP, [&] { return Erase_Image_Chunks(pdv); });
+	}
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::ZIP_CHECK, [&] { return Check_Zip_File(pdv); });
+	}
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::SCRIPT_BUILD, [&] { return Complete_Extraction_Script(pdv); });
+	}
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	// Index location of the last "IDAT" chunk's name field (user's ZIP file), once combined. The whole ZIP file starts just after it, unless carrier chunks are filled.
+	size_t idat_zip_index = pdv.image_size + pdv.script_size - 8;
+
+	std::vector<ZIP_PIECE> Piece_Vec{ { 0, idat_zip_index + 4, pdv.zip_size - 12 } };
+
+	// Insert vectors "Script_Vec" ("iCCP" chunk with completed extraction script) & "Zip_Vec" ("IDAT" chunk with ZIP file) into vector "Image_Vec" (PNG image).
+	// Then fill any carrier chunks and insert any packs, ahead of the ZIP file.
+	error = Run_Stage(pdv, PDV_STAGE::COMBINE, [&] {
+		Combine_Vectors(pdv);
+
+		const PDV_ERROR CARRIER_ERROR = pdv.carriers != PDV_CARRIERS::NONE ? Fill_Carrier_Chunks(pdv, idat_zip_index, Piece_Vec) : PDV_ERROR::NONE;
+
+		return CARRIER_ERROR != PDV_ERROR::NONE || pdv.Pack_Vec.empty() ? CARRIER_ERROR : Add_Zip_Packs(pdv, idat_zip_index, Piece_Vec);
+	});
+
+	// Before updating the last "IDAT" chunk's CRC value, adjust ZIP file offsets within this chunk, to their new locations, so that the ZIP file continues to be valid & extractable.
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::OFFSET_FIX, [&] { return Fix_Zip_Offset(pdv, Piece_Vec); });
+	}
+	if (error == PDV_ERROR::NONE) {
+		Run_Stage(pdv, PDV_STAGE::CRC, [&] { Update_Zip_Crc(pdv, idat_zip_index); return PDV_ERROR::NONE; });
+	}
+	return error;
+}
+
+PDV_ERROR Embed_Zip_Stream(PDV_STRUCT& pdv, size_t zip_file_size) {
+
+	if (pdv.reduce_image) {
+		Run_Stage(pdv, PDV_STAGE::IMAGE_REDUCE, [&] { return Reduce_Image_File(pdv); });
+	}
+
+	PDV_ERROR error = Run_Stage(pdv, PDV_STAGE::IMAGE_CHECK, [&] { return Check_Image_File(pdv); });
+
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::CHUNK_STRIP, [&] { return Erase_Image_Chunks(pdv); });
+	}
+
+	// Only the start of the ZIP file (first local file header, with its file name) is needed for the ZIP checks & the extraction script.
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::ZIP_CHECK, [&] {
+			const size_t HEAD_SIZE = std::min(zip_file_size, ZIP_LOCAL_VIEW::SIZE + 0xFFFF);
+
+			return pdv.Read_Zip(pdv, Frame_Zip(pdv, zip_file_size, HEAD_SIZE), 0, HEAD_SIZE) ? Check_Zip_File(pdv) : PDV_ERROR::ZIP_READ;
+		});
+	}
+	if (error == PDV_ERROR::NONE) {
+		error = Run_Stage(pdv, PDV_STAGE::SCRIPT_BUILD, [&] { return Complete_Extraction_Script(pdv); });
+	}
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	// From here on, only the "IDAT" chunk length & name fields of vector "Zip_Vec" are needed.
+	pdv.Zip_Vec.resize(8);
+	pdv.Zip_Vec.shrink_to_fit();
+
+	// Index location of the ZIP file within the polyglot image (just after the last "IDAT" chunk's name field).
+	const size_t ZIP_INDEX = pdv.image_size + pdv.script_size - 4;
+
+	// Read the ZIP file's trailing records into vector "Records_Vec". Start with the largest possible End Central Directory record (+ comment) and ZIP64 locator,
+	// then extend the window back to the start of the central directory, once its location is known.
+	const size_t RECORDS_BUDGET = pdv.max_memory - std::min(pdv.max_memory, Stream_Memory_Size(pdv.image_size,
+		Decode_Memory_Size(pdv.image_size >= PNG_HEADER_SIZE ? pdv.Image_Vec.data() : nullptr, pdv.image_size, pdv.reduce_image)));
+
+	size_t records_index = zip_file_size - std::min(zip_file_size, ZIP64_LOCATOR_VIEW::SIZE + ZIP_END_VIEW::SIZE + MAX_ZIP_COMMENT_LENGTH);
+
+	std::vector<Byte> Records_Vec;
+
+	ZIP_RECORDS records{};
+
+	error = Run_Stage(pdv, PDV_STAGE::OFFSET_FIX, [&] {
+		while (true) {
+			if (pdv.max_memory && zip_file_size - records_index > RECORDS_BUDGET) {
+				return PDV_ERROR::MEMORY_BUDGET;
+			}
+
+			// Free the previous window first, so that two windows are never held at once.
+			std::vector<Byte>().swap(Records_Vec);
+			Records_Vec.resize(zip_file_size - records_index);
+
+			if (!pdv.Read_Zip(pdv, Records_Vec.data(), records_index, Records_Vec.size())) {
+				return PDV_ERROR::ZIP_READ;
+			}
+
+			const PDV_ERROR ERROR_FOUND = Find_Zip_Records(Records_Vec.data(), records_index, zip_file_size, records, 0);
+
+			if (ERROR_FOUND != PDV_ERROR::NONE) {
+				return ERROR_FOUND;
+			}
+			if (records.first_index >= records_index) {
+				break;
+			}
+			records_index = records.first_index;
+		}
+		return Relocate_Zip_Records(Records_Vec.data(), records_index, zip_file_size, records, [ZIP_INDEX](uint64_t offset) { return ZIP_INDEX + offset; }, 16);
+	});
+
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	if (pdv.Progress) {
+		pdv.Progress("\nEmbedding extraction script within the PNG image.\n");
+		pdv.Progress("\nEmbedding ZIP file within the PNG image.\n");
+		pdv.Progress("\nWriting ZIP embedded PNG image out to disk.\n");
+	}
+
+	return Run_Stage(pdv, PDV_STAGE::WRITE, [&] {
+		// Write out the polyglot image in the same layout as "Combine_Vectors": PNG header & "IHDR" chunk, "iCCP" chunk (extraction script),
+		// remaining image chunks, then the last "IDAT" chunk (ZIP file), followed by the "IEND" chunk.
+		constexpr size_t FIRST_IDAT_INDEX = 33;
+
+		Byte* const IMAGE = pdv.Image_Vec.data();
+
+		const size_t IEND_INDEX = pdv.image_size - 12;
+
+		bool write_ok = pdv.Write_Out(pdv, IMAGE, FIRST_IDAT_INDEX)
+			&& pdv.Write_Out(pdv, pdv.Script_Vec.data(), pdv.script_size)
+			&& pdv.Write_Out(pdv, IMAGE + FIRST_IDAT_INDEX, IEND_INDEX - FIRST_IDAT_INDEX)
+			&& pdv.Write_Out(pdv, pdv.Zip_Vec.data(), 8);
+
+		// The last "IDAT" chunk's CRC covers its name field and the ZIP file, so it is computed as the ZIP file is copied through.
+		size_t idat_zip_crc = Crc_Update(0xffffffffL, &pdv.Zip_Vec[4], 4);
+
+		// The ZIP file's local records & file data (everything before its trailing records) are copied through unchanged.
+		std::vector<Byte> Block_Vec(std::min(ZIP_STREAM_BLOCK_SIZE, records_index));
+
+		for (size_t zip_index = 0; write_ok && zip_index != records_index;) {
+			const size_t BLOCK_SIZE = std::min(Block_Vec.size(), records_index - zip_index);
+
+			if (!pdv.Read_Zip(pdv, Block_Vec.data(), zip_index, BLOCK_SIZE)) {
+				return PDV_ERROR::ZIP_READ;
+			}
+			idat_zip_crc = Crc_Update(idat_zip_crc, Block_Vec.data(), BLOCK_SIZE);
+			write_ok = pdv.Write_Out(pdv, Block_Vec.data(), BLOCK_SIZE);
+			zip_index += BLOCK_SIZE;
+		}
+
+		idat_zip_crc = Crc_Update(idat_zip_crc, Records_Vec.data(), Records_Vec.size()) ^ 0xffffffffL;
+
+		Byte idat_zip_crc_field[4];
+		Store<uint32_t, Endian::Big>(idat_zip_crc_field, static_cast<uint32_t>(idat_zip_crc));
+
+		write_ok = write_ok
+			&& pdv.Write_Out(pdv, Records_Vec.data(), Records_Vec.size())
+			&& pdv.Write_Out(pdv, idat_zip_crc_field, sizeof(idat_zip_crc_field))
+			&& pdv.Write_Out(pdv, IMAGE + IEND_INDEX, 12);
+
+		pdv.image_size += pdv.script_size + pdv.zip_size;
+
+		return write_ok ? PDV_ERROR::NONE : PDV_ERROR::WRITE_OUT;
+	});
+}
+
+size_t Decode_Memory_Size(const Byte* png_header, size_t image_file_size, bool reduce_image) {
+	if (!png_header) {
+		return 0;
+	}
+
+	// The view only reads from the header.
+	const IHDR_VIEW IHDR(const_cast<Byte*>(png_header) + 8, PNG_HEADER_SIZE - 8);
+
+	const uint32_t
+		WIDTH = IHDR.Width(),
+		HEIGHT = IHDR.Height();
+
+	const Byte
+		BIT_DEPTH = IHDR.Bit_Depth(),
+		COLOR_TYPE = IHDR.Color_Type();
+
+	// Indexed-colour (PNG-8) covers are never decoded, nor are covers that "Check_Image_File" & "Decode_Png" reject before allocating.
+	if (IHDR.Name() != IHDR_NAME || (COLOR_TYPE != 2 && COLOR_TYPE != 6) || (BIT_DEPTH != 8 && BIT_DEPTH != 16)
+		|| WIDTH < MIN_DIMS || HEIGHT < MIN_DIMS || WIDTH > MAX_TRUECOLOR_DIMS || HEIGHT > MAX_TRUECOLOR_DIMS) {
+		return 0;
+	}
+
+	// The inflated rows, each preceded by its filter type byte. An interlaced image is inflated (its passes' rows, with one more filter type byte each at most)
+	// apart from its deinterlaced rows.
+	const size_t
+		ROWS_SIZE = static_cast<size_t>(HEIGHT) * (static_cast<size_t>(WIDTH) * (COLOR_TYPE == 6 ? 4 : 3) * BIT_DEPTH / 8 + 1),
+		DECODE_SIZE = IHDR.Interlace() ? 2 * ROWS_SIZE + HEIGHT : ROWS_SIZE;
+
+	// With "reduce_image", the rows are filtered again in place and compressed into slices (each at most its "deflateBound"),
+	// which then make up the new IDAT data, alongside the new PNG file (kept below the image's size).
+	return reduce_image ? std::max(DECODE_SIZE, 2 * ROWS_SIZE + ROWS_SIZE / 1024 + 64 + image_file_size) : DECODE_SIZE;
+}
+
+size_t Embed_Memory_Size(size_t image_file_size, size_t zip_file_size, size_t decode_size) {
+	// "Image_Vec", "Temp_Vec" (stripped image) & "Zip_Vec" (reserved for the complete polyglot image) while "Erase_Image_Chunks" runs,
+	// or "Image_Vec", "Zip_Vec" and the decoding (& re-encoding) buffers, whichever is larger.
+	// With "carriers", "Fill_Carrier_Chunks" also copies aside the carried part of the ZIP file.
+	return image_file_size + zip_file_size + std::max(2 * image_file_size + MAX_SCRIPT_SIZE + 12, decode_size)
+		+ std::min(zip_file_size, MAX_CARRIER_SIZE);
+}
+
+size_t Pack_Chunks_Size(const PDV_STRUCT& pdv) {
+	if (pdv.Pack_Vec.empty()) {
+		return 0;
+	}
+
+	size_t chunks_size = PNG_CHUNK_VIEW::OVERHEAD + PACK_DIRECTORY_HEADER_SIZE;
+
+	for (size_t pack = 0; pack < pdv.Pack_Vec.size(); pack++) {
+		const std::string& PACK_NAME = pdv.Pack_Name_Vec.size() > pack ? pdv.Pack_Name_Vec[pack] : std::string();
+
+		const size_t NAME_LENGTH = PACK_NAME.length() - (PACK_NAME.find_last_of("/\\") + 1);
+
+		chunks_size += PNG_CHUNK_VIEW::OVERHEAD + pdv.Pack_Vec[pack].size() + PACK_ENTRY_SIZE + std::min(NAME_LENGTH, MAX_PACK_NAME_LENGTH);
+	}
+	return chunks_size;
+}
+
+size_t Stream_Memory_Size(size_t image_file_size, size_t decode_size) {
+	// "Image_Vec", "Temp_Vec", "Script_Vec", the start of the ZIP file within "Zip_Vec" and the copy buffer,
+	// or "Image_Vec" and the decoding (& re-encoding) buffers, whichever is larger.
+	return image_file_size + std::max(image_file_size + MAX_SCRIPT_SIZE + ZIP_LOCAL_VIEW::SIZE + 0xFFFF + 12 + ZIP_STREAM_BLOCK_SIZE, decode_size);
+}
+
+PDV_ERROR Check_Image_File(PDV_STRUCT& pdv) {
+
+	// Vector "Image_Vec" stores the user's PNG image. Later, it will also store the contents of vectors "Script_Vec" and "Zip_Vec".
+	pdv.image_size = pdv.Image_Vec.size();
+
+	constexpr size_t MIN_IMAGE_SIZE = 68;
+
+	if (MIN_IMAGE_SIZE >= pdv.image_size) {
+		return PDV_ERROR::IMAGE_TOO_SMALL;
+	}
+
+	// Make sure we are dealing with a valid PNG image file.
+	const std::string
+		PNG_TOP_SIG = "\x89\x50\x4E\x47", 		  // PNG image header signature. 
+		PNG_END_SIG = "\x49\x45\x4E\x44\xAE\x42\x60\x82", // PNG image end signature.
+		GET_PNG_TOP_SIG{ pdv.Image_Vec.begin(), pdv.Image_Vec.begin() + PNG_TOP_SIG.length() },	// Attempt to get both image signatures from file stored in vector. 
+		GET_PNG_END_SIG{ pdv.Image_Vec.end() - PNG_END_SIG.length(), pdv.Image_Vec.end() };
+
+	// Make sure image has valid PNG signatures.
+	if (GET_PNG_TOP_SIG != PNG_TOP_SIG || GET_PNG_END_SIG != PNG_END_SIG) {
+		// Invalid image file.
+		return PDV_ERROR::IMAGE_SIGNATURE;
+	}
+
+	// Check a range of bytes within the "IHDR" chunk to make sure we have no "BAD_CHAR" characters that will break the Linux extraction script.
+	// A script breaking character can appear within the width & height fields or the 4 byte CRC field of the "IHDR" chunk.
+	// Manually modifying the dimensions (1% increase or decrease) of the image will usually resolve the issue. Repeat if necessary.
+
+	if (Has_Ihdr_Bad_Char(pdv, pdv.Image_Vec)) {
+		return PDV_ERROR::IHDR_BAD_CHAR;
+	}
+
+	// Now check for supported image dimensions and color types.
+	const IHDR_VIEW IHDR(pdv.Image_Vec, 8);
+
+	const uint32_t
+		IMAGE_WIDTH_DIMS = IHDR.Width(),	// Get width dimensions from the "IHDR" chunk.
+		IMAGE_HEIGHT_DIMS = IHDR.Height(),	// Get height dimensions from the "IHDR" chunk.
+		PNG_COLOR_TYPE = IHDR.Color_Type() == 6 ? 2 : IHDR.Color_Type();	// Get image color type value. If value is 6 (Truecolor with alpha), set the value to 2 (Truecolor).
+
+	constexpr uint32_t
+		PNG_INDEXED_COLOR = 3,		// PNG-8, Indexed color value.
+		PNG_TRUECOLOR = 2;		// PNG-24, Truecolour value. (We also use this value for PNG-32 (Truecolour with alpha 6), as we consider them the same for this program.
+
+	const bool
+		VALID_COLOR_TYPE = (PNG_COLOR_TYPE == PNG_INDEXED_COLOR) ? true		// Checking for valid color type of PNG image (PNG-32/24 Truecolor or PNG-8 Indexed color only).
+		: ((PNG_COLOR_TYPE == PNG_TRUECOLOR) ? true : false),
+
+		VALID_IMAGE_DIMS = (PNG_COLOR_TYPE == PNG_TRUECOLOR			// Checking for valid dimension size for PNG Truecolor (PNG-32/24) images.
+			&& MAX_TRUECOLOR_DIMS >= IMAGE_WIDTH_DIMS
+			&& MAX_TRUECOLOR_DIMS >= IMAGE_HEIGHT_DIMS
+			&& IMAGE_WIDTH_DIMS >= MIN_DIMS
+			&& IMAGE_HEIGHT_DIMS >= MIN_DIMS) ? true
+		: ((PNG_COLOR_TYPE == PNG_INDEXED_COLOR					// Checking for valid dimension size for PNG Indexed color (PNG-8) images.
+			&& MAX_INDEXED_COLOR_DIMS >= IMAGE_WIDTH_DIMS
+			&& MAX_INDEXED_COLOR_DIMS >= IMAGE_HEIGHT_DIMS
+			&& IMAGE_WIDTH_DIMS >= MIN_DIMS
+			&& IMAGE_HEIGHT_DIMS >= MIN_DIMS) ? true : false);
+
+	if (!VALID_COLOR_TYPE || !VALID_IMAGE_DIMS) {
+		// Requirements check failure.
+		return !VALID_COLOR_TYPE ? PDV_ERROR::IMAGE_COLOR_TYPE : PDV_ERROR::IMAGE_DIMENSIONS;
+	}
+
+	// Platforms such as Twitter convert PNG-32/24 images of 256 colours or less to PNG-8, which destroys the embedded content.
+	// Decode the image and count its colours (stopping at 257), so that such a cover is rejected now, not found out after uploading.
+	// Single threaded, as jobs may already be running on every CPU. Truecolour covers are small (899 x 899 max.), so this takes milliseconds.
+	if (PNG_COLOR_TYPE == PNG_TRUECOLOR) {
+		PNG_IMAGE image;
+
+		const PDV_ERROR DECODE_ERROR = Decode_Png(pdv.Image_Vec, image, 1);
+
+		if (DECODE_ERROR != PDV_ERROR::NONE) {
+			return DECODE_ERROR;
+		}
+		if (Count_Colors(image) < PNG8_COLOR_LIMIT) {
+			return PDV_ERROR::IMAGE_COLORS;
+		}
+	}
+
+	// We appear to have a compatible PNG to use as our cover image.
+	return PDV_ERROR::NONE;
+}
+
+static bool Has_Ihdr_Bad_Char(const PDV_STRUCT& pdv, const std::vector<Byte>& Image_Vec) {
+	int chunk_index = 18;
+
+	// From index location, increment through 14 bytes of the IHDR chunk within vector "Image_Vec" and compare each byte to the 7 characters within "BAD_CHAR" string.
+	while (chunk_index++ != 32) { // We start checking from the 19th character position of the IHDR chunk within vector "Image_Vec".
+		for (int i = 0; i < 7; i++) {
+			if (Image_Vec[chunk_index] == pdv.BAD_CHAR[i]) { // "BAD_CHAR" character found.
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+PDV_ERROR Generate_Cover_Image(PDV_STRUCT& pdv, uint32_t& width, uint32_t& height) {
+
+	if (width < MIN_DIMS || height < MIN_DIMS || width > MAX_TRUECOLOR_DIMS || height > MAX_TRUECOLOR_DIMS) {
+		return PDV_ERROR::IMAGE_DIMENSIONS;
+	}
+
+	// Only the IHDR chunk's width, height & CRC fields can hold a "BAD_CHAR" character (the other fields are fixed). Check just the PNG signature & IHDR chunk
+	// for each candidate size, nearest first (growing the width, then the height, by the same total), before encoding the image once.
+	constexpr Byte PNG_SIG_IHDR[]{ 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52 };
+
+	std::vector<Byte> Header_Vec(PNG_SIG_IHDR, PNG_SIG_IHDR + sizeof(PNG_SIG_IHDR));
+	Header_Vec.resize(IHDR_VIEW::SIZE + 8);
+
+	const IHDR_VIEW IHDR(Header_Vec, 8);
+
+	Header_Vec[24] = 8;	// Bit depth.
+	Header_Vec[25] = 2;	// Truecolour.
+
+	for (uint32_t extra = 0; extra <= 2 * MAX_TRUECOLOR_DIMS; extra++) {
+		for (uint32_t extra_height = 0; extra_height <= extra; extra_height++) {
+			const uint32_t
+				NEW_WIDTH = width + extra - extra_height,
+				NEW_HEIGHT = height + extra_height;
+
+			if (NEW_WIDTH > MAX_TRUECOLOR_DIMS || NEW_HEIGHT > MAX_TRUECOLOR_DIMS) {
+				continue;
+			}
+
+			Store<uint32_t, Endian::Big>(&Header_Vec[16], NEW_WIDTH);
+			Store<uint32_t, Endian::Big>(&Header_Vec[20], NEW_HEIGHT);
+			IHDR.Set_Crc(static_cast<uint32_t>(Crc(&Header_Vec[12], 17)));
+
+			if (Has_Ihdr_Bad_Char(pdv, Header_Vec)) {
+				continue;
+			}
+
+			if (!Generate_Gradient_Png(NEW_WIDTH, NEW_HEIGHT, pdv.Image_Vec)) {
+				return PDV_ERROR::IMAGE_CORRUPT;
+			}
+
+			width = NEW_WIDTH;
+			height = NEW_HEIGHT;
+
+			if (pdv.Progress) {
+				char message[96];
+				std::snprintf(message, sizeof(message), "\nGenerated cover image: %u x %u, %zu bytes.\n", width, height, pdv.Image_Vec.size());
+				pdv.Progress(message);
+			}
+			return PDV_ERROR::NONE;
+		}
+	}
+	return PDV_ERROR::IHDR_BAD_CHAR;
+}
+
+PDV_ERROR Reduce_Image_File(PDV_STRUCT& pdv) {
+
+	// Only PNG-32/24 covers that "Check_Image_File" would size-check as such are reduced. Reduced images keep their dimensions,
+	// and PNG-8 allows larger ones (4096 x 4096), so the result never falls outside the dimension limits.
+	// Other covers are not decoded at all (as counted by "Decode_Memory_Size").
+	PNG_IMAGE image;
+
+	if (pdv.Image_Vec.size() <= 68 || !Decode_Memory_Size(pdv.Image_Vec.data(), pdv.Image_Vec.size(), false) || Decode_Png(pdv.Image_Vec, image, 1) != PDV_ERROR::NONE || image.color_type == 3
+		|| image.width > MAX_TRUECOLOR_DIMS || image.height > MAX_TRUECOLOR_DIMS || image.width < MIN_DIMS || image.height < MIN_DIMS) {
+		return PDV_ERROR::NONE;
+	}
+
+	// Also re-encoded when no colour type / bit depth reduction applies, as the new encoding (adaptive filters, maximum compression) is often smaller.
+	// A PNG-32/24 result still has more than 256 colours (else it would have become PNG-8), so platforms keep it as it is.
+	Reduce_Png(image);
+
+	std::vector<Byte> Reduced_Vec;
+
+	// The new IHDR CRC may contain a "BAD_CHAR" character, where the original's did not. Keep the original image then.
+	if (!Encode_Png(image, Reduced_Vec, pdv.Image_Vec.size() - 1, pdv.threads) || Has_Ihdr_Bad_Char(pdv, Reduced_Vec)) {
+		return PDV_ERROR::NONE;
+	}
+
+	if (pdv.Progress) {
+		char message[128];
+		std::snprintf(message, sizeof(message), "\nCover image reduced to PNG color type %u, bit depth %u: %zu -> %zu bytes.\n",
+			static_cast<unsigned>(image.color_type), static_cast<unsigned>(image.bit_depth), pdv.Image_Vec.size(), Reduced_Vec.size());
+		pdv.Progress(message);
+	}
+
+	pdv.Image_Vec.swap(Reduced_Vec);
+
+	return PDV_ERROR::NONE;
+}
+
+PDV_ERROR Erase_Image_Chunks(PDV_STRUCT& pdv) {
+
+	// Keep the critical PNG chunks: IHDR, *PLTE, IDAT & IEND.
+
+	std::vector<Byte>Temp_Vec;
+
+	// The stripped image is never larger than the original, so "Temp_Vec" is allocated once.
+	Temp_Vec.reserve(pdv.image_size);
+
+	// Copy the first 33 bytes of Image_Vec into Temp_Vec (PNG header + IHDR).
+	Temp_Vec.insert(Temp_Vec.begin(), pdv.Image_Vec.begin(), pdv.Image_Vec.begin() + 33);
+
+	const std::string IDAT_SIG = "IDAT";
+
+	// Get first IDAT chunk index.
+	size_t idat_index = std::search(pdv.Image_Vec.begin(), pdv.Image_Vec.end(), IDAT_SIG.begin(), IDAT_SIG.end()) - pdv.Image_Vec.begin() - 4;  // -4 is to position the index at the start of the IDAT chunk's length field.
+
+	// Make sure this is a valid IDAT chunk. Check it lies within the image, then check CRC value.
+	if (!Chunk_Fits(pdv.Image_Vec, idat_index)) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	const PNG_CHUNK_VIEW FIRST_IDAT(pdv.Image_Vec, idat_index);
+
+	const size_t
+		FIRST_IDAT_LENGTH = FIRST_IDAT.Length(),	// Get first IDAT chunk length value
+		FIRST_IDAT_CRC = FIRST_IDAT.Crc(),		// Get first IDAT chunk's stored CRC value.
+		CALC_FIRST_IDAT_CRC = Crc(&pdv.Image_Vec[idat_index + 4], FIRST_IDAT_LENGTH + 4);
+
+	// Make sure values match.
+	if (FIRST_IDAT_CRC != CALC_FIRST_IDAT_CRC) {
+		return PDV_ERROR::IDAT_CRC;
+	}
+
+	// *For PNG-8 Indexed color (3) we need to keep the PLTE chunk.
+	if (Temp_Vec[25] == 3) {
+
+		const std::string PLTE_SIG = "PLTE";
+
+		// Find PLTE chunk index and copy its contents into Temp_Vec.
+		const size_t PLTE_CHUNK_INDEX = std::search(pdv.Image_Vec.begin(), pdv.Image_Vec.end(), PLTE_SIG.begin(), PLTE_SIG.end()) - pdv.Image_Vec.begin() - 4;
+
+		if (idat_index > PLTE_CHUNK_INDEX) {
+			if (!Chunk_Fits(pdv.Image_Vec, PLTE_CHUNK_INDEX)) {
+				return PDV_ERROR::IMAGE_CORRUPT;
+			}
+
+			const size_t CHUNK_SIZE = PNG_CHUNK_VIEW(pdv.Image_Vec, PLTE_CHUNK_INDEX).Total_Size();
+
+			Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.begin() + PLTE_CHUNK_INDEX, pdv.Image_Vec.begin() + PLTE_CHUNK_INDEX + CHUNK_SIZE);
+		}
+		else {
+			return PDV_ERROR::PLTE_MISSING;
+		}
+	}
+
+	// Find all the IDAT chunks and copy them into Temp_Vec.
+	while (pdv.image_size != idat_index + 4) {
+		if (!Chunk_Fits(pdv.Image_Vec, idat_index)) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		const size_t CHUNK_SIZE = PNG_CHUNK_VIEW(pdv.Image_Vec, idat_index).Total_Size();
+
+		Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.begin() + idat_index, pdv.Image_Vec.begin() + idat_index + CHUNK_SIZE);
+		idat_index = std::search(pdv.Image_Vec.begin() + idat_index + 6, pdv.Image_Vec.end(), IDAT_SIG.begin(), IDAT_SIG.end()) - pdv.Image_Vec.begin() - 4;
+	}
+
+	// Copy the last 12 bytes of Image_Vec into Temp_Vec.
+	Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.end() - 12, pdv.Image_Vec.end());
+
+	Temp_Vec.swap(pdv.Image_Vec);
+
+	// Update image size.
+	pdv.image_size = pdv.Image_Vec.size();
+
+	return PDV_ERROR::NONE;
+}
+
+Byte* Zip_Buffer(PDV_STRUCT& pdv, size_t zip_file_size) {
+
+	// "Combine_Vectors" builds the polyglot image within "Zip_Vec" (stripped image + extraction script + ZIP file), so reserve that much now,
+	// plus the length, name & CRC fields and "sPLT" header & entry padding of any carrier chunks, the "iCCP" chunk's padding ("Fill_Carrier_Chunks") and any packs ("Add_Zip_Packs").
+	pdv.Zip_Vec.reserve(pdv.Image_Vec.size() + MAX_SCRIPT_SIZE + zip_file_size + 12
+		+ MAX_CARRIER_CHUNKS * (PNG_CHUNK_VIEW::OVERHEAD + SPLT_HEADER_SIZE + SPLT_ENTRY_SIZE) + MAX_ICCP_PADDING
+		+ Pack_Chunks_Size(pdv));
+
+	return Frame_Zip(pdv, zip_file_size, zip_file_size);
+}
+
+static Byte* Frame_Zip(PDV_STRUCT& pdv, size_t zip_file_size, size_t buffer_size) {
+
+	// Vector "Zip_Vec" will store the user's ZIP file. The contents of "Zip_Vec" will later be inserted into the vector "Image_Vec" as the last "IDAT" chunk. 
+	// We will need to update the CRC value (last 4-bytes) and the chunk length field (first 4-bytes) within this vector. Both fields currently set to zero. 
+
+	pdv.Zip_Vec = { 0x00, 0x00, 0x00, 0x00, 0x49, 0x44, 0x41, 0x54, 0x00, 0x00, 0x00, 0x00 };	// "IDAT" chunk name with 4-byte chunk length and crc fields.
+
+	// Open a gap of "buffer_size" bytes from index 8, just after "IDAT" chunk name. The caller copies (or reads) the user's ZIP file straight into it.
+	pdv.Zip_Vec.insert(pdv.Zip_Vec.begin() + 8, buffer_size, 0);
+
+	pdv.zip_size = zip_file_size + 12;
+
+	return &pdv.Zip_Vec[8];
+}
+
+PDV_ERROR Check_Zip_File(PDV_STRUCT& pdv) {
+
+	constexpr size_t MIN_ZIP_SIZE = 40;
+
+	// "zip_size" is the framed ZIP file size (see "Zip_Buffer"). "Zip_Vec" may only hold the start of the ZIP file (see "Embed_Zip_Stream").
+	if (MIN_ZIP_SIZE + 12 >= pdv.zip_size) {
+		return PDV_ERROR::ZIP_TOO_SMALL;
+	}
+
+	pdv.combined_file_size = pdv.image_size + pdv.zip_size + Pack_Chunks_Size(pdv);
+
+	if (pdv.combined_file_size > pdv.MAX_FILE_SIZE) {
+		return PDV_ERROR::FILE_SIZE;
+	}
+
+	// Write the updated "IDAT" chunk length of vector "Zip_Vec" within its length field. 
+	PNG_CHUNK_VIEW(pdv.Zip_Vec, 0).Set_Length(static_cast<uint32_t>(pdv.zip_size - 12));
+
+	// The user's ZIP file starts with its first local file header, from index 8 of vector "Zip_Vec".
+	const ZIP_LOCAL_VIEW FIRST_LOCAL(&pdv.Zip_Vec[8], pdv.Zip_Vec.size() - 12);
+
+	constexpr int MIN_INZIP_NAME_LENGTH = 4;		// Set minimum filename length of zipped file. (1st filename record within ZIP archive).
+
+	const bool VALID_ZIP_SIG = FIRST_LOCAL.Signature() == ZIP_LOCAL_VIEW::SIG;	// Valid file signature of ZIP file.
+
+	const int INZIP_NAME_LENGTH = FIRST_LOCAL.Name_Length();	// Get length of zipped file name (1st file in ZIP record).
+
+	if (!VALID_ZIP_SIG || MIN_INZIP_NAME_LENGTH > INZIP_NAME_LENGTH) {
+		return !VALID_ZIP_SIG ? PDV_ERROR::ZIP_SIGNATURE : PDV_ERROR::ZIP_NAME_LENGTH;
+	}
+
+	// The first file name is read by "Complete_Extraction_Script", so make sure it lies within the ZIP file.
+	return FIRST_LOCAL.Fits(0, ZIP_LOCAL_VIEW::SIZE + INZIP_NAME_LENGTH) ? PDV_ERROR::NONE : PDV_ERROR::ZIP_CORRUPT;
+}
+
+PDV_ERROR Complete_Extraction_Script(PDV_STRUCT& pdv) {
+
+	/* Vector "Script_Vec" (See "script_info.txt" in this repo).
+
+	First 4 bytes of the vector is the chunk length field, followed by chunk name "iCCP" then our barebones extraction script.
+
+	This vector stores the shell/batch script used for extracting and opening the embedded zipped file (First filename within the ZIP file record).
+	The barebones script is about 300 bytes. The script size limit is 750 bytes, which should be more than enough to account
+	for the later addition of filenames, application & argument strings, plus other required script commands.
+
+	Script supports both Linux & Windows. The completed script, when executed, will unzip the archive within the
+	PNG image and (depending on file type) attempt to open/display/play/run the first filename within the ZIP file record by using an application
+	command based on the matched file extension, or if no match found, defaulting to the operating system making the choice.
+
+	The zipped file needs to be compatible with the operating system you are running it on.
+	The completed script within the "iCCP" chunk will later be inserted into the vector "Image_Vec" which contains the user's PNG image file */
+
+	pdv.Script_Vec = {
+			0x00, 0x00, 0x00, 0xFD, 0x69, 0x43, 0x43, 0x50, 0x73, 0x63, 0x72, 0x00, 0x00, 0x0D, 0x52,
+			0x45, 0x4D, 0x3B, 0x63, 0x6C, 0x65, 0x61, 0x72, 0x3B, 0x6D, 0x6B, 0x64, 0x69, 0x72, 0x20,
+			0x2E, 0x2F, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63,
+			0x74, 0x65, 0x64, 0x3B, 0x6D, 0x76, 0x20, 0x22, 0x24, 0x30, 0x22, 0x20, 0x2E, 0x2F, 0x70,
+			0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64,
+			0x3B, 0x63, 0x64, 0x20, 0x2E, 0x2F, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78,
+			0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x3B, 0x75, 0x6E, 0x7A, 0x69, 0x70, 0x20, 0x2D,
+			0x71, 0x6F, 0x20, 0x22, 0x24, 0x30, 0x22, 0x3B, 0x63, 0x6C, 0x65, 0x61, 0x72, 0x3B, 0x22,
+			0x22, 0x3B, 0x65, 0x78, 0x69, 0x74, 0x3B, 0x0D, 0x0A, 0x23, 0x26, 0x63, 0x6C, 0x73, 0x26,
+			0x6D, 0x6B, 0x64, 0x69, 0x72, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F,
+			0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x6D, 0x6F, 0x76, 0x65, 0x20,
+			0x22, 0x25, 0x7E, 0x64, 0x70, 0x6E, 0x78, 0x30, 0x22, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76,
+			0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x63,
+			0x64, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72,
+			0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x63, 0x6C, 0x73, 0x26, 0x74, 0x61, 0x72, 0x20, 0x2D,
+			0x78, 0x66, 0x20, 0x22, 0x25, 0x7E, 0x6E, 0x30, 0x25, 0x7E, 0x78, 0x30, 0x22, 0x26, 0x20,
+			0x22, 0x22, 0x26, 0x72, 0x65, 0x6E, 0x20, 0x22, 0x25, 0x7E, 0x6E, 0x30, 0x25, 0x7E, 0x78,
+			0x30, 0x22, 0x20, 0x2A, 0x2E, 0x70, 0x6E, 0x67, 0x26, 0x65, 0x78, 0x69, 0x74, 0x0D, 0x0A,
+			0x00, 0x00, 0x00, 0x00 };
+
+	// "App_Vec" string vector. 
+	// Stores file extensions for some popular media types, along with several default application commands (+ args) that support those extensions.
+	// These vector string elements will be used in the completion of our extraction script.
+
+	std::vector<std::string> App_Vec{ "aac", "mp3", "mp4", "avi", "asf", "flv", "ebm", "mkv", "peg", "wav", "wmv", "wma", "mov", "3gp", "ogg", "pdf", ".py", "ps1", "exe",
+		".sh", "vlc --play-and-exit --no-video-title-show ", "evince ", "python3 ", "pwsh ", "./", "xdg-open ", "powershell;Invoke-Item ",
+		" &> /dev/null", "start /b \"\"", "pause&", "powershell", "chmod +x ", ";" };
+
+	constexpr int
+		FIRST_ZIP_NAME_REC_INDEX = 38,		// "Zip_Vec" start index location for the zipped filename.
+
+		// "App_Vec" vector element index values. 
+		// Some "App_Vec" vector string elements are added later (via emplace_back) so they don't currently appear in the above string vector.
+
+		VIDEO_AUDIO = 20,		// "vlc" app command for Linux. 
+		PDF = 21,			// "evince" app command for Linux. 
+		PYTHON = 22,			// "python3" app command for Linux & Windows.
+		POWERSHELL = 23,		// "pwsh" app command for Linux, for starting PowerShell scripts.
+		EXECUTABLE = 24,		// "./" prepended to filename. Required when running Linux executables.
+		BASH_XDG_OPEN = 25,		// "xdg-open" Linux command, runs shell scripts (.sh), opens folders & unmatched file extensions.
+		FOLDER_INVOKE_ITEM = 26,	// "powershell;Invoke-Item" command used in Windows for opening zipped folders, instead of files.
+		START_B = 28,			// "start /b" Windows command used to open most file types. Windows uses set default app for most file types.
+		WIN_POWERSHELL = 30,		// "powershell" commmand used by Windows for running PowerShell scripts.
+		PREPEND_FIRST_ZIP_NAME_REC = 36;	// first_zip_name with ".\" prepended characters. Required for Windows PowerShell, e.g. powershell ".\my_ps_script.ps1".
+
+	const int FIRST_ZIP_NAME_REC_LENGTH = ZIP_LOCAL_VIEW(pdv.Zip_Vec, 8).Name_Length();	// Get character length of the zipped media filename from vector "Zip_Vec".
+
+	std::string
+		// Get the zipped filename string from vector "Zip_Vec". (First filename within the ZIP record).
+		first_zip_name{ pdv.Zip_Vec.begin() + FIRST_ZIP_NAME_REC_INDEX, pdv.Zip_Vec.begin() + FIRST_ZIP_NAME_REC_INDEX + FIRST_ZIP_NAME_REC_LENGTH },
+
+		// Get the file extension from the zipped filename.
+		first_zip_name_ext = first_zip_name.substr(first_zip_name.length() - 3, 3);
+
+	// Check for "." character to see if the "first_zip_name" has a file extension.
+	const auto CHECK_FILE_EXT = first_zip_name.find_last_of('.');
+
+	// Store this filename (first filename within the ZIP record) in "App_Vec" vector (33).
+	App_Vec.emplace_back(first_zip_name);
+
+	// When inserting string elements from vector "App_Vec" into the script (within vector "Script_Vec"), we are adding items in 
+	// the order of last to first. The Windows script is completed first, followed by Linux. 
+	// This order prevents the vector insert locations from changing every time we add a new string element into the vector.
+
+	// The vector "Sequence_Vec" can be split into four sequences containing "Script_Vec" index values (high numbers) used by the 
+	// "insert_index" variable and the corresponding "App_Vec" index values (low numbers) used by the "app_index" variable.
+
+	// For example, in the 1st sequence, Sequence_Vec[0] = index 241 of "Script_Vec" ("insert_index") corresponds with
+	// Sequence_Vec[5] = "App_Vec" index 33 ("app_index"), which is the "first_zip_name" string element (first filename within the ZIP record). 
+	// "App_Vec" string element 33 (first_zip_name) will be inserted into the script (vector "Script_Vec") at index 241.
+
+	int
+		app_index = 0,		// Uses the "App_Vec" index values from the vector Sequence_Vec.
+		insert_index = 0,	// Uses the "Script_Vec" index values from vector Sequence_Vec.
+		sequence_limit = 0;	// Stores the length limit of each of the four sequences. 
+
+	std::vector<int>Sequence_Vec{
+			241, 239, 121, 120, 119,	// 1st sequence for case "VIDEO_AUDIO".
+			33, 28, 27, 33, 20,
+
+			241, 239, 120, 119,		// 2nd sequence for cases "PDF, FOLDER_INVOKE_ITEM, DEFAULT".
+			33, 28, 33, 21,
+
+			264, 242, 241, 239, 121, 120, 119,			// 3rd sequence for cases "PYTHON, POWERSHELL".
+			29, 35, 33, 22, 34, 33, 22,
+
+			264, 242, 241, 239, 121, 120, 119, 119, 119, 119,	// 4th sequence for cases "EXECUTABLE & BASH_XDG_OPEN".
+			29, 35, 33, 28, 34, 33, 24, 32, 33, 31 };
+
+	/*  	[Sequence_Vec](insert_index)[Sequence_Vec](app_index)
+		Build script example below is using the first sequence (see vector "Sequence_Vec" above).
+
+		VIDEO_AUDIO:
+		[0]>(241)[5]>(33) Windows: "Image_Vec" 241 insert index for the string variable first_zip_name, "App_Vec" 33.
+		[1]>(239)[6]>(28) Windows: "Image_Vec" 239 insert index for the string "start /b", "App_Vec" 28.
+		[2]>(121)[7]>(27) Linux: "Image_Vec" 121 insert index for the string "Dev Null", "App_Vec" 27.
+		[3]>(120)[8]>(33) Linux: "Image_Vec" 120 insert index for the the string variable first_zip_name, "App_Vec" 33.
+		[4]>(119)[9]>(20) Linux: "Image_Vec" 119 insert index for the string "vlc", "App_Vec" 20.
+		Sequence limit is 5 (value taken from first app_index value for each sequence).
+
+		Matching a file extension from the string variable "first_zip_name_ext" within "App_Vec" (33), we can select which application string and commands to use
+		in our extraction script, which when executed, will (depending on file type) open/display/play/run the extracted zipped file ("first_zip_name").
+
+		Once the correct app extension has been matched by the "for-loop" below, it passes the app_index result to the switch statement.
+		The relevant Case sequence is then used in completing the extraction script within vector "Script_Vec".	*/
+
+	for (; app_index != 26; app_index++) {
+		if (App_Vec[app_index] == first_zip_name_ext) {
+			// After a file extension match, any app_index value between 0 and 14 defaults to "App_Vec" 20 (vlc / VIDEO_AUDIO).
+			// If over 14, we add 6 to the value. 15 + 6 = "App_Vec" 21 (evince for PDF (Linux) ), 16 + 6 = "App_Vec" 22 (python3/.py), etc.
+			app_index = app_index <= 14 ? 20 : app_index + 6;
+			break;
+		}
+	}
+
+	// If no file extension detected, check if "first_zip_name" points to a folder (/), else assume file is a Linux executable.
+	if (CHECK_FILE_EXT == 0 || CHECK_FILE_EXT > first_zip_name.length()) {
+		app_index = pdv.Zip_Vec[FIRST_ZIP_NAME_REC_INDEX + FIRST_ZIP_NAME_REC_LENGTH - 1] == '/' ? FOLDER_INVOKE_ITEM : EXECUTABLE;
+	}
+
+	// Provide the user with the option to add command-line arguments for file types: 
+	// Python (.py), PowerShell (.ps1), Shell script (.sh) and executable (.exe). (no extension, defaults to .exe, if not a folder).
+	// The provided arguments for your file type will be stored within the PNG image, along with the extraction script.
+
+	if (app_index > 21 && app_index < 26) {
+		if (pdv.Get_Arguments) {
+			pdv.Get_Arguments(pdv);
+		}
+
+		App_Vec.emplace_back("\x20" + pdv.args_linux),		// "App_Vec" (34).
+		App_Vec.emplace_back("\x20" + pdv.args_windows);	// "App_Vec" (35).
+	}
+
+	if (pdv.Progress) {
+		pdv.Progress("\nUpdating extraction script.\n");
+	}
+
+	switch (app_index) {
+		case VIDEO_AUDIO:	// Case uses 1st sequence: [241,239,121,120,119] , [33,28,27,33,20].
+			app_index = 5;
+			break;
+		case PDF:		// These two cases (with minor changes) use the 2nd sequence: [241,239,120,119] , [33,28,33,21].
+		case FOLDER_INVOKE_ITEM:
+			Sequence_Vec[15] = app_index == FOLDER_INVOKE_ITEM ? FOLDER_INVOKE_ITEM : START_B;
+			Sequence_Vec[17] = app_index == FOLDER_INVOKE_ITEM ? BASH_XDG_OPEN : PDF;
+			insert_index = 10;
+			app_index = 14;
+			break;
+		case PYTHON:		// These two cases (with some changes) use the 3rd sequence: [264,242,241,239,121,120,119] , [29,35,33,22,34,33,22].
+		case POWERSHELL:
+			if (app_index == POWERSHELL) {
+				first_zip_name.insert(0, ".\\");		//  ".\" prepend to "first_zip_name". Required for Windows PowerShell, e.g. powershell ".\my_ps_script.ps1".
+				App_Vec.emplace_back(first_zip_name);		// Add the filename with the prepended ".\" to the "AppVec" vector (36).
+				Sequence_Vec[31] = POWERSHELL;			// Swap index number to Linux PowerShell (pwsh 23)
+				Sequence_Vec[28] = WIN_POWERSHELL;		// Swap index number to Windows PowerShell (powershell 30)
+				Sequence_Vec[27] = PREPEND_FIRST_ZIP_NAME_REC;	// Swap index number to PREPEND_FIRST_ZIP_NAME_REC (36), used with the Windows powershell command.
+			}
+			insert_index = 18;
+			app_index = 25;
+			break;
+		case EXECUTABLE:	// These two cases (with minor changes) use the 4th sequence: [264,242,241,239,121,120,119,119,119,119] , [29,35,33,28,34,33,24,32,33,31].
+		case BASH_XDG_OPEN:
+			insert_index = app_index == EXECUTABLE ? 32 : 33;
+			app_index = insert_index == 32 ? 42 : 43;
+			break;
+		default:			// Unmatched file extensions. Rely on operating system to use the set default program for dealing with unknown file types.
+			insert_index = 10;	// Default uses 2nd sequence, we just need to alter one index number.
+			app_index = 14;
+			Sequence_Vec[17] = BASH_XDG_OPEN;	// Swap index number to BASH_XDG_OPEN (25)
+	}
+
+	// Set the sequence_limit variable using the first app_index value from each switch case sequence.
+	// Reduce sequence_limit variable value by 1 if insert_index is 33 (case BASH_XDG_OPEN).
+
+	sequence_limit = insert_index == 33 ? app_index - 1 : app_index;
+
+	// With just a single vector insert command within the "while-loop", we can insert all the required strings into the extraction script (vector "Script_Vec"), 
+	// based on the sequence, which is selected by the relevant Case from the above switch statement after the extension match. 
+
+	while (sequence_limit > insert_index) {
+		pdv.Script_Vec.insert(pdv.Script_Vec.begin() + Sequence_Vec[insert_index], App_Vec[Sequence_Vec[app_index]].begin(), App_Vec[Sequence_Vec[app_index]].end());
+		insert_index++;
+		app_index++;
+	}
+
+	pdv.script_size = pdv.Script_Vec.size();
+
+	const PNG_CHUNK_VIEW ICCP(pdv.Script_Vec.data(), pdv.Script_Vec.size());
+
+	// Write updated chunk length value for the "iCCP" chunk into its length field. 
+	// Due to its small size, the "iCCP" chunk will only use 2 bytes maximum of the 4 byte length field.
+
+	ICCP.Set_Length(static_cast<uint32_t>(pdv.script_size - 12));
+
+	// Check the first byte of the "iCCP" chunk length field to make sure the updated chunk length does not match 
+	// any of the "BAD_CHAR" characters that will break the Linux extraction script.
+
+	for (int i = 0; i < 7; i++) {
+		if (pdv.Script_Vec[3] == pdv.BAD_CHAR[i]) {
+
+			// "BAD_CHAR" found. Insert 10 bytes "." at the end of "Script_Vec" to increase chunk length. Update chunk length field. 
+			// This should now skip over any BAD_CHAR characters, regardless of the chunk size (within its size limit).
+
+			const std::string INCREASE_LENGTH_STRING = "..........";
+
+			pdv.Script_Vec.insert(pdv.Script_Vec.begin() + pdv.script_size - 4, INCREASE_LENGTH_STRING.begin(), INCREASE_LENGTH_STRING.end());
+
+			pdv.script_size = pdv.Script_Vec.size();
+
+			PNG_CHUNK_VIEW(pdv.Script_Vec.data(), pdv.script_size).Set_Length(static_cast<uint32_t>(pdv.script_size - 12)); // Update size again.
+
+			break;
+		}
+	}
+
+	pdv.combined_file_size = pdv.Script_Vec.size() + pdv.Image_Vec.size() + pdv.zip_size + Pack_Chunks_Size(pdv);
+
+	constexpr int ICCP_CHUNK_INDEX = 4;
+
+	// Stop if extraction script exceeds size limit.
+	if (pdv.script_size > MAX_SCRIPT_SIZE || pdv.combined_file_size > pdv.MAX_FILE_SIZE) {
+		return pdv.script_size > MAX_SCRIPT_SIZE ? PDV_ERROR::SCRIPT_SIZE : PDV_ERROR::SCRIPT_FILE_SIZE;
+	}
+
+	// Now the "iCCP" chunk is complete with the extraction script, we need to update the chunk's CRC value.
+	// Pass these two values (ICCP_CHUNK_INDEX & iCCP chunk size (script_size) - 8) to the CRC function to get correct "iCCP" chunk CRC value.
+
+	const size_t ICCP_CHUNK_CRC = Crc(&pdv.Script_Vec[ICCP_CHUNK_INDEX], pdv.script_size - 8);
+
+	// Write the updated CRC value into the "iCCP" chunk's CRC field within vector "Script_Vec".
+	PNG_CHUNK_VIEW(pdv.Script_Vec.data(), pdv.script_size).Set_Crc(static_cast<uint32_t>(ICCP_CHUNK_CRC));
+
+	return PDV_ERROR::NONE;
+}
+
+void Combine_Vectors(PDV_STRUCT& pdv) {
+
+	// This value will be used as the insert location for contents of vector "Script_Vec". 
+	// Script_Vec's inserted contents will appear within the "iCCP" chunk, just after the "IHDR" chunk of "Image_Vec".
+
+	constexpr int FIRST_IDAT_INDEX = 33;
+
+	// The polyglot image is built within vector "Zip_Vec", which already has room reserved for it (see "Zip_Buffer"),
+	// so the ZIP file (by far the largest part) is moved once, within its own buffer, rather than copied into a second, larger buffer.
+	// Open a gap before the "IDAT" chunk with the ZIP file, for the image (minus its "IEND" chunk) and the "iCCP" chunk.
+
+	const size_t IEND_INDEX = pdv.image_size - 12;
+
+	pdv.Zip_Vec.insert(pdv.Zip_Vec.begin(), IEND_INDEX + pdv.script_size, 0);
+
+	Byte* const POLYGLOT = pdv.Zip_Vec.data();
+
+	std::copy_n(pdv.Image_Vec.begin(), FIRST_IDAT_INDEX, POLYGLOT);
+
+	if (pdv.Progress) {
+		pdv.Progress("\nEmbedding extraction script within the PNG image.\n");
+	}
+
+	// Copy contents of vector "Script_Vec" ("iCCP" chunk containing the extraction script) into place.	
+	std::copy_n(pdv.Script_Vec.begin(), pdv.script_size, POLYGLOT + FIRST_IDAT_INDEX);
+	std::copy(pdv.Image_Vec.begin() + FIRST_IDAT_INDEX, pdv.Image_Vec.begin() + IEND_INDEX, POLYGLOT + FIRST_IDAT_INDEX + pdv.script_size);
+
+	if (pdv.Progress) {
+		pdv.Progress("\nEmbedding ZIP file within the PNG image.\n");
+	}
+
+	// The "IDAT" chunk with the ZIP file now becomes the new last "IDAT" chunk of the PNG image, followed by the "IEND" chunk.
+	pdv.Zip_Vec.insert(pdv.Zip_Vec.end(), pdv.Image_Vec.begin() + IEND_INDEX, pdv.Image_Vec.end());
+
+	// Vector "Image_Vec" now stores the polyglot image. Release the stripped image.
+	pdv.Image_Vec.swap(pdv.Zip_Vec);
+	std::vector<Byte>().swap(pdv.Zip_Vec);
+}
+
+void Update_Zip_Crc(PDV_STRUCT& pdv, const size_t& IDAT_ZIP_INDEX) {
+
+	// Get CRC value for our (new) last "IDAT" chunk.
+	const size_t IDAT_ZIP_CRC = Crc(&pdv.Image_Vec[IDAT_ZIP_INDEX], pdv.zip_size - 8); // We don't include the length or CRC fields (-8 bytes).
+
+	pdv.image_size = pdv.Image_Vec.size();
+
+	// Write new CRC value into the last "IDAT" chunk's CRC field, within the vector "Image_Vec".
+	PNG_CHUNK_VIEW(pdv.Image_Vec, IDAT_ZIP_INDEX - 4).Set_Crc(static_cast<uint32_t>(IDAT_ZIP_CRC));
+}
+
+PDV_ERROR Fill_Carrier_Chunks(PDV_STRUCT& pdv, size_t& idat_zip_index, std::vector<ZIP_PIECE>& Piece_Vec) {
+
+	constexpr size_t ICCP_CHUNK_INDEX = 33;
+
+	const size_t
+		ZIP_INDEX = idat_zip_index + 4,
+		ZIP_SIZE = pdv.zip_size - 12;
+
+	Byte* const ZIP = &pdv.Image_Vec[ZIP_INDEX];
+
+	// Collect the boundaries between the ZIP file's local records (each local file header offset, up to its trailing records).
+	// "Relocate_Zip_Records" only walks the central directory here: each offset maps to itself and the comment length is left as it is.
+	std::vector<uint64_t> Offset_Vec{ 0 };
+
+	ZIP_RECORDS records{};
+
+	PDV_ERROR error = Find_Zip_Records(ZIP, 0, ZIP_SIZE, records, 0);
+
+	if (error == PDV_ERROR::NONE) {
+		error = Relocate_Zip_Records(ZIP, 0, ZIP_SIZE, records, [&Offset_Vec](uint64_t offset) { Offset_Vec.push_back(offset); return offset; }, 0);
+	}
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	std::sort(Offset_Vec.begin(), Offset_Vec.end());
+	Offset_Vec.erase(std::upper_bound(Offset_Vec.begin(), Offset_Vec.end(), records.first_index), Offset_Vec.end());
+	Offset_Vec.erase(std::unique(Offset_Vec.begin(), Offset_Vec.end()), Offset_Vec.end());
+
+	if (Offset_Vec.back() != records.first_index) {
+		Offset_Vec.push_back(records.first_index);
+	}
+
+	// Fill each carrier chunk of the profile, in order, with as many whole local records (header, file data & any data descriptor) as fit.
+	// Local records are never split, so each one stays contiguous, and they stay in order, so each carrier chunk is a single piece of the ZIP file.
+	struct CARRIER {
+		uint32_t name;
+		uint64_t from, size, prefix;	// "prefix": bytes before the carried ZIP file bytes ("iCCP" padding, or "sPLT" header & entry padding).
+	};
+
+	std::vector<CARRIER> Carrier_Vec;
+
+	const size_t ICCP_LENGTH = PNG_CHUNK_VIEW(pdv.Image_Vec, ICCP_CHUNK_INDEX).Length();
+
+	// The "iCCP" chunk's length field precedes the extraction script, so (as in "Complete_Extraction_Script") none of its bytes may match a "BAD_CHAR" character.
+	auto Bad_Length = [&pdv](size_t length) {
+		for (int shift = 0; shift != 32; shift += 8) {
+			if (pdv.BAD_CHAR.find(static_cast<char>(length >> shift & 0xFF)) != std::string::npos) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	size_t record = 0;
+
+	for (const CARRIER_CHUNK& CHUNK : CARRIER_PROFILES[static_cast<size_t>(pdv.carriers)]) {
+		const size_t ROOM = CHUNK.max_length - (CHUNK.name == ICCP_NAME ? std::min(CHUNK.max_length, ICCP_LENGTH) : SPLT_HEADER_SIZE + SPLT_ENTRY_SIZE - 1);
+
+		size_t end_record = record;
+
+		while (end_record + 1 < Offset_Vec.size() && Offset_Vec[end_record + 1] - Offset_Vec[record] <= ROOM) {
+			end_record++;
+		}
+
+		// Pad the "iCCP" chunk (between the extraction script & its carried bytes) until its length is clear of "BAD_CHAR" characters.
+		// If that would take more room than is left (e.g. a length of 0x27xx, where the high byte is "'"), its last record is left for the next carrier chunk.
+		size_t padding = 0;
+
+		for (; CHUNK.name == ICCP_NAME && end_record != record; end_record--) {
+			const size_t CARRIED = Offset_Vec[end_record] - Offset_Vec[record];
+
+			for (padding = 0; padding < MAX_ICCP_PADDING && CARRIED + padding < ROOM && Bad_Length(ICCP_LENGTH + padding + CARRIED); padding++) {}
+
+			if (CARRIED + padding <= ROOM && !Bad_Length(ICCP_LENGTH + padding + CARRIED)) {
+				break;
+			}
+		}
+		if (end_record != record) {
+			const size_t CARRIED = Offset_Vec[end_record] - Offset_Vec[record];
+
+			// An "sPLT" chunk's palette entries start with padding (of '.'), so that its carried bytes end on a whole palette entry.
+			const size_t PREFIX = CHUNK.name == ICCP_NAME ? padding
+				: SPLT_HEADER_SIZE + (SPLT_ENTRY_SIZE - CARRIED % SPLT_ENTRY_SIZE) % SPLT_ENTRY_SIZE;
+
+			Carrier_Vec.push_back({ CHUNK.name, Offset_Vec[record], CARRIED, PREFIX });
+			record = end_record;
+		}
+	}
+
+	if (Carrier_Vec.empty()) {
+		return PDV_ERROR::NONE;
+	}
+
+	// ZIP file bytes moved into the carrier chunks (all of them before "CARRIED_SIZE"). Copy them aside, before the start of the image is rebuilt over them.
+	const size_t CARRIED_SIZE = Offset_Vec[record];
+
+	const std::vector<Byte> Carried_Vec(ZIP, ZIP + CARRIED_SIZE);
+
+	size_t added_size = 0;
+
+	for (const CARRIER& CHUNK : Carrier_Vec) {
+		added_size += CHUNK.prefix + (CHUNK.name == ICCP_NAME ? 0 : PNG_CHUNK_VIEW::OVERHEAD);
+	}
+
+	const size_t
+		ICCP_CRC_INDEX = ICCP_CHUNK_INDEX + PNG_CHUNK_VIEW::HEADER_SIZE + ICCP_LENGTH,
+		PLTE_INDEX = ICCP_CHUNK_INDEX + pdv.script_size,	// The image's "PLTE" chunk (PNG-8) or first "IDAT" chunk.
+		OLD_FRONT_SIZE = ZIP_INDEX + CARRIED_SIZE,
+		NEW_FRONT_SIZE = OLD_FRONT_SIZE + added_size;
+
+	// Open room for the new chunks' length, name & CRC fields ("Zip_Buffer" reserved it), just after the carried ZIP file bytes.
+	// Then rebuild the start of the image, from the back: the last "IDAT" chunk's length & name fields, the image's "PLTE" (PNG-8) & "IDAT" chunks,
+	// the "sPLT" carrier chunks, the "iCCP" chunk's CRC field and its carried ZIP file bytes, just after the extraction script (& padding).
+	// Each part only moves towards the end of the image, onto parts already moved, so nothing is overwritten before it is moved.
+	pdv.Image_Vec.insert(pdv.Image_Vec.begin() + OLD_FRONT_SIZE, added_size, 0);
+
+	Byte* const IMAGE = pdv.Image_Vec.data();
+
+	size_t index = NEW_FRONT_SIZE;
+
+	auto Move_Part = [&](size_t part_index, size_t part_size) {
+		index -= part_size;
+		std::move_backward(IMAGE + part_index, IMAGE + part_index + part_size, IMAGE + index + part_size);
+	};
+
+	// An "sPLT" chunk, with a palette name unique within the image ("pdvzip0", "pdvzip1"...), a sample depth of 8 and the carried bytes as its palette entries.
+	auto Write_Carrier = [&](const CARRIER& CHUNK) {
+		const size_t LENGTH = CHUNK.prefix + CHUNK.size;
+
+		index -= LENGTH + PNG_CHUNK_VIEW::OVERHEAD;
+
+		const PNG_CHUNK_VIEW CARRIER_CHUNK(IMAGE + index, LENGTH + PNG_CHUNK_VIEW::OVERHEAD);
+
+		Byte* const DATA = IMAGE + index + PNG_CHUNK_VIEW::HEADER_SIZE;
+
+		const std::string PALETTE_NAME = "pdvzip" + std::to_string(&CHUNK - Carrier_Vec.data());
+
+		CARRIER_CHUNK.Set_Length(static_cast<uint32_t>(LENGTH));
+		CARRIER_CHUNK.Set<uint32_t>(4, CHUNK.name);
+		std::copy(PALETTE_NAME.begin(), PALETTE_NAME.end(), DATA);
+		DATA[SPLT_HEADER_SIZE - 2] = 0;
+		DATA[SPLT_HEADER_SIZE - 1] = 8;
+		std::fill(DATA + SPLT_HEADER_SIZE, DATA + CHUNK.prefix, '.');
+		std::copy_n(Carried_Vec.begin() + CHUNK.from, CHUNK.size, DATA + CHUNK.prefix);
+		CARRIER_CHUNK.Set_Crc(static_cast<uint32_t>(Crc(IMAGE + index + 4, LENGTH + 4)));
+
+		Piece_Vec.push_back({ CHUNK.from, index + PNG_CHUNK_VIEW::HEADER_SIZE + CHUNK.prefix, CHUNK.size });
+	};
+
+	Piece_Vec.assign(1, { CARRIED_SIZE, NEW_FRONT_SIZE, ZIP_SIZE - CARRIED_SIZE });
+
+	Move_Part(idat_zip_index - 4, PNG_CHUNK_VIEW::HEADER_SIZE);
+	Move_Part(PLTE_INDEX, idat_zip_index - 4 - PLTE_INDEX);
+
+	auto carrier = Carrier_Vec.rbegin();
+
+	for (; carrier != Carrier_Vec.rend() && carrier->name != ICCP_NAME; ++carrier) {
+		Write_Carrier(*carrier);
+	}
+
+	// The "iCCP" chunk is extended in place: its padding & carried bytes follow the extraction script, which always ends with an "exit" command, so they are never run.
+	// The piece starts after the padding, at the first local file header, as "Restore_Zip_File" expects.
+	const size_t
+		ICCP_CARRIED_SIZE = carrier != Carrier_Vec.rend() ? carrier->size : 0,
+		ICCP_PADDING = carrier != Carrier_Vec.rend() ? carrier->prefix : 0,
+		ICCP_ADDED_SIZE = ICCP_PADDING + ICCP_CARRIED_SIZE;
+
+	if (ICCP_CARRIED_SIZE) {
+		std::fill_n(IMAGE + ICCP_CRC_INDEX, ICCP_PADDING, '.');
+		std::copy_n(Carried_Vec.begin(), ICCP_CARRIED_SIZE, IMAGE + ICCP_CRC_INDEX + ICCP_PADDING);
+		Piece_Vec.push_back({ 0, ICCP_CRC_INDEX + ICCP_PADDING, ICCP_CARRIED_SIZE });
+	}
+
+	const PNG_CHUNK_VIEW ICCP_CHUNK(IMAGE + ICCP_CHUNK_INDEX, ICCP_CRC_INDEX + ICCP_ADDED_SIZE + 4 - ICCP_CHUNK_INDEX);
+
+	ICCP_CHUNK.Set_Length(static_cast<uint32_t>(ICCP_LENGTH + ICCP_ADDED_SIZE));
+	ICCP_CHUNK.Set_Crc(static_cast<uint32_t>(Crc(IMAGE + ICCP_CHUNK_INDEX + 4, ICCP_LENGTH + ICCP_ADDED_SIZE + 4)));
+
+	std::reverse(Piece_Vec.begin(), Piece_Vec.end());
+
+	// The rest of the ZIP file (at least its trailing records) stays within the last "IDAT" chunk.
+	idat_zip_index = NEW_FRONT_SIZE - 4;
+	pdv.zip_size = ZIP_SIZE - CARRIED_SIZE + 12;
+
+	PNG_CHUNK_VIEW(IMAGE + idat_zip_index - 4, pdv.zip_size).Set_Length(static_cast<uint32_t>(ZIP_SIZE - CARRIED_SIZE));
+
+	if (pdv.Progress) {
+		const std::string MESSAGE = "\nMoved " + std::to_string(CARRIED_SIZE) + " bytes of the ZIP file into " + std::to_string(Carrier_Vec.size()) + " carrier chunk(s).\n";
+		pdv.Progress(MESSAGE.c_str());
+	}
+	return PDV_ERROR::NONE;
+}
+
+PDV_ERROR Add_Zip_Packs(PDV_STRUCT& pdv, size_t& idat_zip_index, std::vector<ZIP_PIECE>& Piece_Vec) {
+
+	if (pdv.Pack_Vec.size() > MAX_PACKS || pdv.Pack_Name_Vec.size() != pdv.Pack_Vec.size()) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	// Build the pack directory first, with the name each pack is listed under (file name part only). Index values are filled in as the packs are placed.
+	std::vector<Byte> Directory_Vec(PACK_DIRECTORY_HEADER_SIZE);
+
+	Store<uint32_t, Endian::Big>(Directory_Vec.data(), PACK_DIRECTORY_SIG);
+	Directory_Vec[4] = PACK_DIRECTORY_VERSION;
+	Directory_Vec[5] = static_cast<Byte>(pdv.Pack_Vec.size());
+
+	std::vector<size_t> Entry_Vec;	// Index of each pack's entry within the directory.
+
+	size_t packs_size = 0;
+
+	for (size_t pack = 0; pack < pdv.Pack_Vec.size(); pack++) {
+		const std::string& PACK_NAME = pdv.Pack_Name_Vec[pack];
+
+		const std::string NAME = PACK_NAME.substr(PACK_NAME.find_last_of("/\\") + 1);
+
+		if (NAME.empty() || NAME.length() > MAX_PACK_NAME_LENGTH) {
+			return PDV_ERROR::ZIP_NAME_LENGTH;
+		}
+
+		Entry_Vec.push_back(Directory_Vec.size());
+		Directory_Vec.resize(Directory_Vec.size() + PACK_ENTRY_SIZE - 1);
+		Store<uint32_t, Endian::Big>(&Directory_Vec[Entry_Vec.back() + 4], static_cast<uint32_t>(pdv.Pack_Vec[pack].size()));
+		Directory_Vec.push_back(static_cast<Byte>(NAME.length()));
+		Directory_Vec.insert(Directory_Vec.end(), NAME.begin(), NAME.end());
+
+		packs_size += PNG_CHUNK_VIEW::OVERHEAD + pdv.Pack_Vec[pack].size();
+	}
+
+	// Open a gap for the packs & the directory, just before the last "IDAT" chunk ("Zip_Buffer" reserved the room).
+	const size_t
+		INSERT_INDEX = idat_zip_index - 4,
+		INSERT_SIZE = packs_size + PNG_CHUNK_VIEW::OVERHEAD + Directory_Vec.size();
+
+	pdv.Image_Vec.insert(pdv.Image_Vec.begin() + INSERT_INDEX, INSERT_SIZE, 0);
+
+	Byte* const IMAGE = pdv.Image_Vec.data();
+
+	size_t chunk_index = INSERT_INDEX;
+
+	auto Write_Idat = [&](const Byte* data, size_t size) {
+		const PNG_CHUNK_VIEW CHUNK(IMAGE + chunk_index, size + PNG_CHUNK_VIEW::OVERHEAD);
+
+		CHUNK.Set_Length(static_cast<uint32_t>(size));
+		CHUNK.Set<uint32_t>(4, IDAT_NAME);
+		std::copy_n(data, size, IMAGE + chunk_index + PNG_CHUNK_VIEW::HEADER_SIZE);
+	};
+
+	for (size_t pack = 0; pack < pdv.Pack_Vec.size(); pack++) {
+		const size_t
+			PACK_INDEX = chunk_index + PNG_CHUNK_VIEW::HEADER_SIZE,
+			PACK_SIZE = pdv.Pack_Vec[pack].size();
+
+		Write_Idat(pdv.Pack_Vec[pack].data(), PACK_SIZE);
+		std::vector<Byte>().swap(pdv.Pack_Vec[pack]);
+
+		// Relocate the pack's offsets, as for the ZIP file, but leave its comment length as it is.
+		ZIP_RECORDS records{};
+
+		PDV_ERROR error = Find_Zip_Records(IMAGE + PACK_INDEX, 0, PACK_SIZE, records, 0);
+
+		if (error == PDV_ERROR::NONE) {
+			error = Relocate_Zip_Records(IMAGE + PACK_INDEX, 0, PACK_SIZE, records, [PACK_INDEX](uint64_t offset) { return PACK_INDEX + offset; }, 0);
+		}
+		if (error != PDV_ERROR::NONE) {
+			return error;
+		}
+
+		const PNG_CHUNK_VIEW CHUNK(IMAGE + chunk_index, PACK_SIZE + PNG_CHUNK_VIEW::OVERHEAD);
+
+		CHUNK.Set_Crc(static_cast<uint32_t>(Crc(IMAGE + chunk_index + 4, PACK_SIZE + 4)));
+
+		Store<uint32_t, Endian::Big>(&Directory_Vec[Entry_Vec[pack]], static_cast<uint32_t>(PACK_INDEX));
+
+		chunk_index += CHUNK.Total_Size();
+	}
+
+	Write_Idat(Directory_Vec.data(), Directory_Vec.size());
+
+	PNG_CHUNK_VIEW(IMAGE + chunk_index, Directory_Vec.size() + PNG_CHUNK_VIEW::OVERHEAD).Set_Crc(static_cast<uint32_t>(Crc(IMAGE + chunk_index + 4, Directory_Vec.size() + 4)));
+
+	pdv.Pack_Vec.clear();
+
+	// The ZIP file's last piece (last "IDAT" chunk) has moved along. Carrier chunk pieces lie before the gap.
+	idat_zip_index += INSERT_SIZE;
+	Piece_Vec.back().to += INSERT_SIZE;
+
+	if (pdv.Progress) {
+		const std::string MESSAGE = "\nEmbedded " + std::to_string(Entry_Vec.size()) + " ZIP pack(s) within the PNG image.\n";
+		pdv.Progress(MESSAGE.c_str());
+	}
+	return PDV_ERROR::NONE;
+}
+
+PDV_ERROR Fix_Zip_Offset(PDV_STRUCT& pdv, const std::vector<ZIP_PIECE>& Piece_Vec) {
+
+	// The user's ZIP file (or the rest of it, after the carrier chunks) starts just after the last "IDAT" chunk's name field. Its offsets are all relative to
+	// the start of the ZIP file, so each offset is mapped to its new index location within vector "Image_Vec" (increased by the ZIP file's index location, if kept whole).
+	const ZIP_PIECE& LAST_PIECE = Piece_Vec.back();
+
+	const size_t ZIP_SIZE = LAST_PIECE.from + LAST_PIECE.size;
+
+	Byte* const WINDOW = &pdv.Image_Vec[LAST_PIECE.to];
+
+	ZIP_RECORDS records{};
+
+	// The trailing records are all within the last piece, so the window is the last piece.
+	PDV_ERROR error = Find_Zip_Records(WINDOW, LAST_PIECE.from, ZIP_SIZE, records, 0);
+
+	if (error == PDV_ERROR::NONE && LAST_PIECE.from > records.first_index) {
+		error = PDV_ERROR::ZIP_CORRUPT;
+	}
+	return error != PDV_ERROR::NONE ? error
+		: Relocate_Zip_Records(WINDOW, LAST_PIECE.from, ZIP_SIZE, records, [&Piece_Vec](uint64_t offset) { return Map_Offset(Piece_Vec, offset); }, 16);
+}
+
+PDV_ERROR Restore_Zip_File(std::vector<Byte>& Zip_Vec, const std::vector<ZIP_PIECE>& Chunk_Vec, int comment_delta) {
+
+	if (Chunk_Vec.empty()) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	// The trailing records lie within the last "IDAT" chunk, where offsets (image index values) and vector index values differ by a constant.
+	// Collect the local file header offsets first, to find where each carrier chunk's piece starts.
+	const ZIP_PIECE& LAST_CHUNK = Chunk_Vec.back();
+
+	std::vector<uint64_t> Offset_Vec;
+
+	ZIP_RECORDS records{};
+
+	PDV_ERROR error = Find_Zip_Records(Zip_Vec.data() + LAST_CHUNK.to, LAST_CHUNK.to, LAST_CHUNK.to + LAST_CHUNK.size, records, LAST_CHUNK.from - LAST_CHUNK.to);
+
+	if (error == PDV_ERROR::NONE && LAST_CHUNK.to > records.first_index) {
+		error = PDV_ERROR::ZIP_CORRUPT;
+	}
+	if (error == PDV_ERROR::NONE) {
+		error = Relocate_Zip_Records(Zip_Vec.data() + LAST_CHUNK.to, LAST_CHUNK.to, LAST_CHUNK.to + LAST_CHUNK.size, records,
+			[&Offset_Vec](uint64_t offset) { Offset_Vec.push_back(offset); return offset; }, 0);
+	}
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	std::sort(Offset_Vec.begin(), Offset_Vec.end());
+
+	// Move the pieces together. A carrier chunk's piece starts at its first local file header (within the "iCCP" chunk, just after the extraction script)
+	// and runs to the end of the chunk. The last "IDAT" chunk is a piece from its start.
+	std::vector<ZIP_PIECE> Piece_Vec;
+
+	uint64_t zip_size = 0;
+
+	for (const ZIP_PIECE& CHUNK : Chunk_Vec) {
+		const bool LAST = &CHUNK == &LAST_CHUNK;
+
+		const auto FIRST_OFFSET = std::lower_bound(Offset_Vec.begin(), Offset_Vec.end(), CHUNK.from);
+
+		if (!LAST && (FIRST_OFFSET == Offset_Vec.end() || *FIRST_OFFSET - CHUNK.from >= CHUNK.size)) {
+			continue;
+		}
+
+		const uint64_t
+			PIECE_INDEX = LAST ? CHUNK.from : *FIRST_OFFSET,
+			PIECE_SIZE = CHUNK.from + CHUNK.size - PIECE_INDEX;
+
+		std::copy_n(Zip_Vec.begin() + (CHUNK.to + PIECE_INDEX - CHUNK.from), PIECE_SIZE, Zip_Vec.begin() + zip_size);
+
+		Piece_Vec.push_back({ PIECE_INDEX, zip_size, PIECE_SIZE });
+		zip_size += PIECE_SIZE;
+	}
+
+	Zip_Vec.resize(zip_size);
+
+	// Now map each offset back to its index within the ZIP file and (for the ZIP file) take the 16 bytes (last "IDAT" chunk's CRC field & "IEND" chunk)
+	// back off the comment length.
+	const ZIP_PIECE& LAST_PIECE = Piece_Vec.back();
+
+	records = {};
+
+	error = Find_Zip_Records(Zip_Vec.data() + LAST_PIECE.to, LAST_PIECE.to, zip_size, records, LAST_PIECE.from - LAST_PIECE.to);
+
+	if (error == PDV_ERROR::NONE && LAST_PIECE.to > records.first_index) {
+		error = PDV_ERROR::ZIP_CORRUPT;
+	}
+	return error != PDV_ERROR::NONE ? error
+		: Relocate_Zip_Records(Zip_Vec.data() + LAST_PIECE.to, LAST_PIECE.to, zip_size, records, [&Piece_Vec](uint64_t offset) { return Map_Offset(Piece_Vec, offset); }, comment_delta);
+}
+
+static PDV_ERROR Find_Zip_Records(Byte* window, size_t window_index, size_t zip_file_size, ZIP_RECORDS& records, uint64_t offset_base) {
+
+	// Record counts, offsets & lengths are all taken from the user's ZIP file, so each record is checked to lie within the window before it is used.
+	// Index values below are relative to the start of the ZIP file. An offset below "offset_base" wraps around, so it fails the same checks as an offset past the end.
+
+	auto At = [window, window_index](uint64_t index) { return window + (index - window_index); };
+
+	if (window_index > zip_file_size || ZIP_END_VIEW::SIZE > zip_file_size - window_index) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	// Search backwards from the end of the ZIP file for the "End Central Directory" record (it can be followed by a ZIP comment).
+	const size_t END_SEARCH_LIMIT = std::max(window_index, zip_file_size - std::min(zip_file_size, ZIP_END_VIEW::SIZE + MAX_ZIP_COMMENT_LENGTH));
+
+	size_t end_central_dir_index = zip_file_size - ZIP_END_VIEW::SIZE;
+
+	while (end_central_dir_index > END_SEARCH_LIMIT && ZIP_END_VIEW(At(end_central_dir_index), zip_file_size - end_central_dir_index).Signature() != ZIP_END_VIEW::SIG) {
+		end_central_dir_index--;
+	}
+
+	const ZIP_END_VIEW END_CENTRAL_DIR(At(end_central_dir_index), zip_file_size - end_central_dir_index);
+
+	if (END_CENTRAL_DIR.Signature() != ZIP_END_VIEW::SIG || END_CENTRAL_DIR.Comment_Length() + size_t{16} > MAX_ZIP_COMMENT_LENGTH) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	records.end_central_dir_index = end_central_dir_index;
+	records.zip_records = END_CENTRAL_DIR.Total_Records();
+	records.central_dir_index = END_CENTRAL_DIR.Dir_Offset() - offset_base;
+	records.offset_base = offset_base;
+	records.zip64 = false;
+
+	// ZIP64 archive. Record count and "Start Central Directory" offset are taken from (and updated within) the ZIP64 End Central Directory record.
+	if (end_central_dir_index >= window_index + ZIP64_LOCATOR_VIEW::SIZE) {
+		const size_t ZIP64_LOCATOR_INDEX = end_central_dir_index - ZIP64_LOCATOR_VIEW::SIZE;
+
+		const ZIP64_LOCATOR_VIEW ZIP64_LOCATOR(At(ZIP64_LOCATOR_INDEX), zip_file_size - ZIP64_LOCATOR_INDEX);
+
+		if (ZIP64_LOCATOR.Signature() == ZIP64_LOCATOR_VIEW::SIG) {
+			const uint64_t ZIP64_END_INDEX = ZIP64_LOCATOR.End_Offset() - offset_base;
+
+			if (ZIP64_END_INDEX > ZIP64_LOCATOR_INDEX || ZIP64_END_VIEW::SIZE > ZIP64_LOCATOR_INDEX - ZIP64_END_INDEX) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+
+			records.zip64 = true;
+			records.zip64_end_index = ZIP64_END_INDEX;
+
+			// The ZIP64 End Central Directory record lies before the window. The caller needs to read more of the ZIP file.
+			if (window_index > ZIP64_END_INDEX) {
+				records.first_index = ZIP64_END_INDEX;
+				return PDV_ERROR::NONE;
+			}
+
+			const ZIP64_END_VIEW ZIP64_END_CENTRAL_DIR(At(ZIP64_END_INDEX), zip_file_size - ZIP64_END_INDEX);
+
+			if (ZIP64_END_CENTRAL_DIR.Signature() != ZIP64_END_VIEW::SIG) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+
+			records.zip_records = ZIP64_END_CENTRAL_DIR.Total_Records();
+			records.central_dir_index = ZIP64_END_CENTRAL_DIR.Dir_Offset() - offset_base;
+		}
+	}
+
+	if (records.central_dir_index > end_central_dir_index) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	records.first_index = records.zip64 ? std::min(records.central_dir_index, records.zip64_end_index) : records.central_dir_index;
+
+	return PDV_ERROR::NONE;
+}
+
+template <typename Map>
+static PDV_ERROR Relocate_Zip_Records(Byte* window, size_t window_index, size_t zip_file_size, const ZIP_RECORDS& records, Map map, int comment_delta) {
+
+	auto At = [window, window_index](uint64_t index) { return window + (index - window_index); };
+
+	constexpr uint32_t ZIP64_VALUE = 0xFFFFFFFF;	// Field value indicating the actual value is stored within a ZIP64 record.
+
+	const size_t END_CENTRAL_DIR_INDEX = records.end_central_dir_index;
+
+	const ZIP_END_VIEW END_CENTRAL_DIR(At(END_CENTRAL_DIR_INDEX), zip_file_size - END_CENTRAL_DIR_INDEX);
+
+	uint64_t
+		zip_records = records.zip_records,
+		central_dir_index = records.central_dir_index;
+
+	const uint64_t CENTRAL_DIR_OFFSET = map(records.offset_base + central_dir_index);
+
+	if (CENTRAL_DIR_OFFSET == NO_OFFSET || END_CENTRAL_DIR.Comment_Length() + comment_delta < 0) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	if (records.zip64) {
+		const uint64_t ZIP64_END_OFFSET = map(records.offset_base + records.zip64_end_index);
+
+		if (ZIP64_END_OFFSET == NO_OFFSET) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+		ZIP64_END_VIEW(At(records.zip64_end_index), zip_file_size - records.zip64_end_index).Set_Dir_Offset(CENTRAL_DIR_OFFSET);
+		ZIP64_LOCATOR_VIEW(At(END_CENTRAL_DIR_INDEX - ZIP64_LOCATOR_VIEW::SIZE), zip_file_size - END_CENTRAL_DIR_INDEX + ZIP64_LOCATOR_VIEW::SIZE)
+			.Set_End_Offset(ZIP64_END_OFFSET);
+	}
+
+	// Write updated "Start Central Directory" offset into End Central Directory's "Start Central Directory" field.
+	if (END_CENTRAL_DIR.Dir_Offset() != ZIP64_VALUE) {
+		END_CENTRAL_DIR.Set_Dir_Offset(static_cast<uint32_t>(CENTRAL_DIR_OFFSET));
+	}
+
+	// Walk the central directory, updating each record's local file header offset to its new location.
+	while (zip_records--) {
+		const ZIP_CENTRAL_VIEW CENTRAL_RECORD(At(central_dir_index), END_CENTRAL_DIR_INDEX - central_dir_index);
+		if (!CENTRAL_RECORD.Fits(0, ZIP_CENTRAL_VIEW::SIZE) || CENTRAL_RECORD.Signature() != ZIP_CENTRAL_VIEW::SIG
+			|| !CENTRAL_RECORD.Fits(0, CENTRAL_RECORD.Total_Size())) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+
+		// Local file headers lie before the central directory ("map" keeps offsets in order, so this also holds for the mapped offsets).
+		if (CENTRAL_RECORD.Local_Offset() != ZIP64_VALUE) {
+			const uint64_t LOCAL_OFFSET = map(CENTRAL_RECORD.Local_Offset());
+
+			if (LOCAL_OFFSET >= CENTRAL_DIR_OFFSET) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+			CENTRAL_RECORD.Set_Local_Offset(static_cast<uint32_t>(LOCAL_OFFSET));
+		}
+		else {
+			// Offset is within the record's ZIP64 extra field, after the uncompressed & compressed sizes (each only present if its 32-bit field is 0xFFFFFFFF).
+			size_t extra_index = ZIP_CENTRAL_VIEW::SIZE + CENTRAL_RECORD.Name_Length();
+
+			const size_t
+				EXTRA_END_INDEX = extra_index + CENTRAL_RECORD.Extra_Length(),
+				OFFSET_INDEX = ZIP_EXTRA_VIEW::SIZE
+					+ (CENTRAL_RECORD.Uncompressed_Size() == ZIP64_VALUE ? 8 : 0)
+					+ (CENTRAL_RECORD.Compressed_Size() == ZIP64_VALUE ? 8 : 0);
+
+			bool zip64_offset_found = false;
+
+			while (!zip64_offset_found && extra_index + ZIP_EXTRA_VIEW::SIZE <= EXTRA_END_INDEX) {
+				const ZIP_EXTRA_VIEW EXTRA(CENTRAL_RECORD.data + extra_index, EXTRA_END_INDEX - extra_index);
+
+				if (EXTRA.Tag() == ZIP_EXTRA_VIEW::ZIP64_TAG && EXTRA.Fits(0, ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size())
+					&& ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size() >= OFFSET_INDEX + 8) {
+					const uint64_t LOCAL_OFFSET = map(EXTRA.Get<uint64_t>(OFFSET_INDEX));
+
+					if (LOCAL_OFFSET >= CENTRAL_DIR_OFFSET) {
+						return PDV_ERROR::ZIP_CORRUPT;
+					}
+					EXTRA.Set<uint64_t>(OFFSET_INDEX, LOCAL_OFFSET);
+					zip64_offset_found = true;
+				}
+				extra_index += ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size();
+			}
+
+			if (!zip64_offset_found) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+		}
+		central_dir_index += CENTRAL_RECORD.Total_Size();
+	}
+
+	// JAR file support. Get global comment length value from ZIP file within vector "Image_Vec" and increase it by 16 bytes to cover end of PNG file.
+	// To run a JAR file, you will need to rename the '.png' extension to '.jar'.  
+	// or run the command: "java -jar image_file_name.png"
+	// ("Restore_Zip_File" takes the 16 bytes back off.)
+
+	END_CENTRAL_DIR.Set_Comment_Length(static_cast<uint16_t>(END_CENTRAL_DIR.Comment_Length() + comment_delta));
+
+	return PDV_ERROR::NONE;
+}
+
+static uint64_t Map_Offset(const std::vector<ZIP_PIECE>& Piece_Vec, uint64_t offset) {
+
+	// Last piece starting at or before the offset.
+	auto piece = std::upper_bound(Piece_Vec.begin(), Piece_Vec.end(), offset, [](uint64_t value, const ZIP_PIECE& PIECE) { return value < PIECE.from; });
+
+	if (piece == Piece_Vec.begin()) {
+		return NO_OFFSET;
+	}
+	--piece;
+
+	return offset - piece->from < piece->size ? piece->to + (offset - piece->from) : NO_OFFSET;
+}
+
+// The following code (slightly modified) to compute CRC32 (for "IDAT" & "iCCP" chunks) was taken from: https://www.w3.org/TR/2003/REC-PNG-20031110/#D-CRCAppendix 
+size_t Crc_Update(const size_t& Crc, Byte* buf, const size_t& len) {
+	// Table of CRCs of all 8-bit messages.
+	constexpr size_t Crc_Table[256]{
+		0x00, 	    0x77073096, 0xEE0E612C, 0x990951BA, 0x76DC419,  0x706AF48F, 0xE963A535, 0x9E6495A3, 0xEDB8832,  0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x9B64C2B,  0x7EB17CBD,
+		0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7, 0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC,
+		0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+		0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59, 0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+		0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x1DB7106,  0x98D220BC, 0xEFD5102A, 0x71B18589, 0x6B6B51F,
+		0x9FBFE4A5, 0xE8B8D433, 0x7807C9A2, 0xF00F934,  0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x86D3D2D,  0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+		0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65, 0x4DB26158, 0x3AB551CE,
+		0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+		0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F, 0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+		0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x3B6E20C,  0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x4DB2615,  0x73DC1683, 0xE3630B12, 0x94643B84, 0xD6D6A3E,  0x7A6A5AA8,
+		0xE40ECF0B, 0x9309FF9D, 0xA00AE27,  0x7D079EB1, 0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0,
+		0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+		0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703,
+		0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D, 0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x26D930A,
+		0x9C0906A9, 0xEB0E363F, 0x72076785, 0x5005713,  0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0xCB61B38,  0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0xBDBDF21,  0x86D3D2D4, 0xF1D4E242,
+		0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777, 0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+		0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5,
+		0x47B2CF7F, 0x30B5FFE9, 0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+		0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D };
+
+	// Update a running CRC with the bytes buf[0..len - 1] the CRC should be initialized to all 1's, 
+	// and the transmitted value is the 1's complement of the final running CRC (see the crc() routine below).
+	size_t c = Crc;
+
+	const uint64_t START_NS = PDV_PROBE_ENABLED(crc) ? Probe_Now_Ns() : 0;
+
+	for (size_t n = 0; n < len; n++) {
+		c = Crc_Table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
+	}
+
+	if (PDV_PROBE_ENABLED(crc)) {
+		PDV_PROBE2(crc, len, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return c;
+}
+
+// Return the CRC of the bytes buf[0..len-1].
+size_t Crc(Byte* buf, const size_t& len)
+{
+	return Crc_Update(0xffffffffL, buf, len) ^ 0xffffffffL;
+}
+
+
+template <typename Run>
+static PDV_ERROR Run_Stage(PDV_STRUCT& pdv, PDV_STAGE stage, Run run) {
+	if (pdv.Stage) {
+		pdv.Stage(pdv, stage, true);
+	}
+
+	PDV_PROBE2(stage__start, static_cast<int>(stage), Stage_Name(stage));
+
+	const uint64_t START_NS = PDV_PROBE_ENABLED(stage__end) ? Probe_Now_Ns() : 0;
+
+	const PDV_ERROR ERROR_FOUND = run();
+
+	if (PDV_PROBE_ENABLED(stage__end)) {
+		PDV_PROBE4(stage__end, static_cast<int>(stage), Stage_Name(stage), static_cast<int>(ERROR_FOUND), START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+
+	if (pdv.Stage) {
+		pdv.Stage(pdv, stage, false);
+	}
+	return ERROR_FOUND;
+}
+
+static bool Chunk_Fits(std::vector<Byte>& vec, size_t index) {
+	if (index >= vec.size()) {
+		return false;
+	}
+	const PNG_CHUNK_VIEW CHUNK(vec, index);
+
+	return CHUNK.Fits(0, PNG_CHUNK_VIEW::OVERHEAD) && CHUNK.Fits(0, CHUNK.Total_Size());
+}
+
+const char* Error_Message(PDV_ERROR error) {
+	switch (error) {
+		case PDV_ERROR::NONE:
+			return "";
+		case PDV_ERROR::IMAGE_TOO_SMALL:
+			return "\nFile Size Error: Invalid PNG image. File too small.\n\n";
+		case PDV_ERROR::ZIP_TOO_SMALL:
+			return "\nFile Size Error: Invalid ZIP file. File too small.\n\n";
+		case PDV_ERROR::FILE_SIZE:
+			return "\nFile Size Error: The combined file size of your PNG image and ZIP file exceeds maximum limit.\n\n";
+		case PDV_ERROR::IMAGE_SIGNATURE:
+			return "\nImage File Error: File does not appear to be a valid PNG image.\n\n";
+		case PDV_ERROR::IHDR_BAD_CHAR:
+			return "\nImage File Error:\n\nThe IHDR chunk of this image contains a character that will break the Linux extraction script."
+				"\nTry modifying image dimensions (1% increase or decrease) to resolve the issue. Repeat if necessary.\n\n";
+		case PDV_ERROR::IMAGE_COLOR_TYPE:
+			return "\nImage File Error: Color type of PNG image is not supported.\n\nPNG-32/24 (Truecolor) or PNG-8 (Indexed Color) only.\n\n";
+		case PDV_ERROR::IMAGE_DIMENSIONS:
+			return "\nImage File Error: Dimensions of PNG image are not within the supported range.\n\nPNG-32/24 Truecolor: [68 x 68]<->[899 x 899]."
+				"\nPNG-8 Indexed Color: [68 x 68]<->[4096 x 4096].\n\n";
+		case PDV_ERROR::IMAGE_CORRUPT:
+			return "\nImage File Error: PNG chunk length extends beyond the end of the image, or image data is invalid. File appears to be corrupt.\n\n";
+		case PDV_ERROR::IDAT_CRC:
+			return "\nImage File Error: CRC value for first IDAT chunk is invalid.\n\n";
+		case PDV_ERROR::PLTE_MISSING:
+			return "\nImage File Error: Required PLTE chunk not found for Indexed-color (PNG-8) image.\n\n";
+		case PDV_ERROR::ZIP_SIGNATURE:
+			return "\nZIP File Error: File does not appear to be a valid ZIP archive.\n\n";
+		case PDV_ERROR::ZIP_NAME_LENGTH:
+			return "\nZIP File Error: \n\nName length of first file within ZIP archive is too short."
+				"\nIncrease its length (minimum 4 characters) and make sure it has a valid extension.\n\n";
+		case PDV_ERROR::ZIP_CORRUPT:
+			return "\nZIP File Error: ZIP archive records are invalid or truncated. File appears to be corrupt.\n\n";
+		case PDV_ERROR::SCRIPT_SIZE:
+			return "\nFile Size Error: Extraction script exceeds size limit.\n\n";
+		case PDV_ERROR::SCRIPT_FILE_SIZE:
+			return "\nFile Size Error: The combined file size of your PNG image, ZIP file and Extraction Script, exceeds file size limit.\n\n";
+		case PDV_ERROR::MEMORY_BUDGET:
+			return "\nMemory Error: Files are too large to process within the memory budget.\n\n";
+		case PDV_ERROR::ZIP_READ:
+			return "\nRead File Error: Unable to read ZIP file.\n\n";
+		case PDV_ERROR::WRITE_OUT:
+			return "\nWrite File Error: Unable to write to file.\n\n";
+		case PDV_ERROR::IMAGE_OPEN:
+			return "\nRead File Error: Unable to open image file.\n\n";
+		case PDV_ERROR::ZIP_OPEN:
+			return "\nRead File Error: Unable to open ZIP file.\n\n";
+		case PDV_ERROR::DEADLINE:
+			return "\nScheduler Error: Job deadline passed before the job could start.\n\n";
+		case PDV_ERROR::IMAGE_COLORS:
+			return "\nImage File Error: PNG-32/24 image has 256 colours or less."
+				"\nPlatforms such as Twitter will convert it to PNG-8 and the embedded content will be lost."
+				"\nUse an image with more colours (e.g. fill an area with a gradient instead of a single solid colour).\n\n";
+		case PDV_ERROR::PACK_NOT_FOUND:
+			return "\nImage File Error: The image has no pack directory, or no pack of that name.\n\n";
+		case PDV_ERROR::ENTRY_NOT_FOUND:
+			return "\nZIP File Error: No entry of that name within the image's ZIP file (or packs, as <pack_name>:<entry_name>).\n\n";
+		case PDV_ERROR::ENTRY_METHOD:
+			return "\nZIP File Error: The entry is encrypted, or uses a compression method other than store or deflate.\n\n";
+		case PDV_ERROR::CATALOG_OPEN:
+			return "\nRead File Error: Unable to open catalog file, or it is invalid. Run --catalog build to (re)build it.\n\n";
+		case PDV_ERROR::DIR_OPEN:
+			return "\nRead File Error: Unable to open directory.\n\n";
+		case PDV_ERROR::COUNT:
+			break;
+	}
+	return "\nError: Unknown error.\n\n";
+}
+
+const char* Error_Name(PDV_ERROR error) {
+	constexpr const char* ERROR_NAMES[]{ "ok", "image_too_small", "zip_too_small", "file_size", "image_signature", "ihdr_bad_char", "image_color_type",
+		"image_dimensions", "image_corrupt", "idat_crc", "plte_missing", "zip_signature", "zip_name_length", "zip_corrupt", "script_size", "script_file_size",
+		"memory_budget", "zip_read", "write_out", "image_open", "zip_open", "deadline", "image_colors", "pack_not_found",
+		"entry_not_found", "entry_method", "catalog_open", "dir_open" };
+
+	static_assert(sizeof(ERROR_NAMES) / sizeof(ERROR_NAMES[0]) == static_cast<size_t>(PDV_ERROR::COUNT), "Error names");
+
+	return error < PDV_ERROR::COUNT ? ERROR_NAMES[static_cast<size_t>(error)] : "unknown";
+}
+
+void Print_Error(const char* format, ...) {
+	std::fflush(stdout);
+
+	va_list args;
+	va_start(args, format);
+	std::vfprintf(stderr, format, args);
+	va_end(args);
+}
+
+const char* Stage_Name(PDV_STAGE stage) {
+	constexpr const char* STAGE_NAMES[]{ "read", "image_reduce", "image_check", "chunk_strip", "zip_check", "script_build", "combine", "offset_fix", "crc", "write" };
+
+	static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(PDV_STAGE::COUNT), "Stage names");
+
+	return stage < PDV_STAGE::COUNT ? STAGE_NAMES[static_cast<size_t>(stage)] : "unknown";
+}
+
+PDV_CARRIERS Carriers_Profile(const std::string& name) {
+	constexpr const char* CARRIER_NAMES[]{ "none", "twitter", "splt" };
+
+	static_assert(sizeof(CARRIER_NAMES) / sizeof(CARRIER_NAMES[0]) == static_cast<size_t>(PDV_CARRIERS::COUNT), "Carrier names");
+
+	size_t profile = 0;
+
+	while (profile < static_cast<size_t>(PDV_CARRIERS::COUNT) && name != CARRIER_NAMES[profile]) {
+		profile++;
+	}
+	return static_cast<PDV_CARRIERS>(profile);
+}
@@ -0,0 +1,220 @@
+// 	PDVZIP core. Embeds a ZIP file (and its extraction script) within a PNG image, entirely in memory.
+
+//	The core performs no file or console I/O and never exits the program. Each stage returns a "PDV_ERROR" value,
+//	checked by "Embed_Zip", which stops at the first failed stage. The caller displays the matching "Error_Message".
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "pdv_records.hpp"
+
+enum class PDV_ERROR {
+	NONE,
+	IMAGE_TOO_SMALL,
+	ZIP_TOO_SMALL,
+	FILE_SIZE,
+	IMAGE_SIGNATURE,
+	IHDR_BAD_CHAR,
+	IMAGE_COLOR_TYPE,
+	IMAGE_DIMENSIONS,
+	IMAGE_CORRUPT,
+	IDAT_CRC,
+	PLTE_MISSING,
+	ZIP_SIGNATURE,
+	ZIP_NAME_LENGTH,
+	ZIP_CORRUPT,
+	SCRIPT_SIZE,
+	SCRIPT_FILE_SIZE,
+	MEMORY_BUDGET,
+	ZIP_READ,
+	WRITE_OUT,
+	IMAGE_OPEN,
+	ZIP_OPEN,
+	DEADLINE,
+	IMAGE_COLORS,
+	PACK_NOT_FOUND,
+	ENTRY_NOT_FOUND,
+	ENTRY_METHOD,
+	CATALOG_OPEN,
+	DIR_OPEN,
+	COUNT
+};
+
+// Carrier chunk profiles ("--carriers"). Each lists the ancillary chunks that a platform preserves & lets you overfill, used by "Fill_Carrier_Chunks"
+// to carry the ZIP file's first local records (ahead of the image's "IDAT" chunks), leaving the rest of the ZIP file in the last "IDAT" chunk.
+enum class PDV_CARRIERS {
+	NONE,
+	TWITTER,	// "iCCP" (after the extraction script, up to 10KB) & up to six "sPLT" chunks.
+	SPLT,		// Up to eight "sPLT" chunks only. "sPLT" is the one free-form chunk the PNG specification allows more than once (each with its own palette name).
+	COUNT
+};
+
+// A run of "size" bytes of the ZIP file, moved from index "from" to index "to" (e.g. from the ZIP file to a carrier chunk within the image).
+// A piece list maps offsets between the two layouts and is sorted by "from". A ZIP file kept whole has a single piece.
+struct ZIP_PIECE {
+	uint64_t from, to, size;
+};
+
+// Pipeline stages, reported to the "Stage" hook. "READ" & "WRITE" are file I/O stages, run by the caller.
+enum class PDV_STAGE {
+	READ,
+	IMAGE_REDUCE,
+	IMAGE_CHECK,
+	CHUNK_STRIP,
+	ZIP_CHECK,
+	SCRIPT_BUILD,
+	COMBINE,
+	OFFSET_FIX,
+	CRC,
+	WRITE,
+	COUNT
+};
+
+struct PDV_STRUCT {
+	const size_t MAX_FILE_SIZE = 209715200;
+	std::vector<Byte> Image_Vec, Zip_Vec, Script_Vec;
+	const std::string BAD_CHAR = "\x22\x27\x28\x29\x3B\x3E\x60";
+	std::string image_name, zip_name, stats_name, trace_name, metrics_name, args_linux, args_windows;
+	size_t image_size{}, zip_size{}, script_size{}, combined_file_size{};
+
+	// Optional hooks for interactive use (both unused when null).
+	// "Progress" receives each status message. "Get_Arguments" is called for file types that accept command-line arguments
+	// (.py, .ps1, .sh & executables) and should fill in "args_linux" & "args_windows".
+	void (*Progress)(const char*) = nullptr;
+	void (*Get_Arguments)(PDV_STRUCT&) = nullptr;
+
+	// Optional instrumentation hook, called with "true" just before and "false" just after each pipeline stage.
+	// With "Embed_Zip_Stream", the CRC is computed as the ZIP file is written out, so its time is reported within the "WRITE" stage.
+	void (*Stage)(PDV_STRUCT&, PDV_STAGE, bool) = nullptr;
+
+	// Streaming hooks, used by "Embed_Zip_Stream" only. "Read_Zip" reads "length" bytes of the ZIP file, from "offset", into the buffer.
+	// "Write_Out" appends bytes to the output image. Both return false on I/O failure.
+	// "zip_stream" & "out_stream" are for the caller's own use (e.g. file handles). The core never touches them.
+	bool (*Read_Zip)(PDV_STRUCT&, Byte*, size_t, size_t) = nullptr;
+	bool (*Write_Out)(PDV_STRUCT&, const Byte*, size_t) = nullptr;
+	void* zip_stream = nullptr, * out_stream = nullptr;
+
+	// Memory budget for this job's buffers, in bytes (0 = no limit). See "Embed_Memory_Size" & "Stream_Memory_Size".
+	size_t max_memory{};
+
+	// Read the job's files & write its output image with direct I/O, bypassing the page cache ("--direct-io", see "pdv_direct.hpp"). Used by "Run_Embed_Job".
+	bool direct_io{};
+
+	// Compute "output_crc", the CRC-32 of the output image, as "Run_Embed_Job" writes it (for the "--resume" journal, see "pdv_journal.hpp").
+	bool hash_output{};
+	uint32_t output_crc{};
+
+	// Losslessly reduce & re-encode the cover image before embedding (see "Reduce_Image_File"), using up to "threads" threads (0 = one per CPU).
+	bool reduce_image{};
+	size_t threads{};
+
+	// Spread the start of the ZIP file across the profile's carrier chunks ("Embed_Zip" only. "Embed_Zip_Stream" keeps the ZIP file whole).
+	PDV_CARRIERS carriers{};
+
+	// Extra ZIP files ("--pack"), each embedded whole within its own "IDAT" chunk, ahead of the ZIP file, and listed within the pack directory
+	// (see "Add_Zip_Packs") under the file name part of its "Pack_Name_Vec" name. "Embed_Zip" only.
+	std::vector<std::vector<Byte>> Pack_Vec;
+	std::vector<std::string> Pack_Name_Vec;
+};
+
+// Pack directory: an "IDAT" chunk just before the last "IDAT" chunk (the ZIP file), with the data field: "PDVD" (signature), version (1 byte),
+// pack count (1 byte), then for each pack: its index within the image & its size (4 bytes each, big-endian, as are the PNG chunk fields),
+// its name length (1 byte) and its name. Each pack is a complete ZIP file, with offsets relative to the start of the image, and no comment length change,
+// so it can be read straight out of the image, without reading the rest.
+constexpr uint32_t PACK_DIRECTORY_SIG = 0x50445644;	// "PDVD"
+
+constexpr Byte PACK_DIRECTORY_VERSION = 1;
+
+constexpr size_t
+	PACK_DIRECTORY_HEADER_SIZE = 6,
+	PACK_ENTRY_SIZE = 9,		// Pack entry, without its name.
+	MAX_PACKS = 255,
+	MAX_PACK_NAME_LENGTH = 255;
+
+size_t
+	// Code to compute CRC32 (for "IDAT" & "iCCP" chunks within this program) is taken from: https://www.w3.org/TR/2003/REC-PNG-20031110/#D-CRCAppendix
+	Crc_Update(const size_t&, Byte*, const size_t&),
+	Crc(Byte*, const size_t&);
+
+PDV_ERROR
+	// Run all stages below, in order, on the PNG image in "Image_Vec" and the ZIP file in "Zip_Vec" (see "Zip_Buffer").
+	// On success, "Image_Vec" contains the complete PNG-ZIP polyglot ("image_size" bytes).
+	Embed_Zip(PDV_STRUCT&),
+	// As "Embed_Zip", but the ZIP file ("zip_file_size" bytes) is never held in memory. Only its first local file header and its trailing records
+	// (central directory onwards) are read into memory, via the "Read_Zip" hook. The polyglot image is written out as it is built, via the "Write_Out" hook.
+	// Fails with "MEMORY_BUDGET" if the trailing records do not fit within "max_memory".
+	Embed_Zip_Stream(PDV_STRUCT&, size_t),
+	// Fill "Image_Vec" with a generated cover image ("--generate-cover"): the smallest valid PNG-24 of the given dimensions (see "Generate_Gradient_Png").
+	// If its IHDR chunk would contain a "BAD_CHAR" character, the nearest larger dimensions without one are used instead (returned in "width" & "height").
+	// Fails with "IMAGE_DIMENSIONS" for dimensions outside the PNG-24 limits.
+	Generate_Cover_Image(PDV_STRUCT&, uint32_t&, uint32_t&),
+	// If "reduce_image" is set, replace a PNG-32/24 cover with its smallest lossless form (no alpha if opaque, 8-bit if exact, PNG-8 if 256 colours or less),
+	// re-encoded, if that is smaller and keeps the image valid for embedding. Never fails: images it can't improve are left for "Check_Image_File".
+	Reduce_Image_File(PDV_STRUCT&),
+	// Various image file checks to make sure image is valid and meets program's requirements.
+	Check_Image_File(PDV_STRUCT&),
+	// Keep critical PNG chunks, remove the rest.
+	Erase_Image_Chunks(PDV_STRUCT&),
+	// Various ZIP file checks to make sure archive is valid and meets program's requirements.
+	Check_Zip_File(PDV_STRUCT&),
+	// Update barebones extraction script determined by embedded ZIP file content.
+	Complete_Extraction_Script(PDV_STRUCT&),
+	// Move the ZIP file's first local records (whole records only) out of the last "IDAT" chunk into the carrier chunks of the "carriers" profile, as many as fit.
+	// Updates the last "IDAT" chunk's index & "zip_size" and adds a piece (see "ZIP_PIECE") for each carrier chunk, ahead of the last "IDAT" chunk's piece.
+	Fill_Carrier_Chunks(PDV_STRUCT&, size_t&, std::vector<ZIP_PIECE>&),
+	// Insert each ZIP pack ("Pack_Vec") as its own "IDAT" chunk, followed by the pack directory, just before the last "IDAT" chunk, relocating each pack's offsets.
+	// Only the ZIP file (last "IDAT" chunk) gets the 16-byte comment length increase, so unzip & Java still find it at the end of the image.
+	// Updates the last "IDAT" chunk's index and its piece. Releases each pack once it is copied.
+	Add_Zip_Packs(PDV_STRUCT&, size_t&, std::vector<ZIP_PIECE>&),
+	// Adjust embedded ZIP file offsets within the PNG image to their new index locations, so that it remains a valid, working ZIP archive.
+	// The pieces map the ZIP file to its index locations within "Image_Vec". Its trailing records lie within the last piece.
+	Fix_Zip_Offset(PDV_STRUCT&, const std::vector<ZIP_PIECE>&),
+	// Rebuild the original ZIP file ("--extract"). The vector holds the data fields of the image's candidate carrier chunks, in image order, then the data field
+	// of its last "IDAT" chunk, each listed as a piece (image index "from", vector index "to"). Chunks without a local file header carry no part of the ZIP file.
+	// The ZIP file's pieces are moved together, its offsets restored & "comment_delta" added to its comment length (-16 bytes for the ZIP file, 0 for a pack),
+	// so the vector becomes the original ZIP file.
+	Restore_Zip_File(std::vector<Byte>&, const std::vector<ZIP_PIECE>&, int comment_delta = -16);
+
+void
+	// Insert contents of vectors storing user ZIP file and the completed extraction script into the vector containing PNG image. This is our PNG-ZIP polyglot.
+	Combine_Vectors(PDV_STRUCT&),
+	// Get CRC value for the last "IDAT" chunk (user's ZIP file) and write it into the chunk's CRC field.
+	Update_Zip_Crc(PDV_STRUCT&, const size_t&);
+
+// Bytes at the start of a PNG image read by "Decode_Memory_Size": the PNG signature & "IHDR" chunk.
+constexpr size_t PNG_HEADER_SIZE = 33;
+
+size_t
+	// Estimated peak size of the buffers used to decode the cover image ("Check_Image_File") and, with "reduce_image", to re-encode it ("Reduce_Image_File"),
+	// from its first "PNG_HEADER_SIZE" bytes (nullptr if the image is shorter) & its file size. 0 for covers that are not decoded (PNG-8, or not a valid PNG-32/24 cover).
+	Decode_Memory_Size(const Byte*, size_t, bool),
+	// Estimated peak size of the buffers used by "Embed_Zip", for a PNG image & ZIP file of the given sizes (in bytes) & the image's "Decode_Memory_Size".
+	Embed_Memory_Size(size_t, size_t, size_t),
+	// Estimated peak size of the buffers used by "Embed_Zip_Stream" for a PNG image of the given size & "Decode_Memory_Size", excluding the ZIP file's trailing records.
+	Stream_Memory_Size(size_t, size_t),
+	// Size of the "IDAT" chunks added by "Add_Zip_Packs" (each pack & the pack directory). 0 without packs.
+	Pack_Chunks_Size(const PDV_STRUCT&);
+
+// Size vector "Zip_Vec" for a ZIP file of "zip_file_size" bytes, framed as an "IDAT" chunk (4-byte length & "IDAT" name fields before it,
+// 4-byte CRC field after it) and set "zip_size". Returns the location the caller should copy/read the ZIP file into.
+// Call it after reading the PNG image into "Image_Vec", so that "Zip_Vec" has room reserved to become the complete polyglot image, without reallocating.
+Byte* Zip_Buffer(PDV_STRUCT&, size_t);
+
+const char
+	// Display text for each error value.
+	* Error_Message(PDV_ERROR),
+	// Short name for each error value (e.g. "ihdr_bad_char"), for reports & metrics labels. "NONE" is "ok".
+	* Error_Name(PDV_ERROR);
+
+// Write an error message (printf format & arguments) to stderr. Stdout is flushed first, as it is fully buffered by the command-line program,
+// so the message always follows the progress messages already shown.
+void Print_Error(const char*, ...) __attribute__((format(printf, 1, 2)));
+
+// Short name for each stage value (e.g. "chunk_strip"), for reports.
+const char* Stage_Name(PDV_STAGE);
+
+// Carrier profile for a "--carriers" name (e.g. "twitter"). Returns "COUNT" for an unknown name.
+PDV_CARRIERS Carriers_Profile(const std::string&);
@@ -0,0 +1,549 @@
+// 	PDVZIP direct I/O. See "pdv_direct.hpp".
+
+#include "pdv_direct.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/aio_abi.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Free blocks kept by the pool, for the next files opened (more are released).
+constexpr size_t MAX_FREE_BLOCKS = 64;
+
+enum class SLOT_STATE {
+	EMPTY,
+	IN_FLIGHT,
+	READY
+};
+
+// A block of the file, read or being read (reading), being filled or written (writing).
+struct DIRECT_SLOT {
+	Byte* block;
+	uint64_t offset;	// File offset of the block.
+	size_t length;		// Bytes read (READY), or bytes to write (filled so far).
+	SLOT_STATE state;
+	bool failed;
+	iocb request;
+};
+
+struct DIRECT_STATE {
+	int fd;
+	bool
+		writing,
+		direct,		// Opened with O_DIRECT (otherwise, through the page cache).
+		failed;
+
+	aio_context_t aio;	// Native AIO context (0: synchronous).
+
+	uint64_t
+		size,		// Reading: file size. Writing: bytes appended.
+		next_offset,	// Reading: offset just after the last read, to tell sequential reads.
+		dropped,	// Writing, through the page cache: bytes written back & dropped from the cache.
+		started;	// Writing, through the page cache: bytes whose write-back has been started.
+
+	size_t fill;		// Writing, O_DIRECT: slot being filled.
+
+	DIRECT_SLOT Slot[DIRECT_QUEUE_DEPTH];
+};
+
+static std::vector<Byte*> Free_Block_Vec;
+static std::mutex pool_mutex;
+
+// Take an aligned block from the pool (or allocate one). Returns nullptr if out of memory.
+static Byte* Take_Block();
+
+// Return a block to the pool.
+static void Return_Block(Byte*);
+
+static void
+	// Start reading ("IOCB_CMD_PREAD") or writing the slot's block, asynchronously if possible (otherwise, it completes before returning).
+	Submit(DIRECT_STATE&, DIRECT_SLOT&, uint16_t),
+	// Wait for at least "min_events" requests to complete, and mark their slots READY.
+	Reap(DIRECT_STATE&, long),
+	// Wait for the slot's request, if any, to complete.
+	Wait(DIRECT_STATE&, DIRECT_SLOT&),
+	// Read ahead: start reading the blocks after "block_offset", within the queue depth, into slots not in use.
+	Read_Ahead(DIRECT_STATE&, uint64_t),
+	// Page cache only: start write-back of the bytes appended so far, and drop the pages already written back.
+	Write_Back(DIRECT_STATE&, bool);
+
+bool Direct_Open(DIRECT_FILE& file, const std::string& file_name, bool writing) {
+	const int FLAGS = writing ? O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC : O_RDONLY | O_CLOEXEC;
+
+	bool direct = true;
+
+	int fd = open(file_name.c_str(), FLAGS | O_DIRECT, 0644);
+
+	if (fd < 0 && errno == EINVAL) {
+		// The file system doesn't support O_DIRECT.
+		direct = false;
+		fd = open(file_name.c_str(), FLAGS, 0644);
+	}
+	if (fd < 0) {
+		return false;
+	}
+
+	struct stat file_stat;
+
+	if (fstat(fd, &file_stat)) {
+		close(fd);
+		return false;
+	}
+
+	DIRECT_STATE* state = new DIRECT_STATE{};
+
+	state->fd = fd;
+	state->writing = writing;
+	state->direct = direct;
+	state->size = writing ? 0 : static_cast<uint64_t>(file_stat.st_size);
+	state->next_offset = UINT64_MAX;
+
+	file.state = state;
+
+	if (!direct) {
+		if (!writing) {
+			posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+		}
+		return true;
+	}
+
+	for (DIRECT_SLOT& slot : state->Slot) {
+		slot.block = Take_Block();
+
+		if (!slot.block) {
+			Direct_Close(file);
+			return false;
+		}
+	}
+
+	// Without a native AIO context, blocks are read & written synchronously (still bypassing the page cache).
+	if (syscall(SYS_io_setup, DIRECT_QUEUE_DEPTH, &state->aio)) {
+		state->aio = 0;
+	}
+	return true;
+}
+
+bool Direct_Read(DIRECT_FILE& file, Byte* buffer, uint64_t offset, size_t length) {
+	DIRECT_STATE& state = *file.state;
+
+	if (offset > state.size || length > state.size - offset) {
+		return false;
+	}
+
+	if (!state.direct) {
+		const uint64_t START = offset;
+
+		while (length) {
+			const ssize_t READ_SIZE = pread(state.fd, buffer, length, static_cast<off_t>(offset));
+
+			if (READ_SIZE < 0 && errno == EINTR) {
+				continue;
+			}
+			if (READ_SIZE <= 0) {
+				return false;
+			}
+			buffer += READ_SIZE;
+			offset += static_cast<uint64_t>(READ_SIZE);
+			length -= static_cast<size_t>(READ_SIZE);
+		}
+		posix_fadvise(state.fd, static_cast<off_t>(START), static_cast<off_t>(offset - START), POSIX_FADV_DONTNEED);
+		return true;
+	}
+
+	// Reading on from where the last read ended (or more than a block at once) is sequential: keep the next blocks in flight.
+	const bool SEQUENTIAL = offset == state.next_offset || length > DIRECT_BLOCK_SIZE;
+
+	state.next_offset = offset + length;
+
+	while (length) {
+		const uint64_t BLOCK_OFFSET = offset / DIRECT_BLOCK_SIZE * DIRECT_BLOCK_SIZE;
+
+		DIRECT_SLOT* slot = nullptr;
+
+		for (DIRECT_SLOT& other : state.Slot) {
+			if (other.state != SLOT_STATE::EMPTY && other.offset == BLOCK_OFFSET) {
+				slot = &other;
+			}
+		}
+
+		if (!slot) {
+			// Use a free slot, or else the slot furthest from this block (the queue depth covers the read-ahead window, so it lies outside of it).
+			slot = &state.Slot[0];
+
+			for (DIRECT_SLOT& other : state.Slot) {
+				if (other.state == SLOT_STATE::EMPTY
+					|| (slot->state != SLOT_STATE::EMPTY && (other.offset < BLOCK_OFFSET ? BLOCK_OFFSET - other.offset : other.offset - BLOCK_OFFSET)
+						> (slot->offset < BLOCK_OFFSET ? BLOCK_OFFSET - slot->offset : slot->offset - BLOCK_OFFSET))) {
+					slot = &other;
+				}
+			}
+			Wait(state, *slot);
+
+			slot->offset = BLOCK_OFFSET;
+			Submit(state, *slot, IOCB_CMD_PREAD);
+		}
+
+		if (SEQUENTIAL) {
+			Read_Ahead(state, BLOCK_OFFSET);
+		}
+
+		Wait(state, *slot);
+
+		const size_t WITHIN = static_cast<size_t>(offset - BLOCK_OFFSET);
+
+		if (slot->failed || WITHIN >= slot->length) {
+			slot->state = SLOT_STATE::EMPTY;
+			return false;
+		}
+
+		const size_t COPY_SIZE = std::min(length, slot->length - WITHIN);
+
+		std::memcpy(buffer, slot->block + WITHIN, COPY_SIZE);
+
+		buffer += COPY_SIZE;
+		offset += COPY_SIZE;
+		length -= COPY_SIZE;
+	}
+	return true;
+}
+
+bool Direct_Write(DIRECT_FILE& file, const Byte* data, size_t length) {
+	DIRECT_STATE& state = *file.state;
+
+	if (state.failed) {
+		return false;
+	}
+
+	if (!state.direct) {
+		while (length) {
+			const ssize_t WRITTEN = write(state.fd, data, length);
+
+			if (WRITTEN < 0 && errno == EINTR) {
+				continue;
+			}
+			if (WRITTEN <= 0) {
+				state.failed = true;
+				return false;
+			}
+			data += WRITTEN;
+			length -= static_cast<size_t>(WRITTEN);
+			state.size += static_cast<uint64_t>(WRITTEN);
+		}
+		// Keep no more than the queue depth's worth of dirty pages: start writing back each full window, drop the one before it.
+		if (state.size - state.started >= DIRECT_BLOCK_SIZE * DIRECT_QUEUE_DEPTH) {
+			Write_Back(state, false);
+		}
+		return true;
+	}
+
+	while (length) {
+		DIRECT_SLOT& slot = state.Slot[state.fill];
+
+		if (slot.state != SLOT_STATE::EMPTY) {
+			// The slot's last block is still being written.
+			Wait(state, slot);
+
+			if (slot.failed) {
+				state.failed = true;
+				return false;
+			}
+			slot.state = SLOT_STATE::EMPTY;
+			slot.length = 0;
+		}
+
+		const size_t COPY_SIZE = std::min(length, DIRECT_BLOCK_SIZE - slot.length);
+
+		std::memcpy(slot.block + slot.length, data, COPY_SIZE);
+
+		if (!slot.length) {
+			slot.offset = state.size;
+		}
+		slot.length += COPY_SIZE;
+		state.size += COPY_SIZE;
+		data += COPY_SIZE;
+		length -= COPY_SIZE;
+
+		if (slot.length == DIRECT_BLOCK_SIZE) {
+			Submit(state, slot, IOCB_CMD_PWRITE);
+			state.fill = (state.fill + 1) % DIRECT_QUEUE_DEPTH;
+		}
+	}
+	return true;
+}
+
+bool Direct_Close(DIRECT_FILE& file) {
+	if (!file.state) {
+		return false;
+	}
+
+	DIRECT_STATE& state = *file.state;
+
+	if (state.writing && state.direct && !state.failed) {
+		DIRECT_SLOT& slot = state.Slot[state.fill];
+
+		// The last block, partly filled: written padded to the alignment, then the file is cut back to its size.
+		if (slot.state == SLOT_STATE::EMPTY && slot.length) {
+			const size_t PADDED = (slot.length + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+
+			std::memset(slot.block + slot.length, 0, PADDED - slot.length);
+			slot.length = PADDED;
+			Submit(state, slot, IOCB_CMD_PWRITE);
+		}
+	}
+
+	// Every request must complete before its block is reused or freed.
+	for (DIRECT_SLOT& slot : state.Slot) {
+		Wait(state, slot);
+		state.failed |= state.writing && slot.failed;
+
+		if (slot.block) {
+			Return_Block(slot.block);
+		}
+	}
+
+	if (state.aio) {
+		syscall(SYS_io_destroy, state.aio);
+	}
+
+	if (state.writing && !state.failed) {
+		if (state.direct) {
+			state.failed = ftruncate(state.fd, static_cast<off_t>(state.size)) != 0;
+		}
+		else {
+			Write_Back(state, true);
+		}
+	}
+
+	const bool CLOSE_OK = !close(state.fd) && !state.failed;
+
+	delete file.state;
+	file.state = nullptr;
+
+	return CLOSE_OK;
+}
+
+size_t Direct_Read_File(const std::string& file_name, Byte* buffer, size_t length) {
+	DIRECT_FILE file;
+
+	if (!Direct_Open(file, file_name, false)) {
+		return 0;
+	}
+
+	const size_t READ_SIZE = static_cast<size_t>(std::min<uint64_t>(length, file.state->size));
+
+	const bool READ_OK = Direct_Read(file, buffer, 0, READ_SIZE);
+
+	Direct_Close(file);
+
+	return READ_OK ? READ_SIZE : 0;
+}
+
+bool Direct_Write_File(const std::string& file_name, const Byte* data, size_t length) {
+	DIRECT_FILE file;
+
+	if (!Direct_Open(file, file_name, true)) {
+		return false;
+	}
+
+	const bool WRITE_OK = Direct_Write(file, data, length);
+
+	return Direct_Close(file) && WRITE_OK;
+}
+
+static Byte* Take_Block() {
+	{
+		const std::lock_guard<std::mutex> LOCK(pool_mutex);
+
+		if (!Free_Block_Vec.empty()) {
+			Byte* block = Free_Block_Vec.back();
+			Free_Block_Vec.pop_back();
+			return block;
+		}
+	}
+
+	void* block = nullptr;
+
+	return posix_memalign(&block, DIRECT_ALIGNMENT, DIRECT_BLOCK_SIZE) ? nullptr : static_cast<Byte*>(block);
+}
+
+static void Return_Block(Byte* block) {
+	{
+		const std::lock_guard<std::mutex> LOCK(pool_mutex);
+
+		if (Free_Block_Vec.size() < MAX_FREE_BLOCKS) {
+			Free_Block_Vec.push_back(block);
+			return;
+		}
+	}
+	std::free(block);
+}
+
+static void Submit(DIRECT_STATE& state, DIRECT_SLOT& slot, uint16_t opcode) {
+	// Reads ask for the whole block (a short read at the end of the file). Writes are always whole blocks, or the padded last one.
+	const size_t LENGTH = opcode == IOCB_CMD_PREAD ? DIRECT_BLOCK_SIZE : slot.length;
+
+	slot.failed = false;
+	slot.state = SLOT_STATE::IN_FLIGHT;
+
+	if (state.aio) {
+		slot.request = iocb{};
+		slot.request.aio_data = static_cast<uint64_t>(&slot - state.Slot);
+		slot.request.aio_lio_opcode = opcode;
+		slot.request.aio_fildes = static_cast<uint32_t>(state.fd);
+		slot.request.aio_buf = reinterpret_cast<uint64_t>(slot.block);
+		slot.request.aio_nbytes = LENGTH;
+		slot.request.aio_offset = static_cast<int64_t>(slot.offset);
+
+		iocb* request = &slot.request;
+
+		if (syscall(SYS_io_submit, state.aio, 1, &request) == 1) {
+			return;
+		}
+	}
+
+	// Synchronously (no AIO context, or the submission failed).
+	size_t done = 0;
+
+	while (done < LENGTH) {
+		const ssize_t DONE_SIZE = opcode == IOCB_CMD_PREAD
+			? pread(state.fd, slot.block + done, LENGTH - done, static_cast<off_t>(slot.offset + done))
+			: pwrite(state.fd, slot.block + done, LENGTH - done, static_cast<off_t>(slot.offset + done));
+
+		if (DONE_SIZE < 0 && errno == EINTR) {
+			continue;
+		}
+		if (DONE_SIZE < 0) {
+			slot.failed = true;
+			break;
+		}
+		if (!DONE_SIZE) {
+			slot.failed = opcode != IOCB_CMD_PREAD;	// End of the file.
+			break;
+		}
+		done += static_cast<size_t>(DONE_SIZE);
+	}
+	slot.length = done;
+	slot.state = SLOT_STATE::READY;
+}
+
+static void Reap(DIRECT_STATE& state, long min_events) {
+	io_event Event_Vec[DIRECT_QUEUE_DEPTH];
+
+	long events;
+
+	do {
+		events = syscall(SYS_io_getevents, state.aio, min_events, static_cast<long>(DIRECT_QUEUE_DEPTH), Event_Vec, nullptr);
+	} while (events < 0 && errno == EINTR);
+
+	for (long event = 0; event < events; event++) {
+		DIRECT_SLOT& slot = state.Slot[Event_Vec[event].data];
+
+		slot.failed = Event_Vec[event].res < 0 || (slot.request.aio_lio_opcode == IOCB_CMD_PWRITE && static_cast<uint64_t>(Event_Vec[event].res) != slot.request.aio_nbytes);
+		slot.length = slot.failed ? 0 : static_cast<size_t>(Event_Vec[event].res);
+		slot.state = SLOT_STATE::READY;
+	}
+	if (events < 0) {
+		// The context is unusable. Fail the requests still in flight rather than wait for them forever.
+		for (DIRECT_SLOT& slot : state.Slot) {
+			if (slot.state == SLOT_STATE::IN_FLIGHT) {
+				slot.failed = true;
+				slot.state = SLOT_STATE::READY;
+			}
+		}
+	}
+}
+
+static void Wait(DIRECT_STATE& state, DIRECT_SLOT& slot) {
+	while (slot.state == SLOT_STATE::IN_FLIGHT) {
+		Reap(state, 1);
+	}
+}
+
+static void Read_Ahead(DIRECT_STATE& state, uint64_t block_offset) {
+	for (size_t ahead = 1; ahead < DIRECT_QUEUE_DEPTH; ahead++) {
+		const uint64_t AHEAD_OFFSET = block_offset + ahead * DIRECT_BLOCK_SIZE;
+
+		if (AHEAD_OFFSET >= state.size) {
+			return;
+		}
+
+		bool found = false;
+
+		DIRECT_SLOT* free_slot = nullptr;
+
+		for (DIRECT_SLOT& slot : state.Slot) {
+			found |= slot.state != SLOT_STATE::EMPTY && slot.offset == AHEAD_OFFSET;
+
+			// A slot is free if empty, or holding a block behind this one (already used). Never wait here for one still in flight.
+			if (!free_slot && (slot.state == SLOT_STATE::EMPTY || (slot.state == SLOT_STATE::READY && slot.offset < block_offset))) {
+				free_slot = &slot;
+			}
+		}
+		if (found) {
+			continue;
+		}
+		if (!free_slot) {
+			return;
+		}
+		free_slot->offset = AHEAD_OFFSET;
+		Submit(state, *free_slot, IOCB_CMD_PREAD);
+	}
+}
+
+static void Write_Back(DIRECT_STATE& state, bool finish) {
+	// Wait for (and drop) the window whose write-back was started last time, then start the write-back of the new one.
+	// When finishing, wait for it all.
+	if (state.started > state.dropped) {
+		sync_file_range(state.fd, static_cast<off_t>(state.dropped), static_cast<off_t>(state.started - state.dropped),
+			SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+		posix_fadvise(state.fd, static_cast<off_t>(state.dropped), static_cast<off_t>(state.started - state.dropped), POSIX_FADV_DONTNEED);
+		state.dropped = state.started;
+	}
+	if (state.size > state.started) {
+		sync_file_range(state.fd, static_cast<off_t>(state.started), static_cast<off_t>(state.size - state.started),
+			finish ? SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER : SYNC_FILE_RANGE_WRITE);
+		state.started = state.size;
+	}
+	if (finish && state.started > state.dropped) {
+		posix_fadvise(state.fd, static_cast<off_t>(state.dropped), static_cast<off_t>(state.started - state.dropped), POSIX_FADV_DONTNEED);
+		state.dropped = state.started;
+	}
+}
+
+#else
+
+bool Direct_Open(DIRECT_FILE&, const std::string&, bool) {
+	return false;
+}
+
+bool Direct_Read(DIRECT_FILE&, Byte*, uint64_t, size_t) {
+	return false;
+}
+
+bool Direct_Write(DIRECT_FILE&, const Byte*, size_t) {
+	return false;
+}
+
+bool Direct_Close(DIRECT_FILE&) {
+	return false;
+}
+
+size_t Direct_Read_File(const std::string&, Byte*, size_t) {
+	return 0;
+}
+
+bool Direct_Write_File(const std::string&, const Byte*, size_t) {
+	return false;
+}
+
+#endif
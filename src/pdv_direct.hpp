@@ -0,0 +1,45 @@
+// 	PDVZIP direct I/O ("--direct-io"), for batch runs that read each cover image & ZIP file once and write each output image once. Linux only.
+
+//	Files are opened with O_DIRECT, so their data bypasses the page cache: a large batch run no longer fills the cache with data it never reuses
+//	(evicting other services' hot data). All I/O goes through 1 MB blocks aligned for O_DIRECT, taken from a process-wide pool
+//	(so a batch's buffers are allocated once, not per job), and is submitted asynchronously with Linux native AIO ("io_submit"):
+//	once a file is read sequentially, the next blocks are already being read while the current one is used (O_DIRECT has no kernel read-ahead),
+//	and written blocks are queued to the device while the next ones are filled. Each open file uses up to "DIRECT_QUEUE_DEPTH" blocks.
+
+//	Where O_DIRECT isn't supported (e.g. some network & FUSE file systems) the file is read & written through the page cache instead,
+//	and the pages are dropped ("posix_fadvise(POSIX_FADV_DONTNEED)") as soon as they are read, or written back ("sync_file_range").
+//	Without native AIO (e.g. "aio-max-nr" reached), the blocks are read & written synchronously.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "pdv_core.hpp"
+
+constexpr size_t
+	DIRECT_BLOCK_SIZE = 1024 * 1024,	// Block size for all I/O (a multiple of the O_DIRECT alignment).
+	DIRECT_ALIGNMENT = 4096,		// Alignment of O_DIRECT buffers, file offsets & lengths (covers 512 & 4096 byte logical blocks).
+	DIRECT_QUEUE_DEPTH = 4;		// Blocks per open file (read ahead, or queued for writing).
+
+// A file open for direct I/O. For reading (any offsets, fastest in ascending order) or writing (appended, in order).
+struct DIRECT_FILE {
+	struct DIRECT_STATE* state = nullptr;
+};
+
+bool
+	// Open the named file for reading, or create (truncate) it for writing. Returns false if it can't be opened.
+	Direct_Open(DIRECT_FILE&, const std::string&, bool),
+	// Read "length" bytes, from "offset", into the buffer. Returns false on a read error or past the end of the file.
+	Direct_Read(DIRECT_FILE&, Byte*, uint64_t, size_t),
+	// Append bytes to the file. Returns false on a write error (the file is then only closed).
+	Direct_Write(DIRECT_FILE&, const Byte*, size_t),
+	// Finish writing (the last block, then the file is cut to its size) & close the file. Returns false if a write failed. The file is closed either way.
+	Direct_Close(DIRECT_FILE&);
+
+// Read the named file, from its start, into the buffer (up to "length" bytes). Returns the number of bytes read (0 on failure).
+size_t Direct_Read_File(const std::string&, Byte*, size_t);
+
+// Write the named file from the buffer. Returns false on failure.
+bool Direct_Write_File(const std::string&, const Byte*, size_t);
@@ -0,0 +1,479 @@
+// 	PDVZIP extractor. See "pdv_extract.hpp".
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#ifdef __linux__
+#include <climits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#endif
+
+#include "pdv_extract.hpp"
+
+// Names of the chunks that can carry part of the ZIP file (see "PDV_CARRIERS"), besides the last "IDAT" chunk.
+constexpr uint32_t CARRIER_NAMES[]{
+	0x69434350,	// "iCCP"
+	0x73504C54	// "sPLT"
+};
+
+constexpr uint32_t
+	IDAT_NAME = 0x49444154,
+	IEND_NAME = 0x49454E44;
+
+// "Read_Parts" for an image held in memory.
+static bool Read_Data_Parts(const IMAGE_FILE&, uint64_t, std::vector<READ_PART>&);
+
+static PDV_ERROR
+	// Map the image's chunks (see "Read_Chunk_Table"). List the data field of each chunk that can carry part of the ZIP file (image index "from" & "size")
+	// in "Chunk_Vec", and of the last two "IDAT" chunks (ZIP file & pack directory, if any).
+	Map_Chunks(IMAGE_FILE&, std::vector<ZIP_PIECE>&, ZIP_PIECE&, ZIP_PIECE&),
+	// Read the data fields of the chunks that can carry part of the ZIP file into "Zip_Vec" (see "Restore_Zip_File"), listing each one in "Chunk_Vec".
+	Read_Carrier_Chunks(IMAGE_FILE&, std::vector<Byte>&, std::vector<ZIP_PIECE>&),
+	// Find the named pack within the pack directory and read it (only it) into "Zip_Vec", listing it in "Chunk_Vec".
+	Read_Pack(IMAGE_FILE&, const std::string&, std::vector<Byte>&, std::vector<ZIP_PIECE>&);
+
+PDV_ERROR Extract_Zip_File(const std::string& image_name, const std::string& zip_name, const std::string& pack_name, size_t& zip_size) {
+
+	IMAGE_FILE image;
+
+	if (!Open_Image(image, image_name)) {
+		return PDV_ERROR::IMAGE_OPEN;
+	}
+
+	std::vector<Byte> Zip_Vec;
+
+	const PDV_ERROR ERROR_FOUND = Read_Zip_Image(image, pack_name, Zip_Vec);
+
+	Close_Image(image);
+
+	if (ERROR_FOUND != PDV_ERROR::NONE) {
+		return ERROR_FOUND;
+	}
+
+	std::FILE* zip_ofs = std::fopen(zip_name.c_str(), "wb");
+
+	if (!zip_ofs) {
+		return PDV_ERROR::WRITE_OUT;
+	}
+
+	const bool
+		WRITE_OK = std::fwrite(Zip_Vec.data(), 1, Zip_Vec.size(), zip_ofs) == Zip_Vec.size(),
+		CLOSE_OK = !std::fclose(zip_ofs);
+
+	if (!WRITE_OK || !CLOSE_OK) {
+		std::remove(zip_name.c_str());
+		return PDV_ERROR::WRITE_OUT;
+	}
+
+	zip_size = Zip_Vec.size();
+
+	return PDV_ERROR::NONE;
+}
+
+PDV_ERROR Read_Zip_Image(IMAGE_FILE& image, const std::string& pack_name, std::vector<Byte>& Zip_Vec) {
+
+	std::vector<ZIP_PIECE> Chunk_Vec;
+
+	Zip_Vec.clear();
+
+	const PDV_ERROR ERROR_FOUND = pack_name.empty() ? Read_Carrier_Chunks(image, Zip_Vec, Chunk_Vec) : Read_Pack(image, pack_name, Zip_Vec, Chunk_Vec);
+
+	// Packs are stored whole and their comment length was left as it is.
+	return ERROR_FOUND != PDV_ERROR::NONE ? ERROR_FOUND : Restore_Zip_File(Zip_Vec, Chunk_Vec, pack_name.empty() ? -16 : 0);
+}
+
+PDV_ERROR Read_Chunk_Table(IMAGE_FILE& image, std::vector<IMAGE_CHUNK>& Table_Vec) {
+
+	constexpr Byte PNG_SIG[]{ 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	Byte header[PNG_CHUNK_VIEW::HEADER_SIZE];
+
+	std::vector<READ_PART> Part_Vec{ { header, sizeof(header) } };
+
+	if (image.size < sizeof(PNG_SIG) || !Read_Parts(image, 0, Part_Vec) || !std::equal(PNG_SIG, PNG_SIG + sizeof(PNG_SIG), header)) {
+		return PDV_ERROR::IMAGE_SIGNATURE;
+	}
+
+	// Walk the chunks, reading only their length & name fields. Chunk lengths are untrusted input, so each chunk is checked to lie within the image.
+	uint64_t chunk_index = sizeof(PNG_SIG);
+
+	while (true) {
+		if (chunk_index > image.size || PNG_CHUNK_VIEW::OVERHEAD > image.size - chunk_index) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		Part_Vec.assign(1, { header, sizeof(header) });
+
+		if (!Read_Parts(image, chunk_index, Part_Vec)) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		const PNG_CHUNK_VIEW CHUNK(header, sizeof(header));
+
+		const uint64_t
+			DATA_INDEX = chunk_index + PNG_CHUNK_VIEW::HEADER_SIZE,
+			LENGTH = CHUNK.Length();
+
+		if (LENGTH > image.size - chunk_index - PNG_CHUNK_VIEW::OVERHEAD) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+		Table_Vec.push_back({ DATA_INDEX, static_cast<uint32_t>(LENGTH), CHUNK.Name() });
+
+		if (CHUNK.Name() == IEND_NAME) {
+			return PDV_ERROR::NONE;
+		}
+		chunk_index = DATA_INDEX + LENGTH + 4;
+	}
+}
+
+static PDV_ERROR Map_Chunks(IMAGE_FILE& image, std::vector<ZIP_PIECE>& Chunk_Vec, ZIP_PIECE& last_idat, ZIP_PIECE& directory_idat) {
+
+	std::vector<IMAGE_CHUNK> Table_Vec;
+
+	const PDV_ERROR ERROR_FOUND = Read_Chunk_Table(image, Table_Vec);
+
+	if (ERROR_FOUND != PDV_ERROR::NONE) {
+		return ERROR_FOUND;
+	}
+
+	for (const IMAGE_CHUNK& CHUNK : Table_Vec) {
+		if (CHUNK.name == IDAT_NAME) {
+			directory_idat = last_idat;
+			last_idat = { CHUNK.index, 0, CHUNK.length };
+		}
+		else if (std::find(std::begin(CARRIER_NAMES), std::end(CARRIER_NAMES), CHUNK.name) != std::end(CARRIER_NAMES)) {
+			Chunk_Vec.push_back({ CHUNK.index, 0, CHUNK.length });
+		}
+	}
+
+	// The ZIP file (or the rest of it) is within the last "IDAT" chunk, after the image's own "IDAT" chunks.
+	return last_idat.size ? PDV_ERROR::NONE : PDV_ERROR::ZIP_SIGNATURE;
+}
+
+static PDV_ERROR Read_Carrier_Chunks(IMAGE_FILE& image, std::vector<Byte>& Zip_Vec, std::vector<ZIP_PIECE>& Chunk_Vec) {
+
+	ZIP_PIECE last_idat{}, directory_idat{};
+
+	const PDV_ERROR ERROR_FOUND = Map_Chunks(image, Chunk_Vec, last_idat, directory_idat);
+
+	if (ERROR_FOUND != PDV_ERROR::NONE) {
+		return ERROR_FOUND;
+	}
+
+	Chunk_Vec.push_back(last_idat);
+
+	uint64_t zip_index = 0;
+
+	for (ZIP_PIECE& chunk : Chunk_Vec) {
+		chunk.to = zip_index;
+		zip_index += chunk.size;
+	}
+
+	Zip_Vec.resize(zip_index);
+
+	std::vector<READ_PART> Part_Vec;
+
+	// Read each run of adjacent chunks at once. Their data fields go into "Zip_Vec", one after the other. The CRC field of each chunk
+	// and the length & name fields of the next one (12 bytes, between data fields) go aside, into "skip".
+	Byte skip[PNG_CHUNK_VIEW::OVERHEAD];
+
+	size_t chunk = 0;
+
+	while (chunk < Chunk_Vec.size()) {
+		const uint64_t RUN_INDEX = Chunk_Vec[chunk].from;
+
+		Part_Vec.assign(1, { Zip_Vec.data() + Chunk_Vec[chunk].to, Chunk_Vec[chunk].size });
+
+		while (chunk + 1 < Chunk_Vec.size() && Chunk_Vec[chunk + 1].from == Chunk_Vec[chunk].from + Chunk_Vec[chunk].size + PNG_CHUNK_VIEW::OVERHEAD) {
+			chunk++;
+			Part_Vec.push_back({ skip, sizeof(skip) });
+			Part_Vec.push_back({ Zip_Vec.data() + Chunk_Vec[chunk].to, Chunk_Vec[chunk].size });
+		}
+		chunk++;
+
+		if (!Read_Parts(image, RUN_INDEX, Part_Vec)) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+	}
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Read_Pack(IMAGE_FILE& image, const std::string& pack_name, std::vector<Byte>& Zip_Vec, std::vector<ZIP_PIECE>& Chunk_Vec) {
+
+	ZIP_PIECE last_idat{}, directory_idat{};
+
+	std::vector<ZIP_PIECE> Carrier_Vec;
+
+	std::vector<PACK_ENTRY> Pack_Vec;
+
+	PDV_ERROR error = Map_Chunks(image, Carrier_Vec, last_idat, directory_idat);
+
+	if (error == PDV_ERROR::NONE) {
+		error = Read_Pack_Directory(image, { directory_idat.from, static_cast<uint32_t>(directory_idat.size), IDAT_NAME }, Pack_Vec);
+	}
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	for (const PACK_ENTRY& PACK : Pack_Vec) {
+		if (PACK.name == pack_name) {
+			Zip_Vec.resize(PACK.size);
+			Chunk_Vec.assign(1, { PACK.index, 0, PACK.size });
+
+			std::vector<READ_PART> Part_Vec{ { Zip_Vec.data(), Zip_Vec.size() } };
+
+			return Read_Parts(image, PACK.index, Part_Vec) ? PDV_ERROR::NONE : PDV_ERROR::IMAGE_CORRUPT;
+		}
+	}
+	return PDV_ERROR::PACK_NOT_FOUND;
+}
+
+PDV_ERROR Read_Pack_Directory(IMAGE_FILE& image, const IMAGE_CHUNK& directory, std::vector<PACK_ENTRY>& Pack_Vec) {
+
+	// The pack directory's size is bounded by the pack count & name lengths, so it is never large.
+	constexpr size_t MAX_DIRECTORY_SIZE = PACK_DIRECTORY_HEADER_SIZE + MAX_PACKS * (PACK_ENTRY_SIZE + MAX_PACK_NAME_LENGTH);
+
+	if (directory.name != IDAT_NAME || directory.length < PACK_DIRECTORY_HEADER_SIZE || directory.length > MAX_DIRECTORY_SIZE) {
+		return PDV_ERROR::PACK_NOT_FOUND;
+	}
+
+	std::vector<Byte> Directory_Vec(directory.length);
+
+	std::vector<READ_PART> Part_Vec{ { Directory_Vec.data(), Directory_Vec.size() } };
+
+	if (!Read_Parts(image, directory.index, Part_Vec)) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+	if (Load<uint32_t, Endian::Big>(Directory_Vec.data()) != PACK_DIRECTORY_SIG || Directory_Vec[4] != PACK_DIRECTORY_VERSION) {
+		return PDV_ERROR::PACK_NOT_FOUND;
+	}
+
+	// Entries are untrusted input, so each is checked to lie within the directory, and its pack within the image.
+	size_t
+		entry_index = PACK_DIRECTORY_HEADER_SIZE,
+		packs = Directory_Vec[5];
+
+	while (packs--) {
+		if (entry_index + PACK_ENTRY_SIZE > Directory_Vec.size()
+			|| Directory_Vec[entry_index + PACK_ENTRY_SIZE - 1] > Directory_Vec.size() - entry_index - PACK_ENTRY_SIZE) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		const size_t NAME_LENGTH = Directory_Vec[entry_index + PACK_ENTRY_SIZE - 1];
+
+		const uint64_t
+			PACK_INDEX = Load<uint32_t, Endian::Big>(&Directory_Vec[entry_index]),
+			PACK_SIZE = Load<uint32_t, Endian::Big>(&Directory_Vec[entry_index + 4]);
+
+		if (PACK_INDEX > image.size || PACK_SIZE > image.size - PACK_INDEX) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		const char* NAME = reinterpret_cast<const char*>(&Directory_Vec[entry_index + PACK_ENTRY_SIZE]);
+
+		Pack_Vec.push_back({ std::string(NAME, NAME_LENGTH), PACK_INDEX, PACK_SIZE });
+
+		entry_index += PACK_ENTRY_SIZE + NAME_LENGTH;
+	}
+	return PDV_ERROR::NONE;
+}
+
+#ifdef __linux__
+
+bool Open_Image(IMAGE_FILE& image, const std::string& image_name) {
+	image.fd = open(image_name.c_str(), O_RDONLY | O_CLOEXEC);
+
+	struct stat image_stat;
+
+	if (image.fd < 0 || fstat(image.fd, &image_stat)) {
+		Close_Image(image);
+		return false;
+	}
+	image.size = static_cast<uint64_t>(image_stat.st_size);
+	image.mtime = static_cast<uint64_t>(image_stat.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(image_stat.st_mtim.tv_nsec);
+	return true;
+}
+
+bool Read_Parts(IMAGE_FILE& image, uint64_t index, std::vector<READ_PART>& Part_Vec) {
+	if (image.data) {
+		return Read_Data_Parts(image, index, Part_Vec);
+	}
+
+	std::vector<iovec> Iov_Vec;
+
+	size_t part = 0;
+
+	while (true) {
+		while (part < Part_Vec.size() && !Part_Vec[part].size) {
+			part++;
+		}
+		if (part == Part_Vec.size()) {
+			return true;
+		}
+
+		Iov_Vec.clear();
+
+		for (size_t iov = part; iov < Part_Vec.size() && Iov_Vec.size() < IOV_MAX; iov++) {
+			Iov_Vec.push_back({ Part_Vec[iov].buffer, Part_Vec[iov].size });
+		}
+
+		ssize_t read_size = preadv(image.fd, Iov_Vec.data(), static_cast<int>(Iov_Vec.size()), static_cast<off_t>(index));
+
+		if (read_size <= 0) {
+			return false;
+		}
+		index += read_size;
+
+		// Consume the parts read, then carry on from within a part cut short.
+		while (read_size && static_cast<size_t>(read_size) >= Part_Vec[part].size) {
+			read_size -= Part_Vec[part++].size;
+		}
+		if (read_size) {
+			Part_Vec[part].buffer += read_size;
+			Part_Vec[part].size -= read_size;
+		}
+	}
+}
+
+void Close_Image(IMAGE_FILE& image) {
+	if (image.fd >= 0) {
+		close(image.fd);
+		image.fd = -1;
+	}
+	image.data = nullptr;
+}
+
+bool Map_File(MAPPED_FILE& file, const std::string& file_name) {
+	const int FD = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+
+	struct stat file_stat;
+
+	if (FD < 0) {
+		return false;
+	}
+	if (fstat(FD, &file_stat) || !file_stat.st_size) {
+		close(FD);
+		return false;
+	}
+
+	void* map = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, FD, 0);
+
+	close(FD);
+
+	if (map == MAP_FAILED) {
+		return false;
+	}
+	file.data = static_cast<Byte*>(map);
+	file.size = static_cast<size_t>(file_stat.st_size);
+	file.mapped = true;
+	return true;
+}
+
+void Unmap_File(MAPPED_FILE& file) {
+	if (file.mapped) {
+		munmap(file.data, file.size);
+	}
+	file.data = nullptr;
+	file.size = 0;
+	file.mapped = false;
+	file.File_Vec.clear();
+}
+
+#else
+
+bool Open_Image(IMAGE_FILE& image, const std::string& image_name) {
+	image.stream = std::fopen(image_name.c_str(), "rb");
+
+	if (!image.stream) {
+		return false;
+	}
+	std::fseek(image.stream, 0, SEEK_END);
+	image.size = std::ftell(image.stream);
+
+	std::error_code error;
+
+	image.mtime = static_cast<uint64_t>(std::filesystem::last_write_time(image_name, error).time_since_epoch().count());
+	return true;
+}
+
+// No vectored reads: read each part in turn.
+bool Read_Parts(IMAGE_FILE& image, uint64_t index, std::vector<READ_PART>& Part_Vec) {
+	if (image.data) {
+		return Read_Data_Parts(image, index, Part_Vec);
+	}
+	if (std::fseek(image.stream, static_cast<long>(index), SEEK_SET)) {
+		return false;
+	}
+	for (const READ_PART& PART : Part_Vec) {
+		if (std::fread(PART.buffer, 1, PART.size, image.stream) != PART.size) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void Close_Image(IMAGE_FILE& image) {
+	if (image.stream) {
+		std::fclose(image.stream);
+		image.stream = nullptr;
+	}
+	image.data = nullptr;
+}
+
+bool Map_File(MAPPED_FILE& file, const std::string& file_name) {
+	std::FILE* file_ifs = std::fopen(file_name.c_str(), "rb");
+
+	if (!file_ifs) {
+		return false;
+	}
+	std::fseek(file_ifs, 0, SEEK_END);
+	file.File_Vec.resize(static_cast<size_t>(std::max(0L, std::ftell(file_ifs))));
+	std::fseek(file_ifs, 0, SEEK_SET);
+
+	const bool READ_OK = std::fread(file.File_Vec.data(), 1, file.File_Vec.size(), file_ifs) == file.File_Vec.size();
+
+	std::fclose(file_ifs);
+
+	if (!READ_OK || file.File_Vec.empty()) {
+		file.File_Vec.clear();
+		return false;
+	}
+	file.data = file.File_Vec.data();
+	file.size = file.File_Vec.size();
+	return true;
+}
+
+void Unmap_File(MAPPED_FILE& file) {
+	file.data = nullptr;
+	file.size = 0;
+	file.File_Vec.clear();
+}
+
+#endif
+
+void Open_Image_Data(IMAGE_FILE& image, const Byte* data, size_t size) {
+	image.data = data;
+	image.size = size;
+	image.mtime = 0;
+}
+
+static bool Read_Data_Parts(const IMAGE_FILE& image, uint64_t index, std::vector<READ_PART>& Part_Vec) {
+	for (READ_PART& part : Part_Vec) {
+		if (index > image.size || part.size > image.size - index) {
+			return false;
+		}
+		std::copy_n(image.data + index, part.size, part.buffer);
+		index += part.size;
+		part.buffer += part.size;
+		part.size = 0;
+	}
+	return true;
+}
@@ -0,0 +1,93 @@
+// 	PDVZIP extractor ("--extract <image> <zip_file> [<pack_name>]"). Writes out the original ZIP file embedded within a pdvzip image, or one of its packs.
+
+//	Works with images written with carrier chunks ("--carriers"), where the start of the ZIP file is spread across ancillary chunks
+//	ahead of the image's "IDAT" chunks, as well as with images holding the whole ZIP file within the last "IDAT" chunk.
+
+//	Only the chunk headers are read to map the image, then only the chunks that can carry part of the ZIP file ("iCCP", "sPLT" & the last "IDAT" chunk).
+//	Each run of adjacent chunks is read with a single vectored read (Linux "preadv"), which scatters the chunks' data fields together into one buffer
+//	and their length, name & CRC fields aside, so the pieces are reassembled as they are read.
+//	The image's own "IDAT" chunks are skipped over, never read. "Restore_Zip_File" then rebuilds the ZIP file within the buffer.
+
+//	A pack ("--pack") is found through the pack directory (the "IDAT" chunk just before the last one), then read with a single read of its own bytes,
+//	so neither the primary ZIP file nor the other packs are read.
+
+//	The image file reads, file maps & chunk table below are shared with the sidecar index ("pdv_index.hpp") & catalog ("pdv_catalog.hpp").
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "pdv_core.hpp"
+
+// The image file being read, its size and its last modification time (nanoseconds since the epoch).
+// Or, with "data" set (see "Open_Image_Data"), an image already in memory (e.g. a caller's buffer), read in place of the file.
+struct IMAGE_FILE {
+#ifdef __linux__
+	int fd = -1;
+#else
+	std::FILE* stream = nullptr;
+#endif
+	uint64_t size{}, mtime{};
+	const Byte* data = nullptr;
+};
+
+// Part of a vectored read: "size" bytes into "buffer".
+struct READ_PART {
+	Byte* buffer;
+	size_t size;
+};
+
+// A whole file, memory mapped (Linux, read-only), or read into "File_Vec".
+struct MAPPED_FILE {
+	Byte* data = nullptr;
+	size_t size{};
+	std::vector<Byte> File_Vec;
+	bool mapped{};
+};
+
+// A chunk of the image: the index of its data field, its length & name.
+struct IMAGE_CHUNK {
+	uint64_t index;
+	uint32_t length, name;
+};
+
+// A pack listed within the pack directory (see "PACK_DIRECTORY_SIG"): its name, index within the image & size.
+struct PACK_ENTRY {
+	std::string name;
+	uint64_t index, size;
+};
+
+// Extract the ZIP file from the named image (the primary ZIP file, or with a non-empty pack name, the pack of that name) and write it out
+// to the named ZIP file. On success, "zip_size" is set to the ZIP file's size. A failed extraction never leaves a partly written ZIP file behind.
+PDV_ERROR Extract_Zip_File(const std::string&, const std::string&, const std::string&, size_t&);
+
+// Rebuild the ZIP file (the primary ZIP file, or with a non-empty pack name, the pack of that name) from the open image into the vector.
+PDV_ERROR Read_Zip_Image(IMAGE_FILE&, const std::string&, std::vector<Byte>&);
+
+bool
+	// Open the named image file and get its size & modification time.
+	Open_Image(IMAGE_FILE&, const std::string&),
+	// Read the parts, in turn, from the image file's bytes starting at "index". On Linux, a single "preadv" call (per IOV_MAX parts),
+	// with more calls only after a short read. The parts are consumed as they are read.
+	Read_Parts(IMAGE_FILE&, uint64_t, std::vector<READ_PART>&);
+
+// Use the image held in memory (the "size" bytes at "data", which must outlive the "IMAGE_FILE"), for the reads below.
+void Open_Image_Data(IMAGE_FILE&, const Byte*, size_t);
+
+void Close_Image(IMAGE_FILE&);
+
+// Map (or read) the named file, whole (see "MAPPED_FILE"). Used for the sidecar index & catalog, which are used in place.
+bool Map_File(MAPPED_FILE&, const std::string&);
+
+// Unmap (or free) the file.
+void Unmap_File(MAPPED_FILE&);
+
+PDV_ERROR
+	// List every chunk of the image, up to & including "IEND", reading only their length & name fields. Chunk lengths are untrusted input,
+	// so each chunk is checked to lie within the image.
+	Read_Chunk_Table(IMAGE_FILE&, std::vector<IMAGE_CHUNK>&),
+	// Read the pack directory held within the given chunk, listing each pack (checked to lie within the image). Fails with "PACK_NOT_FOUND" if the chunk
+	// isn't a pack directory.
+	Read_Pack_Directory(IMAGE_FILE&, const IMAGE_CHUNK&, std::vector<PACK_ENTRY>&);
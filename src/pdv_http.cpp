@@ -0,0 +1,739 @@
+// 	PDVZIP HTTP server. See "pdv_http.hpp".
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "pdv_core.hpp"
+#include "pdv_http.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pdv_index.hpp"
+
+constexpr size_t
+	MAX_REQUEST_SIZE = 16384,	// Request line & headers.
+	RECV_SIZE = 16384,
+	SENDFILE_SIZE = 1073741824,	// Most bytes per "sendfile" call.
+	MAX_EVENTS = 64,
+	MAX_OPEN_IMAGES = 256;		// Most images kept open (one file descriptor & index each), see "Find_Image". Fewer with a low file descriptor limit.
+
+constexpr int
+	EPOLL_TIMEOUT_MS = 250,		// How often a worker checks for a stop request.
+	ACCEPT_BACKOFF_MS = 100;	// How long a worker stops accepting connections when the process (or system) is out of file descriptors.
+
+// An open image, shared by the connections serving it. Closed once it has left the open image list (changed on disk, or least recently used)
+// and its last response is sent.
+struct HTTP_IMAGE {
+	PDV_INDEX index;
+	~HTTP_IMAGE() { Close_Index(index); }
+};
+
+// A client connection, and the response being sent on it: the head, then the body, from the image ("sendfile") or from memory.
+struct HTTP_CONNECTION {
+	int fd = -1;
+	std::string
+		request,		// Bytes received, not yet answered.
+		head;			// Response status line & headers.
+	size_t head_sent{};
+	std::shared_ptr<HTTP_IMAGE> image;
+	std::shared_ptr<const std::vector<Byte>> body;
+	uint64_t
+		body_index{},		// Image offset ("sendfile"), or index within "body".
+		body_left{};
+	bool
+		sending{},		// A response is being sent.
+		close_after{};		// Close the connection once the response is sent.
+};
+
+// Open image list: most recently used first, keyed by image path.
+struct IMAGE_ITEM {
+	std::string path;
+	std::shared_ptr<HTTP_IMAGE> image;
+};
+
+// Inflated entry cache: most recently used first. Keyed by image path, modification time & entry number.
+struct CACHE_ITEM {
+	std::string key;
+	std::shared_ptr<const std::vector<Byte>> entry;
+};
+
+static std::string serve_dir;
+
+static size_t
+	cache_size,
+	max_open_images;
+
+static std::list<IMAGE_ITEM> Image_List;
+static std::unordered_map<std::string, std::list<IMAGE_ITEM>::iterator> Image_Map;
+static std::mutex image_mutex;
+
+static std::list<CACHE_ITEM> Cache_List;
+static std::unordered_map<std::string, std::list<CACHE_ITEM>::iterator> Cache_Map;
+static size_t cache_used{};
+static std::mutex cache_mutex;
+
+static std::atomic<size_t>
+	requests_served{ 0 },
+	bytes_sent{ 0 };
+
+static volatile std::sig_atomic_t stop_http = 0;
+
+static void Stop_Http(int) {
+	stop_http = 1;
+}
+
+// Open (or reuse) the image at the path, reopening it if it changed on disk since it was opened. Returns nullptr if it isn't a readable pdvzip image.
+// At most "max_open_images" are kept open: opening another drops the least recently used one from the list (closed once no response is using it),
+// so serving a directory of many images doesn't run the process out of file descriptors.
+static std::shared_ptr<HTTP_IMAGE> Find_Image(const std::string& image_path) {
+	struct stat image_stat;
+
+	if (stat(image_path.c_str(), &image_stat) || !S_ISREG(image_stat.st_mode)) {
+		return nullptr;
+	}
+
+	const uint64_t
+		SIZE = static_cast<uint64_t>(image_stat.st_size),
+		MTIME = static_cast<uint64_t>(image_stat.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(image_stat.st_mtim.tv_nsec);
+
+	{
+		const std::lock_guard<std::mutex> LOCK(image_mutex);
+
+		const auto FOUND = Image_Map.find(image_path);
+
+		if (FOUND != Image_Map.end() && FOUND->second->image->index.image.size == SIZE && FOUND->second->image->index.image.mtime == MTIME) {
+			Image_List.splice(Image_List.begin(), Image_List, FOUND->second);
+			return FOUND->second->image;
+		}
+	}
+
+	// Opened outside the lock, so a slow first open doesn't hold up requests for other images. Two threads may both open a new image; the last one is kept.
+	std::shared_ptr<HTTP_IMAGE> image = std::make_shared<HTTP_IMAGE>();
+
+	if (Open_Index(image->index, image_path, false, false) != PDV_ERROR::NONE) {
+		return nullptr;
+	}
+
+	const std::lock_guard<std::mutex> LOCK(image_mutex);
+
+	const auto FOUND = Image_Map.find(image_path);
+
+	if (FOUND != Image_Map.end()) {
+		Image_List.erase(FOUND->second);
+	}
+	Image_List.push_front({ image_path, image });
+	Image_Map[image_path] = Image_List.begin();
+
+	if (Image_List.size() > max_open_images) {
+		Image_Map.erase(Image_List.back().path);
+		Image_List.pop_back();
+	}
+	return image;
+}
+
+// The whole inflated entry, from the cache, or inflated (CRC checked) & added to it. Returns nullptr if the entry can't be read.
+static std::shared_ptr<const std::vector<Byte>> Inflated_Entry(HTTP_IMAGE& image, const std::string& image_path, size_t entry) {
+	const std::string KEY = image_path + '\n' + std::to_string(image.index.image.mtime) + '\n' + std::to_string(entry);
+
+	{
+		const std::lock_guard<std::mutex> LOCK(cache_mutex);
+
+		const auto FOUND = Cache_Map.find(KEY);
+
+		if (FOUND != Cache_Map.end()) {
+			Cache_List.splice(Cache_List.begin(), Cache_List, FOUND->second);
+			return FOUND->second->entry;
+		}
+	}
+
+	std::shared_ptr<std::vector<Byte>> Entry_Vec = std::make_shared<std::vector<Byte>>();
+
+	if (Read_Entry(image.index, entry, 0, UINT64_MAX, *Entry_Vec) != PDV_ERROR::NONE) {
+		return nullptr;
+	}
+
+	const std::lock_guard<std::mutex> LOCK(cache_mutex);
+
+	if (Cache_Map.count(KEY)) {
+		return Entry_Vec;
+	}
+	while (!Cache_List.empty() && cache_used + Entry_Vec->size() > cache_size) {
+		cache_used -= Cache_List.back().entry->size();
+		Cache_Map.erase(Cache_List.back().key);
+		Cache_List.pop_back();
+	}
+	Cache_List.push_front({ KEY, Entry_Vec });
+	Cache_Map[KEY] = Cache_List.begin();
+	cache_used += Entry_Vec->size();
+
+	return Entry_Vec;
+}
+
+// Decode "%XX" escapes within the request path. Returns false for a bad escape or a decoded NUL.
+static bool Percent_Decode(const std::string& text, std::string& decoded) {
+	decoded.clear();
+
+	for (size_t index = 0; index < text.length(); index++) {
+		if (text[index] != '%') {
+			decoded += text[index];
+			continue;
+		}
+		if (index + 2 >= text.length() || !std::isxdigit(static_cast<Byte>(text[index + 1])) || !std::isxdigit(static_cast<Byte>(text[index + 2]))) {
+			return false;
+		}
+
+		const char VALUE = static_cast<char>(std::stoi(text.substr(index + 1, 2), nullptr, 16));
+
+		if (!VALUE) {
+			return false;
+		}
+		decoded += VALUE;
+		index += 2;
+	}
+	return true;
+}
+
+// Value of the named header (case-insensitive name) within the request head, or an empty string.
+static std::string Header_Value(const std::string& request_head, const char* name) {
+	const size_t NAME_LENGTH = std::strlen(name);
+
+	for (size_t line = request_head.find("\r\n"); line != std::string::npos && line + 2 < request_head.length(); line = request_head.find("\r\n", line + 2)) {
+		const size_t START = line + 2;
+
+		if (request_head.length() - START > NAME_LENGTH && request_head[START + NAME_LENGTH] == ':'
+			&& !strncasecmp(request_head.c_str() + START, name, NAME_LENGTH)) {
+			const size_t
+				VALUE_START = request_head.find_first_not_of(" \t", START + NAME_LENGTH + 1),
+				VALUE_END = request_head.find("\r\n", START);
+
+			return VALUE_START < VALUE_END ? request_head.substr(VALUE_START, VALUE_END - VALUE_START) : "";
+		}
+	}
+	return "";
+}
+
+// Parse a single "bytes=<first>-<last>", "bytes=<first>-" or "bytes=-<suffix length>" range of an entry of the given size.
+// Returns 0 to serve the whole entry (no range, or a form not supported, such as several ranges), 1 for a valid range, or -1 if it can't be satisfied.
+static int Parse_Range(const std::string& range, uint64_t size, uint64_t& first, uint64_t& length) {
+	if (range.compare(0, 6, "bytes=") || range.find(',') != std::string::npos) {
+		return 0;
+	}
+
+	const size_t DASH = range.find('-', 6);
+
+	if (DASH == std::string::npos) {
+		return 0;
+	}
+
+	const std::string
+		FIRST = range.substr(6, DASH - 6),
+		LAST = range.substr(DASH + 1);
+
+	if ((FIRST.empty() && LAST.empty()) || FIRST.find_first_not_of("0123456789") != std::string::npos || LAST.find_first_not_of("0123456789") != std::string::npos
+		|| FIRST.length() > 19 || LAST.length() > 19) {
+		return 0;
+	}
+	if (FIRST.empty()) {
+		const uint64_t SUFFIX = std::stoull(LAST);
+
+		if (!SUFFIX || !size) {
+			return -1;
+		}
+		first = size - std::min(SUFFIX, size);
+		length = size - first;
+		return 1;
+	}
+
+	first = std::stoull(FIRST);
+
+	const uint64_t LAST_BYTE = LAST.empty() ? UINT64_MAX : std::stoull(LAST);
+
+	if (LAST_BYTE < first) {
+		return 0;
+	}
+	if (first >= size) {
+		return -1;
+	}
+	length = std::min(LAST_BYTE, size - 1) - first + 1;
+	return 1;
+}
+
+// Content type, from the entry name's extension.
+static const char* Content_Type(const std::string& name) {
+	static const std::pair<const char*, const char*> CONTENT_TYPES[]{
+		{ ".txt", "text/plain; charset=utf-8" }, { ".html", "text/html; charset=utf-8" }, { ".htm", "text/html; charset=utf-8" },
+		{ ".css", "text/css" }, { ".js", "text/javascript" }, { ".json", "application/json" }, { ".xml", "application/xml" },
+		{ ".png", "image/png" }, { ".jpg", "image/jpeg" }, { ".jpeg", "image/jpeg" }, { ".gif", "image/gif" }, { ".webp", "image/webp" },
+		{ ".svg", "image/svg+xml" }, { ".pdf", "application/pdf" }, { ".zip", "application/zip" }, { ".mp3", "audio/mpeg" },
+		{ ".mp4", "video/mp4" }, { ".webm", "video/webm" } };
+
+	const size_t DOT = name.rfind('.');
+
+	if (DOT != std::string::npos && name.find('/', DOT) == std::string::npos) {
+		std::string extension = name.substr(DOT);
+
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<Byte>(c))); });
+
+		for (const auto& TYPE : CONTENT_TYPES) {
+			if (extension == TYPE.first) {
+				return TYPE.second;
+			}
+		}
+	}
+	return "application/octet-stream";
+}
+
+// Start a response with a small text body (errors & entry listings).
+static void Text_Response(HTTP_CONNECTION& connection, const char* status, const std::string& text, bool head_only, const std::string& extra_headers = "") {
+	std::shared_ptr<std::vector<Byte>> Text_Vec = std::make_shared<std::vector<Byte>>(text.begin(), text.end());
+
+	connection.head = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: " + std::to_string(text.length())
+		+ "\r\n" + extra_headers + (connection.close_after ? "Connection: close\r\n\r\n" : "\r\n");
+	connection.body = Text_Vec;
+	connection.body_index = 0;
+	connection.body_left = head_only ? 0 : text.length();
+}
+
+// Answer the request (its head, without the final blank line): set up the connection's response.
+static void Handle_Request(HTTP_CONNECTION& connection, const std::string& request_head) {
+	const size_t
+		LINE_END = request_head.find("\r\n"),
+		METHOD_END = request_head.find(' '),
+		TARGET_END = METHOD_END < LINE_END ? request_head.find(' ', METHOD_END + 1) : std::string::npos;
+
+	connection.image.reset();
+	connection.head_sent = 0;
+	connection.sending = true;
+
+	if (TARGET_END == std::string::npos || TARGET_END > LINE_END) {
+		connection.close_after = true;
+		Text_Response(connection, "400 Bad Request", "Bad request.\n", false);
+		return;
+	}
+
+	const std::string
+		METHOD = request_head.substr(0, METHOD_END),
+		TARGET = request_head.substr(METHOD_END + 1, TARGET_END - METHOD_END - 1),
+		VERSION = request_head.substr(TARGET_END + 1, LINE_END - TARGET_END - 1),
+		CONNECTION = Header_Value(request_head, "Connection");
+
+	// HTTP/1.1 connections are kept alive unless the client asks otherwise. HTTP/1.0 connections only if it asks.
+	connection.close_after = VERSION == "HTTP/1.1" ? !strcasecmp(CONNECTION.c_str(), "close") : strcasecmp(CONNECTION.c_str(), "keep-alive");
+
+	const bool HEAD_ONLY = METHOD == "HEAD";
+
+	if (METHOD != "GET" && !HEAD_ONLY) {
+		Text_Response(connection, "405 Method Not Allowed", "Only GET & HEAD are supported.\n", false, "Allow: GET, HEAD\r\n");
+		return;
+	}
+
+	std::string path;
+
+	if (TARGET.empty() || TARGET[0] != '/' || !Percent_Decode(TARGET.substr(0, TARGET.find('?')), path)) {
+		Text_Response(connection, "400 Bad Request", "Bad request path.\n", HEAD_ONLY);
+		return;
+	}
+
+	// The image path runs up to the first path part ending in ".png". Its parts can't be empty, "." or "..", so requests can't reach outside the directory.
+	size_t image_end = 0;
+
+	for (size_t part = 1; part <= path.length() && !image_end;) {
+		const size_t PART_END = std::min(path.find('/', part), path.length());
+
+		const std::string PART = path.substr(part, PART_END - part);
+
+		if (PART.empty() || PART == "." || PART == "..") {
+			break;
+		}
+		if (PART.length() > 4 && !PART.compare(PART.length() - 4, 4, ".png")) {
+			image_end = PART_END;
+		}
+		part = PART_END + 1;
+	}
+	if (!image_end) {
+		Text_Response(connection, "404 Not Found", "No image within the request path.\n", HEAD_ONLY);
+		return;
+	}
+
+	const std::string
+		IMAGE_PATH = serve_dir + path.substr(0, image_end),
+		ENTRY_NAME = image_end < path.length() ? path.substr(image_end + 1) : "";
+
+	const std::shared_ptr<HTTP_IMAGE> IMAGE = Find_Image(IMAGE_PATH);
+
+	if (!IMAGE) {
+		Text_Response(connection, "404 Not Found", "Image not found (or not a pdvzip image).\n", HEAD_ONLY);
+		return;
+	}
+
+	PDV_INDEX& index = IMAGE->index;
+
+	if (ENTRY_NAME.empty()) {
+		std::string listing;
+
+		for (size_t entry = 0; entry < Index_Entries(index); entry++) {
+			listing += Index_Entry(index, entry).name + '\n';
+		}
+		Text_Response(connection, "200 OK", listing, HEAD_ONLY);
+		return;
+	}
+
+	const size_t ENTRY = Find_Entry(index, ENTRY_NAME);
+
+	if (ENTRY == NO_ENTRY) {
+		Text_Response(connection, "404 Not Found", "Entry not found.\n", HEAD_ONLY);
+		return;
+	}
+
+	const INDEX_ENTRY FOUND = Index_Entry(index, ENTRY);
+
+	if ((FOUND.flags & 1) || (FOUND.method != 0 && FOUND.method != 8)) {
+		Text_Response(connection, "501 Not Implemented", "The entry is encrypted, or uses a compression method other than store or deflate.\n", HEAD_ONLY);
+		return;
+	}
+
+	uint64_t
+		first = 0,
+		length = FOUND.uncompressed_size;
+
+	const int RANGE = Parse_Range(Header_Value(request_head, "Range"), FOUND.uncompressed_size, first, length);
+
+	if (RANGE < 0) {
+		Text_Response(connection, "416 Range Not Satisfiable", "Range not satisfiable.\n", HEAD_ONLY,
+			"Content-Range: bytes */" + std::to_string(FOUND.uncompressed_size) + "\r\n");
+		return;
+	}
+
+	connection.body.reset();
+	connection.body_index = first;
+
+	if (FOUND.method == 8 && !HEAD_ONLY) {
+		if (FOUND.uncompressed_size <= cache_size / 4) {
+			connection.body = Inflated_Entry(*IMAGE, IMAGE_PATH, ENTRY);
+		}
+		else {
+			// Too large to cache: read just the range.
+			std::shared_ptr<std::vector<Byte>> Range_Vec = std::make_shared<std::vector<Byte>>();
+
+			if (Read_Entry(index, ENTRY, first, length, *Range_Vec) == PDV_ERROR::NONE && Range_Vec->size() == length) {
+				connection.body = Range_Vec;
+			}
+			connection.body_index = 0;
+		}
+		if (!connection.body) {
+			Text_Response(connection, "500 Internal Server Error", "Unable to read the entry (image data is invalid).\n", false);
+			return;
+		}
+	}
+	else if (FOUND.method == 0) {
+		// Sent from the image: keep it open until the body is sent.
+		connection.image = IMAGE;
+		connection.body_index = FOUND.data_offset + first;
+	}
+
+	connection.head = std::string(RANGE ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n") + "Content-Type: " + Content_Type(ENTRY_NAME)
+		+ "\r\nContent-Length: " + std::to_string(length) + "\r\nAccept-Ranges: bytes\r\n"
+		+ (RANGE ? "Content-Range: bytes " + std::to_string(first) + '-' + std::to_string(first + length - 1) + '/' + std::to_string(FOUND.uncompressed_size) + "\r\n" : "")
+		+ (connection.close_after ? "Connection: close\r\n\r\n" : "\r\n");
+	connection.body_left = HEAD_ONLY ? 0 : length;
+}
+
+// Send as much of the response as the socket takes. Returns false if the connection failed. Clears "sending" once the response is sent.
+static bool Send_Response(HTTP_CONNECTION& connection) {
+	while (connection.head_sent < connection.head.length()) {
+		// With a body to follow, hold back a part-filled packet (MSG_MORE), so the head & the start of the body go out together.
+		const ssize_t SENT = send(connection.fd, connection.head.data() + connection.head_sent, connection.head.length() - connection.head_sent,
+			MSG_NOSIGNAL | (connection.body_left ? MSG_MORE : 0));
+
+		if (SENT < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		connection.head_sent += static_cast<size_t>(SENT);
+	}
+	while (connection.body_left) {
+		ssize_t sent;
+
+		if (connection.image) {
+			off_t offset = static_cast<off_t>(connection.body_index);
+
+			sent = sendfile(connection.fd, connection.image->index.image.fd, &offset, static_cast<size_t>(std::min<uint64_t>(connection.body_left, SENDFILE_SIZE)));
+
+			if (!sent) {
+				return false;	// The image is shorter than its index says.
+			}
+		}
+		else {
+			sent = send(connection.fd, connection.body->data() + connection.body_index, static_cast<size_t>(connection.body_left), MSG_NOSIGNAL);
+		}
+		if (sent < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		connection.body_index += static_cast<uint64_t>(sent);
+		connection.body_left -= static_cast<uint64_t>(sent);
+		bytes_sent += static_cast<size_t>(sent);
+	}
+
+	connection.sending = false;
+	connection.image.reset();
+	connection.body.reset();
+	requests_served++;
+
+	return true;
+}
+
+// Answer each complete request received on the connection, in order, until one can't be sent in full (the socket is full) or none are left.
+// Returns false if the connection should be closed.
+static bool Serve_Requests(HTTP_CONNECTION& connection) {
+	while (true) {
+		if (connection.sending) {
+			if (!Send_Response(connection)) {
+				return false;
+			}
+			if (connection.sending) {
+				return true;
+			}
+			if (connection.close_after) {
+				shutdown(connection.fd, SHUT_WR);
+				return false;
+			}
+		}
+
+		const size_t HEAD_END = connection.request.find("\r\n\r\n");
+
+		if (HEAD_END == std::string::npos) {
+			if (connection.request.length() <= MAX_REQUEST_SIZE) {
+				return true;
+			}
+			connection.request.clear();
+			connection.close_after = true;
+			connection.head_sent = 0;
+			connection.sending = true;
+			Text_Response(connection, "431 Request Header Fields Too Large", "Request too large.\n", false);
+			continue;
+		}
+
+		const std::string REQUEST_HEAD = connection.request.substr(0, HEAD_END);
+
+		// Request bodies aren't used (GET & HEAD only): a request with one is answered, then the connection closed.
+		const bool HAS_BODY = !Header_Value(REQUEST_HEAD, "Content-Length").empty() || !Header_Value(REQUEST_HEAD, "Transfer-Encoding").empty();
+
+		connection.request.erase(0, HEAD_END + 4);
+
+		Handle_Request(connection, REQUEST_HEAD);
+
+		if (HAS_BODY && !connection.close_after) {
+			connection.close_after = true;
+			connection.head.insert(connection.head.length() - 2, "Connection: close\r\n");
+		}
+	}
+}
+
+// Event loop of a worker thread: accept connections from the shared listening socket, read requests & send responses, until stopped.
+static void Http_Worker(int listen_fd) {
+	const int EPOLL_FD = epoll_create1(EPOLL_CLOEXEC);
+
+	// EPOLLEXCLUSIVE: a new connection wakes one waiting worker, not all of them.
+	epoll_event listen_event{};
+	listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+	listen_event.data.ptr = nullptr;
+
+	if (EPOLL_FD < 0 || epoll_ctl(EPOLL_FD, EPOLL_CTL_ADD, listen_fd, &listen_event)) {
+		Print_Error("\nHTTP Error: Unable to start the event loop.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::vector<std::unique_ptr<HTTP_CONNECTION>> Connection_Vec;
+
+	auto Close_Connection = [&](HTTP_CONNECTION* connection) {
+		close(connection->fd);
+		Connection_Vec.erase(std::find_if(Connection_Vec.begin(), Connection_Vec.end(),
+			[connection](const std::unique_ptr<HTTP_CONNECTION>& open) { return open.get() == connection; }));
+	};
+
+	epoll_event Event_Vec[MAX_EVENTS];
+
+	std::vector<char> Recv_Vec(RECV_SIZE);
+
+	// Out of file descriptors, a pending connection can't be accepted, and the (level-triggered) listening socket would wake "epoll_wait" at once, again & again.
+	// So the worker stops watching it for "ACCEPT_BACKOFF_MS", while its open connections are served (& closed), then tries again.
+	bool accepting = true;
+
+	std::chrono::steady_clock::time_point accept_resume;
+
+	while (!stop_http) {
+		const int EVENTS = epoll_wait(EPOLL_FD, Event_Vec, MAX_EVENTS, accepting ? EPOLL_TIMEOUT_MS : ACCEPT_BACKOFF_MS);
+
+		if (!accepting && std::chrono::steady_clock::now() >= accept_resume) {
+			accepting = !epoll_ctl(EPOLL_FD, EPOLL_CTL_ADD, listen_fd, &listen_event);
+		}
+
+		for (int event = 0; event < EVENTS; event++) {
+			HTTP_CONNECTION* connection = static_cast<HTTP_CONNECTION*>(Event_Vec[event].data.ptr);
+
+			if (!connection) {
+				int client_fd;
+
+				while ((client_fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+					const int NO_DELAY = 1;
+					setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &NO_DELAY, sizeof(NO_DELAY));
+
+					Connection_Vec.push_back(std::make_unique<HTTP_CONNECTION>());
+					Connection_Vec.back()->fd = client_fd;
+
+					epoll_event client_event{};
+					client_event.events = EPOLLIN | EPOLLRDHUP;
+					client_event.data.ptr = Connection_Vec.back().get();
+
+					if (epoll_ctl(EPOLL_FD, EPOLL_CTL_ADD, client_fd, &client_event)) {
+						Close_Connection(Connection_Vec.back().get());
+					}
+				}
+				if (accepting && (errno == EMFILE || errno == ENFILE)) {
+					accepting = epoll_ctl(EPOLL_FD, EPOLL_CTL_DEL, listen_fd, nullptr);
+					accept_resume = std::chrono::steady_clock::now() + std::chrono::milliseconds(ACCEPT_BACKOFF_MS);
+				}
+				continue;
+			}
+
+			bool
+				open = !(Event_Vec[event].events & EPOLLERR),
+				client_closed = false;
+
+			if (open && (Event_Vec[event].events & (EPOLLIN | EPOLLRDHUP))) {
+				ssize_t received;
+
+				while ((received = recv(connection->fd, Recv_Vec.data(), Recv_Vec.size(), 0)) > 0) {
+					connection->request.append(Recv_Vec.data(), static_cast<size_t>(received));
+				}
+				// Closed by the client (received == 0): requests already received are still answered, then the connection is closed.
+				client_closed = !received;
+				open = client_closed || errno == EAGAIN || errno == EWOULDBLOCK;
+			}
+			if (open) {
+				open = Serve_Requests(*connection) && !(client_closed && !connection->sending);
+			}
+			if (!open) {
+				Close_Connection(connection);
+				continue;
+			}
+
+			// Wait for room within the socket while a response is part sent, otherwise for the next request.
+			epoll_event client_event{};
+			client_event.events = connection->sending ? EPOLLOUT : EPOLLIN | EPOLLRDHUP;
+			client_event.data.ptr = connection;
+
+			epoll_ctl(EPOLL_FD, EPOLL_CTL_MOD, connection->fd, &client_event);
+		}
+	}
+
+	for (const std::unique_ptr<HTTP_CONNECTION>& CONNECTION : Connection_Vec) {
+		close(CONNECTION->fd);
+	}
+	close(EPOLL_FD);
+}
+
+void Run_Http(const std::string& address, const std::string& dir_name, size_t workers, size_t inflate_cache_size) {
+	const size_t COLON = address.rfind(':');
+
+	sockaddr_in listen_address{};
+	listen_address.sin_family = AF_INET;
+
+	char* end = nullptr;
+
+	const unsigned long PORT = COLON == std::string::npos ? 0 : std::strtoul(address.c_str() + COLON + 1, &end, 10);
+
+	if (!PORT || PORT > 65535 || *end || inet_pton(AF_INET, address.substr(0, COLON).c_str(), &listen_address.sin_addr) != 1) {
+		Print_Error("\nInvalid Input Error: --http expects an IPv4 address & port (e.g. 127.0.0.1:8080).\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+	listen_address.sin_port = htons(static_cast<uint16_t>(PORT));
+
+	struct stat dir_stat;
+
+	if (stat(dir_name.c_str(), &dir_stat) || !S_ISDIR(dir_stat.st_mode)) {
+		Print_Error("\nHTTP Error: Unable to open the directory.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	serve_dir = dir_name;
+
+	while (serve_dir.size() > 1 && serve_dir.back() == '/') {
+		serve_dir.pop_back();
+	}
+	cache_size = inflate_cache_size;
+
+	// Leave most file descriptors for connections: open images take up to a quarter of the process's limit.
+	rlimit fd_limit{};
+
+	max_open_images = getrlimit(RLIMIT_NOFILE, &fd_limit) || fd_limit.rlim_cur == RLIM_INFINITY ? MAX_OPEN_IMAGES
+		: std::max<size_t>(std::min<size_t>(MAX_OPEN_IMAGES, fd_limit.rlim_cur / 4), 1);
+
+	const int
+		LISTEN_FD = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0),
+		REUSE_ADDRESS = 1;
+
+	if (LISTEN_FD < 0 || setsockopt(LISTEN_FD, SOL_SOCKET, SO_REUSEADDR, &REUSE_ADDRESS, sizeof(REUSE_ADDRESS))
+		|| bind(LISTEN_FD, reinterpret_cast<const sockaddr*>(&listen_address), sizeof(listen_address)) || listen(LISTEN_FD, SOMAXCONN)) {
+		Print_Error("\nHTTP Error: Unable to listen on %s (%s).\n\n", address.c_str(), std::strerror(errno));
+		std::exit(EXIT_FAILURE);
+	}
+
+	// No SA_RESTART, so that a signal interrupts "epoll_wait". A client that goes away mid-response must not kill the server (SIGPIPE from "sendfile").
+	struct sigaction action {};
+	action.sa_handler = Stop_Http;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+	std::signal(SIGPIPE, SIG_IGN);
+
+	std::printf("\nServing %s at http://%s/<image>/<entry> (%zu worker threads, %zu MB inflate cache). Press Ctrl+C to stop.\n\n",
+		serve_dir.c_str(), address.c_str(), workers, cache_size >> 20);
+	std::fflush(stdout);
+
+	std::vector<std::thread> Thread_Vec;
+
+	for (size_t worker = 0; worker < workers; worker++) {
+		Thread_Vec.emplace_back(Http_Worker, LISTEN_FD);
+	}
+	for (std::thread& thread : Thread_Vec) {
+		thread.join();
+	}
+	close(LISTEN_FD);
+
+	std::printf("\nStopped. %zu requests served, %zu bytes sent.\n\n", requests_served.load(), bytes_sent.load());
+}
+
+#else
+
+void Run_Http(const std::string&, const std::string&, size_t, size_t) {
+	Print_Error("\nHTTP Error: --http is only supported on Linux.\n\n");
+	std::exit(EXIT_FAILURE);
+}
+
+#endif
@@ -0,0 +1,27 @@
+// 	PDVZIP HTTP server ("--http <address:port> <dir>"). Serves the ZIP file entries of the pdvzip images within a directory, without extracting them. Linux only (epoll).
+
+//	"GET /<image>/<entry>" serves one entry: "<image>" is the image's path within the directory (up to & including the first path part ending in ".png"),
+//	"<entry>" the entry's name, as "--list" shows it (with "<pack_name>:" before a pack entry's name). "GET /<image>/" lists the image's entries, one per line.
+//	HEAD is supported, and a single "Range: bytes=..." range of an entry is served as "206 Partial Content" (other range requests get the whole entry).
+//	Connections are kept alive (HTTP/1.1), and pipelined requests are answered in order.
+
+//	Each image is opened once, through its sidecar index (see "pdv_index.hpp", used if valid, never written), and kept open until it changes on disk
+//	or, with 256 images open (fewer, up to a quarter of the file descriptor limit), until it is the least recently used one and another image is requested.
+//	Stored entries are sent with "sendfile", straight from the image into the socket (zero copy: the entry data is never read into the process).
+//	Deflated entries are inflated once (CRC checked) into a shared cache of inflated entries, kept within the cache size (least recently used entries go first),
+//	then sent from memory. A deflated entry too large for the cache (over a quarter of it) is read per request, only as far as the requested range
+//	(from the nearest inflate sync point of an image indexed with "--index").
+
+//	Runs one event loop (epoll) per worker thread, all taking connections from the same listening socket, until interrupted (SIGINT / SIGTERM).
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Inflate cache size used when "--max-memory" isn't given (256 MB).
+constexpr size_t HTTP_CACHE_SIZE = 268435456;
+
+// Serve the directory at the address ("<IPv4 address>:<port>", e.g. "127.0.0.1:8080"), with the given number of worker threads (event loops)
+// and inflate cache size, in bytes. Exits the program on setup errors.
+void Run_Http(const std::string&, const std::string&, size_t, size_t);
@@ -0,0 +1,889 @@
+// 	PDVZIP sidecar index. See "pdv_index.hpp".
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <zlib.h>
+
+#include "pdv_index.hpp"
+
+// Sidecar file layout (little-endian): the header, then the chunk, archive, entry, name hash & sync point tables (fixed-size records),
+// then the names (entry & pack names, not terminated), then one 32 KB inflate window per sync point.
+constexpr uint32_t INDEX_SIG = 0x49564450;	// "PDVI"
+
+constexpr uint16_t INDEX_VERSION = 1;
+
+constexpr size_t
+	INDEX_HEADER_SIZE = 64,
+	CHUNK_RECORD_SIZE = 16,		// Data index (8 bytes), length & name (4 bytes each).
+	ARCHIVE_RECORD_SIZE = 16,	// Name offset (4 bytes), name length (2 bytes), unused (2 bytes), first entry & entry count (4 bytes each).
+	ENTRY_RECORD_SIZE = 56,		// See "INDEX_ENTRY_VIEW".
+	HASH_RECORD_SIZE = 16,		// Name hash (8 bytes), entry number (4 bytes), unused (4 bytes). Sorted by hash, then entry number.
+	SYNC_RECORD_SIZE = 24,		// Entry number (4 bytes), bit count (1 byte), unused (3 bytes), uncompressed & image offsets (8 bytes each). Sorted by entry, then offset.
+	WINDOW_SIZE = 32768,		// Inflate window (deflate's largest back reference distance).
+	SAMPLE_SIZE = 65536,		// Bytes hashed from each end of the image.
+	SYNC_SPAN = 4194304,		// Uncompressed bytes between sync points.
+	READ_SIZE = 65536,		// Compressed bytes read from the image at a time, when inflating.
+	MAX_DEFLATE_RATIO = 1032;	// Deflate's largest compression ratio (a 258-byte match per 2-bit code).
+
+constexpr uint32_t
+	IDAT_NAME = 0x49444154,
+	ZIP64_VALUE = 0xFFFFFFFF;
+
+// Sidecar file header.
+struct INDEX_HEADER_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Version() const { return Get<uint16_t>(4); }
+	constexpr uint16_t Header_Size() const { return Get<uint16_t>(6); }
+	constexpr uint64_t Image_Size() const { return Get<uint64_t>(8); }
+	constexpr uint64_t Image_Mtime() const { return Get<uint64_t>(16); }
+	constexpr uint32_t Image_Hash() const { return Get<uint32_t>(24); }
+	constexpr uint32_t Checksum() const { return Get<uint32_t>(28); }
+	constexpr uint32_t Chunks() const { return Get<uint32_t>(32); }
+	constexpr uint32_t Archives() const { return Get<uint32_t>(36); }
+	constexpr uint32_t Entries() const { return Get<uint32_t>(40); }
+	constexpr uint32_t Sync_Points() const { return Get<uint32_t>(44); }
+	constexpr uint64_t Names_Size() const { return Get<uint64_t>(48); }
+
+	// Offsets of the tables, worked out from the counts.
+	constexpr uint64_t Archive_Table() const { return INDEX_HEADER_SIZE + uint64_t{ Chunks() } * CHUNK_RECORD_SIZE; }
+	constexpr uint64_t Entry_Table() const { return Archive_Table() + uint64_t{ Archives() } * ARCHIVE_RECORD_SIZE; }
+	constexpr uint64_t Hash_Table() const { return Entry_Table() + uint64_t{ Entries() } * ENTRY_RECORD_SIZE; }
+	constexpr uint64_t Sync_Table() const { return Hash_Table() + uint64_t{ Entries() } * HASH_RECORD_SIZE; }
+	constexpr uint64_t Names() const { return Sync_Table() + uint64_t{ Sync_Points() } * SYNC_RECORD_SIZE; }
+	constexpr uint64_t Windows() const { return Names() + Names_Size(); }
+	constexpr uint64_t Total_Size() const { return Windows() + uint64_t{ Sync_Points() } * WINDOW_SIZE; }
+};
+
+// Entry record.
+struct INDEX_ENTRY_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	constexpr uint64_t Name_Hash() const { return Get<uint64_t>(0); }
+	constexpr uint64_t Local_Offset() const { return Get<uint64_t>(8); }
+	constexpr uint64_t Data_Offset() const { return Get<uint64_t>(16); }
+	constexpr uint64_t Compressed_Size() const { return Get<uint64_t>(24); }
+	constexpr uint64_t Uncompressed_Size() const { return Get<uint64_t>(32); }
+	constexpr uint32_t Crc() const { return Get<uint32_t>(40); }
+	constexpr uint32_t Name_Offset() const { return Get<uint32_t>(44); }
+	constexpr uint16_t Name_Length() const { return Get<uint16_t>(48); }
+	constexpr uint16_t Method() const { return Get<uint16_t>(50); }
+	constexpr uint16_t Archive() const { return Get<uint16_t>(52); }
+	constexpr uint16_t Flags() const { return Get<uint16_t>(54); }
+};
+
+// A sync point within a deflated entry: inflate can restart at image offset "in_offset" (less "bits" bits of the byte before it),
+// "out_offset" bytes into the entry's uncompressed data, with the 32 KB before that as its window.
+struct SYNC_POINT {
+	uint32_t entry;
+	Byte bits;
+	uint64_t out_offset, in_offset;
+};
+
+// Working copy of an archive (the ZIP file or a pack) while building the index.
+struct INDEX_ARCHIVE {
+	std::string name;		// Empty for the ZIP file.
+	uint64_t index, size;		// Data within the image, holding (at least) the ZIP file's trailing records.
+	size_t first_entry, entries;
+};
+
+// Hash (CRC32) of the image's first & last "SAMPLE_SIZE" bytes. With its size & modification time, a cheap check for a changed image,
+// without reading all of it. "read_ok" is cleared if the image can't be read.
+static uint32_t Image_Hash(IMAGE_FILE&, bool&);
+
+static PDV_ERROR
+	// Build the index for the open image into its "File_Vec".
+	Build_Index(PDV_INDEX&, uint32_t, bool),
+	// List the entries of the archive (found from its trailing records, read from the end of its data), as the numbered archive.
+	Read_Archive_Entries(IMAGE_FILE&, INDEX_ARCHIVE&, uint16_t, std::vector<INDEX_ENTRY>&),
+	// Inflate the deflated entry once, from start to end, listing a sync point (and its window, in "Window_Vec") every "SYNC_SPAN" uncompressed bytes.
+	Find_Sync_Points(IMAGE_FILE&, const INDEX_ENTRY&, uint32_t, std::vector<SYNC_POINT>&, std::vector<Byte>&);
+
+// CRC32 of the index, after its checksum field (index 32 onwards).
+static uint32_t Index_Checksum(const Byte*, size_t);
+
+static bool
+	// Map (see "Map_File") the sidecar file, then check it: version, checksum, image size, modification time & hash, and every table record's bounds.
+	Load_Index(PDV_INDEX&, const std::string&, uint32_t),
+	// Write the index to the sidecar file (via a temporary file, renamed over it, so readers never see a partly written index).
+	Save_Index(const std::string&, const std::vector<Byte>&);
+
+PDV_ERROR Open_Index(PDV_INDEX& index, const std::string& image_name, bool sync_points, bool save) {
+
+	if (!Open_Image(index.image, image_name)) {
+		return PDV_ERROR::IMAGE_OPEN;
+	}
+
+	bool read_ok = true;
+
+	const uint32_t IMAGE_HASH = Image_Hash(index.image, read_ok);
+
+	if (!read_ok) {
+		Close_Image(index.image);
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+	if (!sync_points && Load_Index(index, Index_File_Name(image_name), IMAGE_HASH)) {
+		return PDV_ERROR::NONE;
+	}
+
+	const PDV_ERROR ERROR_FOUND = Build_Index(index, IMAGE_HASH, sync_points);
+
+	if (ERROR_FOUND != PDV_ERROR::NONE) {
+		Close_Index(index);
+		return ERROR_FOUND;
+	}
+
+	index.file.data = index.file.File_Vec.data();
+	index.file.size = index.file.File_Vec.size();
+	index.rebuilt = true;
+	index.saved = save && Save_Index(Index_File_Name(image_name), index.file.File_Vec);
+
+	return PDV_ERROR::NONE;
+}
+
+void Close_Index(PDV_INDEX& index) {
+	Unmap_File(index.file);
+	Close_Image(index.image);
+}
+
+size_t Index_Entries(const PDV_INDEX& index) {
+	return INDEX_HEADER_VIEW(index.file.data, index.file.size).Entries();
+}
+
+size_t Index_Sync_Points(const PDV_INDEX& index) {
+	return INDEX_HEADER_VIEW(index.file.data, index.file.size).Sync_Points();
+}
+
+size_t Index_Chunks(const PDV_INDEX& index) {
+	return INDEX_HEADER_VIEW(index.file.data, index.file.size).Chunks();
+}
+
+IMAGE_CHUNK Index_Chunk(const PDV_INDEX& index, size_t chunk) {
+	const RECORD_VIEW<Endian::Little> CHUNK(index.file.data + INDEX_HEADER_SIZE + chunk * CHUNK_RECORD_SIZE, CHUNK_RECORD_SIZE);
+
+	return { CHUNK.Get<uint64_t>(0), CHUNK.Get<uint32_t>(8), CHUNK.Get<uint32_t>(12) };
+}
+
+INDEX_ENTRY Index_Entry(const PDV_INDEX& index, size_t entry) {
+	const INDEX_HEADER_VIEW HEADER(index.file.data, index.file.size);
+
+	const INDEX_ENTRY_VIEW ENTRY(index.file.data + HEADER.Entry_Table() + entry * ENTRY_RECORD_SIZE, ENTRY_RECORD_SIZE);
+
+	INDEX_ENTRY found{ ENTRY.Name_Hash(), ENTRY.Local_Offset(), ENTRY.Data_Offset(), ENTRY.Compressed_Size(), ENTRY.Uncompressed_Size(),
+		ENTRY.Crc(), ENTRY.Method(), ENTRY.Archive(), ENTRY.Flags(), {} };
+
+	// A pack entry's name starts with its pack's name.
+	if (found.archive) {
+		const RECORD_VIEW<Endian::Little> ARCHIVE(index.file.data + HEADER.Archive_Table() + found.archive * ARCHIVE_RECORD_SIZE, ARCHIVE_RECORD_SIZE);
+
+		found.name.assign(reinterpret_cast<const char*>(index.file.data + HEADER.Names() + ARCHIVE.Get<uint32_t>(0)), ARCHIVE.Get<uint16_t>(4));
+		found.name += ':';
+	}
+	found.name.append(reinterpret_cast<const char*>(index.file.data + HEADER.Names() + ENTRY.Name_Offset()), ENTRY.Name_Length());
+
+	return found;
+}
+
+size_t Find_Entry(const PDV_INDEX& index, const std::string& name) {
+	const INDEX_HEADER_VIEW HEADER(index.file.data, index.file.size);
+
+	const Byte* HASH_TABLE = index.file.data + HEADER.Hash_Table();
+
+	const uint64_t NAME_HASH = Name_Hash(name.data(), name.length());
+
+	// First hash record with the name's hash, then each with the same hash in turn (names that collide).
+	size_t
+		low = 0,
+		high = HEADER.Entries();
+
+	while (low < high) {
+		const size_t MIDDLE = low + (high - low) / 2;
+
+		if (Load<uint64_t, Endian::Little>(HASH_TABLE + MIDDLE * HASH_RECORD_SIZE) < NAME_HASH) {
+			low = MIDDLE + 1;
+		}
+		else {
+			high = MIDDLE;
+		}
+	}
+
+	for (; low < HEADER.Entries() && Load<uint64_t, Endian::Little>(HASH_TABLE + low * HASH_RECORD_SIZE) == NAME_HASH; low++) {
+		const size_t ENTRY = Load<uint32_t, Endian::Little>(HASH_TABLE + low * HASH_RECORD_SIZE + 8);
+
+		if (Index_Entry(index, ENTRY).name == name) {
+			return ENTRY;
+		}
+	}
+	return NO_ENTRY;
+}
+
+PDV_ERROR Read_Entry(PDV_INDEX& index, size_t entry, uint64_t offset, uint64_t length, std::vector<Byte>& Out_Vec) {
+
+	const INDEX_ENTRY ENTRY = Index_Entry(index, entry);
+
+	Out_Vec.clear();
+
+	if ((ENTRY.flags & 1) || (ENTRY.method != 0 && ENTRY.method != 8)) {
+		return PDV_ERROR::ENTRY_METHOD;
+	}
+	// Sizes are untrusted input: check them before sizing the output.
+	if (ENTRY.method == 0 ? ENTRY.compressed_size != ENTRY.uncompressed_size : ENTRY.uncompressed_size / MAX_DEFLATE_RATIO > ENTRY.compressed_size) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+	if (offset >= ENTRY.uncompressed_size) {
+		return PDV_ERROR::NONE;
+	}
+
+	length = std::min(length, ENTRY.uncompressed_size - offset);
+
+	const bool WHOLE_ENTRY = !offset && length == ENTRY.uncompressed_size;
+
+	Out_Vec.resize(length);
+
+	if (ENTRY.method == 0) {
+		std::vector<READ_PART> Part_Vec{ { Out_Vec.data(), Out_Vec.size() } };
+
+		if (!Read_Parts(index.image, ENTRY.data_offset + offset, Part_Vec)) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+	}
+	else {
+		// Start from the last sync point of the entry at or before the offset (sync records are sorted by entry, then offset), or from its start.
+		const INDEX_HEADER_VIEW HEADER(index.file.data, index.file.size);
+
+		const Byte* SYNC_TABLE = index.file.data + HEADER.Sync_Table();
+
+		size_t
+			low = 0,
+			high = HEADER.Sync_Points();
+
+		while (low < high) {
+			const size_t MIDDLE = low + (high - low) / 2;
+
+			const uint32_t SYNC_ENTRY = Load<uint32_t, Endian::Little>(SYNC_TABLE + MIDDLE * SYNC_RECORD_SIZE);
+
+			if (SYNC_ENTRY < entry || (SYNC_ENTRY == entry && Load<uint64_t, Endian::Little>(SYNC_TABLE + MIDDLE * SYNC_RECORD_SIZE + 8) <= offset)) {
+				low = MIDDLE + 1;
+			}
+			else {
+				high = MIDDLE;
+			}
+		}
+
+		z_stream strm{};
+
+		if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+
+		uint64_t
+			in_index = ENTRY.data_offset,
+			out_offset = 0;
+
+		bool start_ok = true;
+
+		if (low && Load<uint32_t, Endian::Little>(SYNC_TABLE + (low - 1) * SYNC_RECORD_SIZE) == entry) {
+			const Byte* SYNC = SYNC_TABLE + (low - 1) * SYNC_RECORD_SIZE;
+
+			const int BITS = SYNC[4];
+
+			out_offset = Load<uint64_t, Endian::Little>(SYNC + 8);
+			in_index = Load<uint64_t, Endian::Little>(SYNC + 16);
+
+			// The sync point is within a byte: prime inflate with the byte's remaining bits.
+			if (BITS) {
+				Byte bits_byte = 0;
+
+				std::vector<READ_PART> Part_Vec{ { &bits_byte, 1 } };
+
+				start_ok = Read_Parts(index.image, in_index - 1, Part_Vec) && inflatePrime(&strm, BITS, bits_byte >> (8 - BITS)) == Z_OK;
+			}
+			start_ok = start_ok && inflateSetDictionary(&strm, index.file.data + HEADER.Windows() + (low - 1) * WINDOW_SIZE, WINDOW_SIZE) == Z_OK;
+		}
+
+		// Inflate into a scratch buffer, keeping only the bytes within the range.
+		const uint64_t
+			IN_END = ENTRY.data_offset + ENTRY.compressed_size,
+			OUT_END = offset + length;
+
+		std::vector<Byte>
+			In_Vec(READ_SIZE),
+			Scratch_Vec(READ_SIZE);
+
+		int status = Z_OK;
+
+		while (start_ok && status == Z_OK && out_offset < OUT_END) {
+			// Once all the input is read, inflate can still have output to give.
+			if (!strm.avail_in && in_index < IN_END) {
+				const size_t READ = static_cast<size_t>(std::min<uint64_t>(READ_SIZE, IN_END - in_index));
+
+				std::vector<READ_PART> Part_Vec{ { In_Vec.data(), READ } };
+
+				if (!Read_Parts(index.image, in_index, Part_Vec)) {
+					break;
+				}
+				in_index += READ;
+				strm.next_in = In_Vec.data();
+				strm.avail_in = static_cast<uInt>(READ);
+			}
+
+			// Once within the range, inflate straight into the output.
+			const bool DIRECT = out_offset >= offset;
+
+			Byte* out = DIRECT ? Out_Vec.data() + (out_offset - offset) : Scratch_Vec.data();
+
+			const size_t OUT_SIZE = DIRECT ? static_cast<size_t>(OUT_END - out_offset)
+				: static_cast<size_t>(std::min<uint64_t>(Scratch_Vec.size(), OUT_END - out_offset));
+
+			strm.next_out = out;
+			strm.avail_out = static_cast<uInt>(std::min<size_t>(OUT_SIZE, UINT32_MAX));
+
+			status = inflate(&strm, Z_NO_FLUSH);
+
+			const size_t PRODUCED = static_cast<size_t>(strm.next_out - out);
+
+			if (!DIRECT && out_offset + PRODUCED > offset) {
+				const size_t SKIP = static_cast<size_t>(offset - out_offset);
+				std::memcpy(Out_Vec.data(), Scratch_Vec.data() + SKIP, PRODUCED - SKIP);
+			}
+			out_offset += PRODUCED;
+
+			if (status == Z_BUF_ERROR && strm.avail_in) {
+				status = Z_OK;
+			}
+		}
+		inflateEnd(&strm);
+
+		if (out_offset < OUT_END) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+	}
+
+	if (WHOLE_ENTRY) {
+		uLong crc = crc32(0, nullptr, 0);
+
+		for (size_t done = 0; done < Out_Vec.size(); done += UINT32_MAX / 2) {
+			crc = crc32(crc, Out_Vec.data() + done, static_cast<uInt>(std::min<size_t>(Out_Vec.size() - done, UINT32_MAX / 2)));
+		}
+		if (crc != ENTRY.crc) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+	}
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Build_Index(PDV_INDEX& index, uint32_t image_hash, bool sync_points) {
+
+	std::vector<IMAGE_CHUNK> Table_Vec;
+
+	PDV_ERROR error = Read_Chunk_Table(index.image, Table_Vec);
+
+	if (error != PDV_ERROR::NONE) {
+		return error;
+	}
+
+	// The ZIP file's trailing records are within the last "IDAT" chunk. The pack directory (if any) is the "IDAT" chunk before it.
+	std::vector<size_t> Idat_Vec;
+
+	for (size_t chunk = 0; chunk < Table_Vec.size(); chunk++) {
+		if (Table_Vec[chunk].name == IDAT_NAME) {
+			Idat_Vec.push_back(chunk);
+		}
+	}
+	if (Idat_Vec.empty()) {
+		return PDV_ERROR::ZIP_SIGNATURE;
+	}
+
+	const IMAGE_CHUNK& LAST_IDAT = Table_Vec[Idat_Vec.back()];
+
+	std::vector<INDEX_ARCHIVE> Archive_Vec{ { "", LAST_IDAT.index, LAST_IDAT.length, 0, 0 } };
+
+	if (Idat_Vec.size() > 1) {
+		std::vector<PACK_ENTRY> Pack_Vec;
+
+		error = Read_Pack_Directory(index.image, Table_Vec[Idat_Vec[Idat_Vec.size() - 2]], Pack_Vec);
+
+		if (error != PDV_ERROR::NONE && error != PDV_ERROR::PACK_NOT_FOUND) {
+			return error;
+		}
+		for (const PACK_ENTRY& PACK : Pack_Vec) {
+			Archive_Vec.push_back({ PACK.name, PACK.index, PACK.size, 0, 0 });
+		}
+	}
+
+	std::vector<INDEX_ENTRY> Entry_Vec;
+
+	for (size_t archive = 0; archive < Archive_Vec.size(); archive++) {
+		Archive_Vec[archive].first_entry = Entry_Vec.size();
+
+		error = Read_Archive_Entries(index.image, Archive_Vec[archive], static_cast<uint16_t>(archive), Entry_Vec);
+
+		if (error != PDV_ERROR::NONE) {
+			return error;
+		}
+		Archive_Vec[archive].entries = Entry_Vec.size() - Archive_Vec[archive].first_entry;
+	}
+
+	std::vector<SYNC_POINT> Sync_Vec;
+	std::vector<Byte> Window_Vec;
+
+	for (size_t entry = 0; sync_points && entry < Entry_Vec.size() && Entry_Vec.size() <= UINT32_MAX; entry++) {
+		const INDEX_ENTRY& ENTRY = Entry_Vec[entry];
+
+		if (ENTRY.method == 8 && !(ENTRY.flags & 1) && ENTRY.uncompressed_size > SYNC_SPAN) {
+			const size_t
+				SYNC_COUNT = Sync_Vec.size(),
+				WINDOW_COUNT = Window_Vec.size();
+
+			// An entry that fails to inflate gets no sync points. "Read_Entry" reports the error if it is read.
+			if (Find_Sync_Points(index.image, ENTRY, static_cast<uint32_t>(entry), Sync_Vec, Window_Vec) != PDV_ERROR::NONE) {
+				Sync_Vec.resize(SYNC_COUNT);
+				Window_Vec.resize(WINDOW_COUNT);
+			}
+		}
+	}
+
+	uint64_t names_size = 0;
+
+	for (const INDEX_ARCHIVE& ARCHIVE : Archive_Vec) {
+		names_size += ARCHIVE.name.length();
+	}
+	for (const INDEX_ENTRY& ENTRY : Entry_Vec) {
+		names_size += ENTRY.name.length();
+	}
+	if (Table_Vec.size() > UINT32_MAX || Entry_Vec.size() > UINT32_MAX || Sync_Vec.size() > UINT32_MAX || names_size > UINT32_MAX) {
+		return PDV_ERROR::FILE_SIZE;
+	}
+
+	// Header first, so its table offsets can be used to fill in the tables.
+	std::vector<Byte>& Index_Vec = index.file.File_Vec;
+
+	Index_Vec.assign(INDEX_HEADER_SIZE, 0);
+
+	Byte* header = Index_Vec.data();
+
+	Store<uint32_t, Endian::Little>(header, INDEX_SIG);
+	Store<uint16_t, Endian::Little>(header + 4, INDEX_VERSION);
+	Store<uint16_t, Endian::Little>(header + 6, static_cast<uint16_t>(INDEX_HEADER_SIZE));
+	Store<uint64_t, Endian::Little>(header + 8, index.image.size);
+	Store<uint64_t, Endian::Little>(header + 16, index.image.mtime);
+	Store<uint32_t, Endian::Little>(header + 24, image_hash);
+	Store<uint32_t, Endian::Little>(header + 32, static_cast<uint32_t>(Table_Vec.size()));
+	Store<uint32_t, Endian::Little>(header + 36, static_cast<uint32_t>(Archive_Vec.size()));
+	Store<uint32_t, Endian::Little>(header + 40, static_cast<uint32_t>(Entry_Vec.size()));
+	Store<uint32_t, Endian::Little>(header + 44, static_cast<uint32_t>(Sync_Vec.size()));
+	Store<uint64_t, Endian::Little>(header + 48, names_size);
+	Store<uint64_t, Endian::Little>(header + 56, SYNC_SPAN);
+
+	const uint64_t TOTAL_SIZE = INDEX_HEADER_VIEW(Index_Vec.data(), Index_Vec.size()).Total_Size();
+
+	Index_Vec.resize(static_cast<size_t>(TOTAL_SIZE));
+
+	const INDEX_HEADER_VIEW HEADER(Index_Vec.data(), Index_Vec.size());
+
+	Byte* names = Index_Vec.data() + HEADER.Names();
+
+	uint32_t name_offset = 0;
+
+	auto Add_Name = [names, &name_offset](const std::string& name) {
+		std::copy(name.begin(), name.end(), names + name_offset);
+		name_offset += static_cast<uint32_t>(name.length());
+		return name_offset - static_cast<uint32_t>(name.length());
+	};
+
+	for (size_t chunk = 0; chunk < Table_Vec.size(); chunk++) {
+		Byte* record = Index_Vec.data() + INDEX_HEADER_SIZE + chunk * CHUNK_RECORD_SIZE;
+
+		Store<uint64_t, Endian::Little>(record, Table_Vec[chunk].index);
+		Store<uint32_t, Endian::Little>(record + 8, Table_Vec[chunk].length);
+		Store<uint32_t, Endian::Little>(record + 12, Table_Vec[chunk].name);
+	}
+
+	for (size_t archive = 0; archive < Archive_Vec.size(); archive++) {
+		Byte* record = Index_Vec.data() + HEADER.Archive_Table() + archive * ARCHIVE_RECORD_SIZE;
+
+		const INDEX_ARCHIVE& ARCHIVE = Archive_Vec[archive];
+
+		Store<uint32_t, Endian::Little>(record, Add_Name(ARCHIVE.name));
+		Store<uint16_t, Endian::Little>(record + 4, static_cast<uint16_t>(ARCHIVE.name.length()));
+		Store<uint32_t, Endian::Little>(record + 8, static_cast<uint32_t>(ARCHIVE.first_entry));
+		Store<uint32_t, Endian::Little>(record + 12, static_cast<uint32_t>(ARCHIVE.entries));
+	}
+
+	std::vector<std::pair<uint64_t, uint32_t>> Hash_Vec;
+
+	for (size_t entry = 0; entry < Entry_Vec.size(); entry++) {
+		Byte* record = Index_Vec.data() + HEADER.Entry_Table() + entry * ENTRY_RECORD_SIZE;
+
+		const INDEX_ENTRY& ENTRY = Entry_Vec[entry];
+
+		Store<uint64_t, Endian::Little>(record, ENTRY.name_hash);
+		Store<uint64_t, Endian::Little>(record + 8, ENTRY.local_offset);
+		Store<uint64_t, Endian::Little>(record + 16, ENTRY.data_offset);
+		Store<uint64_t, Endian::Little>(record + 24, ENTRY.compressed_size);
+		Store<uint64_t, Endian::Little>(record + 32, ENTRY.uncompressed_size);
+		Store<uint32_t, Endian::Little>(record + 40, ENTRY.crc);
+		Store<uint32_t, Endian::Little>(record + 44, Add_Name(ENTRY.name));
+		Store<uint16_t, Endian::Little>(record + 48, static_cast<uint16_t>(ENTRY.name.length()));
+		Store<uint16_t, Endian::Little>(record + 50, ENTRY.method);
+		Store<uint16_t, Endian::Little>(record + 52, ENTRY.archive);
+		Store<uint16_t, Endian::Little>(record + 54, ENTRY.flags);
+
+		Hash_Vec.push_back({ ENTRY.name_hash, static_cast<uint32_t>(entry) });
+	}
+
+	std::sort(Hash_Vec.begin(), Hash_Vec.end());
+
+	for (size_t slot = 0; slot < Hash_Vec.size(); slot++) {
+		Byte* record = Index_Vec.data() + HEADER.Hash_Table() + slot * HASH_RECORD_SIZE;
+
+		Store<uint64_t, Endian::Little>(record, Hash_Vec[slot].first);
+		Store<uint32_t, Endian::Little>(record + 8, Hash_Vec[slot].second);
+	}
+
+	for (size_t sync = 0; sync < Sync_Vec.size(); sync++) {
+		Byte* record = Index_Vec.data() + HEADER.Sync_Table() + sync * SYNC_RECORD_SIZE;
+
+		Store<uint32_t, Endian::Little>(record, Sync_Vec[sync].entry);
+		record[4] = Sync_Vec[sync].bits;
+		Store<uint64_t, Endian::Little>(record + 8, Sync_Vec[sync].out_offset);
+		Store<uint64_t, Endian::Little>(record + 16, Sync_Vec[sync].in_offset);
+	}
+
+	std::copy(Window_Vec.begin(), Window_Vec.end(), Index_Vec.begin() + HEADER.Windows());
+
+	Store<uint32_t, Endian::Little>(Index_Vec.data() + 28, Index_Checksum(Index_Vec.data(), Index_Vec.size()));
+
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Read_Archive_Entries(IMAGE_FILE& image, INDEX_ARCHIVE& archive, uint16_t archive_number, std::vector<INDEX_ENTRY>& Entry_Vec) {
+
+	// Search backwards from the end of the archive's data for the End Central Directory record. The ZIP file's comment length runs on past
+	// the end of the last "IDAT" chunk's data (see "Relocate_Zip_Records"), so the record is found by its signature alone.
+	const size_t TAIL_SIZE = static_cast<size_t>(std::min<uint64_t>(archive.size, ZIP_END_VIEW::SIZE + 0xFFFF + ZIP64_LOCATOR_VIEW::SIZE));
+
+	if (TAIL_SIZE < ZIP_END_VIEW::SIZE) {
+		return PDV_ERROR::ZIP_SIGNATURE;
+	}
+
+	const uint64_t TAIL_INDEX = archive.index + archive.size - TAIL_SIZE;
+
+	std::vector<Byte> Tail_Vec(TAIL_SIZE);
+
+	std::vector<READ_PART> Part_Vec{ { Tail_Vec.data(), Tail_Vec.size() } };
+
+	if (!Read_Parts(image, TAIL_INDEX, Part_Vec)) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	size_t end_index = TAIL_SIZE - ZIP_END_VIEW::SIZE;
+
+	while (end_index && Load<uint32_t, Endian::Little>(&Tail_Vec[end_index]) != ZIP_END_VIEW::SIG) {
+		end_index--;
+	}
+
+	const ZIP_END_VIEW END_CENTRAL_DIR(Tail_Vec, end_index);
+
+	if (END_CENTRAL_DIR.Signature() != ZIP_END_VIEW::SIG) {
+		return PDV_ERROR::ZIP_SIGNATURE;
+	}
+
+	// Offsets are image offsets. The central directory runs up to the ZIP64 End Central Directory record, or the End Central Directory record.
+	uint64_t
+		zip_records = END_CENTRAL_DIR.Total_Records(),
+		central_dir_offset = END_CENTRAL_DIR.Dir_Offset(),
+		central_dir_end = TAIL_INDEX + end_index;
+
+	if (end_index >= ZIP64_LOCATOR_VIEW::SIZE) {
+		const ZIP64_LOCATOR_VIEW ZIP64_LOCATOR(Tail_Vec, end_index - ZIP64_LOCATOR_VIEW::SIZE);
+
+		if (ZIP64_LOCATOR.Signature() == ZIP64_LOCATOR_VIEW::SIG) {
+			const uint64_t ZIP64_END_OFFSET = ZIP64_LOCATOR.End_Offset();
+
+			Byte zip64_end[ZIP64_END_VIEW::SIZE];
+
+			Part_Vec.assign(1, { zip64_end, sizeof(zip64_end) });
+
+			if (ZIP64_END_OFFSET > central_dir_end || !Read_Parts(image, ZIP64_END_OFFSET, Part_Vec)) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+
+			const ZIP64_END_VIEW ZIP64_END_CENTRAL_DIR(zip64_end, sizeof(zip64_end));
+
+			if (ZIP64_END_CENTRAL_DIR.Signature() != ZIP64_END_VIEW::SIG) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+			zip_records = ZIP64_END_CENTRAL_DIR.Total_Records();
+			central_dir_offset = ZIP64_END_CENTRAL_DIR.Dir_Offset();
+			central_dir_end = ZIP64_END_OFFSET;
+		}
+	}
+
+	if (central_dir_offset > central_dir_end) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	std::vector<Byte> Dir_Vec(static_cast<size_t>(central_dir_end - central_dir_offset));
+
+	Part_Vec.assign(1, { Dir_Vec.data(), Dir_Vec.size() });
+
+	if (!Read_Parts(image, central_dir_offset, Part_Vec)) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	// Walk the central directory. Record counts, offsets & lengths are untrusted input, so each record is checked to lie within the central directory,
+	// and each entry's data within the image.
+	size_t central_dir_index = 0;
+
+	Byte local[ZIP_LOCAL_VIEW::SIZE];
+
+	std::string full_name;
+
+	while (zip_records--) {
+		const ZIP_CENTRAL_VIEW CENTRAL_RECORD(Dir_Vec, central_dir_index);
+
+		if (!CENTRAL_RECORD.Fits(0, ZIP_CENTRAL_VIEW::SIZE) || CENTRAL_RECORD.Signature() != ZIP_CENTRAL_VIEW::SIG
+			|| !CENTRAL_RECORD.Fits(0, CENTRAL_RECORD.Total_Size())) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+
+		INDEX_ENTRY entry{ 0, CENTRAL_RECORD.Local_Offset(), 0, CENTRAL_RECORD.Compressed_Size(), CENTRAL_RECORD.Uncompressed_Size(), CENTRAL_RECORD.Crc(),
+			CENTRAL_RECORD.Method(), archive_number, CENTRAL_RECORD.Get<uint16_t>(8),
+			std::string(reinterpret_cast<const char*>(CENTRAL_RECORD.Name()), CENTRAL_RECORD.Name_Length()) };
+
+		// ZIP64 extra field: the uncompressed size, compressed size & local header offset, each only present if its 32-bit field is 0xFFFFFFFF.
+		if (entry.uncompressed_size == ZIP64_VALUE || entry.compressed_size == ZIP64_VALUE || entry.local_offset == ZIP64_VALUE) {
+			size_t extra_index = ZIP_CENTRAL_VIEW::SIZE + CENTRAL_RECORD.Name_Length();
+
+			const size_t EXTRA_END_INDEX = extra_index + CENTRAL_RECORD.Extra_Length();
+
+			bool zip64_found = false;
+
+			while (!zip64_found && extra_index + ZIP_EXTRA_VIEW::SIZE <= EXTRA_END_INDEX) {
+				const ZIP_EXTRA_VIEW EXTRA(CENTRAL_RECORD.data + extra_index, EXTRA_END_INDEX - extra_index);
+
+				if (EXTRA.Tag() == ZIP_EXTRA_VIEW::ZIP64_TAG && EXTRA.Fits(0, ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size())) {
+					size_t value_index = ZIP_EXTRA_VIEW::SIZE;
+
+					for (uint64_t* value : { &entry.uncompressed_size, &entry.compressed_size, &entry.local_offset }) {
+						if (*value == ZIP64_VALUE) {
+							if (value_index + 8 > ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size()) {
+								return PDV_ERROR::ZIP_CORRUPT;
+							}
+							*value = EXTRA.Get<uint64_t>(value_index);
+							value_index += 8;
+						}
+					}
+					zip64_found = true;
+				}
+				extra_index += ZIP_EXTRA_VIEW::SIZE + EXTRA.Data_Size();
+			}
+
+			if (!zip64_found) {
+				return PDV_ERROR::ZIP_CORRUPT;
+			}
+		}
+
+		// The file data follows the local file header, whose name & extra field lengths can differ from the central directory record's.
+		Part_Vec.assign(1, { local, sizeof(local) });
+
+		if (entry.local_offset >= central_dir_offset || !Read_Parts(image, entry.local_offset, Part_Vec)) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+
+		const ZIP_LOCAL_VIEW LOCAL_RECORD(local, sizeof(local));
+
+		entry.data_offset = entry.local_offset + LOCAL_RECORD.Total_Size();
+
+		if (LOCAL_RECORD.Signature() != ZIP_LOCAL_VIEW::SIG || entry.data_offset > image.size || entry.compressed_size > image.size - entry.data_offset) {
+			return PDV_ERROR::ZIP_CORRUPT;
+		}
+
+		full_name = archive.name.empty() ? entry.name : archive.name + ':' + entry.name;
+
+		entry.name_hash = Name_Hash(full_name.data(), full_name.length());
+
+		Entry_Vec.push_back(std::move(entry));
+
+		central_dir_index += CENTRAL_RECORD.Total_Size();
+	}
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Find_Sync_Points(IMAGE_FILE& image, const INDEX_ENTRY& entry, uint32_t entry_number, std::vector<SYNC_POINT>& Sync_Vec, std::vector<Byte>& Window_Vec) {
+
+	// As zlib's "zran.c" example: inflate a block at a time ("Z_BLOCK") into a circular 32 KB window. At the end of each block header
+	// (once at least "SYNC_SPAN" bytes since the last sync point), note the input position, its bit offset & the window.
+	z_stream strm{};
+
+	if (inflateInit2(&strm, -MAX_WBITS) != Z_OK) {
+		return PDV_ERROR::ZIP_CORRUPT;
+	}
+
+	std::vector<Byte>
+		In_Vec(READ_SIZE),
+		Circle_Vec(WINDOW_SIZE);
+
+	const uint64_t IN_END = entry.data_offset + entry.compressed_size;
+
+	uint64_t
+		in_index = entry.data_offset,
+		total_in = 0,
+		total_out = 0,
+		last_out = 0;
+
+	int status = Z_OK;
+
+	while (status == Z_OK) {
+		// Once all the input is read, inflate can still have output to give.
+		if (!strm.avail_in && in_index < IN_END) {
+			const size_t READ = static_cast<size_t>(std::min<uint64_t>(READ_SIZE, IN_END - in_index));
+
+			std::vector<READ_PART> Part_Vec{ { In_Vec.data(), READ } };
+
+			if (!Read_Parts(image, in_index, Part_Vec)) {
+				break;
+			}
+			in_index += READ;
+			strm.next_in = In_Vec.data();
+			strm.avail_in = static_cast<uInt>(READ);
+		}
+		if (!strm.avail_out) {
+			strm.next_out = Circle_Vec.data();
+			strm.avail_out = static_cast<uInt>(WINDOW_SIZE);
+		}
+
+		const uInt
+			AVAIL_IN = strm.avail_in,
+			AVAIL_OUT = strm.avail_out;
+
+		status = inflate(&strm, Z_BLOCK);
+
+		total_in += AVAIL_IN - strm.avail_in;
+		total_out += AVAIL_OUT - strm.avail_out;
+
+		if (status == Z_BUF_ERROR && strm.avail_in) {
+			status = Z_OK;
+		}
+
+		// End of a block header, not the last block's.
+		if (status == Z_OK && (strm.data_type & 128) && !(strm.data_type & 64) && total_out - last_out > SYNC_SPAN) {
+			Sync_Vec.push_back({ entry_number, static_cast<Byte>(strm.data_type & 7), total_out, entry.data_offset + total_in });
+
+			// Oldest byte first: the rest of the circle after the write position, then the start of the circle.
+			const size_t LEFT = strm.avail_out;
+
+			Window_Vec.insert(Window_Vec.end(), Circle_Vec.end() - LEFT, Circle_Vec.end());
+			Window_Vec.insert(Window_Vec.end(), Circle_Vec.begin(), Circle_Vec.end() - LEFT);
+
+			last_out = total_out;
+		}
+	}
+	inflateEnd(&strm);
+
+	return status == Z_STREAM_END && total_out == entry.uncompressed_size ? PDV_ERROR::NONE : PDV_ERROR::ZIP_CORRUPT;
+}
+
+static bool Load_Index(PDV_INDEX& index, const std::string& index_name, uint32_t image_hash) {
+
+	if (!Map_File(index.file, index_name)) {
+		return false;
+	}
+	if (index.file.size < INDEX_HEADER_SIZE) {
+		Unmap_File(index.file);
+		return false;
+	}
+
+	const INDEX_HEADER_VIEW HEADER(index.file.data, index.file.size);
+
+	bool valid = HEADER.Signature() == INDEX_SIG && HEADER.Version() == INDEX_VERSION && HEADER.Header_Size() == INDEX_HEADER_SIZE
+		&& HEADER.Image_Size() == index.image.size && HEADER.Image_Mtime() == index.image.mtime && HEADER.Image_Hash() == image_hash
+		&& HEADER.Names_Size() <= index.file.size && HEADER.Total_Size() == index.file.size
+		&& HEADER.Checksum() == Index_Checksum(index.file.data, index.file.size);
+
+	// The checksum catches damage, but not a crafted file, so each record's references are checked too, once, here.
+	for (size_t archive = 0; valid && archive < HEADER.Archives(); archive++) {
+		const RECORD_VIEW<Endian::Little> ARCHIVE(index.file.data + HEADER.Archive_Table() + archive * ARCHIVE_RECORD_SIZE, ARCHIVE_RECORD_SIZE);
+
+		valid = uint64_t{ ARCHIVE.Get<uint32_t>(0) } + ARCHIVE.Get<uint16_t>(4) <= HEADER.Names_Size()
+			&& uint64_t{ ARCHIVE.Get<uint32_t>(8) } + ARCHIVE.Get<uint32_t>(12) <= HEADER.Entries();
+	}
+	for (size_t entry = 0; valid && entry < HEADER.Entries(); entry++) {
+		const INDEX_ENTRY_VIEW ENTRY(index.file.data + HEADER.Entry_Table() + entry * ENTRY_RECORD_SIZE, ENTRY_RECORD_SIZE);
+
+		const RECORD_VIEW<Endian::Little> HASH(index.file.data + HEADER.Hash_Table() + entry * HASH_RECORD_SIZE, HASH_RECORD_SIZE);
+
+		valid = uint64_t{ ENTRY.Name_Offset() } + ENTRY.Name_Length() <= HEADER.Names_Size() && ENTRY.Archive() < HEADER.Archives()
+			&& ENTRY.Data_Offset() <= index.image.size && ENTRY.Compressed_Size() <= index.image.size - ENTRY.Data_Offset()
+			&& HASH.Get<uint32_t>(8) < HEADER.Entries();
+	}
+	for (size_t sync = 0; valid && sync < HEADER.Sync_Points(); sync++) {
+		const RECORD_VIEW<Endian::Little> SYNC(index.file.data + HEADER.Sync_Table() + sync * SYNC_RECORD_SIZE, SYNC_RECORD_SIZE);
+
+		valid = SYNC.Get<uint32_t>(0) < HEADER.Entries() && SYNC.Get<Byte>(4) < 8;
+	}
+
+	if (!valid) {
+		Unmap_File(index.file);
+	}
+	return valid;
+}
+
+static bool Save_Index(const std::string& index_name, const std::vector<Byte>& Index_Vec) {
+	const std::string TEMP_NAME = index_name + ".tmp";
+
+	std::FILE* index_ofs = std::fopen(TEMP_NAME.c_str(), "wb");
+
+	if (!index_ofs) {
+		return false;
+	}
+
+	const bool
+		WRITE_OK = std::fwrite(Index_Vec.data(), 1, Index_Vec.size(), index_ofs) == Index_Vec.size(),
+		CLOSE_OK = !std::fclose(index_ofs);
+
+	if (!WRITE_OK || !CLOSE_OK || std::rename(TEMP_NAME.c_str(), index_name.c_str())) {
+		std::remove(TEMP_NAME.c_str());
+		return false;
+	}
+	return true;
+}
+
+static uint32_t Index_Checksum(const Byte* index_data, size_t index_size) {
+	uLong crc = crc32(0, nullptr, 0);
+
+	for (size_t index = 32; index < index_size; index += UINT32_MAX / 2) {
+		crc = crc32(crc, index_data + index, static_cast<uInt>(std::min<size_t>(index_size - index, UINT32_MAX / 2)));
+	}
+	return static_cast<uint32_t>(crc);
+}
+
+std::string Index_File_Name(const std::string& image_name) {
+	return image_name + ".pdvidx";
+}
+
+uint64_t Name_Hash(const char* name, size_t length) {
+	uint64_t hash = 0xCBF29CE484222325;
+
+	while (length--) {
+		hash = (hash ^ static_cast<Byte>(*name++)) * 0x100000001B3;
+	}
+	return hash;
+}
+
+static uint32_t Image_Hash(IMAGE_FILE& image, bool& read_ok) {
+	const size_t SAMPLE = static_cast<size_t>(std::min<uint64_t>(SAMPLE_SIZE, image.size));
+
+	std::vector<Byte> Sample_Vec(SAMPLE * 2);
+
+	std::vector<READ_PART>
+		First_Vec{ { Sample_Vec.data(), SAMPLE } },
+		Last_Vec{ { Sample_Vec.data() + SAMPLE, SAMPLE } };
+
+	read_ok = Read_Parts(image, 0, First_Vec) && Read_Parts(image, image.size - SAMPLE, Last_Vec);
+
+	return crc32(crc32(0, nullptr, 0), Sample_Vec.data(), static_cast<uInt>(Sample_Vec.size()));
+}
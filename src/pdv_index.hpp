@@ -0,0 +1,88 @@
+// 	PDVZIP sidecar index ("<image>.pdvidx"), for repeated random access to the ZIP file entries of a large pdvzip image ("--index", "--list" & "--get").
+
+//	Without it, each access walks the image's chunk headers and reparses the central directory. The index holds the results, ready to use in place:
+//	the chunk table, each ZIP file's entry table (name hash, local header & data offsets within the image, sizes, CRC), a name hash table (sorted, for a binary search)
+//	and, optionally, inflate sync points within large deflated entries, so a range of such an entry can be read without inflating everything before it.
+//	Entries of the ZIP file & of each pack ("--pack") are all listed. A pack's entries are named "<pack_name>:<entry_name>" (pack names can't hold a ":").
+
+//	The file is little-endian, with fixed-size records at offsets worked out from the counts in its header, so it is used straight from a read-only
+//	memory map (Linux "mmap", otherwise read into memory), with no parsing. It is versioned and checksummed (CRC32 of everything after the checksum field),
+//	and records the image's size, modification time & a hash of its first & last 64 KB. If any of these no longer match, the index is rebuilt & rewritten.
+//	If the index can't be written (e.g. a read-only directory), the rebuilt index is still used, from memory.
+
+//	An image's offsets are already image offsets (see "Fix_Zip_Offset") and local records are never split between chunks (see "Fill_Carrier_Chunks"),
+//	so each entry is read straight out of the image, with or without carrier chunks.
+
+//	Requires zlib (link with -lz).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pdv_extract.hpp"
+
+// An entry of the index, as held within the sidecar file.
+struct INDEX_ENTRY {
+	uint64_t
+		name_hash,	// FNV-1a hash of "name".
+		local_offset,	// Index of the entry's local file header within the image.
+		data_offset,	// Index of the entry's file data within the image.
+		compressed_size,
+		uncompressed_size;
+	uint32_t crc;
+	uint16_t
+		method,		// ZIP compression method: 0 (stored) & 8 (deflate) can be read.
+		archive,	// 0 for the ZIP file, or the pack's number (1 onwards).
+		flags;		// ZIP general purpose flags (bit 0: encrypted).
+	std::string name;	// Entry name, with "<pack_name>:" before it for a pack entry.
+};
+
+// An open index, and the image it indexes (kept open for "Read_Entry").
+struct PDV_INDEX {
+	IMAGE_FILE image;
+	MAPPED_FILE file;		// The index. Mapped from the sidecar file, or (rebuilt) held in "File_Vec".
+	bool rebuilt{};			// The sidecar was missing, invalid or out of date, so the index was rebuilt.
+	bool saved{};			// The rebuilt index was written to the sidecar file.
+};
+
+// No entry of that name (see "Find_Entry").
+constexpr size_t NO_ENTRY = SIZE_MAX;
+
+// Open the named image and its sidecar index, rebuilding & rewriting the index if it is missing, invalid or out of date.
+// With "sync_points" set ("--index"), the index is always rebuilt, with inflate sync points every "SYNC_SPAN" bytes within each deflated entry over that size
+// (this inflates those entries once). Otherwise, an index rebuilt because it was missing or out of date has no sync points.
+// With "save" cleared, a rebuilt index is only used from memory, never written (the catalog reads many images, and leaves their directories alone).
+// Fails with "IMAGE_OPEN", or the error found while reading the image's chunks or ZIP records.
+PDV_ERROR Open_Index(PDV_INDEX&, const std::string&, bool, bool = true);
+
+// Close the index and its image.
+void Close_Index(PDV_INDEX&);
+
+size_t
+	// Number of entries within the index (all ZIP files).
+	Index_Entries(const PDV_INDEX&),
+	// Number of inflate sync points within the index.
+	Index_Sync_Points(const PDV_INDEX&),
+	// Number of chunks within the image's chunk table.
+	Index_Chunks(const PDV_INDEX&),
+	// Entry number of the named entry (central directory order, ZIP file first), or "NO_ENTRY". A binary search of the name hash table.
+	Find_Entry(const PDV_INDEX&, const std::string&);
+
+// The numbered entry.
+INDEX_ENTRY Index_Entry(const PDV_INDEX&, size_t);
+
+// The numbered chunk of the image's chunk table.
+IMAGE_CHUNK Index_Chunk(const PDV_INDEX&, size_t);
+
+// Read up to "length" bytes of the numbered entry's uncompressed data, from "offset", into the vector. A deflated entry is inflated from the nearest
+// sync point at or before "offset" (or from its start). Reading the whole entry checks its CRC. Fails with "ENTRY_METHOD" for an encrypted entry,
+// or a compression method other than stored or deflate.
+PDV_ERROR Read_Entry(PDV_INDEX&, size_t, uint64_t, uint64_t, std::vector<Byte>&);
+
+// FNV-1a hash of the name (the index's name hashes; also used by the catalog, "pdv_catalog.hpp").
+uint64_t Name_Hash(const char*, size_t);
+
+// Sidecar file name for the named image.
+std::string Index_File_Name(const std::string&);
@@ -0,0 +1,514 @@
+// 	PDVZIP file job. See "pdv_job.hpp".
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <zlib.h>
+
+#include "pdv_direct.hpp"
+#include "pdv_job.hpp"
+#include "pdv_metrics.hpp"
+#include "pdv_probes.hpp"
+#include "pdv_stats.hpp"
+#include "pdv_trace.hpp"
+
+PDV_PROBE_SEMAPHORE(job__start);
+PDV_PROBE_SEMAPHORE(job__end);
+PDV_PROBE_SEMAPHORE(io__read);
+PDV_PROBE_SEMAPHORE(io__write);
+
+static PDV_ERROR
+	// Read each ZIP pack named in "Pack_Name_Vec" into "Pack_Vec".
+	Read_Packs(PDV_STRUCT&),
+	// Embed the ZIP file (read into memory) within the PNG image, then write out the polyglot image.
+	Embed_Files(PDV_STRUCT&, const std::string&),
+	// As above, but stream the ZIP file from disk straight into the output file, for jobs that would exceed the memory budget (--max-memory).
+	Stream_Files(PDV_STRUCT&, std::FILE*, size_t, const std::string&);
+
+static void
+	// Instrumentation for "--stats", "--trace" & "--metrics" ("PDV_STRUCT" hook).
+	Instrument_Stage(PDV_STRUCT&, PDV_STAGE, bool),
+	// Job instrumentation ("--trace" job span, "--metrics" counters & USDT probes). "Job_End" is called once, with the job's result, on every path.
+	Job_Start(PDV_STRUCT&),
+	Job_End(PDV_STRUCT&, PDV_ERROR),
+	// Send a status message to the "Progress" hook, if set.
+	Show_Progress(PDV_STRUCT&, const char*),
+	// Add bytes written to the output image to "output_crc", if "hash_output" is set.
+	Hash_Output(PDV_STRUCT&, const Byte*, size_t);
+
+static bool
+	// Streaming hooks ("PDV_STRUCT"). Read from the ZIP file / write to the output file held in "zip_stream" / "out_stream".
+	Read_Zip_File(PDV_STRUCT&, Byte*, size_t, size_t),
+	Write_Out_File(PDV_STRUCT&, const Byte*, size_t),
+	// As above, for direct I/O ("direct_io"): "zip_stream" & "out_stream" hold "DIRECT_FILE"s.
+	Read_Zip_Direct(PDV_STRUCT&, Byte*, size_t, size_t),
+	Write_Out_Direct(PDV_STRUCT&, const Byte*, size_t),
+	// Write the whole output file, with "fwrite" or direct I/O, with USDT probes. Returns false on failure (the file is left for the caller to remove).
+	Write_Output(PDV_STRUCT&, const std::string&);
+
+static size_t
+	// "fread" & "fwrite", with USDT probes.
+	Read_Bytes(std::FILE*, Byte*, size_t),
+	Write_Bytes(std::FILE*, const Byte*, size_t),
+	// Read a file from its start (up to the given size), with "fread" or direct I/O, with USDT probes.
+	Read_File(PDV_STRUCT&, const std::string&, std::FILE*, Byte*, size_t),
+	// "Decode_Memory_Size" of the PNG image (of the given size) open in the file, from its PNG header. The file is left at its start.
+	Decode_Size(std::FILE*, size_t, bool);
+
+PDV_ERROR Run_Embed_Job(PDV_STRUCT& pdv, const std::string& output_name, bool& streamed) {
+
+	Show_Progress(pdv, "\nReading files. Please wait...\n");
+
+	// Without an image file name, the cover image is already in "Image_Vec" (e.g. "--generate-cover").
+	const bool IMAGE_LOADED = pdv.image_name.empty();
+
+	// Attempt to open user's files.
+	std::FILE
+		* image_ifs = IMAGE_LOADED ? nullptr : std::fopen(pdv.image_name.c_str(), "rb"),
+		* zip_ifs = std::fopen(pdv.zip_name.c_str(), "rb");
+
+	if ((!IMAGE_LOADED && !image_ifs) || !zip_ifs) {
+		if (image_ifs) {
+			std::fclose(image_ifs);
+		}
+		if (zip_ifs) {
+			std::fclose(zip_ifs);
+		}
+		return !zip_ifs ? PDV_ERROR::ZIP_OPEN : PDV_ERROR::IMAGE_OPEN;
+	}
+
+	// Get PNG file size.
+	if (IMAGE_LOADED) {
+		pdv.image_size = pdv.Image_Vec.size();
+	}
+	else {
+		std::fseek(image_ifs, 0, SEEK_END);
+		pdv.image_size = std::ftell(image_ifs);
+		std::fseek(image_ifs, 0, SEEK_SET);
+	}
+
+	// Get ZIP file size
+	std::fseek(zip_ifs, 0, SEEK_END);
+	pdv.zip_size = std::ftell(zip_ifs);
+	std::fseek(zip_ifs, 0, SEEK_SET);
+
+	// Total size of the ZIP packs ("--pack"), if any.
+	size_t packs_size = 0;
+
+	for (const std::string& PACK_NAME : pdv.Pack_Name_Vec) {
+		packs_size += File_Size(PACK_NAME);
+	}
+
+	pdv.combined_file_size = pdv.image_size + pdv.zip_size + packs_size;
+
+	Job_Start(pdv);
+
+	PDV_ERROR size_error = Check_File_Sizes(pdv);
+
+	// Choose how to embed the ZIP file. Read it into memory, unless that would exceed the memory budget (if set),
+	// in which case stream it from disk straight into the output file. Packs are only embedded in memory, and each is held twice
+	// (as read & within the polyglot image) until it is copied into place. The cover image's decoding buffers are sized from its "IHDR" chunk (none for PNG-8).
+	const size_t DECODE_SIZE = !pdv.max_memory ? 0 : IMAGE_LOADED
+		? Decode_Memory_Size(pdv.image_size >= PNG_HEADER_SIZE ? pdv.Image_Vec.data() : nullptr, pdv.image_size, pdv.reduce_image)
+		: Decode_Size(image_ifs, pdv.image_size, pdv.reduce_image);
+
+	streamed = pdv.max_memory && Embed_Memory_Size(pdv.image_size, pdv.zip_size + 2 * packs_size, DECODE_SIZE) > pdv.max_memory;
+
+	if (size_error == PDV_ERROR::NONE && streamed && (!pdv.Pack_Name_Vec.empty() || Stream_Memory_Size(pdv.image_size, DECODE_SIZE) > pdv.max_memory)) {
+		size_error = PDV_ERROR::MEMORY_BUDGET;
+	}
+
+	if (size_error != PDV_ERROR::NONE) {
+		if (image_ifs) {
+			std::fclose(image_ifs);
+		}
+		std::fclose(zip_ifs);
+		Job_End(pdv, size_error);
+		return size_error;
+	}
+
+	if (!pdv.stats_name.empty()) {
+		Stats_Open();
+	}
+	if (!pdv.stats_name.empty() || !pdv.trace_name.empty() || !pdv.metrics_name.empty()) {
+		pdv.Stage = Instrument_Stage;
+	}
+
+	if (pdv.Stage) {
+		pdv.Stage(pdv, PDV_STAGE::READ, true);
+	}
+
+	// Vector "Image_Vec" stores the user's PNG image. Size the vector once from its file size, then read the whole image with a single call.
+	if (!IMAGE_LOADED) {
+		pdv.Image_Vec.resize(pdv.image_size);
+		pdv.Image_Vec.resize(Read_File(pdv, pdv.image_name, image_ifs, pdv.Image_Vec.data(), pdv.image_size));
+
+		std::fclose(image_ifs);
+	}
+
+	PDV_ERROR result;
+
+	if (streamed) {
+		if (pdv.Stage) {
+			pdv.Stage(pdv, PDV_STAGE::READ, false);
+		}
+		result = Stream_Files(pdv, zip_ifs, pdv.zip_size, output_name);
+	}
+	else if ((result = Read_Packs(pdv)) != PDV_ERROR::NONE) {
+		std::fclose(zip_ifs);
+
+		if (pdv.Stage) {
+			pdv.Stage(pdv, PDV_STAGE::READ, false);
+		}
+	}
+	else {
+		// Vector "Zip_Vec" stores the user's ZIP file, read straight into its "IDAT" chunk frame (with room reserved for the packs, read first).
+		const size_t ZIP_READ_SIZE = Read_File(pdv, pdv.zip_name, zip_ifs, Zip_Buffer(pdv, pdv.zip_size), pdv.zip_size);
+		pdv.Zip_Vec.erase(pdv.Zip_Vec.begin() + 8 + ZIP_READ_SIZE, pdv.Zip_Vec.end() - 4);
+		pdv.zip_size = pdv.Zip_Vec.size();
+
+		std::fclose(zip_ifs);
+
+		if (pdv.Stage) {
+			pdv.Stage(pdv, PDV_STAGE::READ, false);
+		}
+		result = Embed_Files(pdv, output_name);
+	}
+
+	Job_End(pdv, result);
+	return result;
+}
+
+static PDV_ERROR Read_Packs(PDV_STRUCT& pdv) {
+
+	pdv.Pack_Vec.clear();
+
+	for (const std::string& PACK_NAME : pdv.Pack_Name_Vec) {
+		std::FILE* pack_ifs = std::fopen(PACK_NAME.c_str(), "rb");
+
+		if (!pack_ifs) {
+			return PDV_ERROR::ZIP_OPEN;
+		}
+
+		std::fseek(pack_ifs, 0, SEEK_END);
+		pdv.Pack_Vec.emplace_back(std::ftell(pack_ifs));
+		std::fseek(pack_ifs, 0, SEEK_SET);
+
+		const bool READ_OK = Read_Bytes(pack_ifs, pdv.Pack_Vec.back().data(), pdv.Pack_Vec.back().size()) == pdv.Pack_Vec.back().size();
+
+		std::fclose(pack_ifs);
+
+		if (!READ_OK) {
+			return PDV_ERROR::ZIP_READ;
+		}
+	}
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Embed_Files(PDV_STRUCT& pdv, const std::string& output_name) {
+
+	const PDV_ERROR EMBED_ERROR = Embed_Zip(pdv);
+
+	if (EMBED_ERROR != PDV_ERROR::NONE) {
+		return EMBED_ERROR;
+	}
+
+	Show_Progress(pdv, "\nWriting ZIP embedded PNG image out to disk.\n");
+
+	if (pdv.Stage) {
+		pdv.Stage(pdv, PDV_STAGE::WRITE, true);
+	}
+
+	// Write out to file vector "Image_Vec" now containing the completed polyglot image (Image + Script + ZIP).
+	const bool WRITE_OK = Write_Output(pdv, output_name);
+
+	if (pdv.Stage) {
+		pdv.Stage(pdv, PDV_STAGE::WRITE, false);
+	}
+
+	if (!WRITE_OK) {
+		std::remove(output_name.c_str());
+		return PDV_ERROR::WRITE_OUT;
+	}
+	return PDV_ERROR::NONE;
+}
+
+static PDV_ERROR Stream_Files(PDV_STRUCT& pdv, std::FILE* zip_ifs, size_t zip_file_size, const std::string& output_name) {
+
+	if (pdv.direct_io) {
+		std::fclose(zip_ifs);
+
+		DIRECT_FILE
+			zip_file,
+			out_file;
+
+		if (!Direct_Open(zip_file, pdv.zip_name, false)) {
+			return PDV_ERROR::ZIP_OPEN;
+		}
+		if (!Direct_Open(out_file, output_name, true)) {
+			Direct_Close(zip_file);
+			return PDV_ERROR::WRITE_OUT;
+		}
+
+		pdv.Read_Zip = Read_Zip_Direct;
+		pdv.Write_Out = Write_Out_Direct;
+		pdv.zip_stream = &zip_file;
+		pdv.out_stream = &out_file;
+
+		PDV_ERROR embed_error = Embed_Zip_Stream(pdv, zip_file_size);
+
+		Direct_Close(zip_file);
+
+		if (!Direct_Close(out_file) && embed_error == PDV_ERROR::NONE) {
+			embed_error = PDV_ERROR::WRITE_OUT;
+		}
+
+		pdv.zip_stream = pdv.out_stream = nullptr;
+
+		if (embed_error != PDV_ERROR::NONE) {
+			std::remove(output_name.c_str());
+		}
+		return embed_error;
+	}
+
+	pdv.Read_Zip = Read_Zip_File;
+	pdv.Write_Out = Write_Out_File;
+
+	std::FILE* file_ofs = std::fopen(output_name.c_str(), "wb");
+
+	if (!file_ofs) {
+		std::fclose(zip_ifs);
+		return PDV_ERROR::WRITE_OUT;
+	}
+
+	pdv.zip_stream = zip_ifs;
+	pdv.out_stream = file_ofs;
+
+	PDV_ERROR embed_error = Embed_Zip_Stream(pdv, zip_file_size);
+
+	std::fclose(zip_ifs);
+
+	if (std::fclose(file_ofs) && embed_error == PDV_ERROR::NONE) {
+		embed_error = PDV_ERROR::WRITE_OUT;
+	}
+
+	pdv.zip_stream = pdv.out_stream = nullptr;
+
+	if (embed_error != PDV_ERROR::NONE) {
+		// Don't leave a partly written image behind.
+		std::remove(output_name.c_str());
+	}
+	return embed_error;
+}
+
+PDV_ERROR Check_File_Sizes(const PDV_STRUCT& pdv) {
+	// Initial file size checks. We will need to check sizes again, later in the program.
+	constexpr size_t
+		MIN_IMAGE_SIZE = 68,
+		MIN_ZIP_SIZE = 40;
+
+	if (MIN_IMAGE_SIZE >= pdv.image_size) {
+		return PDV_ERROR::IMAGE_TOO_SMALL;
+	}
+	if (MIN_ZIP_SIZE >= pdv.zip_size) {
+		return PDV_ERROR::ZIP_TOO_SMALL;
+	}
+	return pdv.combined_file_size > pdv.MAX_FILE_SIZE ? PDV_ERROR::FILE_SIZE : PDV_ERROR::NONE;
+}
+
+size_t File_Size(const std::string& file_name) {
+	std::FILE* ifs = std::fopen(file_name.c_str(), "rb");
+
+	if (!ifs) {
+		return 0;
+	}
+
+	std::fseek(ifs, 0, SEEK_END);
+	const long SIZE = std::ftell(ifs);
+	std::fclose(ifs);
+
+	return SIZE > 0 ? static_cast<size_t>(SIZE) : 0;
+}
+
+size_t Cover_Decode_Size(const std::string& image_name, size_t image_size, bool reduce_image) {
+	std::FILE* ifs = std::fopen(image_name.c_str(), "rb");
+
+	if (!ifs) {
+		return 0;
+	}
+
+	const size_t DECODE_SIZE = Decode_Size(ifs, image_size, reduce_image);
+	std::fclose(ifs);
+
+	return DECODE_SIZE;
+}
+
+size_t Job_Memory_Size(size_t image_size, size_t zip_size, size_t decode_size, size_t max_memory) {
+	const size_t EMBED_SIZE = Embed_Memory_Size(image_size, zip_size, decode_size);
+	return !max_memory || max_memory >= EMBED_SIZE ? EMBED_SIZE : Stream_Memory_Size(image_size, decode_size);
+}
+
+static bool Read_Zip_File(PDV_STRUCT& pdv, Byte* buffer, size_t offset, size_t length) {
+	std::FILE* zip_ifs = static_cast<std::FILE*>(pdv.zip_stream);
+	return !std::fseek(zip_ifs, static_cast<long>(offset), SEEK_SET) && Read_Bytes(zip_ifs, buffer, length) == length;
+}
+
+static bool Write_Out_File(PDV_STRUCT& pdv, const Byte* data, size_t length) {
+	Hash_Output(pdv, data, length);
+	return Write_Bytes(static_cast<std::FILE*>(pdv.out_stream), data, length) == length;
+}
+
+static bool Read_Zip_Direct(PDV_STRUCT& pdv, Byte* buffer, size_t offset, size_t length) {
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__read) ? Probe_Now_Ns() : 0;
+
+	const bool READ_OK = Direct_Read(*static_cast<DIRECT_FILE*>(pdv.zip_stream), buffer, offset, length);
+
+	if (PDV_PROBE_ENABLED(io__read)) {
+		PDV_PROBE2(io__read, READ_OK ? length : 0, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return READ_OK;
+}
+
+static bool Write_Out_Direct(PDV_STRUCT& pdv, const Byte* data, size_t length) {
+	Hash_Output(pdv, data, length);
+
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__write) ? Probe_Now_Ns() : 0;
+
+	const bool WRITE_OK = Direct_Write(*static_cast<DIRECT_FILE*>(pdv.out_stream), data, length);
+
+	if (PDV_PROBE_ENABLED(io__write)) {
+		PDV_PROBE2(io__write, WRITE_OK ? length : 0, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return WRITE_OK;
+}
+
+static bool Write_Output(PDV_STRUCT& pdv, const std::string& output_name) {
+	Hash_Output(pdv, pdv.Image_Vec.data(), pdv.image_size);
+
+	if (!pdv.direct_io) {
+		std::FILE* file_ofs = std::fopen(output_name.c_str(), "wb");
+
+		if (!file_ofs) {
+			return false;
+		}
+
+		const bool WRITE_OK = Write_Bytes(file_ofs, pdv.Image_Vec.data(), pdv.image_size) == pdv.image_size;
+
+		return !std::fclose(file_ofs) && WRITE_OK;
+	}
+
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__write) ? Probe_Now_Ns() : 0;
+
+	const bool WRITE_OK = Direct_Write_File(output_name, pdv.Image_Vec.data(), pdv.image_size);
+
+	if (PDV_PROBE_ENABLED(io__write)) {
+		PDV_PROBE2(io__write, WRITE_OK ? pdv.image_size : 0, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return WRITE_OK;
+}
+
+static size_t Read_File(PDV_STRUCT& pdv, const std::string& file_name, std::FILE* ifs, Byte* buffer, size_t length) {
+	if (!pdv.direct_io) {
+		return Read_Bytes(ifs, buffer, length);
+	}
+
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__read) ? Probe_Now_Ns() : 0;
+
+	const size_t READ_SIZE = Direct_Read_File(file_name, buffer, length);
+
+	if (PDV_PROBE_ENABLED(io__read)) {
+		PDV_PROBE2(io__read, READ_SIZE, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return READ_SIZE;
+}
+
+static size_t Decode_Size(std::FILE* ifs, size_t image_size, bool reduce_image) {
+	Byte png_header[PNG_HEADER_SIZE];
+
+	const bool HEADER_READ = Read_Bytes(ifs, png_header, PNG_HEADER_SIZE) == PNG_HEADER_SIZE;
+	std::fseek(ifs, 0, SEEK_SET);
+
+	return Decode_Memory_Size(HEADER_READ ? png_header : nullptr, image_size, reduce_image);
+}
+
+static size_t Read_Bytes(std::FILE* ifs, Byte* buffer, size_t length) {
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__read) ? Probe_Now_Ns() : 0;
+
+	const size_t READ_SIZE = std::fread(buffer, 1, length, ifs);
+
+	if (PDV_PROBE_ENABLED(io__read)) {
+		PDV_PROBE2(io__read, READ_SIZE, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return READ_SIZE;
+}
+
+static size_t Write_Bytes(std::FILE* ofs, const Byte* data, size_t length) {
+	const uint64_t START_NS = PDV_PROBE_ENABLED(io__write) ? Probe_Now_Ns() : 0;
+
+	const size_t WRITE_SIZE = std::fwrite(data, 1, length, ofs);
+
+	if (PDV_PROBE_ENABLED(io__write)) {
+		PDV_PROBE2(io__write, WRITE_SIZE, START_NS ? Probe_Now_Ns() - START_NS : 0);
+	}
+	return WRITE_SIZE;
+}
+
+static void Instrument_Stage(PDV_STRUCT& pdv, PDV_STAGE stage, bool begin) {
+	if (!pdv.stats_name.empty()) {
+		Stats_Stage(pdv, stage, begin);
+	}
+	if (!pdv.trace_name.empty()) {
+		Trace_Stage(pdv, stage, begin);
+	}
+	if (!pdv.metrics_name.empty()) {
+		Metrics_Stage(pdv, stage, begin);
+	}
+}
+
+// Start time of the calling thread's job, for the "job__end" probe (only read while the probe is enabled).
+static thread_local uint64_t job_start_ns;
+
+static void Job_Start(PDV_STRUCT& pdv) {
+	if (!pdv.trace_name.empty()) {
+		Trace_Begin_Job(pdv);
+	}
+	if (!pdv.metrics_name.empty()) {
+		Metrics_Begin_Job(pdv);
+	}
+
+	job_start_ns = PDV_PROBE_ENABLED(job__end) ? Probe_Now_Ns() : 0;
+
+	PDV_PROBE2(job__start, pdv.image_size, pdv.zip_size);
+}
+
+static void Job_End(PDV_STRUCT& pdv, PDV_ERROR result) {
+	if (!pdv.trace_name.empty()) {
+		Trace_End_Job(result);
+	}
+	if (!pdv.metrics_name.empty()) {
+		Metrics_End_Job(pdv, result);
+	}
+
+	if (PDV_PROBE_ENABLED(job__end)) {
+		PDV_PROBE3(job__end, static_cast<int>(result), pdv.image_size, job_start_ns ? Probe_Now_Ns() - job_start_ns : 0);
+	}
+}
+
+static void Show_Progress(PDV_STRUCT& pdv, const char* message) {
+	if (pdv.Progress) {
+		pdv.Progress(message);
+	}
+}
+
+static void Hash_Output(PDV_STRUCT& pdv, const Byte* data, size_t length) {
+	if (!pdv.hash_output) {
+		return;
+	}
+
+	uLong crc = pdv.output_crc;
+
+	for (size_t done = 0; done < length; done += UINT32_MAX / 2) {
+		crc = crc32(crc, data + done, static_cast<uInt>(std::min<size_t>(length - done, UINT32_MAX / 2)));
+	}
+	pdv.output_crc = static_cast<uint32_t>(crc);
+}
@@ -0,0 +1,33 @@
+// 	PDVZIP file job. Reads a cover image & ZIP file from disk, embeds the ZIP file (in memory, or streamed within the memory budget) and writes out the polyglot image.
+
+//	Used by the command-line program for a single job and by the scheduler for batch jobs. Never exits the program:
+//	each failure is returned as a "PDV_ERROR" value, for the caller to display ("Error_Message") or report ("Error_Name").
+//	A failed job never leaves a partly written output image behind.
+
+//	Jobs are independent, so several can run at once, on different threads, each with its own "PDV_STRUCT"
+//	(except with "stats_name" set, as the "--stats" counters belong to the whole process).
+
+#pragma once
+
+#include <string>
+
+#include "pdv_core.hpp"
+
+// Run the job for the files named in "image_name" & "zip_name", writing the polyglot image to "output_name". On success, "image_size" is the output size.
+// With an empty "image_name", the cover image already held in "Image_Vec" is used. Any ZIP packs named in "Pack_Name_Vec" are read & embedded too
+// (in memory only: a job with packs that would exceed "max_memory" fails with "MEMORY_BUDGET").
+// "streamed" is set if the ZIP file was streamed from disk (job would exceed "max_memory" in memory).
+// Status messages go to the "Progress" hook. Instrumentation ("--stats", "--trace", "--metrics" & USDT probes) is recorded for the job.
+PDV_ERROR Run_Embed_Job(PDV_STRUCT&, const std::string&, bool&);
+
+// Initial size checks of a job's files ("image_size", "zip_size" & "combined_file_size"), before reading them: "IMAGE_TOO_SMALL", "ZIP_TOO_SMALL" or "FILE_SIZE".
+PDV_ERROR Check_File_Sizes(const PDV_STRUCT&);
+
+size_t
+	// Size of the named file, in bytes (0 if it can't be opened).
+	File_Size(const std::string&),
+	// "Decode_Memory_Size" of the named cover image, of the given size (& "reduce_image"), read from its PNG header (0 if it can't be opened).
+	Cover_Decode_Size(const std::string&, size_t, bool),
+	// Estimated memory a job will use, for a PNG image & ZIP file of the given sizes, the image's "Decode_Memory_Size" & a memory budget (0 = no limit).
+	// In memory ("Embed_Memory_Size") when that fits within the budget, otherwise streamed ("Stream_Memory_Size").
+	Job_Memory_Size(size_t, size_t, size_t, size_t);
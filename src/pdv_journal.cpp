@@ -0,0 +1,394 @@
+// 	PDVZIP batch journal. See "pdv_journal.hpp".
+
+#include "pdv_journal.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <zlib.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pdv_index.hpp"
+
+// Journal file layout (little-endian): the header, then one record per completed job.
+constexpr uint32_t JOURNAL_SIG = 0x4A564450;	// "PDVJ"
+
+constexpr uint16_t JOURNAL_VERSION = 1;
+
+constexpr size_t
+	JOURNAL_HEADER_SIZE = 16,	// Signature (4 bytes), version & record size (2 bytes each), unused (8 bytes).
+	JOURNAL_RECORD_SIZE = 24,	// Job key & output size (8 bytes each), output CRC-32, then the CRC-32 of the record's first 20 bytes (4 bytes each).
+	OUTPUT_READ_SIZE = 1 << 20;	// "Journal_Done" reads an output image back through a buffer of this size, to check its CRC-32.
+
+// Output image of a job recorded by an earlier run.
+struct JOURNAL_OUTPUT {
+	uint64_t size;
+	uint32_t crc;
+};
+
+// A completed job, waiting for its group to be written.
+struct JOURNAL_ENTRY {
+	Byte record[JOURNAL_RECORD_SIZE];
+	std::string output_name;
+};
+
+static int journal_fd = -1;
+
+// Output image of each job recorded by earlier runs, by key. Not changed once the journal is open (so read without a lock).
+static std::unordered_map<uint64_t, JOURNAL_OUTPUT> Done_Map;
+static size_t loaded_records;
+
+// Options that change the output image, hashed into each job's key.
+static uint64_t options_hash;
+
+// Completed jobs waiting to be written, & the writer thread. "journal_failed" is set by the writer thread when a write or sync fails.
+static std::vector<JOURNAL_ENTRY> Pending_Vec;
+static std::mutex journal_mutex;
+static std::condition_variable journal_cv;
+static std::thread journal_thread;
+static bool
+	journal_stop,
+	journal_failed;
+
+// Writer thread: write & sync each group of records (see "pdv_journal.hpp").
+static void Journal_Writer();
+
+// Flush the group's output images to disk, then append its records to the journal & flush it. Returns false on failure.
+static bool Write_Group(const std::vector<JOURNAL_ENTRY>&);
+
+// Load the records, & cut off a torn or partly written tail. Returns false if the file isn't a journal.
+static bool Load_Journal();
+
+// Read / write the whole buffer at the file offset, retrying short reads & writes. Returns false on failure.
+static bool Read_At(Byte*, size_t, uint64_t);
+static bool Write_At(const Byte*, size_t, uint64_t);
+
+// CRC-32 of a record's fields (its first 20 bytes).
+static uint32_t Record_Crc(const Byte*);
+
+bool Journal_Open(const std::string& journal_name, const PDV_STRUCT& options) {
+	journal_fd = open(journal_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+	if (journal_fd < 0) {
+		return false;
+	}
+
+	if (!Load_Journal()) {
+		close(journal_fd);
+		journal_fd = -1;
+		return false;
+	}
+
+	const Byte OPTIONS[]{ static_cast<Byte>(options.reduce_image), static_cast<Byte>(options.carriers) };
+
+	options_hash = Name_Hash(reinterpret_cast<const char*>(OPTIONS), sizeof(OPTIONS));
+
+	journal_stop = journal_failed = false;
+	journal_thread = std::thread(Journal_Writer);
+	return true;
+}
+
+size_t Journal_Records() {
+	return loaded_records;
+}
+
+uint64_t Journal_Key(const PDV_JOB& job) {
+	struct stat image_stat, zip_stat;
+
+	if (stat(job.image_name.c_str(), &image_stat) || stat(job.zip_name.c_str(), &zip_stat)) {
+		return 0;
+	}
+
+	// The file names (each with its terminating null, so that names can't run into each other), then the sizes & modification times, then the options.
+	std::string key_data;
+
+	key_data.reserve(job.image_name.length() + job.zip_name.length() + job.output_name.length() + 3 + 5 * 8);
+
+	for (const std::string* NAME : { &job.image_name, &job.zip_name, &job.output_name }) {
+		key_data.append(NAME->c_str(), NAME->length() + 1);
+	}
+
+	const uint64_t FIELDS[]{
+		static_cast<uint64_t>(image_stat.st_size),
+		static_cast<uint64_t>(image_stat.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(image_stat.st_mtim.tv_nsec),
+		static_cast<uint64_t>(zip_stat.st_size),
+		static_cast<uint64_t>(zip_stat.st_mtim.tv_sec) * 1000000000 + static_cast<uint64_t>(zip_stat.st_mtim.tv_nsec),
+		options_hash };
+
+	for (const uint64_t FIELD : FIELDS) {
+		Byte field[8];
+		Store<uint64_t, Endian::Little>(field, FIELD);
+		key_data.append(reinterpret_cast<const char*>(field), sizeof(field));
+	}
+
+	// 0 is kept for "no key".
+	const uint64_t KEY = Name_Hash(key_data.data(), key_data.length());
+
+	return KEY ? KEY : 1;
+}
+
+bool Journal_Done(const PDV_JOB& job) {
+	const auto DONE = job.journal_key ? Done_Map.find(job.journal_key) : Done_Map.end();
+
+	if (DONE == Done_Map.end()) {
+		return false;
+	}
+
+	// A missing, partly written or changed output image (e.g. removed, or overwritten by another run since) is made again.
+	// The size is checked first, so only an output image of the recorded size is read back, for its CRC-32.
+	const int OUTPUT_FD = open(job.output_name.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (OUTPUT_FD < 0) {
+		return false;
+	}
+
+	struct stat output_stat;
+
+	bool done = !fstat(OUTPUT_FD, &output_stat) && static_cast<uint64_t>(output_stat.st_size) == DONE->second.size;
+
+	if (done) {
+		std::vector<Byte> Read_Vec(OUTPUT_READ_SIZE);
+
+		uLong crc = crc32(0, nullptr, 0);
+		uint64_t left = DONE->second.size;
+		ssize_t read_size;
+
+		while (left && (read_size = read(OUTPUT_FD, Read_Vec.data(), Read_Vec.size())) > 0) {
+			crc = crc32(crc, Read_Vec.data(), static_cast<uInt>(read_size));
+			left -= std::min<uint64_t>(left, static_cast<uint64_t>(read_size));
+		}
+		done = !left && static_cast<uint32_t>(crc) == DONE->second.crc;
+	}
+	close(OUTPUT_FD);
+	return done;
+}
+
+void Journal_Append(const PDV_JOB& job) {
+	JOURNAL_ENTRY entry;
+
+	Store<uint64_t, Endian::Little>(entry.record, job.journal_key);
+	Store<uint64_t, Endian::Little>(entry.record + 8, job.output_size);
+	Store<uint32_t, Endian::Little>(entry.record + 16, job.output_crc);
+	Store<uint32_t, Endian::Little>(entry.record + 20, Record_Crc(entry.record));
+
+	entry.output_name = job.output_name;
+
+	const std::lock_guard<std::mutex> LOCK(journal_mutex);
+
+	Pending_Vec.push_back(std::move(entry));
+
+	if (Pending_Vec.size() == JOURNAL_GROUP_SIZE) {
+		journal_cv.notify_one();
+	}
+}
+
+bool Journal_Close() {
+	if (journal_fd < 0) {
+		return true;
+	}
+
+	{
+		const std::lock_guard<std::mutex> LOCK(journal_mutex);
+		journal_stop = true;
+	}
+	journal_cv.notify_one();
+	journal_thread.join();
+
+	const bool CLOSE_OK = !close(journal_fd);
+
+	journal_fd = -1;
+	return CLOSE_OK && !journal_failed;
+}
+
+static void Journal_Writer() {
+	std::vector<JOURNAL_ENTRY> Group_Vec;
+
+	std::unique_lock<std::mutex> lock(journal_mutex);
+
+	while (true) {
+		journal_cv.wait_for(lock, std::chrono::milliseconds(JOURNAL_SYNC_MS), [] { return journal_stop || Pending_Vec.size() >= JOURNAL_GROUP_SIZE; });
+
+		if (Pending_Vec.empty()) {
+			if (journal_stop) {
+				break;
+			}
+			continue;
+		}
+
+		// Write the group without holding the lock, so that workers finishing jobs meanwhile never wait for the disk.
+		Group_Vec.swap(Pending_Vec);
+		lock.unlock();
+
+		const bool WRITE_OK = Write_Group(Group_Vec);
+
+		Group_Vec.clear();
+		lock.lock();
+
+		journal_failed |= !WRITE_OK;
+	}
+}
+
+static bool Write_Group(const std::vector<JOURNAL_ENTRY>& Group_Vec) {
+	// Start writing back every output image of the group, then wait for each in turn, so the device works on them all at once.
+	std::vector<int> Fd_Vec;
+
+	Fd_Vec.reserve(Group_Vec.size());
+
+	for (const JOURNAL_ENTRY& ENTRY : Group_Vec) {
+		const int FD = open(ENTRY.output_name.c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (FD >= 0) {
+			sync_file_range(FD, 0, 0, SYNC_FILE_RANGE_WRITE);
+		}
+		Fd_Vec.push_back(FD);
+	}
+
+	bool sync_ok = true;
+
+	for (const int FD : Fd_Vec) {
+		sync_ok &= FD >= 0 && !fdatasync(FD);
+		if (FD >= 0) {
+			close(FD);
+		}
+	}
+
+	// Without its output image on disk, a record would skip a job that has to be run again. Leave the group out.
+	if (!sync_ok) {
+		return false;
+	}
+
+	std::vector<Byte> Record_Vec(Group_Vec.size() * JOURNAL_RECORD_SIZE);
+
+	for (size_t i = 0; i < Group_Vec.size(); i++) {
+		std::memcpy(Record_Vec.data() + i * JOURNAL_RECORD_SIZE, Group_Vec[i].record, JOURNAL_RECORD_SIZE);
+	}
+
+	const off_t END = lseek(journal_fd, 0, SEEK_END);
+
+	return END >= 0 && Write_At(Record_Vec.data(), Record_Vec.size(), static_cast<uint64_t>(END)) && !fdatasync(journal_fd);
+}
+
+static bool Load_Journal() {
+	struct stat journal_stat;
+
+	if (fstat(journal_fd, &journal_stat)) {
+		return false;
+	}
+
+	const uint64_t JOURNAL_SIZE = static_cast<uint64_t>(journal_stat.st_size);
+
+	Byte header[JOURNAL_HEADER_SIZE]{};
+
+	Store<uint32_t, Endian::Little>(header, JOURNAL_SIG);
+	Store<uint16_t, Endian::Little>(header + 4, JOURNAL_VERSION);
+	Store<uint16_t, Endian::Little>(header + 6, static_cast<uint16_t>(JOURNAL_RECORD_SIZE));
+
+	Done_Map.clear();
+	loaded_records = 0;
+
+	// A new journal, or one whose header was torn as it was created: (re)write the header.
+	if (JOURNAL_SIZE < JOURNAL_HEADER_SIZE) {
+		Byte start[JOURNAL_HEADER_SIZE];
+
+		if (!Read_At(start, static_cast<size_t>(JOURNAL_SIZE), 0) || std::memcmp(start, header, static_cast<size_t>(JOURNAL_SIZE))) {
+			return false;
+		}
+		return Write_At(header, sizeof(header), 0) && !fdatasync(journal_fd);
+	}
+
+	std::vector<Byte> Journal_Vec(static_cast<size_t>(JOURNAL_SIZE));
+
+	if (!Read_At(Journal_Vec.data(), Journal_Vec.size(), 0) || std::memcmp(Journal_Vec.data(), header, 8)) {
+		return false;
+	}
+
+	const size_t RECORDS = (Journal_Vec.size() - JOURNAL_HEADER_SIZE) / JOURNAL_RECORD_SIZE;
+
+	Done_Map.reserve(RECORDS);
+
+	// Stop at the first record that fails its check: the rest are from a group that was being written.
+	size_t records = 0;
+
+	for (; records < RECORDS; records++) {
+		const Byte* RECORD = Journal_Vec.data() + JOURNAL_HEADER_SIZE + records * JOURNAL_RECORD_SIZE;
+
+		if (Load<uint32_t, Endian::Little>(RECORD + 20) != Record_Crc(RECORD)) {
+			break;
+		}
+		Done_Map[Load<uint64_t, Endian::Little>(RECORD)] = { Load<uint64_t, Endian::Little>(RECORD + 8), Load<uint32_t, Endian::Little>(RECORD + 16) };
+	}
+	loaded_records = records;
+
+	const uint64_t VALID_SIZE = JOURNAL_HEADER_SIZE + uint64_t{ records } * JOURNAL_RECORD_SIZE;
+
+	// New records are appended after the last valid one.
+	return VALID_SIZE == JOURNAL_SIZE || (!ftruncate(journal_fd, static_cast<off_t>(VALID_SIZE)) && !fdatasync(journal_fd));
+}
+
+static bool Read_At(Byte* buffer, size_t length, uint64_t offset) {
+	while (length) {
+		const ssize_t READ_SIZE = pread(journal_fd, buffer, length, static_cast<off_t>(offset));
+
+		if (READ_SIZE <= 0) {
+			return false;
+		}
+		buffer += READ_SIZE;
+		length -= static_cast<size_t>(READ_SIZE);
+		offset += static_cast<uint64_t>(READ_SIZE);
+	}
+	return true;
+}
+
+static bool Write_At(const Byte* data, size_t length, uint64_t offset) {
+	while (length) {
+		const ssize_t WRITE_SIZE = pwrite(journal_fd, data, length, static_cast<off_t>(offset));
+
+		if (WRITE_SIZE <= 0) {
+			return false;
+		}
+		data += WRITE_SIZE;
+		length -= static_cast<size_t>(WRITE_SIZE);
+		offset += static_cast<uint64_t>(WRITE_SIZE);
+	}
+	return true;
+}
+
+static uint32_t Record_Crc(const Byte* record) {
+	return static_cast<uint32_t>(crc32(crc32(0, nullptr, 0), record, 20));
+}
+
+#else
+
+bool Journal_Open(const std::string&, const PDV_STRUCT&) {
+	return false;
+}
+
+size_t Journal_Records() {
+	return 0;
+}
+
+uint64_t Journal_Key(const PDV_JOB&) {
+	return 0;
+}
+
+bool Journal_Done(const PDV_JOB&) {
+	return false;
+}
+
+void Journal_Append(const PDV_JOB&) {}
+
+bool Journal_Close() {
+	return true;
+}
+
+#endif
@@ -0,0 +1,47 @@
+// 	PDVZIP batch journal ("--batch jobs.txt --resume <journal>"), so that a large batch stopped part way (crash, power loss, kill) can be run again
+//	without redoing the jobs it had already completed. Linux only.
+
+//	The journal is an append-only file of fixed-size records, one per completed job: the job's key, and its output image's size & CRC-32.
+//	A job's key is a hash of its file names, its input files' sizes & modification times, and the batch options that change the output image,
+//	so a job whose inputs (or options) changed since it was recorded is run again.
+
+//	Records are written in groups, by a background thread, every "JOURNAL_GROUP_SIZE" completed jobs or "JOURNAL_SYNC_MS" milliseconds, whichever comes first:
+//	the group's output images are flushed to disk first, then its records are appended & the journal is flushed ("fdatasync"). So a recorded job's
+//	output image is always on disk, and a crash loses at most the last group's records (those jobs are run again). Worker threads never wait for the disk.
+//	Each record carries its own checksum: a torn or partly written group at the end of the journal is found & cut off when it is next opened.
+
+//	On open, the records are loaded into a hash index (key to output size & CRC-32), so each job of the batch is looked up in O(1) time:
+//	it is skipped if it was recorded and its output image is still in place with the recorded size & CRC-32 (read back only when the size matches,
+//	still much less work than running the job again). Jobs that were running (in flight) or queued when the batch stopped have no record, so they are run again.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "pdv_sched.hpp"
+
+constexpr size_t
+	JOURNAL_GROUP_SIZE = 64,	// Records written & synced at once (at most).
+	JOURNAL_SYNC_MS = 200;		// Longest wait before a completed job's record is written & synced.
+
+// Open the journal (created if it doesn't exist) & load its records, for a batch run with the given options. Starts the writer thread.
+// Returns false if the file can't be opened, or isn't a journal (it is left unchanged).
+bool Journal_Open(const std::string&, const PDV_STRUCT&);
+
+// Number of records loaded from the journal (jobs completed by earlier runs, including any that were recorded more than once).
+size_t Journal_Records();
+
+// Key of a job (see above). 0 if an input file can't be read: such a job is never skipped.
+uint64_t Journal_Key(const PDV_JOB&);
+
+// Whether the job ("journal_key" set) was completed by an earlier run, and its output image is still in place, unchanged. Safe to call from any thread.
+bool Journal_Done(const PDV_JOB&);
+
+// Record a completed job ("journal_key", "output_size" & "output_crc" set). Written & synced with its group. Safe to call from any thread.
+void Journal_Append(const PDV_JOB&);
+
+// Write & sync the records still queued, stop the writer thread & close the journal. Returns false if any write or sync failed
+// (the jobs that were not recorded are run again by the next "--resume").
+bool Journal_Close();
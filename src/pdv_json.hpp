@@ -0,0 +1,24 @@
+// 	PDVZIP JSON output helper, shared by the report writers ("--stats", "--trace").
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+// Write "text" as a JSON string (quoted & escaped).
+inline void Write_Json_String(std::FILE* ofs, const std::string& text) {
+	std::fputc('"', ofs);
+	for (const unsigned char c : text) {
+		if (c == '"' || c == '\\') {
+			std::fputc('\\', ofs);
+			std::fputc(c, ofs);
+		}
+		else if (c < 0x20) {
+			std::fprintf(ofs, "\\u%04x", c);
+		}
+		else {
+			std::fputc(c, ofs);
+		}
+	}
+	std::fputc('"', ofs);
+}
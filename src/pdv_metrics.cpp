@@ -0,0 +1,294 @@
+// 	PDVZIP metrics output. See "pdv_metrics.hpp".
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "pdv_metrics.hpp"
+
+// Latency histogram bucket upper bounds, in seconds (plus "+Inf"). From 100 microseconds (small in-memory stages) to 10 seconds (200 MB jobs on slow disks).
+static constexpr double BUCKET_BOUNDS[]{ 0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10 };
+
+static constexpr size_t
+	BUCKETS = sizeof(BUCKET_BOUNDS) / sizeof(BUCKET_BOUNDS[0]),
+	STAGES = static_cast<size_t>(PDV_STAGE::COUNT),
+	RESULTS = static_cast<size_t>(PDV_ERROR::COUNT);
+
+struct METRICS_HISTOGRAM {
+	uint64_t Bucket_Count[BUCKETS + 1]{};	// Not cumulative. The last bucket is "+Inf".
+	uint64_t count{};
+	double sum{};
+
+	void Observe(double seconds) {
+		size_t bucket = 0;
+		while (bucket < BUCKETS && seconds > BUCKET_BOUNDS[bucket]) {
+			bucket++;
+		}
+		Bucket_Count[bucket]++;
+		count++;
+		sum += seconds;
+	}
+};
+
+static std::mutex metrics_mutex;
+
+static std::string metrics_file_name;
+
+static METRICS_HISTOGRAM
+	Job_Histogram,
+	Stage_Histogram[STAGES];
+
+static uint64_t
+	Result_Count[RESULTS],
+	input_bytes,
+	output_bytes,
+	jobs_in_flight,
+	queue_depth;
+
+// Throughput of the most recent successful job (output bytes per second).
+static double last_bytes_per_second;
+
+// Counter & histogram samples read from the metrics file by "Metrics_Open", added to this run's values when writing.
+static std::unordered_map<std::string, double> Base_Map;
+
+// Set when there are values not yet written out.
+static bool metrics_dirty;
+
+static thread_local std::chrono::steady_clock::time_point
+	job_start,
+	stage_start[STAGES];
+
+// Read counter & histogram samples from an existing metrics file into "Base_Map".
+static void Load_Base(const std::string&);
+
+// Write the metrics file if anything changed since it was last written ("atexit" handler).
+static void Write_Metrics_At_Exit();
+
+// Append formatted text to the output.
+static void Append(std::string&, const char*, ...);
+
+void Metrics_Open(const std::string& metrics_name) {
+	metrics_file_name = metrics_name;
+	Load_Base(metrics_name);
+	metrics_dirty = true;
+	std::atexit(Write_Metrics_At_Exit);
+}
+
+void Metrics_Stage(PDV_STRUCT&, PDV_STAGE stage, bool begin) {
+	if (stage >= PDV_STAGE::COUNT) {
+		return;
+	}
+	const size_t INDEX = static_cast<size_t>(stage);
+
+	if (begin) {
+		stage_start[INDEX] = std::chrono::steady_clock::now();
+		return;
+	}
+
+	const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - stage_start[INDEX]).count();
+
+	const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+
+	Stage_Histogram[INDEX].Observe(SECONDS);
+}
+
+void Metrics_Begin_Job(const PDV_STRUCT& pdv) {
+	job_start = std::chrono::steady_clock::now();
+
+	const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+
+	jobs_in_flight++;
+	input_bytes += pdv.image_size + pdv.zip_size;
+	metrics_dirty = true;
+}
+
+void Metrics_End_Job(const PDV_STRUCT& pdv, PDV_ERROR result) {
+	const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - job_start).count();
+
+	{
+		const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+
+		if (jobs_in_flight) {
+			jobs_in_flight--;
+		}
+
+		Result_Count[result < PDV_ERROR::COUNT ? static_cast<size_t>(result) : 0]++;
+		Job_Histogram.Observe(SECONDS);
+
+		if (result == PDV_ERROR::NONE) {
+			// On success, "image_size" is the size of the polyglot image.
+			output_bytes += pdv.image_size;
+			last_bytes_per_second = SECONDS > 0 ? static_cast<double>(pdv.image_size) / SECONDS : 0;
+		}
+		metrics_dirty = true;
+	}
+	Write_Metrics();
+}
+
+void Metrics_Queue_Depth(size_t depth) {
+	const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+
+	queue_depth = depth;
+	metrics_dirty = true;
+}
+
+// Output one histogram family. "label" is the name of the label that separates each histogram within the family (empty for a single histogram).
+static void Append_Histogram(std::string& text, const char* name, const char* label, const char* label_value, const METRICS_HISTOGRAM& histogram) {
+	char key[160];
+
+	const std::string LABEL_PREFIX = *label ? std::string(label) + "=\"" + label_value + "\"," : std::string();
+	const std::string LABELS = *label ? "{" + std::string(label) + "=\"" + label_value + "\"}" : std::string();
+
+	uint64_t cumulative = 0;
+
+	for (size_t bucket = 0; bucket <= BUCKETS; bucket++) {
+		cumulative += histogram.Bucket_Count[bucket];
+
+		if (bucket < BUCKETS) {
+			std::snprintf(key, sizeof(key), "%s_bucket{%sle=\"%g\"}", name, LABEL_PREFIX.c_str(), BUCKET_BOUNDS[bucket]);
+		}
+		else {
+			std::snprintf(key, sizeof(key), "%s_bucket{%sle=\"+Inf\"}", name, LABEL_PREFIX.c_str());
+		}
+		Append(text, "%s %.17g\n", key, static_cast<double>(cumulative) + Base_Map[key]);
+	}
+
+	std::snprintf(key, sizeof(key), "%s_sum%s", name, LABELS.c_str());
+	Append(text, "%s %.17g\n", key, histogram.sum + Base_Map[key]);
+
+	std::snprintf(key, sizeof(key), "%s_count%s", name, LABELS.c_str());
+	Append(text, "%s %.17g\n", key, static_cast<double>(histogram.count) + Base_Map[key]);
+}
+
+bool Write_Metrics() {
+	const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+
+	if (metrics_file_name.empty()) {
+		return false;
+	}
+
+	std::string text;
+	text.reserve(16384);
+
+	char key[160];
+
+	Append(text, "# HELP pdvzip_jobs_total Embed jobs finished, by result (\"ok\" or the error reason).\n# TYPE pdvzip_jobs_total counter\n");
+
+	for (size_t result = 0; result < RESULTS; result++) {
+		std::snprintf(key, sizeof(key), "pdvzip_jobs_total{result=\"%s\"}", Error_Name(static_cast<PDV_ERROR>(result)));
+		Append(text, "%s %.17g\n", key, static_cast<double>(Result_Count[result]) + Base_Map[key]);
+	}
+
+	Append(text, "# HELP pdvzip_input_bytes_total Bytes read in (PNG image & ZIP file) by started jobs.\n# TYPE pdvzip_input_bytes_total counter\n"
+		"pdvzip_input_bytes_total %.17g\n", static_cast<double>(input_bytes) + Base_Map["pdvzip_input_bytes_total"]);
+
+	Append(text, "# HELP pdvzip_output_bytes_total Bytes of PNG-ZIP polyglot images written out by successful jobs.\n# TYPE pdvzip_output_bytes_total counter\n"
+		"pdvzip_output_bytes_total %.17g\n", static_cast<double>(output_bytes) + Base_Map["pdvzip_output_bytes_total"]);
+
+	Append(text, "# HELP pdvzip_jobs_in_flight Embed jobs currently running.\n# TYPE pdvzip_jobs_in_flight gauge\npdvzip_jobs_in_flight %llu\n",
+		static_cast<unsigned long long>(jobs_in_flight));
+
+	Append(text, "# HELP pdvzip_queue_depth Embed jobs waiting to start.\n# TYPE pdvzip_queue_depth gauge\npdvzip_queue_depth %llu\n",
+		static_cast<unsigned long long>(queue_depth));
+
+	Append(text, "# HELP pdvzip_last_job_bytes_per_second Output bytes per second of the most recent successful job in this process.\n# TYPE pdvzip_last_job_bytes_per_second gauge\n"
+		"pdvzip_last_job_bytes_per_second %.17g\n", last_bytes_per_second);
+
+	Append(text, "# HELP pdvzip_job_duration_seconds Embed job latency, from reading the files to writing the image.\n# TYPE pdvzip_job_duration_seconds histogram\n");
+	Append_Histogram(text, "pdvzip_job_duration_seconds", "", "", Job_Histogram);
+
+	Append(text, "# HELP pdvzip_stage_duration_seconds Pipeline stage latency, by stage.\n# TYPE pdvzip_stage_duration_seconds histogram\n");
+
+	for (size_t stage = 0; stage < STAGES; stage++) {
+		Append_Histogram(text, "pdvzip_stage_duration_seconds", "stage", Stage_Name(static_cast<PDV_STAGE>(stage)), Stage_Histogram[stage]);
+	}
+
+	// Write a temporary file, then rename it over the metrics file, so that readers (e.g. node_exporter) never see a partly written file.
+	const std::string TEMP_NAME = metrics_file_name + ".tmp";
+
+	std::FILE* file_ofs = std::fopen(TEMP_NAME.c_str(), "wb");
+
+	if (!file_ofs) {
+		return false;
+	}
+
+	const bool WRITE_OK = std::fwrite(text.data(), 1, text.size(), file_ofs) == text.size();
+
+	if (std::fclose(file_ofs) || !WRITE_OK) {
+		std::remove(TEMP_NAME.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	// Windows "rename" does not replace an existing file.
+	std::remove(metrics_file_name.c_str());
+#endif
+
+	if (std::rename(TEMP_NAME.c_str(), metrics_file_name.c_str())) {
+		std::remove(TEMP_NAME.c_str());
+		return false;
+	}
+
+	metrics_dirty = false;
+	return true;
+}
+
+static void Write_Metrics_At_Exit() {
+	bool dirty;
+	{
+		const std::lock_guard<std::mutex> LOCK(metrics_mutex);
+		dirty = metrics_dirty;
+	}
+	if (dirty) {
+		Write_Metrics();
+	}
+}
+
+static void Load_Base(const std::string& metrics_name) {
+	std::FILE* file_ifs = std::fopen(metrics_name.c_str(), "rb");
+
+	if (!file_ifs) {
+		return;
+	}
+
+	char line[512];
+
+	// Whether the samples that follow belong to a counter or histogram family (gauges are not carried on).
+	bool carry_on = false;
+
+	while (std::fgets(line, sizeof(line), file_ifs)) {
+		line[std::strcspn(line, "\r\n")] = '\0';
+
+		if (!std::strncmp(line, "# TYPE ", 7)) {
+			const char* TYPE = std::strrchr(line, ' ') + 1;
+			carry_on = !std::strcmp(TYPE, "counter") || !std::strcmp(TYPE, "histogram");
+		}
+		else if (*line && *line != '#' && carry_on) {
+			char* value = std::strrchr(line, ' ');
+			if (value) {
+				*value++ = '\0';
+				Base_Map[line] = std::strtod(value, nullptr);
+			}
+		}
+	}
+	std::fclose(file_ifs);
+}
+
+static void Append(std::string& text, const char* format, ...) {
+	char buffer[512];
+
+	va_list args;
+	va_start(args, format);
+	const int LENGTH = std::vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+
+	if (LENGTH > 0) {
+		text.append(buffer, std::min(static_cast<size_t>(LENGTH), sizeof(buffer) - 1));
+	}
+}
@@ -0,0 +1,31 @@
+// 	PDVZIP metrics output, for "--metrics pdvzip.prom".
+
+//	Keeps job, byte & error counters, queue gauges and latency histograms (per job & per pipeline stage, see "PDV_STAGE"),
+//	and writes them to a file in the Prometheus text exposition format. Point the node_exporter "textfile" collector at the file's directory,
+//	or read it directly. Errors are counted by reason, using the "Error_Name" of each "PDV_ERROR" value (e.g. result="ihdr_bad_char").
+
+//	Counters & histograms carry on from the values already in the file, so they keep counting across runs of the program
+//	(one process per metrics file at a time). The file is rewritten (atomically, via a temporary file & rename) after each job and at exit.
+
+//	Safe to call from several threads at once.
+
+#pragma once
+
+#include <string>
+
+#include "pdv_core.hpp"
+
+void
+	// Start recording metrics, to be written to "metrics_name". Counters start from the values found in the file, if it exists.
+	Metrics_Open(const std::string&),
+	// "Stage" hook ("PDV_STRUCT"). Observe the stage's duration in the stage latency histogram.
+	Metrics_Stage(PDV_STRUCT&, PDV_STAGE, bool),
+	// A job has started on the calling thread ("image_size" & "zip_size" bytes in).
+	Metrics_Begin_Job(const PDV_STRUCT&),
+	// The calling thread's job has finished with the given result ("image_size" bytes out, on success). Rewrites the metrics file.
+	Metrics_End_Job(const PDV_STRUCT&, PDV_ERROR),
+	// Set the number of jobs waiting to start (for callers that queue jobs).
+	Metrics_Queue_Depth(size_t);
+
+// Write the metrics file now. Returns false if it could not be written.
+bool Write_Metrics();
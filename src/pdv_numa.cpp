@@ -0,0 +1,142 @@
+// 	PDVZIP NUMA topology & thread placement. See "pdv_numa.hpp".
+
+#include "pdv_numa.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+
+// Parse a sysfs CPU list ("0-3,8-11,16"), adding the CPUs within "allowed" to "Cpu_Vec". Returns false if the list is malformed.
+static bool Parse_Cpu_List(const char*, const cpu_set_t&, std::vector<uint32_t>&);
+
+std::vector<NUMA_NODE> Numa_Nodes() {
+	std::vector<NUMA_NODE> Node_Vec;
+
+	cpu_set_t allowed;
+
+	if (sched_getaffinity(0, sizeof(allowed), &allowed)) {
+		return Node_Vec;
+	}
+
+	DIR* node_dir = opendir("/sys/devices/system/node");
+
+	if (!node_dir) {
+		return Node_Vec;
+	}
+
+	while (const dirent* entry = readdir(node_dir)) {
+		char* end = nullptr;
+
+		if (std::strncmp(entry->d_name, "node", 4) || !std::isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+			continue;
+		}
+
+		const unsigned long ID = std::strtoul(entry->d_name + 4, &end, 10);
+
+		if (*end) {
+			continue;
+		}
+
+		const std::string LIST_NAME = std::string("/sys/devices/system/node/") + entry->d_name + "/cpulist";
+
+		std::FILE* list_ifs = std::fopen(LIST_NAME.c_str(), "rb");
+
+		if (!list_ifs) {
+			continue;
+		}
+
+		char list[4096]{};
+
+		const bool READ_OK = std::fgets(list, sizeof(list), list_ifs) != nullptr;
+
+		std::fclose(list_ifs);
+
+		NUMA_NODE node{ static_cast<uint32_t>(ID), {} };
+
+		// Memory-only nodes (no CPUs, e.g. CXL or HBM expanders) and nodes outside the affinity mask have no workers to run.
+		if (READ_OK && Parse_Cpu_List(list, allowed, node.Cpu_Vec) && !node.Cpu_Vec.empty()) {
+			Node_Vec.push_back(std::move(node));
+		}
+	}
+	closedir(node_dir);
+
+	std::sort(Node_Vec.begin(), Node_Vec.end(), [](const NUMA_NODE& a, const NUMA_NODE& b) { return a.id < b.id; });
+
+	return Node_Vec;
+}
+
+bool Numa_Bind(const NUMA_NODE& node) {
+	cpu_set_t cpus;
+
+	CPU_ZERO(&cpus);
+
+	for (const uint32_t CPU : node.Cpu_Vec) {
+		if (CPU < CPU_SETSIZE) {
+			CPU_SET(CPU, &cpus);
+		}
+	}
+	return !pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+}
+
+int Numa_Current_Node() {
+	unsigned
+		cpu = 0,
+		node = 0;
+
+	// The vDSO "getcpu" call is cheap (no system call), so this can be sampled often.
+	return getcpu(&cpu, &node) ? -1 : static_cast<int>(node);
+}
+
+static bool Parse_Cpu_List(const char* list, const cpu_set_t& allowed, std::vector<uint32_t>& Cpu_Vec) {
+	while (*list && *list != '\n') {
+		char* end = nullptr;
+
+		const unsigned long FIRST = std::strtoul(list, &end, 10);
+
+		unsigned long last = FIRST;
+
+		if (end == list) {
+			return false;
+		}
+		if (*end == '-') {
+			list = end + 1;
+			last = std::strtoul(list, &end, 10);
+
+			if (end == list || last < FIRST) {
+				return false;
+			}
+		}
+		for (unsigned long cpu = FIRST; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &allowed)) {
+				Cpu_Vec.push_back(static_cast<uint32_t>(cpu));
+			}
+		}
+		list = *end == ',' ? end + 1 : end;
+	}
+	return true;
+}
+
+#else
+
+std::vector<NUMA_NODE> Numa_Nodes() {
+	return {};
+}
+
+bool Numa_Bind(const NUMA_NODE&) {
+	return false;
+}
+
+int Numa_Current_Node() {
+	return -1;
+}
+
+#endif
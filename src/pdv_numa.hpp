@@ -0,0 +1,26 @@
+// 	PDVZIP NUMA topology & thread placement, for the job scheduler (see "pdv_sched.hpp"). Linux only (sysfs), elsewhere no nodes are found.
+
+//	The nodes are read from "/sys/devices/system/node/node<N>/cpulist", keeping only the CPUs this process may run on (its affinity mask,
+//	e.g. as set by "taskset", "numactl --cpunodebind" or a container's cpuset), and only the nodes left with at least one of them.
+
+//	Memory placement relies on the kernel's default (first-touch) policy: a page is placed on the node of the CPU that first writes to it.
+//	So a buffer allocated & filled by a thread bound to a node stays local to that node's workers.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct NUMA_NODE {
+	uint32_t id;
+	std::vector<uint32_t> Cpu_Vec;	// CPUs of the node this process may run on, in ascending order.
+};
+
+// Nodes with CPUs this process may run on, in ascending order of id. Empty if the topology isn't available.
+std::vector<NUMA_NODE> Numa_Nodes();
+
+// Bind the calling thread to the CPUs of the node (the kernel still balances it across them). Returns false on failure.
+bool Numa_Bind(const NUMA_NODE&);
+
+// Node of the CPU the calling thread is running on, or -1 if unknown.
+int Numa_Current_Node();
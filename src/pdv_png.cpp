@@ -0,0 +1,1118 @@
+// 	PDVZIP PNG decoder. See "pdv_png.hpp".
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include <zlib.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PDV_SSE2
+#endif
+
+#if defined(PDV_SSE2) && defined(__GNUC__)
+#include <immintrin.h>
+#define PDV_AVX2
+#endif
+
+#include "pdv_png.hpp"
+
+// Largest unfiltered image accepted (1 GiB), so that a crafted IHDR can't request an unbounded allocation.
+static constexpr size_t MAX_RAW_SIZE = size_t{ 1 } << 30;
+
+// Smallest image (unfiltered bytes) worth unfiltering on more than one thread.
+static constexpr size_t PARALLEL_MIN_SIZE = size_t{ 1 } << 20;
+
+enum : Byte {
+	FILTER_NONE,
+	FILTER_SUB,
+	FILTER_UP,
+	FILTER_AVERAGE,
+	FILTER_PAETH
+};
+
+// Inflate the data of every IDAT chunk (in file order) into the buffer, which must be filled exactly. Returns false on zlib errors or too little data.
+static bool Inflate_Idat(const std::vector<const Byte*>&, const std::vector<uint32_t>&, Byte*, size_t);
+
+// Unfilter "rows" rows of "row_size" bytes, each preceded by its filter type byte, in place. Runs of rows are split across threads where possible.
+// Returns false if a row has an invalid filter type.
+static bool Unfilter_Rows(Byte*, size_t, size_t, size_t, size_t);
+
+// Decode an interlaced (Adam7) image from the inflated data into "Pixel_Vec". Returns false if a row has an invalid filter type.
+static bool Deinterlace(PNG_IMAGE&, Byte*);
+
+// Scalar kernels, for any pixel size.
+static void Unfilter_Row_Scalar(Byte filter, Byte* row, const Byte* prior, size_t length, size_t pixel_size) {
+	switch (filter) {
+		case FILTER_SUB:
+			for (size_t i = pixel_size; i < length; i++) {
+				row[i] = static_cast<Byte>(row[i] + row[i - pixel_size]);
+			}
+			break;
+		case FILTER_UP:
+			if (prior) {
+				for (size_t i = 0; i < length; i++) {
+					row[i] = static_cast<Byte>(row[i] + prior[i]);
+				}
+			}
+			break;
+		case FILTER_AVERAGE:
+			for (size_t i = 0; i < length; i++) {
+				const unsigned
+					LEFT = i >= pixel_size ? row[i - pixel_size] : 0,
+					ABOVE = prior ? prior[i] : 0;
+				row[i] = static_cast<Byte>(row[i] + ((LEFT + ABOVE) >> 1));
+			}
+			break;
+		case FILTER_PAETH:
+			for (size_t i = 0; i < length; i++) {
+				const int
+					A = i >= pixel_size ? row[i - pixel_size] : 0,
+					B = prior ? prior[i] : 0,
+					C = prior && i >= pixel_size ? prior[i - pixel_size] : 0,
+					PA = std::abs(B - C),
+					PB = std::abs(A - C),
+					PC = std::abs(A + B - 2 * C);
+				row[i] = static_cast<Byte>(row[i] + (PA <= PB && PA <= PC ? A : (PB <= PC ? B : C)));
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+#ifdef PDV_SSE2
+
+// Load/store one 3 or 4 byte pixel in the low lane of a vector.
+template <size_t N>
+static inline __m128i Load_Pixel(const Byte* ptr) {
+	int value = 0;
+	std::memcpy(&value, ptr, N);
+	return _mm_cvtsi32_si128(value);
+}
+
+template <size_t N>
+static inline void Store_Pixel(Byte* ptr, __m128i pixel) {
+	const int VALUE = _mm_cvtsi128_si32(pixel);
+	std::memcpy(ptr, &VALUE, N);
+}
+
+static void Unfilter_Up_Sse2(Byte* row, const Byte* prior, size_t length) {
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		const __m128i SUM = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(prior + i)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), SUM);
+	}
+	for (; i < length; i++) {
+		row[i] = static_cast<Byte>(row[i] + prior[i]);
+	}
+}
+
+// Sub, 4 byte pixels: a 16 byte block (4 pixels) is prefix summed within the register (shift & add twice), then the previous block's last pixel is added to every pixel.
+static void Unfilter_Sub4_Sse2(Byte* row, size_t length) {
+	__m128i last = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= length; i += 16) {
+		__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+		block = _mm_add_epi8(block, _mm_slli_si128(block, 4));
+		block = _mm_add_epi8(block, _mm_slli_si128(block, 8));
+		block = _mm_add_epi8(block, last);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), block);
+		last = _mm_shuffle_epi32(block, 0xFF);
+	}
+	for (; i < length; i++) {
+		row[i] = static_cast<Byte>(row[i] + (i >= 4 ? row[i - 4] : 0));
+	}
+}
+
+template <size_t N>
+static void Unfilter_Sub_Sse2(Byte* row, size_t length) {
+	__m128i a = _mm_setzero_si128();
+	for (size_t i = 0; i < length; i += N) {
+		a = _mm_add_epi8(a, Load_Pixel<N>(row + i));
+		Store_Pixel<N>(row + i, a);
+	}
+}
+
+// Average: floor((a + b) / 2) per byte, from the rounding-up "_mm_avg_epu8" less the bit it rounded up by.
+template <size_t N>
+static void Unfilter_Average_Sse2(Byte* row, const Byte* prior, size_t length) {
+	const __m128i ONE = _mm_set1_epi8(1);
+	__m128i a = _mm_setzero_si128();
+	for (size_t i = 0; i < length; i += N) {
+		const __m128i
+			B = Load_Pixel<N>(prior + i),
+			AVERAGE = _mm_sub_epi8(_mm_avg_epu8(a, B), _mm_and_si128(_mm_xor_si128(a, B), ONE));
+		a = _mm_add_epi8(Load_Pixel<N>(row + i), AVERAGE);
+		Store_Pixel<N>(row + i, a);
+	}
+}
+
+// Paeth, in 16-bit lanes: pa = |b - c|, pb = |a - c|, pc = |(b - c) + (a - c)|, then pick a, b or c (ties favour a, then b).
+template <size_t N>
+static void Unfilter_Paeth_Sse2(Byte* row, const Byte* prior, size_t length) {
+	const __m128i ZERO = _mm_setzero_si128();
+
+	const auto Abs = [&ZERO](__m128i x) { return _mm_max_epi16(x, _mm_sub_epi16(ZERO, x)); };
+	const auto Select = [](__m128i mask, __m128i x, __m128i y) { return _mm_or_si128(_mm_and_si128(mask, x), _mm_andnot_si128(mask, y)); };
+
+	__m128i
+		a = ZERO,
+		c = ZERO;
+
+	for (size_t i = 0; i < length; i += N) {
+		const __m128i
+			B = _mm_unpacklo_epi8(Load_Pixel<N>(prior + i), ZERO),
+			B_C = _mm_sub_epi16(B, c),
+			A_C = _mm_sub_epi16(a, c),
+			PA = Abs(B_C),
+			PB = Abs(A_C),
+			PC = Abs(_mm_add_epi16(B_C, A_C)),
+			SMALLEST = _mm_min_epi16(PC, _mm_min_epi16(PA, PB)),
+			NEAREST = Select(_mm_cmpeq_epi16(SMALLEST, PA), a, Select(_mm_cmpeq_epi16(SMALLEST, PB), B, c)),
+			PIXEL = _mm_add_epi8(Load_Pixel<N>(row + i), _mm_packus_epi16(NEAREST, NEAREST));
+
+		Store_Pixel<N>(row + i, PIXEL);
+
+		a = _mm_unpacklo_epi8(PIXEL, ZERO);
+		c = B;
+	}
+}
+
+#endif
+
+#ifdef PDV_AVX2
+
+__attribute__((target("avx2")))
+static void Unfilter_Up_Avx2(Byte* row, const Byte* prior, size_t length) {
+	size_t i = 0;
+	for (; i + 32 <= length; i += 32) {
+		const __m256i SUM = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prior + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), SUM);
+	}
+	for (; i < length; i++) {
+		row[i] = static_cast<Byte>(row[i] + prior[i]);
+	}
+}
+
+static const bool HAS_AVX2 = __builtin_cpu_supports("avx2");
+
+#endif
+
+void Unfilter_Row(Byte filter, Byte* row, const Byte* prior, size_t length, size_t pixel_size, bool use_simd) {
+#ifdef PDV_SSE2
+	// Pixel-serial kernels need whole pixels, so the SIMD path is only taken for 3 & 4 byte pixels (8-bit RGB & RGBA) on rows of whole pixels.
+	// The first row's "prior" is all zeros: Average & Paeth become simpler (scalar) cases there.
+	const bool SIMD_PIXEL = use_simd && (pixel_size == 3 || pixel_size == 4) && length % pixel_size == 0;
+
+	if (use_simd) {
+		switch (filter) {
+			case FILTER_UP:
+				if (prior) {
+#ifdef PDV_AVX2
+					if (HAS_AVX2) {
+						Unfilter_Up_Avx2(row, prior, length);
+						return;
+					}
+#endif
+					Unfilter_Up_Sse2(row, prior, length);
+				}
+				return;
+			case FILTER_SUB:
+				if (SIMD_PIXEL) {
+					pixel_size == 4 ? Unfilter_Sub4_Sse2(row, length) : Unfilter_Sub_Sse2<3>(row, length);
+					return;
+				}
+				break;
+			case FILTER_AVERAGE:
+				if (SIMD_PIXEL && prior) {
+					pixel_size == 4 ? Unfilter_Average_Sse2<4>(row, prior, length) : Unfilter_Average_Sse2<3>(row, prior, length);
+					return;
+				}
+				break;
+			case FILTER_PAETH:
+				if (SIMD_PIXEL && prior) {
+					pixel_size == 4 ? Unfilter_Paeth_Sse2<4>(row, prior, length) : Unfilter_Paeth_Sse2<3>(row, prior, length);
+					return;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+#else
+	(void)use_simd;
+#endif
+	Unfilter_Row_Scalar(filter, row, prior, length, pixel_size);
+}
+
+PDV_ERROR Decode_Png(const std::vector<Byte>& Image_Vec, PNG_IMAGE& image, size_t threads) {
+
+	constexpr size_t
+		SIGNATURE_SIZE = 8,
+		IHDR_LENGTH = 13;
+
+	constexpr Byte PNG_SIG[]{ 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	if (Image_Vec.size() < SIGNATURE_SIZE + IHDR_VIEW::SIZE || !std::equal(PNG_SIG, PNG_SIG + SIGNATURE_SIZE, Image_Vec.begin())) {
+		return PDV_ERROR::IMAGE_SIGNATURE;
+	}
+
+	// The views only read from the image.
+	Byte* const IMAGE_DATA = const_cast<Byte*>(Image_Vec.data());
+
+	const IHDR_VIEW IHDR(IMAGE_DATA + SIGNATURE_SIZE, Image_Vec.size() - SIGNATURE_SIZE);
+
+	if (IHDR.Name() != 0x49484452 || IHDR.Length() != IHDR_LENGTH) {	// "IHDR"
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	image.width = IHDR.Width();
+	image.height = IHDR.Height();
+	image.bit_depth = IHDR.Bit_Depth();
+	image.color_type = IHDR.Color_Type();
+
+	const Byte INTERLACE = IHDR.Interlace();
+
+	const bool VALID_DEPTH = image.color_type == 3 ? (image.bit_depth == 1 || image.bit_depth == 2 || image.bit_depth == 4 || image.bit_depth == 8)
+		: ((image.color_type == 2 || image.color_type == 6) && (image.bit_depth == 8 || image.bit_depth == 16));
+
+	if (!VALID_DEPTH) {
+		return PDV_ERROR::IMAGE_COLOR_TYPE;
+	}
+
+	if (!image.width || !image.height || image.width > 0x7FFFFFFF || image.height > 0x7FFFFFFF || INTERLACE > 1) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	image.channels = image.color_type == 2 ? 3 : (image.color_type == 6 ? 4 : 1);
+
+	const size_t BITS_PER_PIXEL = image.channels * image.bit_depth;
+
+	image.pixel_size = std::max<size_t>(1, BITS_PER_PIXEL / 8);
+
+	// Check the image size before computing row sizes from it, so that nothing below can overflow.
+	if (image.width > MAX_RAW_SIZE / BITS_PER_PIXEL || static_cast<size_t>(image.height) > MAX_RAW_SIZE / ((image.width * BITS_PER_PIXEL + 7) / 8 + 1)) {
+		return PDV_ERROR::IMAGE_DIMENSIONS;
+	}
+
+	image.row_size = (image.width * BITS_PER_PIXEL + 7) / 8;
+
+	// Walk the chunks after IHDR, collecting each IDAT chunk's data span (fed to inflate in order, without copying), the palette & transparency.
+	std::vector<const Byte*> Idat_Vec;
+	std::vector<uint32_t> Idat_Length_Vec;
+
+	image.Palette_Vec.clear();
+	image.Trns_Vec.clear();
+
+	size_t chunk_index = SIGNATURE_SIZE + IHDR_VIEW::SIZE;
+
+	while (true) {
+		const PNG_CHUNK_VIEW CHUNK(IMAGE_DATA + chunk_index, chunk_index < Image_Vec.size() ? Image_Vec.size() - chunk_index : 0);
+
+		if (!CHUNK.Fits(0, PNG_CHUNK_VIEW::OVERHEAD) || !CHUNK.Fits(0, CHUNK.Total_Size())) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+
+		const uint32_t
+			NAME = CHUNK.Name(),
+			LENGTH = CHUNK.Length();
+
+		const Byte* CHUNK_DATA = CHUNK.data + PNG_CHUNK_VIEW::HEADER_SIZE;
+
+		if (NAME == 0x49444154) {		// "IDAT"
+			Idat_Vec.push_back(CHUNK_DATA);
+			Idat_Length_Vec.push_back(LENGTH);
+		}
+		else if (NAME == 0x504C5445) {		// "PLTE"
+			image.Palette_Vec.assign(CHUNK_DATA, CHUNK_DATA + LENGTH);
+		}
+		else if (NAME == 0x74524E53) {		// "tRNS"
+			image.Trns_Vec.assign(CHUNK_DATA, CHUNK_DATA + LENGTH);
+		}
+		else if (NAME == 0x49454E44) {		// "IEND"
+			break;
+		}
+		chunk_index += CHUNK.Total_Size();
+	}
+
+	if (Idat_Vec.empty() || (image.color_type == 3 && (image.Palette_Vec.empty() || image.Palette_Vec.size() % 3))) {
+		return image.color_type == 3 && image.Palette_Vec.empty() ? PDV_ERROR::PLTE_MISSING : PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	// Inflated size: each row (of each Adam7 pass, when interlaced) is preceded by its filter type byte.
+	size_t raw_size = 0;
+
+	if (INTERLACE) {
+		constexpr uint32_t
+			X_START[]{ 0, 4, 0, 2, 0, 1, 0 }, X_STEP[]{ 8, 8, 4, 4, 2, 2, 1 },
+			Y_START[]{ 0, 0, 4, 0, 2, 0, 1 }, Y_STEP[]{ 8, 8, 8, 4, 4, 2, 2 };
+
+		for (size_t pass = 0; pass < 7; pass++) {
+			const size_t
+				PASS_WIDTH = image.width > X_START[pass] ? (image.width - X_START[pass] + X_STEP[pass] - 1) / X_STEP[pass] : 0,
+				PASS_HEIGHT = image.height > Y_START[pass] ? (image.height - Y_START[pass] + Y_STEP[pass] - 1) / Y_STEP[pass] : 0;
+
+			if (PASS_WIDTH && PASS_HEIGHT) {
+				raw_size += PASS_HEIGHT * ((PASS_WIDTH * BITS_PER_PIXEL + 7) / 8 + 1);
+			}
+		}
+	}
+	else {
+		raw_size = image.height * (image.row_size + 1);
+	}
+
+	if (INTERLACE) {
+		std::vector<Byte> Raw_Vec(raw_size);
+
+		if (!Inflate_Idat(Idat_Vec, Idat_Length_Vec, Raw_Vec.data(), raw_size)) {
+			return PDV_ERROR::IMAGE_CORRUPT;
+		}
+		return Deinterlace(image, Raw_Vec.data()) ? PDV_ERROR::NONE : PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	// Not interlaced: inflate into "Pixel_Vec", unfilter each row in place, then close up the gaps left by the filter type bytes.
+	image.Pixel_Vec.resize(raw_size);
+
+	Byte* const RAW = image.Pixel_Vec.data();
+
+	if (!Inflate_Idat(Idat_Vec, Idat_Length_Vec, RAW, raw_size)) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	if (!threads) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	if (!Unfilter_Rows(RAW, image.height, image.row_size, image.pixel_size, raw_size >= PARALLEL_MIN_SIZE ? threads : 1)) {
+		return PDV_ERROR::IMAGE_CORRUPT;
+	}
+
+	for (size_t row = 0; row < image.height; row++) {
+		std::memmove(RAW + row * image.row_size, RAW + row * (image.row_size + 1) + 1, image.row_size);
+	}
+	image.Pixel_Vec.resize(image.height * image.row_size);
+
+	return PDV_ERROR::NONE;
+}
+
+static bool Inflate_Idat(const std::vector<const Byte*>& Idat_Vec, const std::vector<uint32_t>& Idat_Length_Vec, Byte* out, size_t out_size) {
+	z_stream stream{};
+
+	if (inflateInit(&stream) != Z_OK) {
+		return false;
+	}
+
+	int status = Z_OK;
+
+	size_t produced = 0;
+
+	for (size_t i = 0; i < Idat_Vec.size() && status == Z_OK; i++) {
+		stream.next_in = const_cast<Bytef*>(Idat_Vec[i]);
+		stream.avail_in = Idat_Length_Vec[i];
+
+		// "avail_out" is 32 bits wide, so larger outputs are given to inflate a window at a time.
+		while (stream.avail_in && status == Z_OK && produced < out_size) {
+			const size_t WINDOW = std::min<size_t>(out_size - produced, 0x40000000);
+
+			stream.next_out = out + produced;
+			stream.avail_out = static_cast<uInt>(WINDOW);
+
+			status = inflate(&stream, Z_NO_FLUSH);
+
+			produced += WINDOW - stream.avail_out;
+		}
+		if (produced == out_size) {
+			// All rows inflated. Any image data left over (or a missing zlib trailer) is ignored, as other decoders do.
+			break;
+		}
+	}
+	inflateEnd(&stream);
+
+	return produced == out_size && (status == Z_OK || status == Z_STREAM_END || status == Z_BUF_ERROR);
+}
+
+// Unfilter the rows [first, last) in order. The row before "first" (if any) must already be unfiltered.
+static bool Unfilter_Run(Byte* raw, size_t first, size_t last, size_t row_size, size_t pixel_size) {
+	const size_t STRIDE = row_size + 1;
+
+	for (size_t row = first; row < last; row++) {
+		Byte* const LINE = raw + row * STRIDE;
+
+		if (LINE[0] > FILTER_PAETH) {
+			return false;
+		}
+		Unfilter_Row(LINE[0], LINE + 1, row ? LINE + 1 - STRIDE : nullptr, row_size, pixel_size);
+	}
+	return true;
+}
+
+static bool Unfilter_Rows(Byte* raw, size_t rows, size_t row_size, size_t pixel_size, size_t threads) {
+	const size_t STRIDE = row_size + 1;
+
+	// Rows filtered with None or Sub only depend on themselves, so each starts a run that can be unfiltered independently of the rows before it.
+	std::vector<size_t> Run_Start_Vec{ 0 };
+
+	if (threads > 1) {
+		for (size_t row = 1; row < rows; row++) {
+			if (raw[row * STRIDE] <= FILTER_SUB) {
+				Run_Start_Vec.push_back(row);
+			}
+		}
+	}
+
+	if (Run_Start_Vec.size() < 2) {
+		return Unfilter_Run(raw, 0, rows, row_size, pixel_size);
+	}
+
+	Run_Start_Vec.push_back(rows);
+
+	// Give each thread a contiguous group of runs, of about "rows / threads" rows, ending on a run boundary.
+	threads = std::min(threads, Run_Start_Vec.size() - 1);
+
+	std::vector<std::thread> Thread_Vec;
+	std::vector<char> Result_Vec(threads, 1);
+
+	size_t run = 0;
+
+	for (size_t t = 0; t < threads && run + 1 < Run_Start_Vec.size(); t++) {
+		const size_t
+			FIRST = Run_Start_Vec[run],
+			TARGET = t + 1 == threads ? rows : rows * (t + 1) / threads;
+
+		while (run + 1 < Run_Start_Vec.size() - 1 && Run_Start_Vec[run + 1] < TARGET) {
+			run++;
+		}
+		run++;
+
+		const size_t LAST = Run_Start_Vec[run];
+
+		Thread_Vec.emplace_back([=, &Result_Vec] { Result_Vec[t] = Unfilter_Run(raw, FIRST, LAST, row_size, pixel_size); });
+	}
+
+	for (std::thread& thread : Thread_Vec) {
+		thread.join();
+	}
+	return std::all_of(Result_Vec.begin(), Result_Vec.end(), [](char ok) { return ok; });
+}
+
+static bool Deinterlace(PNG_IMAGE& image, Byte* raw) {
+	constexpr uint32_t
+		X_START[]{ 0, 4, 0, 2, 0, 1, 0 }, X_STEP[]{ 8, 8, 4, 4, 2, 2, 1 },
+		Y_START[]{ 0, 0, 4, 0, 2, 0, 1 }, Y_STEP[]{ 8, 8, 8, 4, 4, 2, 2 };
+
+	const size_t BITS_PER_PIXEL = image.channels * image.bit_depth;
+
+	image.Pixel_Vec.assign(image.height * image.row_size, 0);
+
+	for (size_t pass = 0; pass < 7; pass++) {
+		const size_t
+			PASS_WIDTH = image.width > X_START[pass] ? (image.width - X_START[pass] + X_STEP[pass] - 1) / X_STEP[pass] : 0,
+			PASS_HEIGHT = image.height > Y_START[pass] ? (image.height - Y_START[pass] + Y_STEP[pass] - 1) / Y_STEP[pass] : 0;
+
+		if (!PASS_WIDTH || !PASS_HEIGHT) {
+			continue;
+		}
+
+		const size_t PASS_ROW_SIZE = (PASS_WIDTH * BITS_PER_PIXEL + 7) / 8;
+
+		if (!Unfilter_Run(raw, 0, PASS_HEIGHT, PASS_ROW_SIZE, image.pixel_size)) {
+			return false;
+		}
+
+		// Scatter the pass's pixels to their places within the image.
+		for (size_t y = 0; y < PASS_HEIGHT; y++) {
+			const Byte* PASS_ROW = raw + y * (PASS_ROW_SIZE + 1) + 1;
+
+			Byte* const IMAGE_ROW = image.Pixel_Vec.data() + (Y_START[pass] + y * Y_STEP[pass]) * image.row_size;
+
+			for (size_t x = 0; x < PASS_WIDTH; x++) {
+				const size_t IMAGE_X = X_START[pass] + x * X_STEP[pass];
+
+				if (BITS_PER_PIXEL >= 8) {
+					std::memcpy(IMAGE_ROW + IMAGE_X * image.pixel_size, PASS_ROW + x * image.pixel_size, image.pixel_size);
+				}
+				else {
+					// Sub-byte indices are packed from the most significant bit.
+					const size_t
+						SOURCE_BIT = x * BITS_PER_PIXEL,
+						TARGET_BIT = IMAGE_X * BITS_PER_PIXEL;
+
+					const Byte
+						MASK = static_cast<Byte>((1u << BITS_PER_PIXEL) - 1),
+						VALUE = static_cast<Byte>((PASS_ROW[SOURCE_BIT / 8] >> (8 - BITS_PER_PIXEL - SOURCE_BIT % 8)) & MASK);
+
+					IMAGE_ROW[TARGET_BIT / 8] |= static_cast<Byte>(VALUE << (8 - BITS_PER_PIXEL - TARGET_BIT % 8));
+				}
+			}
+		}
+		raw += PASS_HEIGHT * (PASS_ROW_SIZE + 1);
+	}
+	return true;
+}
+
+// Set of up to 512 colour keys: 256 buckets of 4 slots, linear probing between buckets. A key of 0 marks an empty slot, so key 0 is tracked apart.
+template <typename Key>
+struct COLOR_SET {
+	static constexpr size_t
+		BUCKETS = 256,
+		SLOTS = 4;
+
+	alignas(16) Key Slot_Arr[BUCKETS * SLOTS]{};
+
+	size_t count{};
+	bool has_zero{};
+
+	void Insert(Key key) {
+		if (!key) {
+			count += !has_zero;
+			has_zero = true;
+			return;
+		}
+
+		// Fibonacci hashing, on the key folded to 32 bits.
+		size_t bucket = (static_cast<uint32_t>(key ^ (key >> 16 >> 16)) * 0x9E3779B1u) >> 24;
+
+		while (true) {
+			Key* const SLOT = Slot_Arr + bucket * SLOTS;
+#ifdef PDV_SSE2
+			if constexpr (sizeof(Key) == 4) {
+				const __m128i BUCKET = _mm_load_si128(reinterpret_cast<const __m128i*>(SLOT));
+
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(BUCKET, _mm_set1_epi32(static_cast<int>(key))))) {
+					return;
+				}
+
+				const int EMPTY = _mm_movemask_epi8(_mm_cmpeq_epi32(BUCKET, _mm_setzero_si128()));
+
+				if (EMPTY) {
+					SLOT[__builtin_ctz(static_cast<unsigned>(EMPTY)) / 4] = key;
+					count++;
+					return;
+				}
+				bucket = (bucket + 1) % BUCKETS;
+				continue;
+			}
+#endif
+			for (size_t i = 0; i < SLOTS; i++) {
+				if (SLOT[i] == key) {
+					return;
+				}
+				if (!SLOT[i]) {
+					SLOT[i] = key;
+					count++;
+					return;
+				}
+			}
+			bucket = (bucket + 1) % BUCKETS;
+		}
+	}
+};
+
+// Insert each pixel's key (read by "Get_Key" from "pixel_size" bytes) until "limit" colours are found. Runs of a repeated pixel are only inserted once.
+template <typename Key, typename Get>
+static size_t Count_Keys(const Byte* pixels, size_t pixel_count, size_t pixel_size, size_t limit, Get Get_Key) {
+	COLOR_SET<Key> set;
+
+	Key last = Get_Key(pixels);
+	set.Insert(last);
+
+	for (size_t i = 1; i < pixel_count && set.count < limit; i++) {
+#ifdef PDV_SSE2
+		// 4 byte pixels: skip 4 at a time while they all repeat the last one.
+		if constexpr (sizeof(Key) == 4) {
+			if (pixel_size == 4) {
+				const __m128i LAST = _mm_set1_epi32(static_cast<int>(last));
+
+				while (i + 4 <= pixel_count
+					&& _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4)), LAST)) == 0xFFFF) {
+					i += 4;
+				}
+				if (i == pixel_count) {
+					break;
+				}
+			}
+		}
+#endif
+		const Key KEY = Get_Key(pixels + i * pixel_size);
+
+		if (KEY != last) {
+			set.Insert(KEY);
+			last = KEY;
+		}
+	}
+	return std::min(set.count, limit);
+}
+
+size_t Count_Colors(const PNG_IMAGE& image, size_t limit) {
+	limit = std::min<size_t>(limit, 512);
+
+	if (image.Pixel_Vec.empty()) {
+		return 0;
+	}
+
+	const Byte* PIXELS = image.Pixel_Vec.data();
+
+	const size_t PIXEL_COUNT = static_cast<size_t>(image.width) * image.height;
+
+	if (image.color_type == 3) {
+		// At most 256 indices, so a flag per index will do.
+		bool used[256]{};
+
+		size_t count = 0;
+
+		const unsigned
+			BITS = image.bit_depth,
+			MASK = (1u << BITS) - 1;
+
+		for (size_t y = 0; y < image.height && count < limit; y++) {
+			const Byte* ROW = PIXELS + y * image.row_size;
+
+			for (size_t x = 0; x < image.width; x++) {
+				const size_t BIT = x * BITS;
+				const Byte INDEX = static_cast<Byte>((ROW[BIT / 8] >> (8 - BITS - BIT % 8)) & MASK);
+
+				count += !used[INDEX];
+				used[INDEX] = true;
+			}
+		}
+		return std::min(count, limit);
+	}
+
+	// Keys are the pixel's bytes, in memory order. Truecolour (type 2) keys get an opaque alpha, so that no colour maps to the empty key 0 more than once.
+	if (image.bit_depth == 8) {
+		if (image.color_type == 6) {
+			return Count_Keys<uint32_t>(PIXELS, PIXEL_COUNT, 4, limit, [](const Byte* pixel) { uint32_t key; std::memcpy(&key, pixel, 4); return key; });
+		}
+		return Count_Keys<uint32_t>(PIXELS, PIXEL_COUNT, 3, limit, [](const Byte* pixel) {
+			return static_cast<uint32_t>(pixel[0] | pixel[1] << 8 | pixel[2] << 16) | 0xFF000000u;
+		});
+	}
+
+	if (image.color_type == 6) {
+		return Count_Keys<uint64_t>(PIXELS, PIXEL_COUNT, 8, limit, [](const Byte* pixel) { uint64_t key; std::memcpy(&key, pixel, 8); return key; });
+	}
+	return Count_Keys<uint64_t>(PIXELS, PIXEL_COUNT, 6, limit, [](const Byte* pixel) {
+		uint64_t key = uint64_t{ 0xFFFF } << 48;
+		std::memcpy(&key, pixel, 6);
+		return key;
+	});
+}
+
+bool Reduce_Png(PNG_IMAGE& image) {
+	if (image.color_type == 3 || image.Pixel_Vec.empty()) {
+		return false;
+	}
+
+	const size_t
+		SAMPLE_SIZE = image.bit_depth / 8,
+		PIXEL_COUNT = static_cast<size_t>(image.width) * image.height;
+
+	const Byte* const PIXELS = image.Pixel_Vec.data();
+
+	// 16-bit samples reduce exactly to 8 bits when both their bytes are equal (v * 257).
+	bool to_8_bit = SAMPLE_SIZE == 1;
+
+	if (!to_8_bit) {
+		to_8_bit = true;
+		for (size_t i = 0; i < image.Pixel_Vec.size() && to_8_bit; i += 2) {
+			to_8_bit = PIXELS[i] == PIXELS[i + 1];
+		}
+	}
+
+	bool opaque = image.color_type == 2;
+
+	if (!opaque) {
+		opaque = true;
+		for (size_t i = 0; i < PIXEL_COUNT && opaque; i++) {
+			const Byte* ALPHA = PIXELS + (i * 4 + 3) * SAMPLE_SIZE;
+			opaque = ALPHA[0] == 0xFF && ALPHA[SAMPLE_SIZE - 1] == 0xFF;
+		}
+	}
+
+	const bool TO_PALETTE = opaque && to_8_bit && Count_Colors(image) < PNG8_COLOR_LIMIT;
+
+	if (!TO_PALETTE && !(SAMPLE_SIZE == 2 && to_8_bit) && !(image.color_type == 6 && opaque)) {
+		return false;
+	}
+
+	// RGB of pixel "i", from the high byte of each sample (exact, when reducing to 8 bits).
+	const auto Rgb_Key = [&](size_t i) {
+		const Byte* PIXEL = PIXELS + i * image.channels * SAMPLE_SIZE;
+		return static_cast<uint32_t>(PIXEL[0] << 16 | PIXEL[SAMPLE_SIZE] << 8 | PIXEL[2 * SAMPLE_SIZE]);
+	};
+
+	PNG_IMAGE reduced;
+
+	reduced.width = image.width;
+	reduced.height = image.height;
+
+	std::vector<uint32_t> Color_Vec;
+
+	if (TO_PALETTE) {
+		COLOR_SET<uint32_t> set;
+		for (size_t i = 0; i < PIXEL_COUNT; i++) {
+			set.Insert(Rgb_Key(i) | 0xFF000000u);
+		}
+		for (const uint32_t KEY : set.Slot_Arr) {
+			if (KEY) {
+				Color_Vec.push_back(KEY & 0xFFFFFF);
+			}
+		}
+		std::sort(Color_Vec.begin(), Color_Vec.end());
+
+		reduced.color_type = 3;
+		reduced.bit_depth = Color_Vec.size() <= 2 ? 1 : (Color_Vec.size() <= 4 ? 2 : (Color_Vec.size() <= 16 ? 4 : 8));
+		reduced.channels = 1;
+
+		for (const uint32_t COLOR : Color_Vec) {
+			reduced.Palette_Vec.insert(reduced.Palette_Vec.end(), { static_cast<Byte>(COLOR >> 16), static_cast<Byte>(COLOR >> 8), static_cast<Byte>(COLOR) });
+		}
+	}
+	else {
+		reduced.color_type = opaque ? 2 : 6;
+		reduced.bit_depth = to_8_bit ? 8 : 16;
+		reduced.channels = opaque ? 3 : 4;
+	}
+
+	const size_t
+		BITS_PER_PIXEL = reduced.channels * reduced.bit_depth,
+		NEW_SAMPLE_SIZE = reduced.bit_depth / 8;
+
+	reduced.pixel_size = std::max<size_t>(1, BITS_PER_PIXEL / 8);
+	reduced.row_size = (reduced.width * BITS_PER_PIXEL + 7) / 8;
+
+	// Reduced rows are never larger than the originals, so each is built in "Row_Vec", then written over the start of "Pixel_Vec".
+	std::vector<Byte> Row_Vec(reduced.row_size);
+
+	uint32_t last_key = 0xFFFFFFFF;
+	Byte last_index = 0;
+
+	for (size_t y = 0; y < image.height; y++) {
+		std::fill(Row_Vec.begin(), Row_Vec.end(), Byte{ 0 });
+
+		for (size_t x = 0; x < image.width; x++) {
+			const size_t I = y * image.width + x;
+
+			if (TO_PALETTE) {
+				const uint32_t KEY = Rgb_Key(I);
+
+				if (KEY != last_key) {
+					last_key = KEY;
+					last_index = static_cast<Byte>(std::lower_bound(Color_Vec.begin(), Color_Vec.end(), KEY) - Color_Vec.begin());
+				}
+
+				const size_t BIT = x * reduced.bit_depth;
+				Row_Vec[BIT / 8] |= static_cast<Byte>(last_index << (8 - reduced.bit_depth - BIT % 8));
+			}
+			else {
+				const Byte* PIXEL = PIXELS + I * image.channels * SAMPLE_SIZE;
+
+				for (size_t c = 0; c < reduced.channels; c++) {
+					std::memcpy(Row_Vec.data() + (x * reduced.channels + c) * NEW_SAMPLE_SIZE, PIXEL + c * SAMPLE_SIZE, NEW_SAMPLE_SIZE);
+				}
+			}
+		}
+		std::memcpy(image.Pixel_Vec.data() + y * reduced.row_size, Row_Vec.data(), reduced.row_size);
+	}
+
+	image.Pixel_Vec.resize(image.height * reduced.row_size);
+
+	reduced.Pixel_Vec.swap(image.Pixel_Vec);
+	image = std::move(reduced);
+
+	return true;
+}
+
+// Filter one row (of "length" bytes, "prior" = the unfiltered row above or nullptr) into "out". The inverse of "Unfilter_Row_Scalar".
+static void Filter_Row(Byte filter, const Byte* row, const Byte* prior, size_t length, size_t pixel_size, Byte* out) {
+	for (size_t i = 0; i < length; i++) {
+		const int
+			A = i >= pixel_size ? row[i - pixel_size] : 0,
+			B = prior ? prior[i] : 0,
+			C = prior && i >= pixel_size ? prior[i - pixel_size] : 0;
+
+		int predictor = 0;
+
+		switch (filter) {
+			case FILTER_SUB:
+				predictor = A;
+				break;
+			case FILTER_UP:
+				predictor = B;
+				break;
+			case FILTER_AVERAGE:
+				predictor = (A + B) >> 1;
+				break;
+			case FILTER_PAETH: {
+				const int
+					PA = std::abs(B - C),
+					PB = std::abs(A - C),
+					PC = std::abs(A + B - 2 * C);
+				predictor = PA <= PB && PA <= PC ? A : (PB <= PC ? B : C);
+				break;
+			}
+			default:
+				break;
+		}
+		out[i] = static_cast<Byte>(row[i] - predictor);
+	}
+}
+
+// Compress "size" bytes to a zlib stream, in slices on up to "threads" threads (see "pdv_png.hpp"). Returns false if zlib fails.
+static bool Deflate_Parallel(const Byte* data, size_t size, int strategy, size_t threads, std::vector<Byte>& Out_Vec) {
+	// Smallest slice worth its own thread. Smaller slices also cost compression ratio (each restarts its Huffman tables).
+	constexpr size_t
+		MIN_SLICE_SIZE = 128 * 1024,
+		DICTIONARY_SIZE = 32 * 1024;
+
+	const size_t SLICES = std::max<size_t>(1, std::min(threads, size / MIN_SLICE_SIZE));
+
+	std::vector<std::vector<Byte>> Slice_Vec(SLICES);
+	std::vector<uLong> Adler_Vec(SLICES);
+	std::vector<char> Result_Vec(SLICES, 0);
+
+	const auto Deflate_Slice = [&](size_t slice) {
+		const size_t
+			START = size * slice / SLICES,
+			END = size * (slice + 1) / SLICES;
+
+		const bool LAST = slice + 1 == SLICES;
+
+		z_stream stream{};
+
+		if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -15, 9, strategy) != Z_OK) {
+			return;
+		}
+
+		if (START) {
+			const size_t DICTIONARY_LENGTH = std::min(START, DICTIONARY_SIZE);
+			deflateSetDictionary(&stream, data + START - DICTIONARY_LENGTH, static_cast<uInt>(DICTIONARY_LENGTH));
+		}
+
+		std::vector<Byte>& Slice = Slice_Vec[slice];
+
+		// deflateBound, plus the sync flush's empty stored block.
+		Slice.resize(deflateBound(&stream, static_cast<uLong>(END - START)) + 16);
+
+		stream.next_in = const_cast<Bytef*>(data + START);
+		stream.avail_in = static_cast<uInt>(END - START);
+		stream.next_out = Slice.data();
+		stream.avail_out = static_cast<uInt>(Slice.size());
+
+		const int STATUS = deflate(&stream, LAST ? Z_FINISH : Z_SYNC_FLUSH);
+
+		Result_Vec[slice] = (LAST ? STATUS == Z_STREAM_END : STATUS == Z_OK) && !stream.avail_in;
+
+		Slice.resize(stream.total_out);
+		deflateEnd(&stream);
+
+		Adler_Vec[slice] = adler32(adler32(0, nullptr, 0), data + START, static_cast<uInt>(END - START));
+	};
+
+	std::vector<std::thread> Thread_Vec;
+
+	for (size_t slice = 1; slice < SLICES; slice++) {
+		Thread_Vec.emplace_back(Deflate_Slice, slice);
+	}
+	Deflate_Slice(0);
+
+	for (std::thread& thread : Thread_Vec) {
+		thread.join();
+	}
+
+	if (!std::all_of(Result_Vec.begin(), Result_Vec.end(), [](char ok) { return ok; })) {
+		return false;
+	}
+
+	// zlib header (deflate, 32 KB window, maximum compression), the slices, then the Adler-32 of all the data.
+	Out_Vec.assign({ 0x78, 0xDA });
+
+	uLong adler = Adler_Vec[0];
+
+	for (size_t slice = 0; slice < SLICES; slice++) {
+		Out_Vec.insert(Out_Vec.end(), Slice_Vec[slice].begin(), Slice_Vec[slice].end());
+		std::vector<Byte>().swap(Slice_Vec[slice]);
+
+		if (slice) {
+			adler = adler32_combine(adler, Adler_Vec[slice], static_cast<z_off_t>(size * (slice + 1) / SLICES - size * slice / SLICES));
+		}
+	}
+
+	const size_t ADLER_INDEX = Out_Vec.size();
+	Out_Vec.resize(ADLER_INDEX + 4);
+	Store<uint32_t, Endian::Big>(Out_Vec.data() + ADLER_INDEX, static_cast<uint32_t>(adler));
+
+	return true;
+}
+
+// Compress the filtered rows ("raw_size" bytes, each row preceded by its filter type byte) and write the PNG file for the image into the vector.
+// Returns false if zlib fails or the file would exceed "max_size" bytes (0 = no limit).
+static bool Write_Png(const PNG_IMAGE&, const Byte*, size_t, int, size_t, size_t, std::vector<Byte>&);
+
+// Append a PNG chunk (length, name, data & CRC fields) to the vector.
+static void Append_Chunk(std::vector<Byte>& Png_Vec, uint32_t name, const Byte* data, size_t length) {
+	const size_t INDEX = Png_Vec.size();
+
+	Png_Vec.resize(INDEX + length + PNG_CHUNK_VIEW::OVERHEAD);
+
+	Byte* const CHUNK = Png_Vec.data() + INDEX;
+
+	Store<uint32_t, Endian::Big>(CHUNK, static_cast<uint32_t>(length));
+	Store<uint32_t, Endian::Big>(CHUNK + 4, name);
+
+	if (length) {
+		std::memcpy(CHUNK + PNG_CHUNK_VIEW::HEADER_SIZE, data, length);
+	}
+
+	const uLong CRC = crc32(crc32(0, nullptr, 0), CHUNK + 4, static_cast<uInt>(length + 4));
+	Store<uint32_t, Endian::Big>(CHUNK + PNG_CHUNK_VIEW::HEADER_SIZE + length, static_cast<uint32_t>(CRC));
+}
+
+bool Encode_Png(PNG_IMAGE& image, std::vector<Byte>& Png_Vec, size_t max_size, size_t threads) {
+	const size_t
+		ROWS = image.height,
+		ROW_SIZE = image.row_size,
+		STRIDE = ROW_SIZE + 1;
+
+	if (image.Pixel_Vec.size() != ROWS * ROW_SIZE) {
+		return false;
+	}
+
+	// Make room for each row's filter type byte, moving the rows apart from the last one back.
+	image.Pixel_Vec.resize(ROWS * STRIDE);
+
+	Byte* const RAW = image.Pixel_Vec.data();
+
+	for (size_t row = ROWS; row--;) {
+		std::memmove(RAW + row * STRIDE + 1, RAW + row * ROW_SIZE, ROW_SIZE);
+	}
+
+	// Indexed-colour & sub-byte images compress best unfiltered. Otherwise, each row gets the filter with the least sum of absolute (signed) differences.
+	// Rows are filtered from the last one up, so that the row above is still unfiltered when each row is filtered.
+	const bool ADAPTIVE = image.color_type != 3 && image.bit_depth >= 8;
+
+	std::vector<Byte> Candidate_Vec(ADAPTIVE ? 2 * ROW_SIZE : 0);
+
+	for (size_t row = ROWS; row--;) {
+		Byte* const LINE = RAW + row * STRIDE;
+
+		LINE[0] = FILTER_NONE;
+
+		if (!ADAPTIVE) {
+			continue;
+		}
+
+		const Byte* PRIOR = row ? LINE + 1 - STRIDE : nullptr;
+
+		Byte* best = Candidate_Vec.data();
+		Byte* trial = best + ROW_SIZE;
+
+		const auto Cost = [ROW_SIZE](const Byte* data) {
+			size_t sum = 0;
+			for (size_t i = 0; i < ROW_SIZE; i++) {
+				sum += data[i] < 128 ? data[i] : 256 - data[i];
+			}
+			return sum;
+		};
+
+		size_t best_cost = Cost(LINE + 1);
+
+		Byte best_filter = FILTER_NONE;
+
+		for (Byte filter = FILTER_SUB; filter <= FILTER_PAETH; filter++) {
+			Filter_Row(filter, LINE + 1, PRIOR, ROW_SIZE, image.pixel_size, trial);
+
+			const size_t COST = Cost(trial);
+
+			if (COST < best_cost) {
+				best_cost = COST;
+				best_filter = filter;
+				std::swap(best, trial);
+			}
+		}
+
+		if (best_filter != FILTER_NONE) {
+			LINE[0] = best_filter;
+			std::memcpy(LINE + 1, best, ROW_SIZE);
+		}
+	}
+
+	return Write_Png(image, RAW, image.Pixel_Vec.size(), ADAPTIVE ? Z_FILTERED : Z_DEFAULT_STRATEGY, threads, max_size, Png_Vec);
+}
+
+static bool Write_Png(const PNG_IMAGE& image, const Byte* raw, size_t raw_size, int strategy, size_t threads, size_t max_size, std::vector<Byte>& Png_Vec) {
+	if (!threads) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	std::vector<Byte> Idat_Vec;
+
+	if (!Deflate_Parallel(raw, raw_size, strategy, threads, Idat_Vec)) {
+		return false;
+	}
+
+	constexpr Byte PNG_SIG[]{ 0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	const size_t PNG_SIZE = sizeof(PNG_SIG) + IHDR_VIEW::SIZE + (image.color_type == 3 ? image.Palette_Vec.size() + PNG_CHUNK_VIEW::OVERHEAD : 0)
+		+ Idat_Vec.size() + 2 * PNG_CHUNK_VIEW::OVERHEAD;
+
+	if (max_size && PNG_SIZE > max_size) {
+		return false;
+	}
+
+	Byte ihdr[13]{};
+
+	Store<uint32_t, Endian::Big>(ihdr, image.width);
+	Store<uint32_t, Endian::Big>(ihdr + 4, image.height);
+	ihdr[8] = image.bit_depth;
+	ihdr[9] = image.color_type;
+
+	Png_Vec.clear();
+	Png_Vec.reserve(PNG_SIZE);
+	Png_Vec.assign(PNG_SIG, PNG_SIG + sizeof(PNG_SIG));
+
+	Append_Chunk(Png_Vec, 0x49484452, ihdr, sizeof(ihdr));	// "IHDR"
+
+	if (image.color_type == 3) {
+		Append_Chunk(Png_Vec, 0x504C5445, image.Palette_Vec.data(), image.Palette_Vec.size());	// "PLTE"
+	}
+	Append_Chunk(Png_Vec, 0x49444154, Idat_Vec.data(), Idat_Vec.size());	// "IDAT"
+	Append_Chunk(Png_Vec, 0x49454E44, nullptr, 0);	// "IEND"
+
+	return true;
+}
+
+bool Generate_Gradient_Png(uint32_t width, uint32_t height, std::vector<Byte>& Png_Vec) {
+	PNG_IMAGE image;
+
+	image.width = width;
+	image.height = height;
+	image.color_type = 2;
+	image.bit_depth = 8;
+	image.channels = 3;
+	image.pixel_size = 3;
+	image.row_size = width * image.pixel_size;
+
+	const size_t STRIDE = image.row_size + 1;
+
+	// Pixel (x, y) is RGB (x mod 256, y mod 256, 0). The filtered rows are written directly: the first row with Sub (red steps by 1),
+	// every other row with Up (green steps by 1), so the image data is one short byte pattern repeated, which deflate reduces to almost nothing.
+	std::vector<Byte> Raw_Vec(height * STRIDE);
+
+	Raw_Vec[0] = FILTER_SUB;
+	for (size_t x = 1; x < width; x++) {
+		Raw_Vec[1 + x * 3] = 1;
+	}
+
+	for (size_t y = 1; y < height; y++) {
+		Byte* const LINE = Raw_Vec.data() + y * STRIDE;
+
+		LINE[0] = FILTER_UP;
+		for (size_t x = 0; x < width; x++) {
+			LINE[2 + x * 3] = 1;
+		}
+	}
+	return Write_Png(image, Raw_Vec.data(), Raw_Vec.size(), Z_DEFAULT_STRATEGY, 1, 0, Png_Vec);
+}
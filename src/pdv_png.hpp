@@ -0,0 +1,78 @@
+// 	PDVZIP PNG decoder, for cover image analysis & transformation (colour counting, palette conversion, recompression).
+
+//	Decodes the colour types accepted by "Check_Image_File": Truecolour (2), Indexed-colour (3) & Truecolour with alpha (6),
+//	at any bit depth the PNG specification allows for them (1, 2, 4, 8 for type 3; 8, 16 for types 2 & 6), interlaced or not.
+
+//	The IDAT chunk data is fed to zlib's inflate span by span, straight from the image (no concatenation copy), into one buffer sized from IHDR.
+//	Scanlines are then unfiltered with SSE2 kernels (Sub, Average & Paeth for 3 & 4 byte pixels, Up for all) and AVX2 (Up) where the CPU has it,
+//	with a scalar fallback for other pixel sizes & CPUs. Rows filtered with None or Sub don't depend on the row above,
+//	so each one starts an independent run of rows, and runs are unfiltered in parallel on large images.
+
+//	"Count_Colors" counts the distinct colours of a decoded image, for the PNG-8 downgrade check (platforms such as Twitter convert
+//	PNG-32/24 images of 256 colours or less to PNG-8, which destroys the embedded content). It stops as soon as the limit is reached,
+//	using a small hash set of 4-slot buckets, each probed with one SSE2 compare, and skipping runs of repeated pixels 4 at a time.
+
+//	"Reduce_Png" & "Encode_Png" shrink a truecolour cover losslessly: opaque alpha is dropped (6 -> 2), 16-bit samples that are exact 8-bit values
+//	are reduced to 8 bits, and images of 256 colours or less become Indexed-colour (3) at the smallest bit depth that holds the palette.
+//	The image is then re-encoded (row filters chosen per row, by least sum of absolute differences) with a parallel deflate:
+//	the filtered rows are split into slices compressed on their own threads, each primed with the 32 KB before it as its dictionary
+//	and ended on a byte boundary (sync flush), so the slices join into one zlib stream (Adler-32s combined).
+
+//	Requires zlib (link with -lz).
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "pdv_core.hpp"
+
+struct PNG_IMAGE {
+	uint32_t
+		width{},
+		height{};
+
+	Byte
+		bit_depth{},
+		color_type{};
+
+	size_t
+		channels{},		// Samples per pixel: 3 (type 2), 1 (type 3) or 4 (type 6).
+		pixel_size{},		// Bytes per complete pixel, rounded up to 1 (the filter offset).
+		row_size{};		// Bytes per unfiltered row (no filter type byte).
+
+	// Unfiltered pixel rows ("height" rows of "row_size" bytes), at the image's own bit depth & sample order (big-endian 16-bit samples, packed sub-byte indices).
+	std::vector<Byte> Pixel_Vec;
+
+	// PLTE entries (RGB triples) & tRNS chunk data, if present.
+	std::vector<Byte> Palette_Vec, Trns_Vec;
+};
+
+// Decode the PNG image held in the vector (a complete PNG file). "threads" limits the threads used to unfilter rows (0 = one per CPU).
+// Returns "IMAGE_COLOR_TYPE" for colour types / bit depths other than those above, "IMAGE_DIMENSIONS" for images
+// too large to decode (over 1 GiB unfiltered) and "IMAGE_CORRUPT" for malformed chunks or image data.
+PDV_ERROR Decode_Png(const std::vector<Byte>&, PNG_IMAGE&, size_t = 0);
+
+// Colour count at which "Count_Colors" stops by default: one more than PNG-8 can hold.
+constexpr size_t PNG8_COLOR_LIMIT = 257;
+
+// Count the distinct colours (RGBA, at the image's bit depth) of the decoded image, up to "limit" (at most 512). Returns "limit" if there are that many or more.
+// Indexed-colour images count the distinct palette indices used.
+size_t Count_Colors(const PNG_IMAGE&, size_t = PNG8_COLOR_LIMIT);
+
+// Reduce the decoded truecolour image (types 2 & 6) to its smallest lossless colour type & bit depth, as above, in place.
+// A palette is only made for fully opaque images (the embedding keeps no "tRNS" chunk). Returns false if no reduction applies (and for Indexed-colour images).
+bool Reduce_Png(PNG_IMAGE&);
+
+// Encode the image as a PNG file (IHDR, PLTE if Indexed-colour, one IDAT & IEND chunk) into the vector, using up to "threads" threads (0 = one per CPU).
+// "Pixel_Vec" is filtered in place, so the image can't be encoded twice. Returns false if zlib fails or the file would exceed "max_size" bytes (0 = no limit).
+bool Encode_Png(PNG_IMAGE&, std::vector<Byte>&, size_t = 0, size_t = 0);
+
+// Encode a "width" x "height" PNG-24 gradient (red = x, green = y, both mod 256), for use as a minimal cover image.
+// Every row filters (Sub / Up) to the same few bytes, so the file stays within a few hundred bytes (a few KB at 899 x 899).
+// With at least 17 x 17 pixels it has more than 256 colours, so platforms keep it as PNG-24. Returns false if zlib fails.
+bool Generate_Gradient_Png(uint32_t, uint32_t, std::vector<Byte>&);
+
+// Unfilter one row in place, with the unfiltered row above ("prior", or nullptr for the first row). Exposed for benchmarking the kernels.
+// "use_simd" = false forces the scalar kernels.
+void Unfilter_Row(Byte, Byte*, const Byte*, size_t, size_t, bool = true);
@@ -0,0 +1,58 @@
+// 	PDVZIP USDT probes (static tracepoints), for observing live processes with bpftrace, perf or SystemTap, without restarting them.
+
+//	Built on <sys/sdt.h> (package systemtap-sdt-dev / systemtap-sdt-devel) when it is installed, otherwise every probe compiles to nothing.
+//	An unattached probe costs a single "nop". Arguments that cost something to compute (durations) are only computed while a tracer
+//	is attached to that probe, which is checked with the probe's semaphore (set by the tracer).
+
+//	Provider "pdvzip". Probes & arguments:
+//	job__start	image_size, zip_size
+//	job__end	result (PDV_ERROR), output_size, duration_ns
+//	stage__start	stage (PDV_STAGE), stage_name
+//	stage__end	stage, stage_name, result (PDV_ERROR), duration_ns
+//	crc		length, duration_ns
+//	io__read	length, duration_ns
+//	io__write	length, duration_ns
+
+//	List them:	$ readelf -n pdvzip | grep -A4 stapsdt
+//	Example:	$ sudo bpftrace -e 'usdt:./pdvzip:pdvzip:stage__end { @ns[str(arg1)] = hist(arg3); }'
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define PDV_USDT
+#endif
+#endif
+
+#ifdef PDV_USDT
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+// Define a probe's semaphore. Once per probe, within the file that fires it.
+#define PDV_PROBE_SEMAPHORE(name) unsigned short pdvzip_##name##_semaphore __attribute__((unused)) __attribute__((section(".probes")))
+
+#define PDV_PROBE_ENABLED(name) __builtin_expect(pdvzip_##name##_semaphore != 0, 0)
+
+#define PDV_PROBE2(name, a1, a2) STAP_PROBE2(pdvzip, name, a1, a2)
+#define PDV_PROBE3(name, a1, a2, a3) STAP_PROBE3(pdvzip, name, a1, a2, a3)
+#define PDV_PROBE4(name, a1, a2, a3, a4) STAP_PROBE4(pdvzip, name, a1, a2, a3, a4)
+
+#else
+
+#define PDV_PROBE_SEMAPHORE(name) static_assert(true, "USDT probes disabled")
+#define PDV_PROBE_ENABLED(name) false
+// Arguments are named within "sizeof" (never evaluated), so that values only computed for probes don't trigger unused variable warnings.
+#define PDV_PROBE2(name, a1, a2) ((void)sizeof((a1), (a2)))
+#define PDV_PROBE3(name, a1, a2, a3) ((void)sizeof((a1), (a2), (a3)))
+#define PDV_PROBE4(name, a1, a2, a3, a4) ((void)sizeof((a1), (a2), (a3), (a4)))
+
+#endif
+
+// Clock for probe durations. Only read while a probe that reports a duration is enabled.
+inline uint64_t Probe_Now_Ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
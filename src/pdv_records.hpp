@@ -0,0 +1,196 @@
+// 	Typed views over the PNG & ZIP binary records used by pdvzip.
+
+//	Each view wraps a pointer to the start of a record, plus the number of bytes available from that point to the end of the buffer.
+//	Field accessors are constexpr big-endian (PNG) or little-endian (ZIP) loads/stores of a fixed width at a fixed offset,
+//	which the compiler reduces to a single mov (little-endian) or mov + bswap/movbe (big-endian) on x86.
+
+//	Accessors are bounds-checked (assert) in debug builds and unchecked in release builds (-DNDEBUG).
+//	Untrusted offsets and lengths must still be validated by the parser (see "Fits"), before a field is read.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+typedef unsigned char Byte;
+
+enum class Endian { Big, Little };
+
+// Each byte is loaded/stored by its own expression (fold over the byte index), rather than a loop,
+// so the byte-combine is visible to the compiler before loop unrolling and merges into one load/store.
+template <typename T, Endian E, size_t... I>
+constexpr T Load(const Byte* ptr, std::index_sequence<I...>) {
+	return static_cast<T>(((static_cast<T>(ptr[I]) << (8 * (E == Endian::Big ? sizeof(T) - 1 - I : I))) | ...));
+}
+
+template <typename T, Endian E, size_t... I>
+constexpr void Store(Byte* ptr, T value, std::index_sequence<I...>) {
+	((ptr[I] = static_cast<Byte>(value >> (8 * (E == Endian::Big ? sizeof(T) - 1 - I : I)))), ...);
+}
+
+template <typename T, Endian E>
+constexpr T Load(const Byte* ptr) {
+	return Load<T, E>(ptr, std::make_index_sequence<sizeof(T)>{});
+}
+
+template <typename T, Endian E>
+constexpr void Store(Byte* ptr, T value) {
+	Store<T, E>(ptr, value, std::make_index_sequence<sizeof(T)>{});
+}
+
+inline constexpr Byte LOAD_TEST[4]{ 0x01, 0x02, 0x03, 0x04 };
+static_assert(Load<uint32_t, Endian::Big>(LOAD_TEST) == 0x01020304 && Load<uint32_t, Endian::Little>(LOAD_TEST) == 0x04030201, "Endian load");
+
+// Base for all record views. "E" is the byte order of the record's multi-byte fields.
+template <Endian E>
+struct RECORD_VIEW {
+	Byte* data;
+	size_t size;	// Bytes available from "data" to the end of the underlying buffer.
+
+	constexpr RECORD_VIEW(Byte* record_data, size_t available) : data(record_data), size(available) {}
+	RECORD_VIEW(std::vector<Byte>& vec, size_t index) : data(vec.data() + index), size(index < vec.size() ? vec.size() - index : 0) {}
+
+	// Check that "length" bytes from "offset" lie within the buffer. Use this to validate untrusted offsets/lengths.
+	constexpr bool Fits(size_t offset, size_t length) const { return offset <= size && length <= size - offset; }
+
+	template <typename T>
+	constexpr T Get(size_t offset) const {
+		assert(Fits(offset, sizeof(T)));
+		return Load<T, E>(data + offset);
+	}
+
+	template <typename T>
+	constexpr void Set(size_t offset, T value) const {
+		assert(Fits(offset, sizeof(T)));
+		Store<T, E>(data + offset, value);
+	}
+};
+
+// PNG chunk: 4-byte length, 4-byte name, data ("length" bytes), 4-byte CRC (covers name + data).
+struct PNG_CHUNK_VIEW : RECORD_VIEW<Endian::Big> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr size_t
+		HEADER_SIZE = 8,
+		OVERHEAD = 12;	// Length, name & CRC fields.
+
+	constexpr uint32_t Length() const { return Get<uint32_t>(0); }
+	constexpr uint32_t Name() const { return Get<uint32_t>(4); }
+	constexpr uint32_t Crc() const { return Get<uint32_t>(HEADER_SIZE + Length()); }
+	constexpr size_t Total_Size() const { return Length() + OVERHEAD; }
+
+	constexpr void Set_Length(uint32_t value) const { Set<uint32_t>(0, value); }
+	constexpr void Set_Crc(uint32_t value) const { Set<uint32_t>(HEADER_SIZE + Length(), value); }
+};
+
+// PNG IHDR chunk (view starts at the chunk's length field, index 8 of a PNG file).
+struct IHDR_VIEW : PNG_CHUNK_VIEW {
+	using PNG_CHUNK_VIEW::PNG_CHUNK_VIEW;
+
+	static constexpr size_t SIZE = 25;
+
+	constexpr uint32_t Width() const { return Get<uint32_t>(8); }
+	constexpr uint32_t Height() const { return Get<uint32_t>(12); }
+	constexpr Byte Bit_Depth() const { return Get<Byte>(16); }
+	constexpr Byte Color_Type() const { return Get<Byte>(17); }
+	constexpr Byte Interlace() const { return Get<Byte>(20); }
+};
+
+// ZIP local file header.
+struct ZIP_LOCAL_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint32_t SIG = 0x04034B50;	// "PK\x03\x04"
+	static constexpr size_t SIZE = 30;		// Fixed part of the record.
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Method() const { return Get<uint16_t>(8); }
+	constexpr uint32_t Crc() const { return Get<uint32_t>(14); }
+	constexpr uint32_t Compressed_Size() const { return Get<uint32_t>(18); }
+	constexpr uint32_t Uncompressed_Size() const { return Get<uint32_t>(22); }
+	constexpr uint16_t Name_Length() const { return Get<uint16_t>(26); }
+	constexpr uint16_t Extra_Length() const { return Get<uint16_t>(28); }
+	constexpr const Byte* Name() const { return data + SIZE; }
+	constexpr size_t Total_Size() const { return SIZE + Name_Length() + Extra_Length(); }	// Header only, excludes file data.
+};
+
+// ZIP central directory file header.
+struct ZIP_CENTRAL_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint32_t SIG = 0x02014B50;	// "PK\x01\x02"
+	static constexpr size_t SIZE = 46;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Method() const { return Get<uint16_t>(10); }
+	constexpr uint32_t Crc() const { return Get<uint32_t>(16); }
+	constexpr uint32_t Compressed_Size() const { return Get<uint32_t>(20); }
+	constexpr uint32_t Uncompressed_Size() const { return Get<uint32_t>(24); }
+	constexpr uint16_t Name_Length() const { return Get<uint16_t>(28); }
+	constexpr uint16_t Extra_Length() const { return Get<uint16_t>(30); }
+	constexpr uint16_t Comment_Length() const { return Get<uint16_t>(32); }
+	constexpr uint32_t Local_Offset() const { return Get<uint32_t>(42); }
+	constexpr const Byte* Name() const { return data + SIZE; }
+	constexpr size_t Total_Size() const { return SIZE + Name_Length() + Extra_Length() + Comment_Length(); }
+
+	constexpr void Set_Local_Offset(uint32_t value) const { Set<uint32_t>(42, value); }
+};
+
+// ZIP end of central directory record.
+struct ZIP_END_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint32_t SIG = 0x06054B50;	// "PK\x05\x06"
+	static constexpr size_t SIZE = 22;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint16_t Total_Records() const { return Get<uint16_t>(10); }
+	constexpr uint32_t Dir_Size() const { return Get<uint32_t>(12); }
+	constexpr uint32_t Dir_Offset() const { return Get<uint32_t>(16); }
+	constexpr uint16_t Comment_Length() const { return Get<uint16_t>(20); }
+
+	constexpr void Set_Dir_Offset(uint32_t value) const { Set<uint32_t>(16, value); }
+	constexpr void Set_Comment_Length(uint16_t value) const { Set<uint16_t>(20, value); }
+};
+
+// ZIP64 end of central directory locator (immediately precedes the end of central directory record).
+struct ZIP64_LOCATOR_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint32_t SIG = 0x07064B50;	// "PK\x06\x07"
+	static constexpr size_t SIZE = 20;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint64_t End_Offset() const { return Get<uint64_t>(8); }
+
+	constexpr void Set_End_Offset(uint64_t value) const { Set<uint64_t>(8, value); }
+};
+
+// ZIP64 end of central directory record.
+struct ZIP64_END_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint32_t SIG = 0x06064B50;	// "PK\x06\x06"
+	static constexpr size_t SIZE = 56;
+
+	constexpr uint32_t Signature() const { return Get<uint32_t>(0); }
+	constexpr uint64_t Total_Records() const { return Get<uint64_t>(32); }
+	constexpr uint64_t Dir_Size() const { return Get<uint64_t>(40); }
+	constexpr uint64_t Dir_Offset() const { return Get<uint64_t>(48); }
+
+	constexpr void Set_Dir_Offset(uint64_t value) const { Set<uint64_t>(48, value); }
+};
+
+// ZIP extra field header (tag + data size), as found within the local and central directory records.
+struct ZIP_EXTRA_VIEW : RECORD_VIEW<Endian::Little> {
+	using RECORD_VIEW::RECORD_VIEW;
+
+	static constexpr uint16_t ZIP64_TAG = 0x0001;
+	static constexpr size_t SIZE = 4;
+
+	constexpr uint16_t Tag() const { return Get<uint16_t>(0); }
+	constexpr uint16_t Data_Size() const { return Get<uint16_t>(2); }
+};
@@ -0,0 +1,311 @@
+// 	PDVZIP job scheduler. See "pdv_sched.hpp".
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "pdv_metrics.hpp"
+#include "pdv_numa.hpp"
+#include "pdv_sched.hpp"
+
+// Queue order: priority class, then earliest deadline (none last), then smallest job, then submission order.
+struct JOB_ORDER {
+	bool operator()(const PDV_JOB& a, const PDV_JOB& b) const {
+		if (a.priority != b.priority) {
+			return a.priority < b.priority;
+		}
+		const uint64_t
+			A_DEADLINE = a.deadline_ns ? a.deadline_ns : UINT64_MAX,
+			B_DEADLINE = b.deadline_ns ? b.deadline_ns : UINT64_MAX;
+
+		if (A_DEADLINE != B_DEADLINE) {
+			return A_DEADLINE < B_DEADLINE;
+		}
+		if (a.size != b.size) {
+			return a.size < b.size;
+		}
+		return a.sequence < b.sequence;
+	}
+};
+
+// One worker pool & job queue per NUMA node (a single one without NUMA). Its workers are bound to the node's CPUs,
+// so the buffers each job allocates & fills are placed on the node (first touch) and only ever read from it.
+struct NODE_POOL {
+	std::set<PDV_JOB, JOB_ORDER> Queue_Set;
+	size_t
+		workers,
+		queued_size;	// Input size of the jobs queued, for placing new jobs.
+};
+
+static std::vector<NODE_POOL> Pool_Vec;
+
+// NUMA nodes of the pools (empty without NUMA).
+static std::vector<NUMA_NODE> Node_Vec;
+
+static std::vector<std::thread> Worker_Vec;
+
+static std::mutex queue_mutex;
+static std::condition_variable queue_changed;
+
+static PDV_ERROR (*run_job)(PDV_JOB&);
+static void (*job_done)(const PDV_JOB&);
+
+static size_t
+	max_memory,
+	memory_in_use,
+	large_jobs_running,
+	large_job_limit,
+	next_sequence,
+	queued_jobs;
+
+static bool stopping;
+
+// Worker thread of the pool. Run jobs from the queues until they are empty & "Scheduler_Finish" has been called.
+static void Worker(size_t);
+
+// Find the next job for a worker of the pool, and remove it from its queue. Jobs found past their deadline are moved to "Expired_Vec".
+// Returns false if no job can start. Call with "queue_mutex" held.
+static bool Next_Job(size_t, PDV_JOB&, std::vector<PDV_JOB>&);
+
+// First job of the pool's queue, in queue order, that can start now (or the queue's end). Jobs found past their deadline are moved to "Expired_Vec".
+static std::set<PDV_JOB, JOB_ORDER>::iterator Startable_Job(NODE_POOL&, uint64_t, std::vector<PDV_JOB>&);
+
+uint64_t Sched_Now_Ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void Scheduler_Start(size_t workers, size_t memory_budget, PDV_ERROR (*run)(PDV_JOB&), void (*done)(const PDV_JOB&), bool numa) {
+	run_job = run;
+	job_done = done;
+	max_memory = memory_budget;
+	stopping = false;
+
+	workers = workers ? workers : 1;
+
+	// Keep one worker free of large jobs (when there is more than one), for small jobs.
+	large_job_limit = workers > 1 ? workers - 1 : 1;
+
+	Node_Vec.clear();
+
+	if (numa) {
+		Node_Vec = Numa_Nodes();
+	}
+	if (Node_Vec.size() < 2) {
+		Node_Vec.clear();
+	}
+
+	Pool_Vec.assign(Node_Vec.empty() ? 1 : Node_Vec.size(), NODE_POOL{});
+
+	// Share the workers out in proportion to each node's CPUs: each goes to the pool with the fewest workers per CPU.
+	std::vector<size_t> Worker_Pool_Vec;
+
+	for (size_t i = 0; i < workers; i++) {
+		size_t pool = 0;
+
+		for (size_t other = 1; other < Node_Vec.size(); other++) {
+			if ((Pool_Vec[other].workers + 1) * Node_Vec[pool].Cpu_Vec.size() < (Pool_Vec[pool].workers + 1) * Node_Vec[other].Cpu_Vec.size()) {
+				pool = other;
+			}
+		}
+		Pool_Vec[pool].workers++;
+		Worker_Pool_Vec.push_back(pool);
+	}
+
+#if defined(__GLIBC__)
+	// Job buffers ("Image_Vec", "Zip_Vec") are allocated & first written by the job's worker. Buffers from 1 MB up are mapped afresh
+	// for each job, rather than reusing heap memory a worker of another node may have touched first (glibc arenas are shared by threads).
+	if (!Node_Vec.empty()) {
+		mallopt(M_MMAP_THRESHOLD, 1024 * 1024);
+	}
+#endif
+
+	Worker_Vec.reserve(workers);
+
+	for (const size_t POOL : Worker_Pool_Vec) {
+		Worker_Vec.emplace_back(Worker, POOL);
+	}
+}
+
+size_t Scheduler_Nodes() {
+	return Node_Vec.size();
+}
+
+void Scheduler_Submit(std::vector<PDV_JOB> Job_Vec) {
+	const uint64_t NOW_NS = Sched_Now_Ns();
+
+	std::vector<PDV_JOB> Rejected_Vec;
+	{
+		const std::lock_guard<std::mutex> LOCK(queue_mutex);
+
+		for (PDV_JOB& job : Job_Vec) {
+			job.submit_ns = NOW_NS;
+			job.sequence = next_sequence++;
+
+			// Admission control. A job whose estimated memory exceeds the whole budget could never start.
+			if (!max_memory || max_memory >= job.memory) {
+				// Queue it with the pool that has the least queued input per worker.
+				size_t pool = 0;
+
+				while (!Pool_Vec[pool].workers) {
+					pool++;
+				}
+				for (size_t other = pool + 1; other < Pool_Vec.size(); other++) {
+					if (Pool_Vec[other].workers && Pool_Vec[other].queued_size * Pool_Vec[pool].workers < Pool_Vec[pool].queued_size * Pool_Vec[other].workers) {
+						pool = other;
+					}
+				}
+				Pool_Vec[pool].queued_size += job.size;
+				Pool_Vec[pool].Queue_Set.insert(std::move(job));
+				queued_jobs++;
+			}
+			else {
+				Rejected_Vec.push_back(std::move(job));
+			}
+		}
+		Metrics_Queue_Depth(queued_jobs);
+	}
+	queue_changed.notify_all();
+
+	for (PDV_JOB& job : Rejected_Vec) {
+		job.result = PDV_ERROR::MEMORY_BUDGET;
+		job.start_ns = job.end_ns = NOW_NS;
+		job_done(job);
+	}
+}
+
+void Scheduler_Finish() {
+	{
+		const std::lock_guard<std::mutex> LOCK(queue_mutex);
+		stopping = true;
+	}
+	queue_changed.notify_all();
+
+	for (std::thread& worker : Worker_Vec) {
+		worker.join();
+	}
+	Worker_Vec.clear();	Pool_Vec.clear();
+}
+
+static void Worker(size_t pool) {
+	if (!Node_Vec.empty()) {
+		Numa_Bind(Node_Vec[pool]);
+	}
+
+	std::vector<PDV_JOB> Expired_Vec;
+
+	std::unique_lock<std::mutex> lock(queue_mutex);
+
+	while (true) {
+		PDV_JOB job;
+
+		const bool
+			STARTED = Next_Job(pool, job, Expired_Vec),
+			EXPIRED = !Expired_Vec.empty();
+
+		if (EXPIRED) {
+			Metrics_Queue_Depth(queued_jobs);
+			lock.unlock();
+
+			for (PDV_JOB& expired : Expired_Vec) {
+				expired.result = PDV_ERROR::DEADLINE;
+				expired.start_ns = expired.end_ns = Sched_Now_Ns();
+				job_done(expired);
+			}
+			Expired_Vec.clear();
+
+			lock.lock();
+		}
+
+		if (STARTED) {
+			const bool LARGE = job.size >= SMALL_JOB_SIZE;
+
+			memory_in_use += job.memory;
+			large_jobs_running += LARGE;
+
+			Metrics_Queue_Depth(queued_jobs);
+			lock.unlock();
+
+			job.start_ns = Sched_Now_Ns();
+			job.result = run_job(job);
+			job.end_ns = Sched_Now_Ns();
+
+			job_done(job);
+
+			lock.lock();
+
+			memory_in_use -= job.memory;
+			large_jobs_running -= LARGE;
+
+			// Memory & a worker were freed. Any waiting worker may now be able to start a job.
+			queue_changed.notify_all();
+		}
+		else if (!queued_jobs && stopping) {
+			break;
+		}
+		else if (!EXPIRED) {
+			queue_changed.wait(lock);
+		}
+	}
+}
+
+static bool Next_Job(size_t pool, PDV_JOB& job, std::vector<PDV_JOB>& Expired_Vec) {
+	const uint64_t NOW_NS = Sched_Now_Ns();
+
+	// The pool's own queue first. A job of another pool's queue is taken only if it is of a higher priority class than any
+	// the worker could start from its own queue, so that priority classes hold across pools & no worker idles while another pool's jobs wait.
+	size_t source = pool;
+
+	auto best = Startable_Job(Pool_Vec[pool], NOW_NS, Expired_Vec);
+
+	for (size_t other = 0; other < Pool_Vec.size(); other++) {
+		if (other == pool) {
+			continue;
+		}
+
+		const auto FOUND = Startable_Job(Pool_Vec[other], NOW_NS, Expired_Vec);
+
+		if (FOUND != Pool_Vec[other].Queue_Set.end() && (best == Pool_Vec[source].Queue_Set.end() || FOUND->priority < best->priority)) {
+			source = other;
+			best = FOUND;
+		}
+	}
+
+	if (best == Pool_Vec[source].Queue_Set.end()) {
+		return false;
+	}
+
+	job = std::move(Pool_Vec[source].Queue_Set.extract(best).value());
+	Pool_Vec[source].queued_size -= job.size;
+	queued_jobs--;
+	return true;
+}
+
+static std::set<PDV_JOB, JOB_ORDER>::iterator Startable_Job(NODE_POOL& pool, uint64_t now_ns, std::vector<PDV_JOB>& Expired_Vec) {
+	std::set<PDV_JOB, JOB_ORDER>& Queue_Set = pool.Queue_Set;
+
+	for (auto it = Queue_Set.begin(); it != Queue_Set.end();) {
+		if (it->deadline_ns && now_ns > it->deadline_ns) {
+			pool.queued_size -= it->size;
+			queued_jobs--;
+			Expired_Vec.push_back(std::move(Queue_Set.extract(it++).value()));
+			continue;
+		}
+
+		const bool
+			LARGE_OK = it->size < SMALL_JOB_SIZE || large_job_limit > large_jobs_running,
+			MEMORY_OK = !max_memory || max_memory - memory_in_use >= it->memory;
+
+		if (LARGE_OK && MEMORY_OK) {
+			return it;
+		}
+		++it;
+	}
+	return Queue_Set.end();
+}
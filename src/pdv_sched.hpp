@@ -0,0 +1,84 @@
+// 	PDVZIP job scheduler, for running many embed jobs at once ("--batch jobs.txt").
+
+//	Jobs wait in a queue until a worker thread is free and the job's memory fits within the budget (admission control).
+//	The next job is chosen by:
+//	1. Priority class ("HIGH" before "NORMAL" before "LOW").
+//	2. Deadline, earliest first (jobs without one come after those with one).
+//	3. Size, smallest first (shortest job first).
+//	4. Submission order.
+
+//	Jobs whose deadline has passed before they could start are not run (result "DEADLINE"). Jobs that could never fit within
+//	the memory budget are rejected on submission (result "MEMORY_BUDGET").
+
+//	With two or more workers, large jobs ("SMALL_JOB_SIZE" bytes or more) are limited to all but one of them, so that
+//	small jobs never wait behind a worker pool full of large ones.
+
+//	On NUMA hosts, each node has its own worker pool (bound to the node's CPUs) and job queue. A job is queued with the pool holding the least
+//	queued input per worker, so its buffers are allocated, filled & copied on one node (first touch), never across the interconnect.
+//	A worker takes jobs from its own queue, and from another pool's queue only for a job of a higher priority class than it could start from its own
+//	(so the order above holds between classes, and within a class, within each pool).
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pdv_core.hpp"
+
+enum class PDV_PRIORITY {
+	HIGH,
+	NORMAL,
+	LOW,
+	COUNT
+};
+
+struct PDV_JOB {
+	// Files for the job. "output_name" is where the polyglot image is written.
+	std::string image_name, zip_name, output_name;
+
+	PDV_PRIORITY priority = PDV_PRIORITY::NORMAL;
+
+	size_t
+		size{},		// Input size (PNG image + ZIP file), in bytes. Orders jobs within a class & decides which jobs are "large".
+		memory{},	// Memory to reserve against the budget while the job runs (see "Job_Memory_Size").
+		sequence{};	// Submission order (set by "Scheduler_Submit").
+
+	// Latest time (steady clock, nanoseconds, see "Sched_Now_Ns") by which the job should finish. 0 = no deadline.
+	uint64_t deadline_ns{};
+
+	// Set by the scheduler. Times are steady clock nanoseconds.
+	uint64_t
+		submit_ns{},
+		start_ns{},
+		end_ns{};
+
+	PDV_ERROR result = PDV_ERROR::NONE;
+	bool streamed{};
+
+	// "--resume" journal (see "pdv_journal.hpp"): the job's key, then its output image's size & CRC-32 (set by the run callback, on success).
+	uint64_t
+		journal_key{},
+		output_size{};
+	uint32_t output_crc{};
+};
+
+// Input size (PNG image + ZIP file) from which a job is "large".
+constexpr size_t SMALL_JOB_SIZE = 1024 * 1024;
+
+// Steady clock, in nanoseconds, for job deadlines & times.
+uint64_t Sched_Now_Ns();
+
+// Number of NUMA nodes the workers of "Scheduler_Start" were shared out between (0 without NUMA: one pool, not bound to any node).
+size_t Scheduler_Nodes();
+
+void
+	// Start "workers" threads, with a memory budget of "max_memory" bytes (0 = no limit).
+	// Each job is run by "run" (on a worker thread). "done" is then called with the finished (or rejected) job, on the same thread, so must be thread safe.
+	// With "numa" set, on a host with two or more NUMA nodes (see "pdv_numa.hpp"), the workers are shared out between the nodes, in proportion to their CPUs,
+	// each pool of workers bound to its node & taking jobs from its own queue.
+	Scheduler_Start(size_t, size_t, PDV_ERROR (*)(PDV_JOB&), void (*)(const PDV_JOB&), bool = true),
+	// Queue jobs. Jobs submitted together are queued together, so that the first to start is the best of them (not just the first in the list).
+	Scheduler_Submit(std::vector<PDV_JOB>),
+	// Wait for every queued job to finish, then stop the worker threads.
+	Scheduler_Finish();
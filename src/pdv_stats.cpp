@@ -0,0 +1,186 @@
+// 	PDVZIP per-stage statistics. See "pdv_stats.hpp".
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "pdv_json.hpp"
+#include "pdv_stats.hpp"
+
+enum COUNTER { CYCLES, INSTRUCTIONS, LLC_MISSES, PAGE_FAULTS, COUNTER_TOTAL };
+
+struct STAGE_STATS {
+	uint64_t
+		calls,
+		wall_ns,
+		counters[COUNTER_TOTAL],
+		start_ns,
+		start_counters[COUNTER_TOTAL];
+};
+
+static STAGE_STATS Stage_Stats[static_cast<size_t>(PDV_STAGE::COUNT)];
+
+// perf_event_open file descriptor for each counter (-1 if not available).
+static int Counter_Fd[COUNTER_TOTAL]{ -1, -1, -1, -1 };
+
+static bool Counter_Available(int);
+
+static void Close_Counters();
+
+static uint64_t
+	Read_Counter(int),
+	Now_Ns();
+
+void Stats_Open() {
+#ifdef __linux__
+	struct EVENT { uint32_t type; uint64_t config; };
+
+	constexpr EVENT EVENTS[COUNTER_TOTAL]{
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+		{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+		{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+		{ PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS } };
+
+	for (int counter = 0; counter != COUNTER_TOTAL; counter++) {
+		perf_event_attr attr{};
+		attr.size = sizeof(attr);
+		attr.type = EVENTS[counter].type;
+		attr.config = EVENTS[counter].config;
+		attr.exclude_kernel = 1;	// Allowed with the default perf_event_paranoid setting (2).
+		attr.exclude_hv = 1;
+		attr.inherit = 1;		// Also count the threads started later ("--reduce-cover" deflates & unfilters on one per CPU).
+
+		// This thread (and, inherited, the threads it starts), any CPU, no group. Each counter runs (and can fail) independently.
+		// A thread's counts are added to the counter when it exits. The stages join their threads before they end, so each stage's delta includes them.
+		Counter_Fd[counter] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+	}
+#endif
+}
+
+void Stats_Stage(PDV_STRUCT&, PDV_STAGE stage, bool begin) {
+
+	STAGE_STATS& stats = Stage_Stats[static_cast<size_t>(stage)];
+
+	// Counters are read last on entry and first on exit, so the stage's own figures include as little of this function as possible.
+	if (begin) {
+		stats.start_ns = Now_Ns();
+		for (int counter = 0; counter != COUNTER_TOTAL; counter++) {
+			stats.start_counters[counter] = Read_Counter(counter);
+		}
+	}
+	else {
+		for (int counter = COUNTER_TOTAL - 1; counter >= 0; counter--) {
+			stats.counters[counter] += Read_Counter(counter) - stats.start_counters[counter];
+		}
+		stats.wall_ns += Now_Ns() - stats.start_ns;
+		stats.calls++;
+	}
+}
+
+bool Write_Stats_Report(const PDV_STRUCT& pdv, const std::string& output_name, bool streamed) {
+
+	constexpr const char* COUNTER_NAMES[COUNTER_TOTAL]{ "cycles", "instructions", "llc_misses", "page_faults" };
+
+	std::FILE* stats_ofs = std::fopen(pdv.stats_name.c_str(), "w");
+
+	if (!stats_ofs) {
+		Close_Counters();
+		return false;
+	}
+
+	std::fputs("{\n\t\"image\": ", stats_ofs);
+	Write_Json_String(stats_ofs, pdv.image_name);
+	std::fputs(",\n\t\"zip\": ", stats_ofs);
+	Write_Json_String(stats_ofs, pdv.zip_name);
+	std::fputs(",\n\t\"output\": ", stats_ofs);
+	Write_Json_String(stats_ofs, output_name);
+	std::fprintf(stats_ofs, ",\n\t\"output_size\": %zu,\n\t\"mode\": \"%s\",\n\t\"max_memory\": %zu,\n\t\"stages\": [",
+		pdv.image_size, streamed ? "stream" : "memory", pdv.max_memory);
+
+	STAGE_STATS total{};
+
+	for (size_t stage = 0; stage != static_cast<size_t>(PDV_STAGE::COUNT); stage++) {
+		const STAGE_STATS& stats = Stage_Stats[stage];
+
+		std::fprintf(stats_ofs, "%s\n\t\t{ \"stage\": \"%s\", \"calls\": %llu, \"wall_ns\": %llu", stage ? "," : "",
+			Stage_Name(static_cast<PDV_STAGE>(stage)), static_cast<unsigned long long>(stats.calls), static_cast<unsigned long long>(stats.wall_ns));
+
+		for (int counter = 0; counter != COUNTER_TOTAL; counter++) {
+			if (Counter_Available(counter)) {
+				std::fprintf(stats_ofs, ", \"%s\": %llu", COUNTER_NAMES[counter], static_cast<unsigned long long>(stats.counters[counter]));
+			}
+			else {
+				std::fprintf(stats_ofs, ", \"%s\": null", COUNTER_NAMES[counter]);
+			}
+			total.counters[counter] += stats.counters[counter];
+		}
+		std::fputs(" }", stats_ofs);
+
+		total.wall_ns += stats.wall_ns;
+	}
+
+	std::fprintf(stats_ofs, "\n\t],\n\t\"total\": { \"wall_ns\": %llu", static_cast<unsigned long long>(total.wall_ns));
+
+	for (int counter = 0; counter != COUNTER_TOTAL; counter++) {
+		if (Counter_Available(counter)) {
+			std::fprintf(stats_ofs, ", \"%s\": %llu", COUNTER_NAMES[counter], static_cast<unsigned long long>(total.counters[counter]));
+		}
+		else {
+			std::fprintf(stats_ofs, ", \"%s\": null", COUNTER_NAMES[counter]);
+		}
+	}
+	std::fputs(" }\n}\n", stats_ofs);
+
+	Close_Counters();
+
+	const bool WRITE_OK = !std::ferror(stats_ofs);
+
+	return !std::fclose(stats_ofs) && WRITE_OK;
+}
+
+static bool Counter_Available(int counter) {
+#ifdef __linux__
+	return Counter_Fd[counter] >= 0 || counter == PAGE_FAULTS;
+#else
+	return false;
+#endif
+}
+
+// The report is written once, at the end of the job, so the counters are closed then.
+static void Close_Counters() {
+#ifdef __linux__
+	for (int& fd : Counter_Fd) {
+		if (fd >= 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+#endif
+}
+
+static uint64_t Read_Counter(int counter) {
+#ifdef __linux__
+	uint64_t value = 0;
+
+	if (Counter_Fd[counter] >= 0) {
+		return read(Counter_Fd[counter], &value, sizeof(value)) == sizeof(value) ? value : 0;
+	}
+	if (counter == PAGE_FAULTS) {
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		return static_cast<uint64_t>(usage.ru_minflt + usage.ru_majflt);
+	}
+#endif
+	return 0;
+}
+
+static uint64_t Now_Ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
@@ -0,0 +1,21 @@
+// 	PDVZIP per-stage statistics, for "--stats report.json".
+
+//	Records the wall time of each pipeline stage (see "PDV_STAGE") and, on Linux, performance counter deltas read with perf_event_open:
+//	CPU cycles, instructions and last level cache read misses (user space only), plus page faults, counted across the job's thread and the threads it starts.
+//	Counters the kernel or CPU won't provide (no PMU within a VM, perf_event_paranoid > 2, etc.) are reported as null.
+//	Page faults fall back to getrusage, which is always available on Linux.
+
+#pragma once
+
+#include <string>
+
+#include "pdv_core.hpp"
+
+void
+	// Open the performance counters. Call once, before the first stage.
+	Stats_Open(),
+	// "Stage" hook ("PDV_STRUCT"). Accumulate the stage's wall time & counter deltas.
+	Stats_Stage(PDV_STRUCT&, PDV_STAGE, bool);
+
+// Write the JSON report to the file named by "stats_name", then close the performance counters. Returns false if the report could not be written.
+bool Write_Stats_Report(const PDV_STRUCT&, const std::string&, bool);
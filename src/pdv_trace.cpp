@@ -0,0 +1,154 @@
+// 	PDVZIP trace output. See "pdv_trace.hpp".
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "pdv_json.hpp"
+#include "pdv_trace.hpp"
+
+struct TRACE_EVENT {
+	const char* name;
+	uint64_t
+		start_ns,
+		duration_ns,
+		job;
+	uint32_t thread_id;
+	bool
+		job_span,
+		done;
+	PDV_ERROR result;
+	std::string image_name, zip_name;	// Job spans only.
+};
+
+static std::vector<TRACE_EVENT> Event_Vec;
+static std::mutex event_mutex;
+
+static std::string trace_file_name;
+
+static std::chrono::steady_clock::time_point trace_start;
+
+static std::atomic<uint32_t> next_thread_id{ 0 };
+static std::atomic<uint64_t> next_job{ 0 };
+
+// Small sequential thread IDs, rather than OS thread IDs, so that rows appear in the order threads first recorded an event.
+static thread_local const uint32_t THREAD_ID = next_thread_id++;
+
+// The calling thread's current job, its span (index within "Event_Vec") & the start time of each of its open stage spans.
+static thread_local uint64_t
+	current_job,
+	stage_start_ns[static_cast<size_t>(PDV_STAGE::COUNT)];
+
+static thread_local size_t job_span_index;
+
+static uint64_t Now_Ns();
+
+// Write all recorded events to the trace file ("atexit" handler).
+static void Write_Trace();
+
+void Trace_Open(const std::string& trace_name) {
+	trace_file_name = trace_name;
+	trace_start = std::chrono::steady_clock::now();
+	std::atexit(Write_Trace);
+}
+
+void Trace_Begin_Job(const PDV_STRUCT& pdv) {
+
+	current_job = next_job++;
+
+	const std::lock_guard<std::mutex> LOCK(event_mutex);
+
+	Event_Vec.push_back({ "job", Now_Ns(), 0, current_job, THREAD_ID, true, false, PDV_ERROR::NONE, pdv.image_name, pdv.zip_name });
+
+	job_span_index = Event_Vec.size() - 1;
+}
+
+void Trace_End_Job(PDV_ERROR result) {
+
+	const uint64_t END_NS = Now_Ns();
+
+	const std::lock_guard<std::mutex> LOCK(event_mutex);
+
+	TRACE_EVENT& event = Event_Vec[job_span_index];
+
+	event.duration_ns = END_NS - event.start_ns;
+	event.result = result;
+	event.done = true;
+}
+
+void Trace_Stage(PDV_STRUCT&, PDV_STAGE stage, bool begin) {
+
+	uint64_t& start_ns = stage_start_ns[static_cast<size_t>(stage)];
+
+	if (begin) {
+		start_ns = Now_Ns();
+	}
+	else {
+		const uint64_t END_NS = Now_Ns();
+
+		const std::lock_guard<std::mutex> LOCK(event_mutex);
+
+		Event_Vec.push_back({ Stage_Name(stage), start_ns, END_NS - start_ns, current_job, THREAD_ID, false, true, PDV_ERROR::NONE, {}, {} });
+	}
+}
+
+static void Write_Trace() {
+
+	const uint64_t EXIT_NS = Now_Ns();
+
+	std::FILE* trace_ofs = std::fopen(trace_file_name.c_str(), "w");
+
+	if (!trace_ofs) {
+		Print_Error("\nWrite File Error: Unable to write trace file.\n\n");
+		return;
+	}
+
+#ifdef __linux__
+	const long PROCESS_ID = static_cast<long>(getpid());
+#else
+	const long PROCESS_ID = 1;
+#endif
+
+	const std::lock_guard<std::mutex> LOCK(event_mutex);
+
+	std::fprintf(trace_ofs, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":0,\"args\":{\"name\":\"pdvzip\"}}", PROCESS_ID);
+
+	for (uint32_t thread_id = 0; thread_id != next_thread_id; thread_id++) {
+		std::fprintf(trace_ofs, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+			PROCESS_ID, thread_id, thread_id);
+	}
+
+	// Complete ("X") events. Timestamps & durations are in microseconds.
+	for (const TRACE_EVENT& event : Event_Vec) {
+		const uint64_t DURATION_NS = event.done ? event.duration_ns : EXIT_NS - event.start_ns;
+
+		std::fprintf(trace_ofs, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%u,\"args\":{\"job\":%llu",
+			event.name, event.job_span ? "job" : "stage", event.start_ns / 1000.0, DURATION_NS / 1000.0, PROCESS_ID, event.thread_id,
+			static_cast<unsigned long long>(event.job));
+
+		if (event.job_span) {
+			std::fputs(",\"image\":", trace_ofs);
+			Write_Json_String(trace_ofs, event.image_name);
+			std::fputs(",\"zip\":", trace_ofs);
+			Write_Json_String(trace_ofs, event.zip_name);
+			std::fputs(",\"result\":", trace_ofs);
+			Write_Json_String(trace_ofs, !event.done ? "incomplete" : Error_Name(event.result));
+		}
+		std::fputs("}}", trace_ofs);
+	}
+	std::fputs("\n]}\n", trace_ofs);
+	std::fclose(trace_ofs);
+}
+
+static uint64_t Now_Ns() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - trace_start).count());
+}
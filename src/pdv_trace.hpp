@@ -0,0 +1,23 @@
+// 	PDVZIP trace output, for "--trace out.json".
+
+//	Records a span for each job and for each pipeline stage within it (see "PDV_STAGE"), with the ID of the thread that ran it,
+//	in the Chrome trace event format (JSON). Open the file with Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+//	Safe to call from several threads at once. The trace file is written when the program exits, including on error,
+//	in which case unfinished job spans end at exit and are marked "incomplete".
+
+#pragma once
+
+#include <string>
+
+#include "pdv_core.hpp"
+
+void
+	// Start tracing. Timestamps are relative to this call. The trace is written to "trace_name" at exit.
+	Trace_Open(const std::string&),
+	// "Stage" hook ("PDV_STRUCT"). Record a span for the stage, within the calling thread's current job.
+	Trace_Stage(PDV_STRUCT&, PDV_STAGE, bool),
+	// Begin a job span on the calling thread (with the job's image & ZIP file names).
+	Trace_Begin_Job(const PDV_STRUCT&),
+	// End the calling thread's job span, with the job's result.
+	Trace_End_Job(PDV_ERROR);
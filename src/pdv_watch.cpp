@@ -0,0 +1,316 @@
+// 	PDVZIP watch mode. See "pdv_watch.hpp".
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "pdv_watch.hpp"
+
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "pdv_job.hpp"
+#include "pdv_metrics.hpp"
+#include "pdv_sched.hpp"
+#include "pdv_trace.hpp"
+
+// Watch options, shared by the scheduler's worker threads.
+static const PDV_STRUCT* watch_options;
+
+static std::string
+	spool_dir,
+	out_dir;
+
+// Valid cover images, used in turn.
+static std::vector<std::string> Cover_Vec;
+static std::atomic<size_t> next_cover{ 0 };
+
+// Spool ZIP files queued or running, so that a file reported twice (found at start & by an event, or after an event queue overflow) is only embedded once.
+static std::set<std::string> Pending_Set;
+static std::mutex pending_mutex;
+
+static std::atomic<size_t>
+	jobs_done{ 0 },
+	jobs_failed{ 0 };
+
+static volatile std::sig_atomic_t stop_watch = 0;
+
+static void Stop_Watch(int) {
+	stop_watch = 1;
+}
+
+// List the names of files within a directory that end with the given extension (e.g. ".zip"), skipping hidden files.
+static std::vector<std::string> List_Files(const std::string& dir, const char* extension) {
+	std::vector<std::string> Name_Vec;
+
+	DIR* dir_stream = opendir(dir.c_str());
+
+	if (!dir_stream) {
+		return Name_Vec;
+	}
+
+	const size_t EXTENSION_LENGTH = std::char_traits<char>::length(extension);
+
+	while (const dirent* entry = readdir(dir_stream)) {
+		const std::string NAME = entry->d_name;
+		if (NAME[0] != '.' && NAME.size() > EXTENSION_LENGTH && !NAME.compare(NAME.size() - EXTENSION_LENGTH, EXTENSION_LENGTH, extension)) {
+			Name_Vec.push_back(NAME);
+		}
+	}
+	closedir(dir_stream);
+
+	return Name_Vec;
+}
+
+// Check each image within the cover pool directory (after reducing it, with "--reduce-cover", as its jobs will). Keep the valid ones.
+static void Load_Cover_Pool(const PDV_STRUCT& options, const std::string& cover_dir) {
+	std::vector<std::string> Name_Vec = List_Files(cover_dir, ".png");
+
+	std::sort(Name_Vec.begin(), Name_Vec.end());
+
+	for (const std::string& NAME : Name_Vec) {
+		const std::string COVER_NAME = cover_dir + "/" + NAME;
+
+		PDV_STRUCT pdv;
+
+		pdv.reduce_image = options.reduce_image;
+		pdv.threads = 1;
+		pdv.Image_Vec.resize(File_Size(COVER_NAME));
+
+		std::FILE* cover_ifs = std::fopen(COVER_NAME.c_str(), "rb");
+
+		PDV_ERROR cover_error = PDV_ERROR::IMAGE_OPEN;
+
+		if (cover_ifs) {
+			pdv.Image_Vec.resize(std::fread(pdv.Image_Vec.data(), 1, pdv.Image_Vec.size(), cover_ifs));
+			std::fclose(cover_ifs);
+			if (pdv.reduce_image) {
+				Reduce_Image_File(pdv);
+			}
+			cover_error = pdv.Image_Vec.size() > 68 ? Check_Image_File(pdv) : PDV_ERROR::IMAGE_TOO_SMALL;
+		}
+
+		if (cover_error == PDV_ERROR::NONE) {
+			Cover_Vec.push_back(COVER_NAME);
+		}
+		else {
+			Print_Error("Skipping cover image %s: %s", COVER_NAME.c_str(), Error_Message(cover_error) + 1);
+		}
+	}
+}
+
+// Queue a job for a ZIP file within the spool directory (unless it is already queued).
+static void Submit_Zip(const std::string& zip_file) {
+	const std::string ZIP_NAME = spool_dir + "/" + zip_file;
+	{
+		const std::lock_guard<std::mutex> LOCK(pending_mutex);
+		if (!Pending_Set.insert(ZIP_NAME).second) {
+			return;
+		}
+	}
+
+	PDV_JOB job;
+
+	job.image_name = Cover_Vec[next_cover++ % Cover_Vec.size()];
+	job.zip_name = ZIP_NAME;
+	job.output_name = out_dir + "/" + zip_file.substr(0, zip_file.size() - 4) + ".png";
+
+	const size_t
+		IMAGE_SIZE = File_Size(job.image_name),
+		ZIP_SIZE = File_Size(job.zip_name);
+
+	job.size = IMAGE_SIZE + ZIP_SIZE;
+	job.memory = Job_Memory_Size(IMAGE_SIZE, ZIP_SIZE, Cover_Decode_Size(job.image_name, IMAGE_SIZE, watch_options->reduce_image), watch_options->max_memory);
+	job.priority = job.size < SMALL_JOB_SIZE ? PDV_PRIORITY::HIGH : PDV_PRIORITY::NORMAL;
+
+	Scheduler_Submit({ std::move(job) });
+}
+
+// Scheduler callbacks. Run a job, writing to a temporary file, then publish it / display its result & clear the spool file.
+static PDV_ERROR Run_Watch_Job(PDV_JOB& job) {
+	PDV_STRUCT pdv;
+
+	pdv.image_name = job.image_name;
+	pdv.zip_name = job.zip_name;
+	pdv.max_memory = watch_options->max_memory;
+	pdv.trace_name = watch_options->trace_name;
+	pdv.metrics_name = watch_options->metrics_name;
+	pdv.reduce_image = watch_options->reduce_image;
+	pdv.carriers = watch_options->carriers;
+	pdv.direct_io = watch_options->direct_io;
+	pdv.threads = 1;	// Jobs already run in parallel.
+
+	const size_t NAME_INDEX = job.output_name.rfind('/') + 1;
+
+	const std::string TEMP_NAME = job.output_name.substr(0, NAME_INDEX) + "." + job.output_name.substr(NAME_INDEX) + ".tmp";
+
+	const PDV_ERROR EMBED_ERROR = Run_Embed_Job(pdv, TEMP_NAME, job.streamed);
+
+	if (EMBED_ERROR != PDV_ERROR::NONE) {
+		return EMBED_ERROR;
+	}
+
+	// Flush the image to disk before renaming it into place, so that a crash can't publish an empty or partial image.
+	const int FD = open(TEMP_NAME.c_str(), O_RDONLY);
+
+	const bool SYNC_OK = FD >= 0 && !fsync(FD);
+
+	if (FD >= 0) {
+		close(FD);
+	}
+
+	if (!SYNC_OK || std::rename(TEMP_NAME.c_str(), job.output_name.c_str())) {
+		std::remove(TEMP_NAME.c_str());
+		return PDV_ERROR::WRITE_OUT;
+	}
+	return PDV_ERROR::NONE;
+}
+
+static void Watch_Job_Done(const PDV_JOB& job) {
+	if (job.result == PDV_ERROR::NONE) {
+		std::remove(job.zip_name.c_str());
+	}
+	else {
+		std::rename(job.zip_name.c_str(), (job.zip_name + ".failed").c_str());
+		jobs_failed++;
+	}
+	jobs_done++;
+
+	{
+		const std::lock_guard<std::mutex> LOCK(pending_mutex);
+		Pending_Set.erase(job.zip_name);
+
+		std::printf("%-24s %-16s %10.2f ms\n", job.output_name.c_str(), Error_Name(job.result), (job.end_ns - job.submit_ns) / 1e6);
+		std::fflush(stdout);
+	}
+}
+
+void Run_Watch(const PDV_STRUCT& options, const std::string& spool_name, const std::string& cover_name, const std::string& out_name, size_t workers) {
+
+	const auto Trim = [](std::string dir) {
+		while (dir.size() > 1 && dir.back() == '/') {
+			dir.pop_back();
+		}
+		return dir;
+	};
+
+	spool_dir = Trim(spool_name);
+	out_dir = Trim(out_name);
+
+	Load_Cover_Pool(options, Trim(cover_name));
+
+	if (Cover_Vec.empty()) {
+		Print_Error("\nWatch Error: No valid cover images found within the cover pool directory.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	const int INOTIFY_FD = inotify_init1(IN_CLOEXEC);
+
+	if (INOTIFY_FD < 0 || inotify_add_watch(INOTIFY_FD, spool_dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		Print_Error("\nWatch Error: Unable to watch the spool directory.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+
+	// No SA_RESTART, so that a signal interrupts the blocking "read" below.
+	struct sigaction action {};
+	action.sa_handler = Stop_Watch;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGINT, &action, nullptr);
+	sigaction(SIGTERM, &action, nullptr);
+
+	if (!options.trace_name.empty()) {
+		Trace_Open(options.trace_name);
+	}
+	if (!options.metrics_name.empty()) {
+		Metrics_Open(options.metrics_name);
+	}
+
+	watch_options = &options;
+
+	// Start the worker threads with SIGINT & SIGTERM blocked (they inherit the mask), so that the signals are delivered to this thread & interrupt its "read".
+	sigset_t stop_signals, old_signals;
+	sigemptyset(&stop_signals);
+	sigaddset(&stop_signals, SIGINT);
+	sigaddset(&stop_signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stop_signals, &old_signals);
+
+	Scheduler_Start(workers, options.max_memory, Run_Watch_Job, Watch_Job_Done);
+
+	pthread_sigmask(SIG_SETMASK, &old_signals, nullptr);
+
+	std::printf("\nWatching %s (%zu cover images, %zu worker threads", spool_dir.c_str(), Cover_Vec.size(), workers);
+	if (Scheduler_Nodes()) {
+		std::printf(" across %zu NUMA nodes", Scheduler_Nodes());
+	}
+	std::printf("). Images are published to %s. Press Ctrl+C to stop.\n\n", out_dir.c_str());
+	std::fflush(stdout);
+
+	// The watch is already in place, so nothing that lands from now on is missed. Files reported both ways are only queued once ("Pending_Set").
+	for (const std::string& ZIP_FILE : List_Files(spool_dir, ".zip")) {
+		Submit_Zip(ZIP_FILE);
+	}
+
+	alignas(inotify_event) char event_buf[16384];
+
+	while (!stop_watch) {
+		const ssize_t READ_SIZE = read(INOTIFY_FD, event_buf, sizeof(event_buf));
+
+		if (READ_SIZE <= 0) {
+			if (READ_SIZE < 0 && errno == EINTR) {
+				continue;
+			}
+			Print_Error("\nWatch Error: Unable to read spool directory events.\n\n");
+			break;
+		}
+
+		for (ssize_t index = 0; index < READ_SIZE;) {
+			const inotify_event* EVENT = reinterpret_cast<const inotify_event*>(event_buf + index);
+
+			index += sizeof(inotify_event) + EVENT->len;
+
+			if (EVENT->mask & IN_Q_OVERFLOW) {
+				// Events were dropped. Rescan the directory instead.
+				for (const std::string& ZIP_FILE : List_Files(spool_dir, ".zip")) {
+					Submit_Zip(ZIP_FILE);
+				}
+				continue;
+			}
+
+			const std::string NAME = EVENT->len ? EVENT->name : "";
+
+			if (NAME.size() > 4 && NAME[0] != '.' && !NAME.compare(NAME.size() - 4, 4, ".zip")) {
+				Submit_Zip(NAME);
+			}
+		}
+	}
+
+	close(INOTIFY_FD);
+
+	std::fputs("\nStopping. Finishing queued jobs...\n", stdout);
+	std::fflush(stdout);
+
+	Scheduler_Finish();
+
+	std::printf("\nComplete! %zu jobs, %zu failed.\n\n", jobs_done.load(), jobs_failed.load());
+}
+
+#else
+
+void Run_Watch(const PDV_STRUCT&, const std::string&, const std::string&, const std::string&, size_t) {
+	Print_Error("\nWatch Error: --watch is only supported on Linux.\n\n");
+	std::exit(EXIT_FAILURE);
+}
+
+#endif
@@ -0,0 +1,25 @@
+// 	PDVZIP watch mode ("--watch spool/ --cover-pool covers/ --out outbox/"). Linux only (inotify).
+
+//	Embeds each ZIP file as soon as it lands within the spool directory: a file is picked up when the writer closes it (IN_CLOSE_WRITE)
+//	or when it is moved into the directory (IN_MOVED_TO), so half written files are never read. ZIP files already within the
+//	spool directory at start are picked up too. Jobs run on the scheduler's worker threads (see "pdv_sched.hpp").
+
+//	Cover images are taken in turn from the cover pool directory. Each is checked once, at start ("Check_Image_File"),
+//	and covers that fail the check (including PNG-32/24 covers of 256 colours or less, which platforms would convert to PNG-8)
+//	are left out of the pool.
+
+//	Each image is written to a hidden temporary file within the output directory, flushed to disk, then renamed to "<zip name>.png",
+//	so readers of the output directory only ever see complete images. On success the spool ZIP file is removed.
+//	On failure it is renamed to "<zip name>.zip.failed", so that it is not retried.
+
+//	Runs until interrupted (SIGINT / SIGTERM), then finishes the queued jobs and exits.
+
+#pragma once
+
+#include <string>
+
+#include "pdv_core.hpp"
+
+// Watch the spool directory, with the cover pool & output directories, and the number of worker threads.
+// Options (memory budget, trace & metrics files) are taken from the "PDV_STRUCT". Exits the program on setup errors.
+void Run_Watch(const PDV_STRUCT&, const std::string&, const std::string&, const std::string&, size_t);
@@ -1,772 +1,907 @@
 // 	PNG Data Vehicle, ZIP Edition (PDVZIP v1.8). Created by Nicholas Cleasby (@CleasbyCode) 6/08/2022
 
 //	To compile program (Linux):
-// 	$ g++ pdvzip.cpp -O2 -s -o pdvzip
+// 	$ g++ pdvzip.cpp pdv_core.cpp pdv_job.cpp pdv_sched.cpp pdv_numa.cpp pdv_cgroup.cpp pdv_direct.cpp pdv_journal.cpp pdv_watch.cpp pdv_stats.cpp pdv_trace.cpp pdv_metrics.cpp pdv_png.cpp pdv_extract.cpp pdv_index.cpp pdv_catalog.cpp pdv_http.cpp -O2 -DNDEBUG -s -pthread -lz -o pdvzip
 
 // 	Run it:
 // 	$ ./pdvzip
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
-#include <regex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
-typedef unsigned char Byte;
-
-struct PDV_STRUCT {
-	const size_t MAX_FILE_SIZE = 209715200;
-	std::vector<Byte> Image_Vec, Zip_Vec, Script_Vec;
-	const std::string BAD_CHAR = "\x22\x27\x28\x29\x3B\x3E\x60";
-	std::string image_name, zip_name;
-	size_t image_size{}, zip_size{}, script_size{}, combined_file_size{};
-	bool big_endian = true;
-};
-
-size_t
-	// Code to compute CRC32 (for "IDAT" & "iCCP" chunks within this program) is taken from: https://www.w3.org/TR/2003/REC-PNG-20031110/#D-CRCAppendix 
-	Crc_Update(const size_t&, Byte*, const size_t&),
-	Crc(Byte*, const size_t&);
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+#include "pdv_catalog.hpp"
+#include "pdv_cgroup.hpp"
+#include "pdv_core.hpp"
+#include "pdv_extract.hpp"
+#include "pdv_http.hpp"
+#include "pdv_index.hpp"
+#include "pdv_job.hpp"
+#include "pdv_journal.hpp"
+#include "pdv_metrics.hpp"
+#include "pdv_sched.hpp"
+#include "pdv_stats.hpp"
+#include "pdv_trace.hpp"
+#include "pdv_watch.hpp"
 
 void
-	// Attempt to open PNG & ZIP file, followed by some initial file size checks. Display relevant error message and exit program if any file fails to open or fails size checks.
-	Open_Files(PDV_STRUCT&),
-	// Various image file checks to make sure image is valid and meets program's requirements. Display relevant error message if checks fail, exit program.
-	Check_Image_File(PDV_STRUCT&, std::ifstream&, std::ifstream&),
-	// Various ZIP file checks to make sure archive is valid and meets program's requirements. Display relevant error message if checks fail, exit program.
-	Check_Zip_File(PDV_STRUCT&, std::ifstream&),
-	// Keep critical PNG chunks, remove the rest.
-	Erase_Image_Chunks(PDV_STRUCT&, std::ifstream&),
-	// Update barebones extraction script determined by embedded ZIP file content. 
-	Complete_Extraction_Script(PDV_STRUCT&),
-	// Insert contents of vectors storing user ZIP file and the completed extraction script into the vector containing PNG image. This is our PNG-ZIP polyglot.
-	Combine_Vectors(PDV_STRUCT&),
-	// Adjust embedded ZIP file offsets within the PNG image to their new index locations, so that it remains a valid, working ZIP archive. 
-	Fix_Zip_Offset(PDV_STRUCT&, const size_t&),
-	// Write out to file the complete ZIP embedded PNG image file, creating our PNG-ZIP polyglot.
-	Write_Out_Polyglot_File(PDV_STRUCT&),
-	// Update values, such as chunk lengths, CRC, file sizes and other values. Writes them into the relevant vector index locations.
-	Value_Updater(std::vector<Byte>&, size_t, const size_t&, int, bool),
+	// Embed the ZIP file within the PNG image (see "pdv_job.hpp") and write out the polyglot image. Display relevant error message and exit program if the job fails.
+	Embed_Files(PDV_STRUCT&),
+	// Run each job listed in the batch file on the scheduler (see "pdv_sched.hpp"), with the given number of worker threads, then display a latency summary.
+	// Options (memory budget, trace & metrics files) are taken from the "PDV_STRUCT". With a journal file name ("--resume"), jobs the journal records
+	// as completed are skipped, and completed jobs are recorded (see "pdv_journal.hpp"). Exit program if the batch file can't be read or has an invalid line.
+	Run_Batch(const PDV_STRUCT&, const std::string&, const std::string&, size_t),
+	// Extract the ZIP file, or the named pack (if not empty), from the polyglot image ("--extract", see "pdv_extract.hpp").
+	// Display relevant error message and exit program if it fails.
+	Extract_Files(const std::string&, const std::string&, const std::string&),
+	// Build the image's sidecar index, with inflate sync points ("--index"), list its entries ("--list") or write out one entry ("--get"), see "pdv_index.hpp".
+	// Display relevant error message and exit program if it fails.
+	Index_Image(const std::string&),
+	List_Entries(const std::string&),
+	Get_Entry(const std::string&, const std::string&, const std::string&),
+	// Build the catalog of the images within the directory, with the given number of worker threads ("--catalog build"),
+	// or list the images holding an entry of the given name ("--catalog find"), see "pdv_catalog.hpp". Display relevant error message and exit program if it fails.
+	Build_Catalog_File(const std::string&, const std::string&, size_t),
+	Find_Catalog_Entry(const std::string&, const std::string&),
+	// Display the saved file details. With a memory budget, also display the embed mode & the process's peak resident memory.
+	// With "--stats", also write the stats report.
+	Display_Saved(PDV_STRUCT&, const std::string&, bool),
+	// Display progress messages from the core ("PDV_STRUCT" hook).
+	Show_Progress(const char*),
+	// Prompt the user for optional command-line arguments for the extraction script ("PDV_STRUCT" hook).
+	Prompt_Arguments(PDV_STRUCT&),
+	// Read a line of user input (command-line arguments for the extraction script).
+	Read_Line(std::string&),
 	// Output to screen detailed program usage information.
 	Display_Info();
 
-int main(int argc, char** argv) {
+bool
+	// Parse a size argument, in bytes, with an optional K, M or G suffix (e.g. "64M").
+	Parse_Size(const char*, size_t&),
+	// Parse a "WxH" dimensions argument (e.g. "68x68").
+	Parse_Dimensions(const char*, uint32_t&, uint32_t&);
+
+// Unique filename for the complete polyglot image.
+std::string Output_File_Name();
+
+// Check the cover image & ZIP file names (file extensions & characters). Returns the error message, or nullptr if both are valid.
+const char* Check_File_Names(const std::string&, const std::string&);
+
+// Character classes accepted within the cover image and ZIP file name arguments: a-z A-Z 0-9 _ . \ - / and whitespace.
+// Built at compile time, so validating a file name is a single table lookup per character (no std::regex construction at startup).
+struct NAME_CHAR_TABLE {
+	bool valid[256]{};
+	constexpr NAME_CHAR_TABLE() {
+		for (int c = 0; c < 256; c++) {
+			valid[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+				|| c == '_' || c == '.' || c == '\\' || c == '-' || c == '/'
+				|| c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+		}
+	}
+};
 
-	PDV_STRUCT pdv;
+constexpr NAME_CHAR_TABLE NAME_CHARS{};
 
-	if (argc == 2 && std::string(argv[1]) == "--info") {
-		Display_Info();
+constexpr bool Valid_File_Name(const char* name) {
+	if (!*name) {
+		return false;
 	}
-	else if (argc < 3 || argc > 3) {
-		std::cout << "\nUsage: pdvzip <cover_image> <zip_file>\n\t\bpdvzip --info\n\n";
+	while (*name) {
+		if (!NAME_CHARS.valid[static_cast<Byte>(*name++)]) {
+			return false;
+		}
 	}
-	else {
-		pdv.image_name = argv[1];
-		pdv.zip_name = argv[2];
+	return true;
+}
+
+static_assert(Valid_File_Name("my_image-01.png") && Valid_File_Name("../covers/cover image.png") && !Valid_File_Name("bad;name.zip") && !Valid_File_Name(""), "File name validator");
 
-		const std::regex REG_EXP("(\\.[a-zA-Z_0-9\\.\\\\\\s\\-\\/]+)?[a-zA-Z_0-9\\.\\\\\\s\\-\\/]+?(\\.[a-zA-Z0-9]+)?");
+int main(int argc, char** argv) {
 
-		const std::string
-			// Get file extensions from image and data file names.
-			GET_PNG_EXT = pdv.image_name.length() > 2 ? pdv.image_name.substr(pdv.image_name.length() - 3) : pdv.image_name,
-			GET_ZIP_EXT = pdv.zip_name.length() > 2 ? pdv.zip_name.substr(pdv.zip_name.length() - 3) : pdv.zip_name;
+	// Fully buffer stdout. Progress messages are small and frequent, so we only pay for a write when the buffer fills, the user is prompted or the program exits.
+	static char stdout_buf[8192];
+	std::setvbuf(stdout, stdout_buf, _IOFBF, sizeof(stdout_buf));
 
-		if (GET_PNG_EXT != "png" || GET_ZIP_EXT != "zip" || !regex_match(pdv.image_name, REG_EXP) || !regex_match(pdv.zip_name, REG_EXP)) {
-			// Either file contains an incorrect file extension and/or invalid input. Display error message and exit program.
-			std::cerr << (GET_PNG_EXT != "png" || GET_ZIP_EXT != "zip" ? "\nFile Type Error: Invalid file extension found. Only expecting 'png' followed by 'zip'"
-				: "\nInvalid Input Error: Characters not supported by this program found within file name arguments") << ".\n\n";
+	PDV_STRUCT pdv;
+
+	std::string
+		batch_name,
+		journal_name,
+		watch_name,
+		cover_pool_name,
+		out_dir_name,
+		catalog_name = CATALOG_FILE_NAME;
+
+	// Container limits (cgroup v2) size the defaults: worker threads, the threads used within a job, and the memory budget.
+	const CGROUP_LIMITS LIMITS = Cgroup_Limits();
+
+	size_t workers = LIMITS.cpus;
+
+	// "--max-memory" given (including "max": no budget, even within a memory limit).
+	bool memory_set = false;
+
+	// "--generate-cover" dimensions (0 = use the cover image file argument).
+	uint32_t
+		cover_width = 0,
+		cover_height = 0;
+
+	// Options, before the file name arguments. "--max-memory <size>": memory budget for the job's buffers. Jobs that would exceed it in memory are streamed instead.
+	// With "--batch", the budget is shared by all running jobs. Defaults to 3/4 of the cgroup memory limit, if any ("max" for no budget).
+	// "--threads <n>": threads used within a job, to re-encode the cover image ("--reduce-cover"). Defaults to the CPUs the cgroup allows.
+	// "--stats <report.json>": write per-stage timings & performance counters to a JSON report.
+	// "--trace <out.json>": write job & stage spans in the Chrome trace event format (for Perfetto).
+	// "--metrics <file.prom>": keep job, error & latency metrics in the Prometheus text format (counters carry on across runs).
+	// "--batch <jobs.txt>": run every job listed in the file (see "Run_Batch"), in place of the file name arguments. "--jobs <n>": worker threads for "--batch" & "--watch"
+	// (default: the CPUs the cgroup allows). "--resume <journal>" (Linux only): with "--batch", skip the jobs the journal records as completed, and record
+	// each job as it completes (the journal is created if it doesn't exist), so the same command carries on a batch that was stopped (see "pdv_journal.hpp").
+	// "--watch <spool/> --cover-pool <covers/> --out <outbox/>": embed each ZIP file as it lands within the spool directory (see "pdv_watch.hpp").
+	// "--generate-cover <WxH>": in place of the cover image file argument, embed within a generated minimal cover image of (about) those dimensions.
+	// "--reduce-cover" (no value): losslessly reduce & re-encode the cover image before embedding, to leave more room for the ZIP file.
+	// "--direct-io" (no value, Linux only): read the job files & write the output images with direct I/O, bypassing the page cache (see "pdv_direct.hpp").
+	// "--carriers <profile>": spread the start of the ZIP file across the ancillary chunks the platform preserves (see "PDV_CARRIERS").
+	// "--pack <zip_file>" (repeatable): also embed the ZIP file as a separate pack, listed within the pack directory by its file name.
+	// "--http <address:port> <dir>" (after the other options): serve the image entries within the directory over HTTP (see "pdv_http.hpp"), on "--jobs" event loops,
+	// with "--max-memory" as its inflate cache size (default: "HTTP_CACHE_SIZE", or half the default memory budget within a cgroup memory limit, if less).
+	// "--catalog-file <file>": catalog file for "--catalog build" & "--catalog find" (default "pdvzip.pdvcat"). "--jobs <n>" also sets the "--catalog build" worker threads.
+	int arg_index = 1;
+
+	while (argc - arg_index > 1) {
+		if (!std::strcmp(argv[arg_index], "--reduce-cover")) {
+			pdv.reduce_image = true;
+			arg_index++;
+			continue;
+		}
+		if (!std::strcmp(argv[arg_index], "--direct-io")) {
+#ifndef __linux__
+			Print_Error("\nInvalid Input Error: --direct-io is only supported on Linux.\n\n");
+			std::exit(EXIT_FAILURE);
+#endif
+			pdv.direct_io = true;
+			arg_index++;
+			continue;
+		}
+		if (!std::strcmp(argv[arg_index], "--max-memory")) {
+			memory_set = true;
+			pdv.max_memory = 0;
+			if (std::strcmp(argv[arg_index + 1], "max") && (!Parse_Size(argv[arg_index + 1], pdv.max_memory) || !pdv.max_memory)) {
+				Print_Error("\nInvalid Input Error: --max-memory expects a size in bytes, with an optional K, M or G suffix (e.g. 64M), or max (no limit).\n\n");
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (!std::strcmp(argv[arg_index], "--stats")) {
+			pdv.stats_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--trace")) {
+			pdv.trace_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--metrics")) {
+			pdv.metrics_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--batch")) {
+			batch_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--resume")) {
+#ifndef __linux__
+			Print_Error("\nInvalid Input Error: --resume is only supported on Linux.\n\n");
 			std::exit(EXIT_FAILURE);
+#endif
+			journal_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--watch")) {
+			watch_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--cover-pool")) {
+			cover_pool_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--out")) {
+			out_dir_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--generate-cover")) {
+			if (!Parse_Dimensions(argv[arg_index + 1], cover_width, cover_height) || !cover_width || !cover_height) {
+				Print_Error("\nInvalid Input Error: --generate-cover expects image dimensions, width x height (e.g. 68x68).\n\n");
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (!std::strcmp(argv[arg_index], "--carriers")) {
+			pdv.carriers = Carriers_Profile(argv[arg_index + 1]);
+			if (pdv.carriers == PDV_CARRIERS::COUNT) {
+				Print_Error("\nInvalid Input Error: --carriers expects a platform profile: twitter, splt or none.\n\n");
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (!std::strcmp(argv[arg_index], "--pack")) {
+			const std::string PACK_NAME = argv[arg_index + 1];
+
+			const char* PACK_ERROR = Check_File_Names("", PACK_NAME);
+
+			const size_t NAME_INDEX = PACK_NAME.find_last_of("/\\") + 1;
+
+			for (const std::string& NAME : pdv.Pack_Name_Vec) {
+				if (!PACK_ERROR && NAME.substr(NAME.find_last_of("/\\") + 1) == PACK_NAME.substr(NAME_INDEX)) {
+					PACK_ERROR = "Invalid Input Error: Each --pack file needs a different file name";
+				}
+			}
+			if (!PACK_ERROR && (pdv.Pack_Name_Vec.size() == MAX_PACKS || PACK_NAME.length() - NAME_INDEX > MAX_PACK_NAME_LENGTH)) {
+				PACK_ERROR = "Invalid Input Error: Up to 255 --pack files, with file names of up to 255 characters";
+			}
+			if (PACK_ERROR) {
+				Print_Error("\n%s.\n\n", PACK_ERROR);
+				std::exit(EXIT_FAILURE);
+			}
+			pdv.Pack_Name_Vec.push_back(PACK_NAME);
+		}
+		else if (!std::strcmp(argv[arg_index], "--catalog-file")) {
+			catalog_name = argv[arg_index + 1];
+		}
+		else if (!std::strcmp(argv[arg_index], "--jobs")) {
+			char* end = nullptr;
+			workers = std::strtoul(argv[arg_index + 1], &end, 10);
+			if (*end || !workers || workers > 1024) {
+				Print_Error("\nInvalid Input Error: --jobs expects a number of worker threads (1 to 1024).\n\n");
+				std::exit(EXIT_FAILURE);
+			}
+		}
+		else if (!std::strcmp(argv[arg_index], "--threads")) {
+			char* end = nullptr;
+			pdv.threads = std::strtoul(argv[arg_index + 1], &end, 10);
+			if (*end || !pdv.threads || pdv.threads > 1024) {
+				Print_Error("\nInvalid Input Error: --threads expects a number of threads (1 to 1024).\n\n");
+				std::exit(EXIT_FAILURE);
+			}
 		}
-		Open_Files(pdv);
+		else {
+			break;
+		}
+		arg_index += 2;
 	}
-	return 0;
-}
 
-void Open_Files(PDV_STRUCT& pdv) {
+	if (!pdv.threads) {
+		pdv.threads = LIMITS.cpus;
+	}
 
-	std::cout << "\nReading files. Please wait...\n";
+	// The HTTP inflate cache keeps its own default size, within the memory limit.
+	size_t cache_size = pdv.max_memory ? pdv.max_memory : HTTP_CACHE_SIZE;
 
-	// Attempt to open user's files.
-	std::ifstream
-		image_ifs(pdv.image_name, std::ios::binary),
-		zip_ifs(pdv.zip_name, std::ios::binary);
+	if (!memory_set && LIMITS.memory) {
+		pdv.max_memory = LIMITS.memory / 4 * CGROUP_MEMORY_QUARTERS;
+		cache_size = std::min(HTTP_CACHE_SIZE, pdv.max_memory / 2);
+	}
 
-	if (!image_ifs || !zip_ifs) {
-		// Display relevant error message and exit program if any file fails to open.
-		std::cerr << "\nRead File Error: " << (!image_ifs ? "Unable to open image file" : "Unable to open ZIP file") << ".\n\n";
+	if (argc == 2 && !std::strcmp(argv[1], "--info")) {
+		Display_Info();
+	}
+	else if ((argc == 4 || argc == 5) && !std::strcmp(argv[1], "--extract")) {
+		Extract_Files(argv[2], argv[3], argc == 5 ? argv[4] : "");
+	}
+	else if (argc == 3 && !std::strcmp(argv[1], "--index")) {
+		Index_Image(argv[2]);
+	}
+	else if (argc == 3 && !std::strcmp(argv[1], "--list")) {
+		List_Entries(argv[2]);
+	}
+	else if (argc == 5 && !std::strcmp(argv[1], "--get")) {
+		Get_Entry(argv[2], argv[3], argv[4]);
+	}
+	else if (argc - arg_index == 3 && !std::strcmp(argv[arg_index], "--http")) {
+		Run_Http(argv[arg_index + 1], argv[arg_index + 2], workers, cache_size);
+	}
+	else if (argc - arg_index == 3 && !std::strcmp(argv[arg_index], "--catalog") && !std::strcmp(argv[arg_index + 1], "build")) {
+		Build_Catalog_File(catalog_name, argv[arg_index + 2], workers);
+	}
+	else if (argc - arg_index == 3 && !std::strcmp(argv[arg_index], "--catalog") && !std::strcmp(argv[arg_index + 1], "find")) {
+		Find_Catalog_Entry(catalog_name, argv[arg_index + 2]);
+	}
+	else if (!pdv.stats_name.empty() && (!batch_name.empty() || !watch_name.empty())) {
+		// The "--stats" counters measure the whole process, so can't be split between jobs that run at the same time.
+		Print_Error("\nInvalid Input Error: --stats is not supported with --batch or --watch. Use --metrics or --trace.\n\n");
 		std::exit(EXIT_FAILURE);
 	}
+	else if (!pdv.Pack_Name_Vec.empty() && (!batch_name.empty() || !watch_name.empty())) {
+		Print_Error("\nInvalid Input Error: --pack is not supported with --batch or --watch.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
+	else if (!batch_name.empty() && watch_name.empty() && !cover_width && argc == arg_index) {
+		Run_Batch(pdv, batch_name, journal_name, workers);
+	}
+	else if (!watch_name.empty() && !cover_pool_name.empty() && !out_dir_name.empty() && batch_name.empty() && !cover_width && argc == arg_index) {
+		Run_Watch(pdv, watch_name, cover_pool_name, out_dir_name, workers);
+	}
+	else if (!batch_name.empty() || !journal_name.empty() || !watch_name.empty() || !cover_pool_name.empty() || !out_dir_name.empty() || argc - arg_index != (cover_width ? 1 : 2)) {
+		std::fputs("\nUsage: pdvzip [--reduce-cover] [--direct-io] [--threads <n>] [--carriers <profile>] [--pack <zip_file>]... [--max-memory <size>] [--stats <report.json>] [--trace <out.json>] [--metrics <file.prom>] <cover_image> <zip_file>\n"
+			"\t\bpdvzip [--carriers <profile>] [--pack <zip_file>]... [--max-memory <size>] [--stats <report.json>] [--trace <out.json>] [--metrics <file.prom>] --generate-cover <WxH> <zip_file>\n"
+			"\t\bpdvzip [--reduce-cover] [--direct-io] [--carriers <profile>] [--max-memory <size>] [--trace <out.json>] [--metrics <file.prom>] [--jobs <n>] [--resume <journal>] --batch <jobs.txt>\n"
+			"\t\bpdvzip [--reduce-cover] [--direct-io] [--carriers <profile>] [--max-memory <size>] [--trace <out.json>] [--metrics <file.prom>] [--jobs <n>] --watch <spool/> --cover-pool <covers/> --out <outbox/>\n"
+			"\t\bpdvzip --extract <pdvzip_image> <zip_file> [<pack_name>]\n"
+			"\t\bpdvzip --index <pdvzip_image>\n"
+			"\t\bpdvzip --list <pdvzip_image>\n"
+			"\t\bpdvzip --get <pdvzip_image> <entry_name> <out_file>\n"
+			"\t\bpdvzip [--catalog-file <file>] [--jobs <n>] --catalog build <dir>\n"
+			"\t\bpdvzip [--catalog-file <file>] --catalog find <entry_name>\n"
+			"\t\bpdvzip [--max-memory <size>] [--jobs <n>] --http <address:port> <dir>\n"
+			"\t\bpdvzip --info\n\n", stdout);
+	}
 	else {
-		// Initial file size checks. We will need to check sizes again, later in the program.
-		constexpr int
-			MIN_IMAGE_SIZE = 68,
-			MIN_ZIP_SIZE = 40;
-
-		bool file_size_check = false;
-
-		// Get PNG file size.
-		image_ifs.seekg(0, image_ifs.end);
-		pdv.image_size = image_ifs.tellg();
-		image_ifs.seekg(0, image_ifs.beg);
+		if (!cover_width) {
+			pdv.image_name = argv[arg_index++];
+		}
+		pdv.zip_name = argv[arg_index];
 
-		// Get ZIP file size
-		zip_ifs.seekg(0, zip_ifs.end);
-		pdv.zip_size = zip_ifs.tellg();
-		zip_ifs.seekg(0, zip_ifs.beg);
+		const char* NAME_ERROR = Check_File_Names(pdv.image_name, pdv.zip_name);
 
-		pdv.combined_file_size = pdv.image_size + pdv.zip_size;
+		if (NAME_ERROR) {
+			// Either file contains an incorrect file extension and/or invalid input. Display error message and exit program.
+			Print_Error("\n%s.\n\n", NAME_ERROR);
+			std::exit(EXIT_FAILURE);
+		}
+		if (cover_width) {
+			// The generated cover image is held in "Image_Vec" (no image file name), for "Run_Embed_Job".
+			pdv.Progress = Show_Progress;
 
-		file_size_check = pdv.image_size > MIN_IMAGE_SIZE && pdv.zip_size > MIN_ZIP_SIZE && pdv.MAX_FILE_SIZE >= pdv.combined_file_size;
+			const PDV_ERROR COVER_ERROR = Generate_Cover_Image(pdv, cover_width, cover_height);
 
-		if (!file_size_check) {
-			// Display relevant error message and exit program if any size check fails.
-			std::cerr << "\nFile Size Error: " << (MIN_IMAGE_SIZE > pdv.image_size ? "Invalid PNG image. File too small"
-				: (MIN_ZIP_SIZE > pdv.zip_size ? "Invalid ZIP file. File too small"
-					: "The combined file size of your PNG image and ZIP file exceeds maximum limit")) << ".\n\n";
-			std::exit(EXIT_FAILURE);
+			if (COVER_ERROR != PDV_ERROR::NONE) {
+				Print_Error("%s", Error_Message(COVER_ERROR));
+				std::exit(EXIT_FAILURE);
+			}
 		}
-		Check_Image_File(pdv, image_ifs, zip_ifs);
+		if (!pdv.trace_name.empty()) {
+			Trace_Open(pdv.trace_name);
+		}
+		if (!pdv.metrics_name.empty()) {
+			Metrics_Open(pdv.metrics_name);
+		}
+
+		Embed_Files(pdv);
 	}
+	return 0;
 }
 
-void Check_Image_File(PDV_STRUCT& pdv, std::ifstream& image_ifs, std::ifstream& zip_ifs) {
+const char* Check_File_Names(const std::string& image_name, const std::string& zip_name) {
+	const std::string
+		// Get file extensions from image and data file names. No image file name ("--generate-cover") passes as "png".
+		GET_PNG_EXT = image_name.empty() ? "png" : (image_name.length() > 2 ? image_name.substr(image_name.length() - 3) : image_name),
+		GET_ZIP_EXT = zip_name.length() > 2 ? zip_name.substr(zip_name.length() - 3) : zip_name;
 
-	// Vector "Image_Vec" stores the user's PNG image. Later, it will also store the contents of vectors "Script_Vec" and "Zip_Vec".
-	pdv.Image_Vec.assign(std::istreambuf_iterator<char>(image_ifs), std::istreambuf_iterator<char>());
+	if (GET_PNG_EXT != "png" || GET_ZIP_EXT != "zip") {
+		return "File Type Error: Invalid file extension found. Only expecting 'png' followed by 'zip'";
+	}
+	if ((!image_name.empty() && !Valid_File_Name(image_name.c_str())) || !Valid_File_Name(zip_name.c_str())) {
+		return "Invalid Input Error: Characters not supported by this program found within file name arguments";
+	}
+	return nullptr;
+}
 
-	pdv.image_size = pdv.Image_Vec.size();
+void Extract_Files(const std::string& image_name, const std::string& zip_name, const std::string& pack_name) {
 
-	// Make sure we are dealing with a valid PNG image file.
-	const std::string
-		PNG_TOP_SIG = "\x89\x50\x4E\x47", 		  // PNG image header signature. 
-		PNG_END_SIG = "\x49\x45\x4E\x44\xAE\x42\x60\x82", // PNG image end signature.
-		GET_PNG_TOP_SIG{ pdv.Image_Vec.begin(), pdv.Image_Vec.begin() + PNG_TOP_SIG.length() },	// Attempt to get both image signatures from file stored in vector. 
-		GET_PNG_END_SIG{ pdv.Image_Vec.end() - PNG_END_SIG.length(), pdv.Image_Vec.end() };
-
-	// Make sure image has valid PNG signatures.
-	if (GET_PNG_TOP_SIG != PNG_TOP_SIG || GET_PNG_END_SIG != PNG_END_SIG) {
-		// Invalid image file, display error message and exit program.
-		std::cerr << "\nImage File Error: File does not appear to be a valid PNG image.\n\n";
+	// The image can have any name. Only the ZIP file name is checked.
+	const char* NAME_ERROR = Check_File_Names("", zip_name);
+
+	if (NAME_ERROR || !Valid_File_Name(image_name.c_str())) {
+		Print_Error("\n%s.\n\n", NAME_ERROR ? NAME_ERROR : "Invalid Input Error: Characters not supported by this program found within file name arguments");
 		std::exit(EXIT_FAILURE);
 	}
 
-	// Check a range of bytes within the "IHDR" chunk to make sure we have no "BAD_CHAR" characters that will break the Linux extraction script.
-	// A script breaking character can appear within the width & height fields or the 4 byte CRC field of the "IHDR" chunk.
-	// Manually modifying the dimensions (1% increase or decrease) of the image will usually resolve the issue. Repeat if necessary.
+	size_t zip_size = 0;
 
-	int chunk_index = 18;
+	const PDV_ERROR EXTRACT_ERROR = Extract_Zip_File(image_name, zip_name, pack_name, zip_size);
 
-	// From index location, increment through 14 bytes of the IHDR chunk within vector "Image_Vec" and compare each byte to the 7 characters within "BAD_CHAR" string.
-	while (chunk_index++ != 32) { // We start checking from the 19th character position of the IHDR chunk within vector "Image_Vec".
-		for (int i = 0; i < 7; i++) {
-			if (pdv.Image_Vec[chunk_index] == pdv.BAD_CHAR[i]) { // "BAD_CHAR" character found, display error message and exit program.
-				std::cerr <<
-					"\nImage File Error:\n\nThe IHDR chunk of this image contains a character that will break the Linux extraction script."
-					"\nTry modifying image dimensions (1% increase or decrease) to resolve the issue. Repeat if necessary.\n\n";
-				std::exit(EXIT_FAILURE);
-			}
-		}
+	if (EXTRACT_ERROR != PDV_ERROR::NONE) {
+		Print_Error("%s", Error_Message(EXTRACT_ERROR));
+		std::exit(EXIT_FAILURE);
 	}
+	std::printf("\nExtracted ZIP file: %s (%zu bytes).\n\nComplete!\n\n", zip_name.c_str(), zip_size);
+}
+
+void Index_Image(const std::string& image_name) {
 
-	// Now check for supported image dimensions and color types.
-	const int
-		IMAGE_WIDTH_DIMS = pdv.Image_Vec[18] << 8 | pdv.Image_Vec[19],		// Get width dimensions from vector.
-		IMAGE_HEIGHT_DIMS = pdv.Image_Vec[22] << 8 | pdv.Image_Vec[23],		// Get height dimensions from vector.
-		PNG_COLOR_TYPE = pdv.Image_Vec[25] == 6 ? 2 : pdv.Image_Vec[25];	// Get image color type value from vector. If value is 6 (Truecolor with alpha), set the value to 2 (Truecolor).
-
-	constexpr int
-		MAX_TRUECOLOR_DIMS = 899,	// 899 x 899 maximum supported dimensions for PNG Truecolor (PNG-32/24, color types 2 & 6).
-		MAX_INDEXED_COLOR_DIMS = 4096,	// 4096 x 4096 maximum supported dimensions for PNG Indexed color (PNG-8, color type 3).
-		MIN_DIMS = 68,			// 68 x 68 minimum supported dimensions for both PNG Indexed color and Truecolor.
-		PNG_INDEXED_COLOR = 3,		// PNG-8, Indexed color value.
-		PNG_TRUECOLOR = 2;		// PNG-24, Truecolour value. (We also use this value for PNG-32 (Truecolour with alpha 6), as we consider them the same for this program.
-
-	const bool
-		VALID_COLOR_TYPE = (PNG_COLOR_TYPE == PNG_INDEXED_COLOR) ? true		// Checking for valid color type of PNG image (PNG-32/24 Truecolor or PNG-8 Indexed color only).
-		: ((PNG_COLOR_TYPE == PNG_TRUECOLOR) ? true : false),
-
-		VALID_IMAGE_DIMS = (PNG_COLOR_TYPE == PNG_TRUECOLOR			// Checking for valid dimension size for PNG Truecolor (PNG-32/24) images.
-			&& MAX_TRUECOLOR_DIMS >= IMAGE_WIDTH_DIMS
-			&& MAX_TRUECOLOR_DIMS >= IMAGE_HEIGHT_DIMS
-			&& IMAGE_WIDTH_DIMS >= MIN_DIMS
-			&& IMAGE_HEIGHT_DIMS >= MIN_DIMS) ? true
-		: ((PNG_COLOR_TYPE == PNG_INDEXED_COLOR					// Checking for valid dimension size for PNG Indexed color (PNG-8) images.
-			&& MAX_INDEXED_COLOR_DIMS >= IMAGE_WIDTH_DIMS
-			&& MAX_INDEXED_COLOR_DIMS >= IMAGE_HEIGHT_DIMS
-			&& IMAGE_WIDTH_DIMS >= MIN_DIMS
-			&& IMAGE_HEIGHT_DIMS >= MIN_DIMS) ? true : false);
-
-	if (!VALID_COLOR_TYPE || !VALID_IMAGE_DIMS) {
-		// Requirements check failure, display relevant error message and exit program.
-		std::cerr << "\nImage File Error: " << (!VALID_COLOR_TYPE ? "Color type of PNG image is not supported.\n\nPNG-32/24 (Truecolor) or PNG-8 (Indexed Color) only"
-			: "Dimensions of PNG image are not within the supported range.\n\nPNG-32/24 Truecolor: [68 x 68]<->[899 x 899].\nPNG-8 Indexed Color: [68 x 68]<->[4096 x 4096]") << ".\n\n";
+	PDV_INDEX index;
+
+	const PDV_ERROR INDEX_ERROR = Open_Index(index, image_name, true);
+
+	if (INDEX_ERROR != PDV_ERROR::NONE || !index.saved) {
+		Print_Error("%s", Error_Message(INDEX_ERROR != PDV_ERROR::NONE ? INDEX_ERROR : PDV_ERROR::WRITE_OUT));
 		std::exit(EXIT_FAILURE);
 	}
+	std::printf("\nSaved index: %s (%zu chunks, %zu entries, %zu sync points, %zu bytes).\n\nComplete!\n\n", Index_File_Name(image_name).c_str(),
+		Index_Chunks(index), Index_Entries(index), Index_Sync_Points(index), index.file.size);
 
-	// We appear to have a compatible PNG to use as our cover image. Now erase all unnecessary chunks.
-	Erase_Image_Chunks(pdv, zip_ifs);
+	Close_Index(index);
 }
 
-void Erase_Image_Chunks(PDV_STRUCT& pdv, std::ifstream& zip_ifs) {
-
-	// Keep the critical PNG chunks: IHDR, *PLTE, IDAT & IEND.
+void List_Entries(const std::string& image_name) {
 
-	std::vector<Byte>Temp_Vec;
+	PDV_INDEX index;
 
-	// Copy the first 33 bytes of Image_Vec into Temp_Vec (PNG header + IHDR).
-	Temp_Vec.insert(Temp_Vec.begin(), pdv.Image_Vec.begin(), pdv.Image_Vec.begin() + 33);
+	const PDV_ERROR INDEX_ERROR = Open_Index(index, image_name, false);
 
-	const std::string IDAT_SIG = "IDAT";
-
-	// Get first IDAT chunk index.
-	size_t idat_index = std::search(pdv.Image_Vec.begin(), pdv.Image_Vec.end(), IDAT_SIG.begin(), IDAT_SIG.end()) - pdv.Image_Vec.begin() - 4;  // -4 is to position the index at the start of the IDAT chunk's length field.
+	if (INDEX_ERROR != PDV_ERROR::NONE) {
+		Print_Error("%s", Error_Message(INDEX_ERROR));
+		std::exit(EXIT_FAILURE);
+	}
 
-	// Make sure this is a valid IDAT chunk. Check CRC value.
+	std::printf("\n%14s %14s %-8s  %s\n", "Size", "Packed", "CRC", "Name");
 
-	// Get first IDAT chunk length value
-	const size_t
-		FIRST_IDAT_LENGTH = ((static_cast<size_t>(pdv.Image_Vec[idat_index]) << 24)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 1]) << 16)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 2]) << 8)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 3]))),
+	for (size_t entry = 0; entry < Index_Entries(index); entry++) {
+		const INDEX_ENTRY ENTRY = Index_Entry(index, entry);
 
-		// Get first IDAT chunk's CRC index location.
-		FIRST_IDAT_CRC_INDEX = idat_index + FIRST_IDAT_LENGTH + 8,
+		std::printf("%14llu %14llu %08x  %s\n", static_cast<unsigned long long>(ENTRY.uncompressed_size), static_cast<unsigned long long>(ENTRY.compressed_size),
+			static_cast<unsigned>(ENTRY.crc), ENTRY.name.c_str());
+	}
+	std::printf("\n%zu entries. Index %s.\n\n", Index_Entries(index),
+		!index.rebuilt ? "loaded" : index.saved ? "rebuilt & saved" : "rebuilt (not saved)");
 
-		FIRST_IDAT_CRC = ((static_cast<size_t>(pdv.Image_Vec[FIRST_IDAT_CRC_INDEX]) << 24)
-			| (static_cast<size_t>(pdv.Image_Vec[FIRST_IDAT_CRC_INDEX + 1]) << 16)
-			| (static_cast<size_t>(pdv.Image_Vec[FIRST_IDAT_CRC_INDEX + 2]) << 8)
-			| (static_cast<size_t>(pdv.Image_Vec[FIRST_IDAT_CRC_INDEX + 3]))),
+	Close_Index(index);
+}
 
-		CALC_FIRST_IDAT_CRC = Crc(&pdv.Image_Vec[idat_index + 4], FIRST_IDAT_LENGTH + 4);
+void Get_Entry(const std::string& image_name, const std::string& entry_name, const std::string& out_name) {
 
-	// Make sure values match.
-	if (FIRST_IDAT_CRC != CALC_FIRST_IDAT_CRC) {
-		std::cerr << "\nImage File Error: CRC value for first IDAT chunk is invalid.\n\n";
+	if (!Valid_File_Name(out_name.c_str())) {
+		Print_Error("\nInvalid Input Error: Characters not supported by this program found within file name arguments.\n\n");
 		std::exit(EXIT_FAILURE);
 	}
 
-	// *For PNG-8 Indexed color (3) we need to keep the PLTE chunk.
-	if (Temp_Vec[25] == 3) {
+	PDV_INDEX index;
 
-		const std::string PLTE_SIG = "PLTE";
+	PDV_ERROR error = Open_Index(index, image_name, false);
 
-		// Find PLTE chunk index and copy its contents into Temp_Vec.
-		const size_t PLTE_CHUNK_INDEX = std::search(pdv.Image_Vec.begin(), pdv.Image_Vec.end(), PLTE_SIG.begin(), PLTE_SIG.end()) - pdv.Image_Vec.begin() - 4;
+	std::vector<Byte> Entry_Vec;
 
-		if (idat_index > PLTE_CHUNK_INDEX) {
-			const size_t CHUNK_SIZE = ((static_cast<size_t>(pdv.Image_Vec[PLTE_CHUNK_INDEX + 1]) << 16)
-				| (static_cast<size_t>(pdv.Image_Vec[PLTE_CHUNK_INDEX + 2]) << 8)
-				| (static_cast<size_t>(pdv.Image_Vec[PLTE_CHUNK_INDEX + 3])));
+	if (error == PDV_ERROR::NONE) {
+		const size_t ENTRY = Find_Entry(index, entry_name);
 
-			Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.begin() + PLTE_CHUNK_INDEX, pdv.Image_Vec.begin() + PLTE_CHUNK_INDEX + (CHUNK_SIZE + 12));
-		}
-		else {
-			std::cerr << "\nImage File Error: Required PLTE chunk not found for Indexed-color (PNG-8) image.\n\n";
-			std::exit(EXIT_FAILURE);
-		}
+		error = ENTRY == NO_ENTRY ? PDV_ERROR::ENTRY_NOT_FOUND : Read_Entry(index, ENTRY, 0, UINT64_MAX, Entry_Vec);
+
+		Close_Index(index);
 	}
 
-	// Find all the IDAT chunks and copy them into Temp_Vec.
-	while (pdv.image_size != idat_index + 4) {
-		const size_t CHUNK_SIZE = ((static_cast<size_t>(pdv.Image_Vec[idat_index]) << 24)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 1]) << 16)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 2]) << 8)
-			| (static_cast<size_t>(pdv.Image_Vec[idat_index + 3])));
+	std::FILE* entry_ofs = error == PDV_ERROR::NONE ? std::fopen(out_name.c_str(), "wb") : nullptr;
 
-		Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.begin() + idat_index, pdv.Image_Vec.begin() + idat_index + (CHUNK_SIZE + 12));
-		idat_index = std::search(pdv.Image_Vec.begin() + idat_index + 6, pdv.Image_Vec.end(), IDAT_SIG.begin(), IDAT_SIG.end()) - pdv.Image_Vec.begin() - 4;
+	if (error == PDV_ERROR::NONE && !entry_ofs) {
+		error = PDV_ERROR::WRITE_OUT;
 	}
+	if (entry_ofs) {
+		const bool
+			WRITE_OK = std::fwrite(Entry_Vec.data(), 1, Entry_Vec.size(), entry_ofs) == Entry_Vec.size(),
+			CLOSE_OK = !std::fclose(entry_ofs);
+
+		if (!WRITE_OK || !CLOSE_OK) {
+			std::remove(out_name.c_str());
+			error = PDV_ERROR::WRITE_OUT;
+		}
+	}
+	if (error != PDV_ERROR::NONE) {
+		Print_Error("%s", Error_Message(error));
+		std::exit(EXIT_FAILURE);
+	}
+	std::printf("\nExtracted entry: %s (%zu bytes).\n\nComplete!\n\n", out_name.c_str(), Entry_Vec.size());
+}
 
-	// Copy the last 12 bytes of Image_Vec into Temp_Vec.
-	Temp_Vec.insert(Temp_Vec.end(), pdv.Image_Vec.end() - 12, pdv.Image_Vec.end());
+void Build_Catalog_File(const std::string& catalog_name, const std::string& dir_name, size_t workers) {
 
-	Temp_Vec.swap(pdv.Image_Vec);
+	CATALOG_SUMMARY summary{};
 
-	// Update image size.
-	pdv.image_size = pdv.Image_Vec.size();
+	const PDV_ERROR CATALOG_ERROR = Build_Catalog(catalog_name, dir_name, workers, summary);
 
-	Check_Zip_File(pdv, zip_ifs);
+	if (CATALOG_ERROR != PDV_ERROR::NONE) {
+		Print_Error("%s", Error_Message(CATALOG_ERROR));
+		std::exit(EXIT_FAILURE);
+	}
+	std::printf("\nSaved catalog: %s (%zu images: %zu read, %zu unchanged. %zu names, %zu bytes).\n\nComplete!\n\n", catalog_name.c_str(),
+		summary.images, summary.read, summary.reused, summary.names, summary.size);
 }
 
-void Check_Zip_File(PDV_STRUCT& pdv, std::ifstream& zip_ifs) {
+void Find_Catalog_Entry(const std::string& catalog_name, const std::string& entry_name) {
 
-	// Vector "Zip_Vec" will store the user's ZIP file. The contents of "Zip_Vec" will later be inserted into the vector "Image_Vec" as the last "IDAT" chunk. 
-	// We will need to update the CRC value (last 4-bytes) and the chunk length field (first 4-bytes) within this vector. Both fields currently set to zero. 
+	const uint64_t START_NS = Sched_Now_Ns();
 
-	pdv.Zip_Vec = { 0x00, 0x00, 0x00, 0x00, 0x49, 0x44, 0x41, 0x54, 0x00, 0x00, 0x00, 0x00 };	// "IDAT" chunk name with 4-byte chunk length and crc fields.
+	std::vector<std::string> Path_Vec;
 
-	// Insert user's ZIP file into vector "Zip_Vec" from index 8, just after "IDAT" chunk name.
-	pdv.Zip_Vec.insert(pdv.Zip_Vec.begin() + 8, std::istreambuf_iterator<char>(zip_ifs), std::istreambuf_iterator<char>());
+	const PDV_ERROR CATALOG_ERROR = Find_In_Catalog(catalog_name, entry_name, Path_Vec);
 
-	pdv.zip_size = pdv.Zip_Vec.size();
+	const uint64_t END_NS = Sched_Now_Ns();
 
-	// Location of "IDAT" chunk length field for vector "Zip_Vec".
-	int
-		chunk_length_index = 0,
-		bits = 32;
+	if (CATALOG_ERROR != PDV_ERROR::NONE) {
+		Print_Error("%s", Error_Message(CATALOG_ERROR));
+		std::exit(EXIT_FAILURE);
+	}
 
-	// Write the updated "IDAT" chunk length of vector "Zip_Vec" within its length field. 
-	Value_Updater(pdv.Zip_Vec, chunk_length_index, pdv.zip_size - 12, bits, pdv.big_endian);
+	std::putchar('\n');
 
-	const std::string
-		ZIP_SIG = "\x50\x4B\x03\x04",	// Valid file signature of ZIP file.
-		GET_ZIP_SIG{ pdv.Zip_Vec.begin() + 8, pdv.Zip_Vec.begin() + 8 + ZIP_SIG.length() };	// Get ZIP file signature from vector "Zip_Vec".
+	for (const std::string& PATH : Path_Vec) {
+		std::printf("%s\n", PATH.c_str());
+	}
+	std::printf("\n%zu image%s holding %s (%.3f ms).\n\n", Path_Vec.size(), Path_Vec.size() == 1 ? "" : "s", entry_name.c_str(), (END_NS - START_NS) / 1e6);
+}
+
+void Embed_Files(PDV_STRUCT& pdv) {
 
-	constexpr int MIN_INZIP_NAME_LENGTH = 4;		// Set minimum filename length of zipped file. (1st filename record within ZIP archive).
+	pdv.Progress = Show_Progress;
+	pdv.Get_Arguments = Prompt_Arguments;
 
-	const int INZIP_NAME_LENGTH = pdv.Zip_Vec[34];		// Get length of zipped file name (1st file in ZIP record) from vector "Zip_Vec".
+	const std::string PDV_FILENAME = Output_File_Name();
 
-	if (GET_ZIP_SIG != ZIP_SIG || MIN_INZIP_NAME_LENGTH > INZIP_NAME_LENGTH) {
+	bool streamed = false;
+
+	const PDV_ERROR EMBED_ERROR = Run_Embed_Job(pdv, PDV_FILENAME, streamed);
+
+	if (EMBED_ERROR != PDV_ERROR::NONE) {
 		// Display relevant error message and exit program.
-		std::cerr << "\nZIP File Error: " << (GET_ZIP_SIG != ZIP_SIG ? "File does not appear to be a valid ZIP archive"
-			: "\n\nName length of first file within ZIP archive is too short.\nIncrease its length (minimum 4 characters) and make sure it has a valid extension") << ".\n\n";
+		Print_Error("%s", Error_Message(EMBED_ERROR));
 		std::exit(EXIT_FAILURE);
 	}
-	Complete_Extraction_Script(pdv);
+	Display_Saved(pdv, PDV_FILENAME, streamed);
 }
 
-void Complete_Extraction_Script(PDV_STRUCT& pdv) {
-
-	/* Vector "Script_Vec" (See "script_info.txt" in this repo).
-
-	First 4 bytes of the vector is the chunk length field, followed by chunk name "iCCP" then our barebones extraction script.
-
-	This vector stores the shell/batch script used for extracting and opening the embedded zipped file (First filename within the ZIP file record).
-	The barebones script is about 300 bytes. The script size limit is 750 bytes, which should be more than enough to account
-	for the later addition of filenames, application & argument strings, plus other required script commands.
-
-	Script supports both Linux & Windows. The completed script, when executed, will unzip the archive within the
-	PNG image and (depending on file type) attempt to open/display/play/run the first filename within the ZIP file record by using an application
-	command based on the matched file extension, or if no match found, defaulting to the operating system making the choice.
-
-	The zipped file needs to be compatible with the operating system you are running it on.
-	The completed script within the "iCCP" chunk will later be inserted into the vector "Image_Vec" which contains the user's PNG image file */
-
-	pdv.Script_Vec = {
-			0x00, 0x00, 0x00, 0xFD, 0x69, 0x43, 0x43, 0x50, 0x73, 0x63, 0x72, 0x00, 0x00, 0x0D, 0x52,
-			0x45, 0x4D, 0x3B, 0x63, 0x6C, 0x65, 0x61, 0x72, 0x3B, 0x6D, 0x6B, 0x64, 0x69, 0x72, 0x20,
-			0x2E, 0x2F, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63,
-			0x74, 0x65, 0x64, 0x3B, 0x6D, 0x76, 0x20, 0x22, 0x24, 0x30, 0x22, 0x20, 0x2E, 0x2F, 0x70,
-			0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64,
-			0x3B, 0x63, 0x64, 0x20, 0x2E, 0x2F, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78,
-			0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x3B, 0x75, 0x6E, 0x7A, 0x69, 0x70, 0x20, 0x2D,
-			0x71, 0x6F, 0x20, 0x22, 0x24, 0x30, 0x22, 0x3B, 0x63, 0x6C, 0x65, 0x61, 0x72, 0x3B, 0x22,
-			0x22, 0x3B, 0x65, 0x78, 0x69, 0x74, 0x3B, 0x0D, 0x0A, 0x23, 0x26, 0x63, 0x6C, 0x73, 0x26,
-			0x6D, 0x6B, 0x64, 0x69, 0x72, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F,
-			0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x6D, 0x6F, 0x76, 0x65, 0x20,
-			0x22, 0x25, 0x7E, 0x64, 0x70, 0x6E, 0x78, 0x30, 0x22, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76,
-			0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72, 0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x63,
-			0x64, 0x20, 0x2E, 0x5C, 0x70, 0x64, 0x76, 0x7A, 0x69, 0x70, 0x5F, 0x65, 0x78, 0x74, 0x72,
-			0x61, 0x63, 0x74, 0x65, 0x64, 0x26, 0x63, 0x6C, 0x73, 0x26, 0x74, 0x61, 0x72, 0x20, 0x2D,
-			0x78, 0x66, 0x20, 0x22, 0x25, 0x7E, 0x6E, 0x30, 0x25, 0x7E, 0x78, 0x30, 0x22, 0x26, 0x20,
-			0x22, 0x22, 0x26, 0x72, 0x65, 0x6E, 0x20, 0x22, 0x25, 0x7E, 0x6E, 0x30, 0x25, 0x7E, 0x78,
-			0x30, 0x22, 0x20, 0x2A, 0x2E, 0x70, 0x6E, 0x67, 0x26, 0x65, 0x78, 0x69, 0x74, 0x0D, 0x0A,
-			0x00, 0x00, 0x00, 0x00 };
-
-	// "App_Vec" string vector. 
-	// Stores file extensions for some popular media types, along with several default application commands (+ args) that support those extensions.
-	// These vector string elements will be used in the completion of our extraction script.
-
-	std::vector<std::string> App_Vec{ "aac", "mp3", "mp4", "avi", "asf", "flv", "ebm", "mkv", "peg", "wav", "wmv", "wma", "mov", "3gp", "ogg", "pdf", ".py", "ps1", "exe",
-		".sh", "vlc --play-and-exit --no-video-title-show ", "evince ", "python3 ", "pwsh ", "./", "xdg-open ", "powershell;Invoke-Item ",
-		" &> /dev/null", "start /b \"\"", "pause&", "powershell", "chmod +x ", ";" };
-
-	constexpr int
-		FIRST_ZIP_NAME_REC_LENGTH_INDEX = 34,	// "Zip_Vec" vector's index location for the length value of the zipped filename (First filename within the ZIP file record).
-		FIRST_ZIP_NAME_REC_INDEX = 38,		// "Zip_Vec" start index location for the zipped filename.
-
-		// "App_Vec" vector element index values. 
-		// Some "App_Vec" vector string elements are added later (via emplace_back) so they don't currently appear in the above string vector.
-
-		VIDEO_AUDIO = 20,		// "vlc" app command for Linux. 
-		PDF = 21,			// "evince" app command for Linux. 
-		PYTHON = 22,			// "python3" app command for Linux & Windows.
-		POWERSHELL = 23,		// "pwsh" app command for Linux, for starting PowerShell scripts.
-		EXECUTABLE = 24,		// "./" prepended to filename. Required when running Linux executables.
-		BASH_XDG_OPEN = 25,		// "xdg-open" Linux command, runs shell scripts (.sh), opens folders & unmatched file extensions.
-		FOLDER_INVOKE_ITEM = 26,	// "powershell;Invoke-Item" command used in Windows for opening zipped folders, instead of files.
-		START_B = 28,			// "start /b" Windows command used to open most file types. Windows uses set default app for most file types.
-		WIN_POWERSHELL = 30,		// "powershell" commmand used by Windows for running PowerShell scripts.
-		PREPEND_FIRST_ZIP_NAME_REC = 36;	// first_zip_name with ".\" prepended characters. Required for Windows PowerShell, e.g. powershell ".\my_ps_script.ps1".
-
-	const int FIRST_ZIP_NAME_REC_LENGTH = pdv.Zip_Vec[FIRST_ZIP_NAME_REC_LENGTH_INDEX];	// Get character length of the zipped media filename from vector "Zip_Vec".
-
-	std::string
-		// Get the zipped filename string from vector "Zip_Vec". (First filename within the ZIP record).
-		first_zip_name{ pdv.Zip_Vec.begin() + FIRST_ZIP_NAME_REC_INDEX, pdv.Zip_Vec.begin() + FIRST_ZIP_NAME_REC_INDEX + FIRST_ZIP_NAME_REC_LENGTH },
+// Batch options ("--batch"), shared by the scheduler's worker threads. Finished jobs are collected in "Done_Vec" for the summary.
+static const PDV_STRUCT* batch_options;
+static std::vector<PDV_JOB> Done_Vec;
+static std::mutex batch_mutex;
 
-		// Get the file extension from the zipped filename.
-		first_zip_name_ext = first_zip_name.substr(first_zip_name.length() - 3, 3),
+static const char* PRIORITY_NAMES[]{ "high", "normal", "low" };
 
-		// Variables for optional command-line arguments.
-		args_linux{},
-		args_windows{};
+// Scheduler callbacks for "--batch". Run a job (quietly, without argument prompts) / display its result as it finishes.
+static PDV_ERROR Run_Batch_Job(PDV_JOB& job) {
+	PDV_STRUCT pdv;
 
-	// Check for "." character to see if the "first_zip_name" has a file extension.
-	const auto CHECK_FILE_EXT = first_zip_name.find_last_of('.');
+	pdv.image_name = job.image_name;
+	pdv.zip_name = job.zip_name;
+	pdv.max_memory = batch_options->max_memory;
+	pdv.trace_name = batch_options->trace_name;
+	pdv.metrics_name = batch_options->metrics_name;
+	pdv.reduce_image = batch_options->reduce_image;
+	pdv.carriers = batch_options->carriers;
+	pdv.direct_io = batch_options->direct_io;
+	pdv.hash_output = job.journal_key != 0;
+	pdv.threads = 1;	// Jobs already run in parallel.
 
-	// Store this filename (first filename within the ZIP record) in "App_Vec" vector (33).
-	App_Vec.emplace_back(first_zip_name);
+	const PDV_ERROR EMBED_ERROR = Run_Embed_Job(pdv, job.output_name, job.streamed);
 
-	// When inserting string elements from vector "App_Vec" into the script (within vector "Script_Vec"), we are adding items in 
-	// the order of last to first. The Windows script is completed first, followed by Linux. 
-	// This order prevents the vector insert locations from changing every time we add a new string element into the vector.
+	job.output_size = pdv.image_size;
+	job.output_crc = pdv.output_crc;
 
-	// The vector "Sequence_Vec" can be split into four sequences containing "Script_Vec" index values (high numbers) used by the 
-	// "insert_index" variable and the corresponding "App_Vec" index values (low numbers) used by the "app_index" variable.
+	return EMBED_ERROR;
+}
 
-	// For example, in the 1st sequence, Sequence_Vec[0] = index 241 of "Script_Vec" ("insert_index") corresponds with
-	// Sequence_Vec[5] = "App_Vec" index 33 ("app_index"), which is the "first_zip_name" string element (first filename within the ZIP record). 
-	// "App_Vec" string element 33 (first_zip_name) will be inserted into the script (vector "Script_Vec") at index 241.
+static void Batch_Job_Done(const PDV_JOB& job) {
+	const std::lock_guard<std::mutex> LOCK(batch_mutex);
 
-	int
-		app_index = 0,		// Uses the "App_Vec" index values from the vector Sequence_Vec.
-		insert_index = 0,	// Uses the "Script_Vec" index values from vector Sequence_Vec.
-		sequence_limit = 0;	// Stores the length limit of each of the four sequences. 
+	std::printf("%-7s %-24s %-16s %10.2f ms%s\n", PRIORITY_NAMES[static_cast<size_t>(job.priority)], job.output_name.c_str(), Error_Name(job.result),
+		(job.end_ns - job.submit_ns) / 1e6, job.deadline_ns && job.end_ns > job.deadline_ns ? " (deadline missed)" : "");
 
-	std::vector<int>Sequence_Vec{
-			241, 239, 121, 120, 119,	// 1st sequence for case "VIDEO_AUDIO".
-			33, 28, 27, 33, 20,
+	// Jobs without a key (an input file couldn't be read when the batch started) are not recorded.
+	if (job.result == PDV_ERROR::NONE && job.journal_key) {
+		Journal_Append(job);
+	}
+	Done_Vec.push_back(job);
+}
 
-			241, 239, 120, 119,		// 2nd sequence for cases "PDF, FOLDER_INVOKE_ITEM, DEFAULT".
-			33, 28, 33, 21,
+// Batch file: one job per line, "<cover_image> <zip_file> [<output_image>] [priority=high|normal|low] [deadline=<ms>]". Blank lines & lines starting with "#" are skipped.
+// Names can't contain spaces. The output image defaults to "pzip_<line number>.png". The priority defaults to "high" for jobs under "SMALL_JOB_SIZE" bytes,
+// otherwise "normal". The deadline is in milliseconds from the start of the batch.
+void Run_Batch(const PDV_STRUCT& options, const std::string& batch_name, const std::string& journal_name, size_t workers) {
 
-			264, 242, 241, 239, 121, 120, 119,			// 3rd sequence for cases "PYTHON, POWERSHELL".
-			29, 35, 33, 22, 34, 33, 22,
+	const uint64_t BATCH_START_NS = Sched_Now_Ns();
 
-			264, 242, 241, 239, 121, 120, 119, 119, 119, 119,	// 4th sequence for cases "EXECUTABLE & BASH_XDG_OPEN".
-			29, 35, 33, 28, 34, 33, 24, 32, 33, 31 };
+	std::FILE* batch_ifs = std::fopen(batch_name.c_str(), "rb");
 
-	/*  	[Sequence_Vec](insert_index)[Sequence_Vec](app_index)
-		Build script example below is using the first sequence (see vector "Sequence_Vec" above).
+	if (!batch_ifs) {
+		Print_Error("\nRead File Error: Unable to open batch file.\n\n");
+		std::exit(EXIT_FAILURE);
+	}
 
-		VIDEO_AUDIO:
-		[0]>(241)[5]>(33) Windows: "Image_Vec" 241 insert index for the string variable first_zip_name, "App_Vec" 33.
-		[1]>(239)[6]>(28) Windows: "Image_Vec" 239 insert index for the string "start /b", "App_Vec" 28.
-		[2]>(121)[7]>(27) Linux: "Image_Vec" 121 insert index for the string "Dev Null", "App_Vec" 27.
-		[3]>(120)[8]>(33) Linux: "Image_Vec" 120 insert index for the the string variable first_zip_name, "App_Vec" 33.
-		[4]>(119)[9]>(20) Linux: "Image_Vec" 119 insert index for the string "vlc", "App_Vec" 20.
-		Sequence limit is 5 (value taken from first app_index value for each sequence).
+	std::vector<PDV_JOB> Job_Vec;
+	std::vector<std::string> Token_Vec;
+	std::unordered_set<std::string> Output_Set;
 
-		Matching a file extension from the string variable "first_zip_name_ext" within "App_Vec" (33), we can select which application string and commands to use
-		in our extraction script, which when executed, will (depending on file type) open/display/play/run the extracted zipped file ("first_zip_name").
+	char line[4096];
+	size_t line_number = 0;
 
-		Once the correct app extension has been matched by the "for-loop" below, it passes the app_index result to the switch statement.
-		The relevant Case sequence is then used in completing the extraction script within vector "Script_Vec".	*/
+	while (std::fgets(line, sizeof(line), batch_ifs)) {
+		line_number++;
 
-	for (; app_index != 26; app_index++) {
-		if (App_Vec[app_index] == first_zip_name_ext) {
-			// After a file extension match, any app_index value between 0 and 14 defaults to "App_Vec" 20 (vlc / VIDEO_AUDIO).
-			// If over 14, we add 6 to the value. 15 + 6 = "App_Vec" 21 (evince for PDF (Linux) ), 16 + 6 = "App_Vec" 22 (python3/.py), etc.
-			app_index = app_index <= 14 ? 20 : app_index += 6;
-			break;
+		Token_Vec.clear();
+		for (char* token = std::strtok(line, " \t\r\n"); token; token = std::strtok(nullptr, " \t\r\n")) {
+			Token_Vec.emplace_back(token);
 		}
-	}
 
-	// If no file extension detected, check if "first_zip_name" points to a folder (/), else assume file is a Linux executable.
-	if (CHECK_FILE_EXT == 0 || CHECK_FILE_EXT > first_zip_name.length()) {
-		app_index = pdv.Zip_Vec[FIRST_ZIP_NAME_REC_INDEX + FIRST_ZIP_NAME_REC_LENGTH - 1] == '/' ? FOLDER_INVOKE_ITEM : EXECUTABLE;
-	}
+		if (Token_Vec.empty() || Token_Vec[0][0] == '#') {
+			continue;
+		}
 
-	// Provide the user with the option to add command-line arguments for file types: 
-	// Python (.py), PowerShell (.ps1), Shell script (.sh) and executable (.exe). (no extension, defaults to .exe, if not a folder).
-	// The provided arguments for your file type will be stored within the PNG image, along with the extraction script.
+		const char* line_error = Token_Vec.size() < 2 ? "Expecting a cover image and a ZIP file" : Check_File_Names(Token_Vec[0], Token_Vec[1]);
 
-	if (app_index > 21 && app_index < 26) {
-		std::cout << "\nFor this file type you can provide command-line arguments here, if required.\n\nLinux: ";
-		std::getline(std::cin, args_linux);
-		std::cout << "\nWindows: ";
-		std::getline(std::cin, args_windows);
+		PDV_JOB job;
 
-		args_linux.insert(0, "\x20"),
-		args_windows.insert(0, "\x20");
+		job.image_name = Token_Vec[0];
+		job.zip_name = Token_Vec.size() > 1 ? Token_Vec[1] : "";
 
-		App_Vec.emplace_back(args_linux),	// "App_Vec" (34).
-		App_Vec.emplace_back(args_windows);	// "App_Vec" (35).
-	}
+		bool priority_set = false;
 
-	std::cout << "\nUpdating extraction script.\n";
+		for (size_t i = 2; i < Token_Vec.size() && !line_error; i++) {
+			const std::string& TOKEN = Token_Vec[i];
 
-	switch (app_index) {
-		case VIDEO_AUDIO:	// Case uses 1st sequence: [241,239,121,120,119] , [33,28,27,33,20].
-			app_index = 5;
-			break;
-		case PDF:		// These two cases (with minor changes) use the 2nd sequence: [241,239,120,119] , [33,28,33,21].
-		case FOLDER_INVOKE_ITEM:
-			Sequence_Vec[15] = app_index == FOLDER_INVOKE_ITEM ? FOLDER_INVOKE_ITEM : START_B;
-			Sequence_Vec[17] = app_index == FOLDER_INVOKE_ITEM ? BASH_XDG_OPEN : PDF;
-			insert_index = 10;
-			app_index = 14;
-			break;
-		case PYTHON:		// These two cases (with some changes) use the 3rd sequence: [264,242,241,239,121,120,119] , [29,35,33,22,34,33,22].
-		case POWERSHELL:
-			if (app_index == POWERSHELL) {
-				first_zip_name.insert(0, ".\\");		//  ".\" prepend to "first_zip_name". Required for Windows PowerShell, e.g. powershell ".\my_ps_script.ps1".
-				App_Vec.emplace_back(first_zip_name);		// Add the filename with the prepended ".\" to the "AppVec" vector (36).
-				Sequence_Vec[31] = POWERSHELL;			// Swap index number to Linux PowerShell (pwsh 23)
-				Sequence_Vec[28] = WIN_POWERSHELL;		// Swap index number to Windows PowerShell (powershell 30)
-				Sequence_Vec[27] = PREPEND_FIRST_ZIP_NAME_REC;	// Swap index number to PREPEND_FIRST_ZIP_NAME_REC (36), used with the Windows powershell command.
+			if (!TOKEN.compare(0, 9, "priority=")) {
+				const auto PRIORITY = std::find(std::begin(PRIORITY_NAMES), std::end(PRIORITY_NAMES), TOKEN.substr(9));
+				if (PRIORITY == std::end(PRIORITY_NAMES)) {
+					line_error = "Invalid priority. Expecting high, normal or low";
+				}
+				job.priority = static_cast<PDV_PRIORITY>(PRIORITY - std::begin(PRIORITY_NAMES));
+				priority_set = true;
 			}
-			insert_index = 18;
-			app_index = 25;
-			break;
-		case EXECUTABLE:	// These two cases (with minor changes) use the 4th sequence: [264,242,241,239,121,120,119,119,119,119] , [29,35,33,28,34,33,24,32,33,31].
-		case BASH_XDG_OPEN:
-			insert_index = app_index == EXECUTABLE ? 32 : 33;
-			app_index = insert_index == 32 ? 42 : 43;
-			break;
-		default:			// Unmatched file extensions. Rely on operating system to use the set default program for dealing with unknown file types.
-			insert_index = 10;	// Default uses 2nd sequence, we just need to alter one index number.
-			app_index = 14;
-			Sequence_Vec[17] = BASH_XDG_OPEN;	// Swap index number to BASH_XDG_OPEN (25)
-	}
-
-	// Set the sequence_limit variable using the first app_index value from each switch case sequence.
-	// Reduce sequence_limit variable value by 1 if insert_index is 33 (case BASH_XDG_OPEN).
-
-	sequence_limit = insert_index == 33 ? app_index - 1 : app_index;
+			else if (!TOKEN.compare(0, 9, "deadline=")) {
+				char* end = nullptr;
+				const unsigned long long DEADLINE_MS = std::strtoull(TOKEN.c_str() + 9, &end, 10);
+				if (*end || end == TOKEN.c_str() + 9 || !DEADLINE_MS) {
+					line_error = "Invalid deadline. Expecting a number of milliseconds";
+				}
+				job.deadline_ns = BATCH_START_NS + DEADLINE_MS * 1000000;
+			}
+			else if (job.output_name.empty() && TOKEN.size() > 4 && !TOKEN.compare(TOKEN.size() - 4, 4, ".png") && Valid_File_Name(TOKEN.c_str())) {
+				job.output_name = TOKEN;
+			}
+			else {
+				line_error = "Unexpected field";
+			}
+		}
 
-	// With just a single vector insert command within the "while-loop", we can insert all the required strings into the extraction script (vector "Script_Vec"), 
-	// based on the sequence, which is selected by the relevant Case from the above switch statement after the extension match. 
+		if (line_error) {
+			Print_Error("\nBatch File Error: Line %zu: %s.\n\n", line_number, line_error);
+			std::exit(EXIT_FAILURE);
+		}
 
-	while (sequence_limit > insert_index) {
-		pdv.Script_Vec.insert(pdv.Script_Vec.begin() + Sequence_Vec[insert_index], App_Vec[Sequence_Vec[app_index]].begin(), App_Vec[Sequence_Vec[app_index]].end());
-		insert_index++;
-		app_index++;
-	}
+		if (job.output_name.empty()) {
+			job.output_name = "pzip_" + std::to_string(line_number) + ".png";
+		}
 
-	pdv.script_size = pdv.Script_Vec.size();
+		const size_t
+			IMAGE_SIZE = File_Size(job.image_name),
+			ZIP_SIZE = File_Size(job.zip_name);
 
-	int
-		chunk_length_index = 2,	// "Script_Vec" vector's index location for the "iCCP" chunk length field.
-		bits = 16;
+		job.size = IMAGE_SIZE + ZIP_SIZE;
+		job.memory = Job_Memory_Size(IMAGE_SIZE, ZIP_SIZE, Cover_Decode_Size(job.image_name, IMAGE_SIZE, options.reduce_image), options.max_memory);
 
-	// Call function to write updated chunk length value for the "iCCP" chunk into its length field. 
-	// Due to its small size, the "iCCP" chunk will only use 2 bytes maximum (bits=16) of the 4 byte length field.
+		if (!priority_set) {
+			job.priority = job.size < SMALL_JOB_SIZE ? PDV_PRIORITY::HIGH : PDV_PRIORITY::NORMAL;
+		}
 
-	Value_Updater(pdv.Script_Vec, chunk_length_index, pdv.script_size - 12, bits, pdv.big_endian);
+		// Hashed, so that large batch files (hundreds of thousands of jobs) are read in linear time.
+		if (!Output_Set.insert(job.output_name).second) {
+			Print_Error("\nBatch File Error: Line %zu: Output image %s is already used by another job.\n\n", line_number, job.output_name.c_str());
+			std::exit(EXIT_FAILURE);
+		}
+		Job_Vec.push_back(std::move(job));
+	}
+	std::fclose(batch_ifs);
 
-	// Check the first byte of the "iCCP" chunk length field to make sure the updated chunk length does not match 
-	// any of the "BAD_CHAR" characters that will break the Linux extraction script.
+	// Skip the jobs completed by earlier runs. The other jobs keep their order (see "PDV_JOB::sequence").
+	size_t skipped = 0;
 
-	for (int i = 0; i < 7; i++) {
-		if (pdv.Script_Vec[3] == pdv.BAD_CHAR[i]) {
+	if (!journal_name.empty()) {
+		if (!Journal_Open(journal_name, options)) {
+			Print_Error("\nJournal Error: Unable to open the journal file, or it is not a pdvzip journal.\n\n");
+			std::exit(EXIT_FAILURE);
+		}
 
-			// "BAD_CHAR" found. Insert 10 bytes "." at the end of "Script_Vec" to increase chunk length. Update chunk length field. 
-			// This should now skip over any BAD_CHAR characters, regardless of the chunk size (within its size limit).
+		for (PDV_JOB& job : Job_Vec) {
+			job.journal_key = Journal_Key(job);
+		}
 
-			const std::string INCREASE_LENGTH_STRING = "..........";
+		const size_t JOBS = Job_Vec.size();
 
-			pdv.Script_Vec.insert(pdv.Script_Vec.begin() + pdv.script_size - 4, INCREASE_LENGTH_STRING.begin(), INCREASE_LENGTH_STRING.end());
+		Job_Vec.erase(std::remove_if(Job_Vec.begin(), Job_Vec.end(), Journal_Done), Job_Vec.end());
 
-			pdv.script_size = pdv.Script_Vec.size();
+		skipped = JOBS - Job_Vec.size();
 
-			Value_Updater(pdv.Script_Vec, chunk_length_index, pdv.script_size - 12, bits, pdv.big_endian); // Update size again.
+		std::printf("\nResuming from journal %s (%zu records): %zu of %zu jobs already completed.\n", journal_name.c_str(), Journal_Records(), skipped, JOBS);
+	}
 
-			break;
-		}
+	if (!options.trace_name.empty()) {
+		Trace_Open(options.trace_name);
+	}
+	if (!options.metrics_name.empty()) {
+		Metrics_Open(options.metrics_name);
 	}
 
-	pdv.combined_file_size = pdv.Script_Vec.size() + pdv.Image_Vec.size() + pdv.Zip_Vec.size();
+	batch_options = &options;
+	Done_Vec.reserve(Job_Vec.size());
 
-	constexpr int
-		MAX_SCRIPT_SIZE = 750,
-		ICCP_CHUNK_INDEX = 4;
+	// Jobs only start once submitted, so nothing is printed by a worker before this line.
+	Scheduler_Start(workers, options.max_memory, Run_Batch_Job, Batch_Job_Done);
 
-	// Display relevant error message and exit program if extraction script exceeds size limit.
-	if (pdv.script_size > MAX_SCRIPT_SIZE || pdv.combined_file_size > pdv.MAX_FILE_SIZE) {
-		std::cerr << "\nFile Size Error: " << (pdv.script_size > MAX_SCRIPT_SIZE ? "Extraction script exceeds size limit"
-			: "The combined file size of your PNG image, ZIP file and Extraction Script, exceeds file size limit") << ".\n\n";
-		std::exit(EXIT_FAILURE);
+	std::printf("\nRunning %zu jobs on %zu worker threads", Job_Vec.size(), workers);
+	if (Scheduler_Nodes()) {
+		std::printf(" across %zu NUMA nodes", Scheduler_Nodes());
 	}
+	if (options.max_memory) {
+		std::printf(", within a memory budget of %zu KB", options.max_memory / 1024);
+	}
+	if (options.direct_io) {
+		std::fputs(", with direct I/O", stdout);
+	}
+	std::fputs(".\n\n", stdout);
+	std::fflush(stdout);
 
-	// Now the "iCCP" chunk is complete with the extraction script, we need to update the chunk's CRC value.
-	// Pass these two values (ICCP_CHUNK_INDEX & iCCP chunk size (script_size) - 8) to the CRC function to get correct "iCCP" chunk CRC value.
-
-	const size_t ICCP_CHUNK_CRC = Crc(&pdv.Script_Vec[ICCP_CHUNK_INDEX], pdv.script_size - 8);
+	Scheduler_Submit(std::move(Job_Vec));
+	Scheduler_Finish();
 
-	// Get vector index location for the "iCCP" chunk's CRC field.
-	size_t iccp_crc_index = pdv.script_size - 4;
+	if (!Journal_Close()) {
+		Print_Error("\nJournal Error: Unable to record some completed jobs. They will be run again by the next --resume.\n");
+	}
 
-	bits = 32;
+	// Summary: latency (from the start of the batch to the end of each job) by priority class, nearest rank percentiles.
+	const double ELAPSED_MS = (Sched_Now_Ns() - BATCH_START_NS) / 1e6;
 
-	// Write the updated CRC value into the "iCCP" chunk's CRC field (bits=32) within vector "Script_Vec".
-	Value_Updater(pdv.Script_Vec, iccp_crc_index, ICCP_CHUNK_CRC, bits, pdv.big_endian);
+	size_t
+		failed = 0,
+		output_bytes = 0;
 
-	// Insert vectors "Scrip_Vec" ("iCCP" chunk with completed extraction script) & "Zip_Vec" ("IDAT" chunk with ZIP file) into vector "Image_Vec" (PNG image).
-	Combine_Vectors(pdv);
-}
+	std::printf("\n%-7s %6s %6s %12s %12s %12s %9s\n", "class", "jobs", "failed", "p50 ms", "p99 ms", "max ms", "missed");
 
-void Combine_Vectors(PDV_STRUCT& pdv) {
+	for (size_t priority = 0; priority < static_cast<size_t>(PDV_PRIORITY::COUNT); priority++) {
+		std::vector<double> Latency_Vec;
+		size_t
+			class_failed = 0,
+			missed = 0;
 
-	// This value will be used as the insert location within vector "Image_Vec" for contents of vector "Script_Vec". 
-	// Script_Vec's inserted contents will appear within the "iCCP" chunk, just after the "IHDR" chunk of "Image_Vec".
+		for (const PDV_JOB& job : Done_Vec) {
+			if (static_cast<size_t>(job.priority) != priority) {
+				continue;
+			}
+			Latency_Vec.push_back((job.end_ns - job.submit_ns) / 1e6);
+			class_failed += job.result != PDV_ERROR::NONE;
+			missed += job.deadline_ns && job.end_ns > job.deadline_ns;
+		}
 
-	constexpr int FIRST_IDAT_INDEX = 33;
+		if (Latency_Vec.empty()) {
+			continue;
+		}
+		std::sort(Latency_Vec.begin(), Latency_Vec.end());
 
-	std::cout << "\nEmbedding extraction script within the PNG image.\n";
+		const auto Percentile = [&Latency_Vec](double p) { return Latency_Vec[static_cast<size_t>(p * (Latency_Vec.size() - 1) + 0.5)]; };
 
-	// Insert contents of vector "Script_Vec" ("iCCP" chunk containing the extraction script) into vector "Image_Vec".	
-	pdv.Image_Vec.insert((pdv.Image_Vec.begin() + FIRST_IDAT_INDEX), pdv.Script_Vec.begin(), pdv.Script_Vec.end());
+		std::printf("%-7s %6zu %6zu %12.2f %12.2f %12.2f %9zu\n", PRIORITY_NAMES[priority], Latency_Vec.size(), class_failed,
+			Percentile(0.5), Percentile(0.99), Latency_Vec.back(), missed);
 
-	std::cout << "\nEmbedding ZIP file within the PNG image.\n";
+		failed += class_failed;
+	}
 
-	// Insert contents of vector "Zip_Vec" ("IDAT" chunk with ZIP file) into vector "Image_Vec".
-	// This now becomes the new last "IDAT" chunk of the PNG image within vector "Image_Vec".
+	for (const PDV_JOB& job : Done_Vec) {
+		if (job.result == PDV_ERROR::NONE) {
+			output_bytes += File_Size(job.output_name);
+		}
+	}
 
-	pdv.Image_Vec.insert((pdv.Image_Vec.end() - 12), pdv.Zip_Vec.begin(), pdv.Zip_Vec.end());
+	std::printf("\nComplete! %zu of %zu jobs succeeded in %.2f ms (%zu bytes written).\n", Done_Vec.size() - failed, Done_Vec.size(), ELAPSED_MS, output_bytes);
+	if (skipped) {
+		std::printf("%zu jobs skipped (completed by an earlier run).\n", skipped);
+	}
+	std::fputs("\n", stdout);
 
-	const size_t IDAT_ZIP_INDEX = pdv.image_size + pdv.script_size - 8;
+	if (failed) {
+		std::exit(EXIT_FAILURE);
+	}
+}
 
-	// Before updating the last "IDAT" chunk's CRC value, adjust ZIP file offsets within this chunk, to their new locations, so that the ZIP file continues to be valid & extractable.
-	Fix_Zip_Offset(pdv, IDAT_ZIP_INDEX);
+void Display_Saved(PDV_STRUCT& pdv, const std::string& PDV_FILENAME, bool streamed) {
 
-	// Get CRC value for our (new) last "IDAT" chunk.
-	const size_t IDAT_ZIP_CRC = Crc(&pdv.Image_Vec[IDAT_ZIP_INDEX], pdv.zip_size - 8); // We don't include the length or CRC fields (-8 bytes).
+	std::printf("\nSaved PNG image: %s %zu Bytes.\n\nComplete!\n\nYou can now share your PNG-ZIP polyglot image on the relevant supported platforms.\n\n", PDV_FILENAME.c_str(), pdv.image_size);
 
-	pdv.image_size = pdv.Image_Vec.size();
+	if (pdv.max_memory) {
+		std::printf("Memory budget: %zu KB (%s).", pdv.max_memory / 1024, streamed ? "ZIP file streamed from disk" : "ZIP file read into memory");
+#ifdef __linux__
+		// Peak resident set size of the whole process (includes program code & libraries, as well as the job's buffers).
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		std::printf(" Peak RSS: %ld KB.", usage.ru_maxrss);
+#endif
+		std::fputs("\n\n", stdout);
+	}
 
-	size_t crc_insert_index = pdv.image_size - 16;	// Get index location for last "IDAT" chunk's 4-byte CRC field, from vector "Image_Vec".
+	if (!pdv.stats_name.empty()) {
+		if (Write_Stats_Report(pdv, PDV_FILENAME, streamed)) {
+			std::printf("Saved stats report: %s\n\n", pdv.stats_name.c_str());
+		}
+		else {
+			Print_Error("\nWrite File Error: Unable to write stats report.\n\n");
+		}
+	}
+}
 
-	int bits = 32;
+std::string Output_File_Name() {
 
-	pdv.big_endian = true;
+	srand((unsigned)time(NULL));  // For output filename.
 
-	// Write new CRC value into the last "IDAT" chunk's CRC index field, within the vector "Image_Vec".
-	Value_Updater(pdv.Image_Vec, crc_insert_index, IDAT_ZIP_CRC, bits, pdv.big_endian);
+	const std::string NAME_VALUE = std::to_string(rand());
 
-	Write_Out_Polyglot_File(pdv);
+	return "pzip_" + NAME_VALUE.substr(0, 5) + ".png";
 }
 
-void Fix_Zip_Offset(PDV_STRUCT& pdv, const size_t& IDAT_ZIP_INDEX) {
+bool Parse_Size(const char* arg, size_t& size) {
+	char* suffix = nullptr;
 
-	const std::string
-		START_CENTRAL_DIR_SIG = "PK\x01\x02",
-		END_CENTRAL_DIR_SIG = "PK\x05\x06",
-		ZIP_SIG = "PK\x03\x04";
-	
-	// Search vector "Image_Vec" (start from last "IDAT" chunk index) to get locations for "Start Central Directory" & "End Central Directory".
-	const size_t
-		START_CENTRAL_DIR_INDEX = std::search(pdv.Image_Vec.begin() + IDAT_ZIP_INDEX, pdv.Image_Vec.end(), START_CENTRAL_DIR_SIG.begin(), START_CENTRAL_DIR_SIG.end()) - pdv.Image_Vec.begin(),
-		END_CENTRAL_DIR_INDEX = std::search(pdv.Image_Vec.begin() + START_CENTRAL_DIR_INDEX, pdv.Image_Vec.end(), END_CENTRAL_DIR_SIG.begin(), END_CENTRAL_DIR_SIG.end()) - pdv.Image_Vec.begin();
+	const unsigned long long VALUE = std::strtoull(arg, &suffix, 10);
 
-	size_t
-		zip_records_index = END_CENTRAL_DIR_INDEX + 11,		// Index location for ZIP file records value.
-		comment_length_index = END_CENTRAL_DIR_INDEX + 21,	// Index location for ZIP comment length.
-		end_central_start_index = END_CENTRAL_DIR_INDEX + 19,	// Index location for End Central Start offset.
-		central_local_index = START_CENTRAL_DIR_INDEX - 1,	// Initialise variable to just before Start Central index location.
-		new_offset = IDAT_ZIP_INDEX;				// Initialise variable to start index of last IDAT chunk, which contains user's ZIP file.
-
-	int 
-		bits = 32,
-		zip_records = (pdv.Image_Vec[zip_records_index] << 8) | pdv.Image_Vec[zip_records_index - 1];	// Get ZIP file records value from index location of vector "Image_Vec".
-	
-	pdv.big_endian = false;
-
-	// Starting from the last "IDAT" chunk, search for ZIP file record offsets and update them to their new offset location.
-	while (zip_records--) {
-		new_offset = std::search(pdv.Image_Vec.begin() + new_offset + 1, pdv.Image_Vec.end(), ZIP_SIG.begin(), ZIP_SIG.end()) - pdv.Image_Vec.begin(),
-		central_local_index = 45 + std::search(pdv.Image_Vec.begin() + central_local_index, pdv.Image_Vec.end(), START_CENTRAL_DIR_SIG.begin(), START_CENTRAL_DIR_SIG.end()) - pdv.Image_Vec.begin();
-		Value_Updater(pdv.Image_Vec, central_local_index, new_offset, bits, pdv.big_endian);
-	}
-	
-	// Write updated "Start Central Directory" offset into End Central Directory's "Start Central Directory" index location within vector "Image_Vec".
-	Value_Updater(pdv.Image_Vec, end_central_start_index, START_CENTRAL_DIR_INDEX, bits, pdv.big_endian);
-
-	// JAR file support. Get global comment length value from ZIP file within vector "Image_Vec" and increase it by 16 bytes to cover end of PNG file.
-	// To run a JAR file, you will need to rename the '.png' extension to '.jar'.  
-	// or run the command: "java -jar image_file_name.png"
-
-	int comment_length = 16 + (static_cast<size_t>(pdv.Image_Vec[comment_length_index] << 8) | (static_cast<size_t>(pdv.Image_Vec[comment_length_index - 1])));
-
-	bits = 16;
-
-	// Write the ZIP comment length value into the comment length index location within vector "Image_Vec".
-	Value_Updater(pdv.Image_Vec, comment_length_index, comment_length, bits, pdv.big_endian);
-}
+	if (suffix == arg || *arg == '-') {
+		return false;
+	}
 
-void Write_Out_Polyglot_File(PDV_STRUCT& pdv) {
+	int shift = 0;
 
-	srand((unsigned)time(NULL));  // For output filename.
+	switch (*suffix) {
+		case '\0':			break;
+		case 'K': case 'k':	shift = 10; break;
+		case 'M': case 'm':	shift = 20; break;
+		case 'G': case 'g':	shift = 30; break;
+		default:		return false;
+	}
 
-	const std::string
-		NAME_VALUE = std::to_string(rand()),
-		PDV_FILENAME = "pzip_" + NAME_VALUE.substr(0, 5) + ".png"; // Unique filename for the complete polyglot image.
+	if ((shift && suffix[1]) || VALUE > (~0ULL >> shift)) {
+		return false;
+	}
+
+	size = static_cast<size_t>(VALUE << shift);
+	return true;
+}
 
-	std::ofstream file_ofs(PDV_FILENAME, std::ios::binary);
+bool Parse_Dimensions(const char* arg, uint32_t& width, uint32_t& height) {
+	char* end = nullptr;
 
-	if (!file_ofs) {
-		std::cerr << "\nWrite File Error: Unable to write to file.\n\n";
-		std::exit(EXIT_FAILURE);
+	const unsigned long WIDTH = std::strtoul(arg, &end, 10);
+
+	if (end == arg || *arg == '-' || (*end != 'x' && *end != 'X')) {
+		return false;
 	}
 
-	std::cout << "\nWriting ZIP embedded PNG image out to disk.\n";
+	const char* HEIGHT_ARG = end + 1;
 
-	// Write out to file vector "Image_Vec" now containing the completed polyglot image (Image + Script + ZIP).
-	file_ofs.write((char*)&pdv.Image_Vec[0], pdv.image_size);
+	const unsigned long HEIGHT = std::strtoul(HEIGHT_ARG, &end, 10);
 
-	std::cout << "\nSaved PNG image: " + PDV_FILENAME + '\x20' + std::to_string(pdv.image_size) + " Bytes.\n\nComplete!\n\nYou can now share your PNG-ZIP polyglot image on the relevant supported platforms.\n\n";
-}
+	if (end == HEIGHT_ARG || *HEIGHT_ARG == '-' || *end || WIDTH > 0xFFFF || HEIGHT > 0xFFFF) {
+		return false;
+	}
 
-// The following code (slightly modified) to compute CRC32 (for "IDAT" & "iCCP" chunks) was taken from: https://www.w3.org/TR/2003/REC-PNG-20031110/#D-CRCAppendix 
-size_t Crc_Update(const size_t& Crc, Byte* buf, const size_t& len) {
-	// Table of CRCs of all 8-bit messages.
-	constexpr size_t Crc_Table[256]{
-		0x00, 	    0x77073096, 0xEE0E612C, 0x990951BA, 0x76DC419,  0x706AF48F, 0xE963A535, 0x9E6495A3, 0xEDB8832,  0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x9B64C2B,  0x7EB17CBD,
-		0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7, 0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC,
-		0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
-		0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59, 0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
-		0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x1DB7106,  0x98D220BC, 0xEFD5102A, 0x71B18589, 0x6B6B51F,
-		0x9FBFE4A5, 0xE8B8D433, 0x7807C9A2, 0xF00F934,  0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x86D3D2D,  0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
-		0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65, 0x4DB26158, 0x3AB551CE,
-		0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
-		0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F, 0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
-		0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x3B6E20C,  0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x4DB2615,  0x73DC1683, 0xE3630B12, 0x94643B84, 0xD6D6A3E,  0x7A6A5AA8,
-		0xE40ECF0B, 0x9309FF9D, 0xA00AE27,  0x7D079EB1, 0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0,
-		0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-		0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703,
-		0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D, 0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x26D930A,
-		0x9C0906A9, 0xEB0E363F, 0x72076785, 0x5005713,  0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0xCB61B38,  0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0xBDBDF21,  0x86D3D2D4, 0xF1D4E242,
-		0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777, 0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
-		0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5,
-		0x47B2CF7F, 0x30B5FFE9, 0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-		0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D };
-
-	// Update a running CRC with the bytes buf[0..len - 1] the CRC should be initialized to all 1's, 
-	// and the transmitted value is the 1's complement of the final running CRC (see the crc() routine below).
-	size_t c = Crc;
-
-	for (int n = 0; n < len; n++) {
-		c = Crc_Table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
-	}
-	return c;
+	width = static_cast<uint32_t>(WIDTH);
+	height = static_cast<uint32_t>(HEIGHT);
+	return true;
 }
 
-// Return the CRC of the bytes buf[0..len-1].
-size_t Crc(Byte* buf, const size_t& len)
-{
-	return Crc_Update(0xffffffffL, buf, len) ^ 0xffffffffL;
+void Show_Progress(const char* message) {
+	std::fputs(message, stdout);
 }
 
-void Value_Updater(std::vector<Byte>& vec, size_t value_insert_index, const size_t& NEW_VALUE, int bits, bool big_endian) {
+// Provide the user with the option to add command-line arguments for file types:
+// Python (.py), PowerShell (.ps1), Shell script (.sh) and executable (.exe). (no extension, defaults to .exe, if not a folder).
+void Prompt_Arguments(PDV_STRUCT& pdv) {
+	std::fputs("\nFor this file type you can provide command-line arguments here, if required.\n\nLinux: ", stdout);
+	Read_Line(pdv.args_linux);
+	std::fputs("\nWindows: ", stdout);
+	Read_Line(pdv.args_windows);
+}
 
-	if (big_endian) {
-		while (bits) {
-			static_cast<size_t>(vec[value_insert_index++] = (NEW_VALUE >> (bits -= 8)) & 0xff);
-		}
+// Read a line of user input from stdin, without the trailing newline. Flush any pending (buffered) prompt text first.
+void Read_Line(std::string& line) {
+	std::fflush(stdout);
+	for (int c; (c = std::getchar()) != EOF && c != '\n';) {
+		line += static_cast<char>(c);
 	}
-	else {
-		while (bits) {
-			static_cast<size_t>(vec[value_insert_index--] = (NEW_VALUE >> (bits -= 8)) & 0xff);
-		}
+	if (!line.empty() && line.back() == '\r') {
+		line.pop_back();
 	}
 }
 
 void Display_Info() {
 
-	std::cout << R"(
+	std::fputs(R"(
 PNG Data Vehicle ZIP Edition (PDVZIP v1.8). Created by Nicholas Cleasby (@CleasbyCode) 6/08/2022.
 		
 PDVZIP enables you to embed a ZIP file within a *tweetable and "executable" PNG image.  		
@@ -809,7 +944,7 @@ Note: Images that are created & saved within your image editor as PNG-32/24 that
 black & white/grayscale, images with 256 colours or less, will be converted by Twitter to 
 PNG-8 and you will lose the embedded content. If you want to use a simple "single" colour PNG-32/24 image,
 then fill an area with a gradient colour instead of a single solid colour.
-Twitter should then keep the image as PNG-32/24.
+Twitter should then keep the image as PNG-32/24. pdvzip checks for this and rejects such images.
 
 PNG-8 (Indexed-colour [3])
 
@@ -829,7 +964,16 @@ PLTE, (Use only with PNG-32 & PNG-24 for arbitrary data).
 pHYs, sBIT, sPLT, sRGB,
 tRNS. (Not recommended, may distort image).
 
-This program uses the iCCP (extraction script) and IDAT (zip file) chunk names for storing arbitrary data.
+This program uses the iCCP (extraction script) and IDAT (zip file, plus any --pack zip files) chunk names for storing arbitrary data.
+With --carriers twitter, the start of the zip file also fills the iCCP (after the script) and up to six sPLT chunks
+(as their palette entries). With --carriers splt, it fills up to eight sPLT chunks instead.
+Use --extract to get the zip file (or a --pack zip file, by name) back from the image.
+Use --index to write a sidecar index (<image>.pdvidx) for fast repeated access, --list to list the zip file entries
+and --get to write out one entry. Entries within a --pack zip file are named <pack_name>:<entry_name>.
+Use --catalog build <dir> to catalog the entries of every image within a directory (rebuilding only new or changed images),
+then --catalog find <entry_name> to list the images holding an entry of that name (or last name part, e.g. readme.txt).
+Use --http 127.0.0.1:8080 <dir> (Linux) to serve the entries of the images within a directory at http://127.0.0.1:8080/<image>/<entry_name>,
+with range requests, without extracting them.
 
 ZIP File Size & Other Information
 
@@ -847,5 +991,5 @@ Use file extensions for your media file within the ZIP archive: my_doc.pdf, my_v
 A file without an extension will be treated as a Linux executable.
 Paint.net application is recommended for easily creating compatible PNG image files.
  
-)";
+)", stdout);
 }